@@ -262,7 +262,7 @@ void HCALRecHitAnalyzer::FillGeometry(const edm::EventSetup& iSetup)
       return;
     }
   
-  const CaloGeometry cG = *pG;
+  const CaloGeometry& cG = *pG;
   
   const HcalGeometry* HBgeom = dynamic_cast<const HcalGeometry*>(cG.getSubdetectorGeometry(DetId::Hcal,HcalBarrel));
   const HcalGeometry* HEgeom = dynamic_cast<const HcalGeometry*>(cG.getSubdetectorGeometry(DetId::Hcal,HcalEndcap));
@@ -32,6 +32,8 @@
 #include "Geometry/ForwardGeometry/interface/ZdcGeometry.h"
 #include "Geometry/HGCalGeometry/interface/HGCalGeometry.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
+
+#include <chrono>
 //
 // member functions
 //
@@ -47,6 +49,33 @@ CaloGeometryBuilder::CaloGeometryBuilder( const edm::ParameterSet& iConfig )
    theCaloList = iConfig.getParameter< std::vector<std::string> >("SelectedCalos");
    if ( theCaloList.empty() ) throw cms::Exception("Configuration") 
       << "No calorimeter specified for geometry, aborting";
+   theLazy = iConfig.getUntrackedParameter<bool>("lazy", false);
+}
+
+template< class Record >
+void
+CaloGeometryBuilder::addSubdet( CaloGeometry& calo, const Record& record, const std::string& tag,
+				DetId::Detector det, int subdet ) const
+{
+   if( theLazy )
+   {
+      // the record copy stays valid for the IOV of the CaloGeometry, which depends on it
+      calo.setSubdetGeometryGetter( det, subdet, [record, tag, det, subdet]() {
+	    auto start = std::chrono::steady_clock::now();
+	    edm::ESHandle< CaloSubdetectorGeometry > pG;
+	    record.get( tag, pG );
+	    edm::LogInfo("CaloGeometryBuilder") << "Lazy access to " << tag << " reconstruction geometry (det "
+						<< (int)det << ", subdet " << subdet << ") took "
+						<< std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count()
+						<< " ms";
+	    return pG.product(); } );
+   }
+   else
+   {
+      edm::ESHandle< CaloSubdetectorGeometry > pG;
+      record.get( tag, pG );
+      calo.setSubdetGeometry( det, subdet, pG.product() );
+   }
 }
 
 // ------------ method called to produce the data  ------------
@@ -54,8 +83,6 @@ CaloGeometryBuilder::CaloGeometryBuilder( const edm::ParameterSet& iConfig )
 CaloGeometryBuilder::ReturnType
 CaloGeometryBuilder::produceAligned( const CaloGeometryRecord& iRecord )
 {
-   edm::ESHandle< CaloSubdetectorGeometry > pG;
-
    ReturnType pCalo ( new CaloGeometry() ) ;
 
    // loop on selected calorimeters
@@ -69,53 +96,54 @@ CaloGeometryBuilder::produceAligned( const CaloGeometryRecord& iRecord )
       {
 	 edm::LogInfo("CaloGeometryBuilder") << "Building HCAL reconstruction geometry";
 
-	 iRecord.getRecord< HcalGeometryRecord >().get( HcalGeometry::producerTag(), pG );  
-	 pCalo->setSubdetGeometry( DetId::Hcal, HcalBarrel , pG.product() );
-	 pCalo->setSubdetGeometry( DetId::Hcal, HcalEndcap , pG.product() );
-	 pCalo->setSubdetGeometry( DetId::Hcal, HcalOuter  , pG.product() );
-	 pCalo->setSubdetGeometry( DetId::Hcal, HcalForward, pG.product() );
+	 const HcalGeometryRecord record ( iRecord.getRecord< HcalGeometryRecord >() );
+	 addSubdet( *pCalo, record, HcalGeometry::producerTag(), DetId::Hcal, HcalBarrel  );
+	 addSubdet( *pCalo, record, HcalGeometry::producerTag(), DetId::Hcal, HcalEndcap  );
+	 addSubdet( *pCalo, record, HcalGeometry::producerTag(), DetId::Hcal, HcalOuter   );
+	 addSubdet( *pCalo, record, HcalGeometry::producerTag(), DetId::Hcal, HcalForward );
       }
       else if ( (*ite) == ZdcGeometry::producerTag() ) 
       {
 	 edm::LogInfo("CaloGeometryBuilder") << "Building ZDC reconstruction geometry";
-	 iRecord.getRecord< ZDCGeometryRecord >().get( ZdcGeometry::producerTag(), pG ); 
-	 pCalo->setSubdetGeometry( DetId::Calo, HcalZDCDetId::SubdetectorId,pG.product());
+	 addSubdet( *pCalo, iRecord.getRecord< ZDCGeometryRecord >(), ZdcGeometry::producerTag(),
+		    DetId::Calo, HcalZDCDetId::SubdetectorId );
       }
       else if ( (*ite) == CastorGeometry::producerTag() ) 
       {
 	 edm::LogInfo("CaloGeometryBuilder") << "Building CASTOR reconstruction geometry";
-	 iRecord.getRecord< CastorGeometryRecord >().get( CastorGeometry::producerTag(), pG ); 
-	 pCalo->setSubdetGeometry( DetId::Calo, HcalCastorDetId::SubdetectorId,pG.product());
+	 addSubdet( *pCalo, iRecord.getRecord< CastorGeometryRecord >(), CastorGeometry::producerTag(),
+		    DetId::Calo, HcalCastorDetId::SubdetectorId );
       }
       // look for Ecal Barrel
       else if ( (*ite) == EcalBarrelGeometry::producerTag() ) 
       {
 	 edm::LogInfo("CaloGeometryBuilder") << "Building EcalBarrel reconstruction geometry";
-	 iRecord.getRecord<EcalBarrelGeometryRecord>().get( EcalBarrelGeometry::producerTag(), pG ); 
-	 pCalo->setSubdetGeometry(DetId::Ecal,EcalBarrel,pG.product());
+	 addSubdet( *pCalo, iRecord.getRecord<EcalBarrelGeometryRecord>(), EcalBarrelGeometry::producerTag(),
+		    DetId::Ecal, EcalBarrel );
       }
       // look for Ecal Endcap
       else if ( (*ite) == EcalEndcapGeometry::producerTag() ) 
       {
 	 edm::LogInfo("CaloGeometryBuilder") << "Building EcalEndcap reconstruction geometry";
-	 iRecord.getRecord<EcalEndcapGeometryRecord>().get( EcalEndcapGeometry::producerTag(), pG ); 
-	 pCalo->setSubdetGeometry(DetId::Ecal,EcalEndcap,pG.product());
+	 addSubdet( *pCalo, iRecord.getRecord<EcalEndcapGeometryRecord>(), EcalEndcapGeometry::producerTag(),
+		    DetId::Ecal, EcalEndcap );
       }
       // look for Ecal Preshower
       else if ( (*ite) == EcalPreshowerGeometry::producerTag() ) 
       {
 	 edm::LogInfo("CaloGeometryBuilder") << "Building EcalPreshower reconstruction geometry";
- 	 iRecord.getRecord<EcalPreshowerGeometryRecord>().get(EcalPreshowerGeometry::producerTag(), pG); 
-	 pCalo->setSubdetGeometry(DetId::Ecal,EcalPreshower,pG.product());
+	 addSubdet( *pCalo, iRecord.getRecord<EcalPreshowerGeometryRecord>(), EcalPreshowerGeometry::producerTag(),
+		    DetId::Ecal, EcalPreshower );
       }
       // look for TOWER parts
       else if ( (*ite) == CaloTowerGeometry::producerTag() ) 
       {
 	 edm::LogInfo("CaloGeometryBuilder") << "Building TOWER reconstruction geometry";
-	 iRecord.getRecord<CaloTowerGeometryRecord>().get(CaloTowerGeometry::producerTag(),pG);
-	 pCalo->setSubdetGeometry(DetId::Calo,1,pG.product());
+	 addSubdet( *pCalo, iRecord.getRecord<CaloTowerGeometryRecord>(), CaloTowerGeometry::producerTag(),
+		    DetId::Calo, 1 );
       }
       else if ( ite->find(HGCalGeometry::producerTag()) != std::string::npos ) {
+	// the detector and subdetector are known only from the geometry itself: never lazy
 	edm::LogInfo("CaloGeometryBuilder") << "Building " << *ite << " reconstruction geometry";
 	edm::ESHandle<HGCalGeometry> pHG;
 	iRecord.getRecord<IdealGeometryRecord>().get(*ite,pHG);
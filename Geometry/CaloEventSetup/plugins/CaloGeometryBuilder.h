@@ -48,8 +48,15 @@ class CaloGeometryBuilder : public edm::ESProducer
       ReturnType produceAligned( const CaloGeometryRecord&  iRecord ) ;
 
    private:
+      // register the subdetector geometry produced with tag in record,
+      // either now or (lazy mode) on first access
+      template< class Record >
+      void addSubdet( CaloGeometry& calo, const Record& record, const std::string& tag,
+		      DetId::Detector det, int subdet ) const ;
+
       // ----------member data ---------------------------
       
       std::vector<std::string> theCaloList;
+      bool theLazy;
 };
 
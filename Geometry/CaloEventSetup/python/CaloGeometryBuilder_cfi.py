@@ -7,7 +7,9 @@ CaloGeometryBuilder = cms.ESProducer("CaloGeometryBuilder",
                                 'EcalBarrel'    , 
                                 'EcalEndcap'    , 
                                 'EcalPreshower' , 
-                                'TOWER'           )
+                                'TOWER'           ),
+    # build each subdetector geometry on first access only
+    lazy = cms.untracked.bool(False)
 )
 
 
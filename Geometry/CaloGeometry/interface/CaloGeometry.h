@@ -3,7 +3,10 @@
 
 #include "DataFormats/DetId/interface/DetId.h"
 #include "DataFormats/GeometryVector/interface/GlobalPoint.h"
+#include <atomic>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 #include "FWCore/Utilities/interface/GCC11Compatibility.h"
@@ -24,12 +27,20 @@ class CaloGeometry
 {
    public:
 
+      typedef std::function<const CaloSubdetectorGeometry*()> SubdetGeometryGetter ;
+
       CaloGeometry() ;
     
       /// Register a subdetector geometry
       void setSubdetGeometry( DetId::Detector                det    , 
 			      int                            subdet , 
 			      const CaloSubdetectorGeometry* geom    ) ;
+
+      /// Register a subdetector geometry to be obtained on first access (lazy mode);
+      /// the getter is called at most once, even with concurrent accesses
+      void setSubdetGeometryGetter( DetId::Detector      det    ,
+				    int                  subdet ,
+				    SubdetGeometryGetter getter  ) ;
     
       /// Get the position of a given detector id
       GlobalPoint getPosition( const DetId& id ) const;
@@ -60,7 +71,11 @@ class CaloGeometry
 
       static const std::vector<DetId> k_emptyVec ;
 
-      std::vector< const CaloSubdetectorGeometry* > m_geos ;
+      const CaloSubdetectorGeometry* subdetGeometry( unsigned int index ) const ;
+
+      std::unique_ptr< std::atomic<const CaloSubdetectorGeometry*>[] > m_geos ;
+      std::vector< SubdetGeometryGetter > m_getters ;
+      std::unique_ptr< std::once_flag[] > m_once ;
 
       unsigned int makeIndex( DetId::Detector det,
 			      int             subdet,
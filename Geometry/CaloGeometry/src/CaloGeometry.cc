@@ -7,8 +7,11 @@
 const std::vector<DetId> CaloGeometry::k_emptyVec ( 0 ) ;
 
 CaloGeometry::CaloGeometry() :
-   m_geos ( kLength, nullptr )
+   m_geos    ( new std::atomic<const CaloSubdetectorGeometry*>[ kLength ] ) ,
+   m_getters ( kLength ) ,
+   m_once    ( new std::once_flag[ kLength ] )
 {
+   for( unsigned int i ( 0 ) ; i != kLength ; ++i ) m_geos[i].store( nullptr ) ;
 }
 
 unsigned int 
@@ -36,15 +39,43 @@ CaloGeometry::setSubdetGeometry( DetId::Detector                det    ,
 				 const CaloSubdetectorGeometry* geom     )  {
    bool ok ;
    const unsigned int index = makeIndex( det, subdet, ok ) ;
-   if( ok ) m_geos[index] = geom ;
+   if( ok ) m_geos[index].store( geom, std::memory_order_release ) ;
 
    edm::LogVerbatim("CaloGeometry") << "Detector=" << (int)det << ", subset="
 				    << subdet << ", index=" << index
-				    << ", size=" << m_geos.size();
+				    << ", size=" << kLength;
 
    assert( ok ) ;
 }
 
+void 
+CaloGeometry::setSubdetGeometryGetter( DetId::Detector      det    , 
+				       int                  subdet , 
+				       SubdetGeometryGetter getter  )  {
+   bool ok ;
+   const unsigned int index = makeIndex( det, subdet, ok ) ;
+   if( ok ) m_getters[index] = std::move( getter ) ;
+
+   edm::LogVerbatim("CaloGeometry") << "Detector=" << (int)det << ", subset="
+				    << subdet << ", index=" << index
+				    << " registered for lazy construction";
+
+   assert( ok ) ;
+}
+
+const CaloSubdetectorGeometry* 
+CaloGeometry::subdetGeometry( unsigned int index ) const
+{
+   const CaloSubdetectorGeometry* geom ( m_geos[index].load( std::memory_order_acquire ) ) ;
+   if( nullptr == geom && m_getters[index] )
+   {
+      std::call_once( m_once[index], [this,index]() { 
+	    m_geos[index].store( m_getters[index](), std::memory_order_release ) ; } ) ;
+      geom = m_geos[index].load( std::memory_order_acquire ) ;
+   }
+   return geom ;
+}
+
 const CaloSubdetectorGeometry* 
 CaloGeometry::getSubdetectorGeometry( const DetId& id ) const 
 {
@@ -53,7 +84,7 @@ CaloGeometry::getSubdetectorGeometry( const DetId& id ) const
    const unsigned int index ( makeIndex( id.det(),
 					 id.subdetId(),
 					 ok             ) ) ;
-   return ( ok ? m_geos[ index ] : nullptr ) ;
+   return ( ok ? subdetGeometry( index ) : nullptr ) ;
 }
 
 const CaloSubdetectorGeometry* 
@@ -65,7 +96,7 @@ CaloGeometry::getSubdetectorGeometry( DetId::Detector det    ,
    const unsigned int index ( makeIndex( det,
 					 subdet,
 					 ok             ) ) ;
-   return ( ok ? m_geos[ index ] : nullptr ) ;
+   return ( ok ? subdetGeometry( index ) : nullptr ) ;
 }
 
 static const GlobalPoint notFound(0,0,0);
@@ -105,11 +136,12 @@ std::vector<DetId> CaloGeometry::getValidDetIds() const
    returnValue.reserve( kLength ) ;
 
    bool doneHcal ( false ) ;
-   for( unsigned int i ( 0 ) ; i != m_geos.size() ; ++i ) 
+   for( unsigned int i ( 0 ) ; i != kLength ; ++i ) 
    {     
-      if( nullptr != m_geos[i] )
+      const CaloSubdetectorGeometry* geom ( subdetGeometry( i ) ) ;
+      if( nullptr != geom )
       {
-	 const std::vector< DetId >& aVec = m_geos[i]->getValidDetIds();	 
+	 const std::vector< DetId >& aVec = geom->getValidDetIds();	 
 	 if( aVec.empty() ) {
 	   edm::LogWarning("CaloGeometry") << "Valid det id list at index " 
 					   << i << " is empty!";
@@ -137,8 +169,9 @@ CaloGeometry::getValidDetIds( DetId::Detector det    ,
 					 subdet,
 					 ok             ) ) ;
 
-   return ( ok && ( nullptr != m_geos[ index ] ) ?
-	    m_geos[ index ]->getValidDetIds( det, subdet ) :
+   const CaloSubdetectorGeometry* geom ( ok ? subdetGeometry( index ) : nullptr ) ;
+   return ( nullptr != geom ?
+	    geom->getValidDetIds( det, subdet ) :
 	    k_emptyVec ) ;
 }
   
@@ -0,0 +1,70 @@
+#ifndef Geometry_TrackerGeometryBuilder_TrackerDetIdIndex_h
+#define Geometry_TrackerGeometryBuilder_TrackerDetIdIndex_h
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+/**
+ * Compact open-addressing table mapping a raw DetId to its position
+ * in a det container (e.g. TrackerGeometry::detUnits()).
+ * Keys and values are stored interleaved so that a lookup touches in the
+ * common case a single cache line; the table is built once at geometry
+ * construction and is read-only afterwards.
+ * DetId 0 is used as the empty marker: it is never a valid tracker det.
+ */
+class TrackerDetIdIndex {
+public:
+  static constexpr uint32_t invalid = std::numeric_limits<uint32_t>::max();
+
+  TrackerDetIdIndex() = default;
+
+  // index i of the input is the value returned by find(rawIds[i]);
+  // duplicated ids keep the first occurrence
+  void build(std::vector<uint32_t> const & rawIds) {
+    unsigned int bits=4;
+    while ( (1u<<bits) < 2*rawIds.size() ) ++bits;
+    theShift = 32-bits;
+    theMask = (1u<<bits)-1;
+    theSize = 0;
+    theTable.assign(1u<<bits, Entry(0,invalid));
+    for (uint32_t i=0; i<rawIds.size(); ++i) {
+      auto id = rawIds[i];
+      if (id==0) continue;
+      auto b = bucket(id);
+      while (theTable[b].first!=0 && theTable[b].first!=id) b = (b+1)&theMask;
+      if (theTable[b].first==id) continue;
+      theTable[b] = Entry(id,i);
+      ++theSize;
+    }
+  }
+
+  uint32_t find(uint32_t id) const {
+    if (theTable.empty()) return invalid;
+    auto b = bucket(id);
+    while (true) {
+      auto const & e = theTable[b];
+      if (e.first==id) return e.second;
+      if (e.first==0) return invalid;
+      b = (b+1)&theMask;
+    }
+  }
+
+  unsigned int size() const { return theSize;}
+  bool empty() const { return theSize==0;}
+  unsigned int capacity() const { return theTable.size();}
+
+private:
+  using Entry = std::pair<uint32_t,uint32_t>;
+
+  // Fibonacci hashing: the high bits of the product mix all DetId fields
+  uint32_t bucket(uint32_t id) const { return (id*2654435769u)>>theShift;}
+
+  std::vector<Entry> theTable;
+  uint32_t theShift=32;
+  uint32_t theMask=0;
+  unsigned int theSize=0;
+};
+
+#endif
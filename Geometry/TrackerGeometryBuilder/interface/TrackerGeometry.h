@@ -4,6 +4,7 @@
 #include "Geometry/CommonDetUnit/interface/TrackingGeometry.h"
 #include "Geometry/CommonDetUnit/interface/GeomDetEnumerators.h"
 #include "Geometry/CommonDetUnit/interface/TrackerGeomDet.h"
+#include "Geometry/TrackerGeometryBuilder/interface/TrackerDetIdIndex.h"
 
 class GeometricDet;
 
@@ -106,6 +107,8 @@ private:
   DetIdContainer    theDetIds; 
   mapIdToDetUnit    theMapUnit; // does not own GeomDetUnit *
   mapIdToDet        theMap;     // does not own GeomDet *
+  TrackerDetIdIndex theUnitIndex; // DetId -> position in theDetUnits, filled in finalize()
+  TrackerDetIdIndex theDetIndex;  // DetId -> position in theDets, filled in finalize()
 
   DetContainer      thePXBDets; // not owned: they're also in 'theDets'
   DetContainer      thePXFDets; // not owned: they're also in 'theDets'
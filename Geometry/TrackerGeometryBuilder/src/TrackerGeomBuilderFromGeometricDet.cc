@@ -145,6 +145,8 @@ TrackerGeomBuilderFromGeometricDet::build( const GeometricDet* gd, const PTracke
 
   verifyDUinTG(*tracker);
 
+  tracker->finalize();
+
   return tracker;
 }
 
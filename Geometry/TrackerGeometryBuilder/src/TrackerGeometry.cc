@@ -110,6 +110,14 @@ void TrackerGeometry::finalize() {
     theTIDDets.shrink_to_fit(); // not owned: they're also in 'theDets'
     theTOBDets.shrink_to_fit(); // not owned: they're also in 'theDets'
     theTECDets.shrink_to_fit(); // not owned: they're also in 'theDets'
+
+    // dense lookup tables used by idToDetUnit/idToDet
+    std::vector<uint32_t> ids; ids.reserve(theDets.size());
+    for (auto d : theDetUnits) ids.push_back(d->geographicalId().rawId());
+    theUnitIndex.build(ids);
+    ids.clear();
+    for (auto d : theDets) ids.push_back(d->geographicalId().rawId());
+    theDetIndex.build(ids);
 }
 
 void TrackerGeometry::addType(GeomDetType const * p) {
@@ -201,6 +209,12 @@ TrackerGeometry::detsTEC() const
 const TrackerGeomDet * 
 TrackerGeometry::idToDetUnit(DetId s)const
 {
+  if (!theUnitIndex.empty()) {
+    auto i = theUnitIndex.find(s.rawId());
+    if (i != TrackerDetIdIndex::invalid) return static_cast<const TrackerGeomDet *>(theDetUnits[i]);
+    throw cms::Exception("WrongTrackerSubDet") << "Invalid DetID: no GeomDetUnit associated with raw ID "
+					       << s.rawId() << " of subdet ID " << s.subdetId();
+  }
   mapIdToDetUnit::const_iterator p=theMapUnit.find(s.rawId());
   if (p != theMapUnit.end()) {
     return static_cast<const TrackerGeomDet *>(p->second);
@@ -213,6 +227,12 @@ TrackerGeometry::idToDetUnit(DetId s)const
 const TrackerGeomDet* 
 TrackerGeometry::idToDet(DetId s)const
 {
+  if (!theDetIndex.empty()) {
+    auto i = theDetIndex.find(s.rawId());
+    if (i != TrackerDetIdIndex::invalid) return static_cast<const TrackerGeomDet *>(theDets[i]);
+    throw cms::Exception("WrongTrackerSubDet") << "Invalid DetID: no GeomDetUnit associated with raw ID "
+					       << s.rawId() << " of subdet ID " << s.subdetId();
+  }
   mapIdToDet::const_iterator p=theMap.find(s.rawId());
   if (p != theMap.end()) {
     return static_cast<const TrackerGeomDet *>(p->second);
@@ -0,0 +1,69 @@
+#include "Geometry/TrackerGeometryBuilder/interface/TrackerDetIdIndex.h"
+
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+  // phase1-like raw ids: det=1 (tracker), subdet 1..6, then a sparse layer/ladder/module pattern
+  std::vector<uint32_t> makeIds() {
+    std::vector<uint32_t> ids;
+    for (uint32_t sub=1; sub<7; ++sub)
+      for (uint32_t layer=1; layer<10; ++layer)
+        for (uint32_t ladder=1; ladder<40; ++ladder)
+          for (uint32_t module=1; module<9; ++module)
+            ids.push_back( (1u<<28) | (sub<<25) | (layer<<20) | (ladder<<12) | (module<<2) );
+    return ids;
+  }
+
+}
+
+int main() {
+
+  auto ids = makeIds();
+
+  TrackerDetIdIndex index;
+  index.build(ids);
+  assert(index.size()==ids.size());
+  for (uint32_t i=0; i<ids.size(); ++i) assert(index.find(ids[i])==i);
+  assert(index.find(0)==TrackerDetIdIndex::invalid);
+  assert(index.find(ids.back()+1)==TrackerDetIdIndex::invalid);
+
+  // duplicates keep the first entry
+  auto dup = ids; dup.push_back(ids[3]);
+  TrackerDetIdIndex dupIndex; dupIndex.build(dup);
+  assert(dupIndex.size()==ids.size());
+  assert(dupIndex.find(ids[3])==3);
+
+  std::unordered_map<unsigned int,uint32_t> map;
+  for (uint32_t i=0; i<ids.size(); ++i) map.insert(std::make_pair(ids[i],i));
+
+  // random access pattern, as from hit building
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<uint32_t> pick(0,ids.size()-1);
+  std::vector<uint32_t> queries(1<<22);
+  for (auto & q : queries) q = ids[pick(rng)];
+
+  using Clock = std::chrono::high_resolution_clock;
+  uint64_t sum=0;
+
+  auto start = Clock::now();
+  for (auto q : queries) sum += map.find(q)->second;
+  auto tMap = std::chrono::duration<double>(Clock::now()-start).count();
+
+  start = Clock::now();
+  for (auto q : queries) sum -= index.find(q);
+  auto tIndex = std::chrono::duration<double>(Clock::now()-start).count();
+
+  assert(sum==0);
+
+  std::cout << "dets " << ids.size() << " table capacity " << index.capacity() << std::endl;
+  std::cout << "unordered_map lookups/s " << queries.size()/tMap << std::endl;
+  std::cout << "TrackerDetIdIndex lookups/s " << queries.size()/tIndex << std::endl;
+
+  return 0;
+}
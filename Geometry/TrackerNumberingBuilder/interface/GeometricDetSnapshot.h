@@ -0,0 +1,49 @@
+#ifndef Geometry_TrackerNumberingBuilder_GeometricDetSnapshot_H
+#define Geometry_TrackerNumberingBuilder_GeometricDetSnapshot_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class GeometricDet;
+class PGeometricDet;
+
+/**
+ * Versioned binary snapshot of the tracker GeometricDet hierarchy, in the
+ * same flat layout as PGeometricDet (depth-first, with levels).
+ * The file is a header, an array of fixed-size records and a string table;
+ * it is memory-mapped when read, so that loading does no parsing at all.
+ * Each snapshot carries a key, the hash of the contents of the geometry
+ * inputs it was built from (the XML files, in order; the detIdShifts are a
+ * DDD vector of trackerParameters.xml and so enter through its contents):
+ * The key also includes algorithmVersion, since the DetIds depend on the
+ * numbering code as much as on the inputs: a snapshot with a different key
+ * or format version is ignored.
+ */
+
+class GeometricDetSnapshot {
+ public:
+  static constexpr uint32_t formatVersion = 2;
+  /// bump whenever the numbering (GeometricDet builders, DetId schemes, sorting) changes
+  static constexpr uint32_t algorithmVersion = 1;
+
+  /// inputFiles: full paths of the geometry inputs, throws if one cannot be read
+  GeometricDetSnapshot(std::string const & fileName, std::vector<std::string> const & inputFiles);
+
+  /// fill pgd from the snapshot; false if the file is missing or does not match
+  bool read(PGeometricDet & pgd) const;
+
+  /// write pgd to the snapshot file (through a temporary file and a rename), throws on failure
+  void write(PGeometricDet const & pgd) const;
+
+  /// flatten the hierarchy below tracker in the PGeometricDet layout
+  static void fill(GeometricDet const * tracker, PGeometricDet & pgd);
+
+  uint64_t key() const { return key_; }
+
+ private:
+  std::string fileName_;
+  uint64_t key_;
+};
+
+#endif
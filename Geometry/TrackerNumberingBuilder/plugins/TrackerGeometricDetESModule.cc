@@ -1,6 +1,8 @@
 #include "Geometry/TrackerNumberingBuilder/plugins/TrackerGeometricDetESModule.h"
 #include "Geometry/TrackerNumberingBuilder/plugins/DDDCmsTrackerContruction.h"
 #include "Geometry/TrackerNumberingBuilder/plugins/CondDBCmsTrackerConstruction.h"
+#include "Geometry/TrackerNumberingBuilder/interface/GeometricDetSnapshot.h"
+#include "Geometry/TrackerNumberingBuilder/interface/GeometricDet.h"
 #include "Geometry/Records/interface/IdealGeometryRecord.h"
 #include "DetectorDescription/Core/interface/DDCompactView.h"
 #include "DetectorDescription/Core/interface/DDVectorGetter.h"
@@ -11,14 +13,21 @@
 #include "FWCore/Framework/interface/ModuleFactory.h"
 #include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
 #include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/ParameterSet/interface/FileInPath.h"
+#include "FWCore/Utilities/interface/Exception.h"
 
 #include <memory>
 
 using namespace edm;
 
 TrackerGeometricDetESModule::TrackerGeometricDetESModule( const edm::ParameterSet & p ) 
-  : fromDDD_( p.getParameter<bool>( "fromDDD" ))
+  : fromDDD_( p.getParameter<bool>( "fromDDD" )),
+    snapshotFile_( p.getParameter<std::string>( "snapshotFile" )),
+    snapshotInputs_( p.getParameter<std::vector<std::string> >( "snapshotInputs" ))
 {
+  if( !snapshotFile_.empty() && snapshotInputs_.empty())
+    throw cms::Exception( "Configuration" ) << "TrackerGeometricDetESModule: snapshotFile requires the snapshotInputs it is built from";
   setWhatProduced( this );
 }
 
@@ -29,17 +38,54 @@ TrackerGeometricDetESModule::fillDescriptions( edm::ConfigurationDescriptions &
 {
   edm::ParameterSetDescription descDB;
   descDB.add<bool>( "fromDDD", false );
+  descDB.add<std::string>( "snapshotFile", "" );
+  descDB.add<std::vector<std::string> >( "snapshotInputs", std::vector<std::string>() );
   descriptions.add( "trackerNumberingGeometryDB", descDB );
 
   edm::ParameterSetDescription desc;
   desc.add<bool>( "fromDDD", true );
+  desc.add<std::string>( "snapshotFile", "" )->setComment( "binary snapshot used instead of the DDD, written if missing or stale" );
+  desc.add<std::vector<std::string> >( "snapshotInputs", std::vector<std::string>() )->setComment( "geometry XML files (FileInPath) whose contents the snapshot must match" );
   descriptions.add( "trackerNumberingGeometry", desc );
 }
 
 std::unique_ptr<GeometricDet> 
 TrackerGeometricDetESModule::produce( const IdealGeometryRecord & iRecord )
 { 
-  if( fromDDD_ )
+  if( fromDDD_ && !snapshotFile_.empty())
+  {
+    // the DDCompactView is not requested at all if the snapshot is valid
+    std::vector<std::string> inputs;
+    for( auto const & name : snapshotInputs_ )
+      inputs.emplace_back( edm::FileInPath( name ).fullPath());
+    GeometricDetSnapshot snapshot( snapshotFile_, inputs );
+    PGeometricDet pgd;
+    if( snapshot.read( pgd ))
+    {
+      LogDebug( "TrackerGeometricDetESModule" ) << "Tracker numbering geometry read from snapshot " << snapshotFile_;
+      CondDBCmsTrackerConstruction cdbtc;
+      return std::unique_ptr<GeometricDet> ( const_cast<GeometricDet*>( cdbtc.construct( pgd )));
+    }
+
+    edm::LogInfo( "TrackerGeometricDetESModule" ) << "Geometry snapshot " << snapshotFile_ << " missing or stale, building from DDD";
+    edm::ESTransientHandle<DDCompactView> cpv;
+    iRecord.get( cpv );
+
+    DDDCmsTrackerContruction theDDDCmsTrackerContruction;
+    std::unique_ptr<GeometricDet> tracker( const_cast<GeometricDet*>( theDDDCmsTrackerContruction.construct(&(*cpv), dbl_to_int( DDVectorGetter::get( "detIdShifts" )))));
+    GeometricDetSnapshot::fill( tracker.get(), pgd );
+    // the snapshot is only a cache: failing to write it does not fail the job
+    try
+    {
+      snapshot.write( pgd );
+    }
+    catch( cms::Exception const & e )
+    {
+      edm::LogWarning( "TrackerGeometricDetESModule" ) << "Geometry snapshot not written: " << e.explainSelf();
+    }
+    return tracker;
+  }
+  else if( fromDDD_ )
   {
     edm::ESTransientHandle<DDCompactView> cpv;
     iRecord.get( cpv );
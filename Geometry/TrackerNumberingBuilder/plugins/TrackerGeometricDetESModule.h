@@ -3,6 +3,9 @@
 
 #include "FWCore/Framework/interface/ESProducer.h"
 
+#include <string>
+#include <vector>
+
 namespace edm {
   class ConfigurationDescriptions;
   class ParameterSet;
@@ -22,6 +25,8 @@ public:
   
 private:
   bool fromDDD_;
+  std::string snapshotFile_;
+  std::vector<std::string> snapshotInputs_;
 };
 
 #endif
@@ -0,0 +1,21 @@
+import FWCore.ParameterSet.Config as cms
+
+# Read the tracker numbering geometry from a binary snapshot instead of building
+# it from the DDD at each job start. The snapshot is keyed on the contents of the XML
+# files of the ideal geometry source: it is (re)written by the first job that finds
+# it missing or built from different inputs.
+def customiseGeometricDetSnapshot(process, fileName = "trackerNumberingGeometry.snapshot"):
+    if not hasattr(process, "TrackerGeometricDetESModule"):
+        return process
+    if not process.TrackerGeometricDetESModule.fromDDD.value():
+        return process
+    xmlFiles = []
+    for name in ("XMLIdealGeometryESSource", "XMLFromDBSource"):
+        if hasattr(process, name) and hasattr(getattr(process, name), "geomXMLFiles"):
+            xmlFiles = getattr(process, name).geomXMLFiles.value()
+            break
+    if not xmlFiles:
+        return process
+    process.TrackerGeometricDetESModule.snapshotFile = cms.string(fileName)
+    process.TrackerGeometricDetESModule.snapshotInputs = cms.vstring(xmlFiles)
+    return process
@@ -0,0 +1,242 @@
+#include "Geometry/TrackerNumberingBuilder/interface/GeometricDetSnapshot.h"
+#include "Geometry/TrackerNumberingBuilder/interface/GeometricDet.h"
+#include "CondFormats/GeometryObjects/interface/PGeometricDet.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+  constexpr char magic[8] = {'C','M','S','G','D','E','T','S'};
+
+  struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    uint64_t key;
+    uint64_t nRecords;
+    uint64_t stringsSize;
+  };
+
+  // the numerical content of a PGeometricDet::Item, names as (offset,size) in the string table
+  struct Record {
+    double d[32];
+    int32_t i[18];
+    uint32_t name, nameSize, ns, nsSize;
+  };
+  static_assert(sizeof(Header)==40, "GeometricDetSnapshot header layout changed: bump formatVersion");
+  static_assert(sizeof(Record)==344, "GeometricDetSnapshot record layout changed: bump formatVersion");
+
+  // FNV-1a
+  constexpr uint64_t fnvOffset = 14695981039346656037ULL;
+  void hashBytes(uint64_t & h, char const * p, size_t n) {
+    for (size_t k=0; k<n; ++k) { h ^= static_cast<unsigned char>(p[k]); h *= 1099511628211ULL; }
+  }
+
+  // the version of the numbering code, then the contents of the inputs, each
+  // followed by its size so that moving bytes from one file to the next changes the key
+  uint64_t hashInputs(std::vector<std::string> const & inputFiles) {
+    uint64_t h = fnvOffset;
+    uint32_t const algorithmVersion = GeometricDetSnapshot::algorithmVersion;
+    hashBytes(h, reinterpret_cast<char const *>(&algorithmVersion), sizeof(algorithmVersion));
+    std::vector<char> buffer(1<<16);
+    for (auto const & name : inputFiles) {
+      std::ifstream in(name, std::ios::binary);
+      if (!in) throw cms::Exception("GeometricDetSnapshot") << "Cannot read geometry input " << name;
+      uint64_t size = 0;
+      while (in) {
+	in.read(buffer.data(), buffer.size());
+	hashBytes(h, buffer.data(), in.gcount());
+	size += in.gcount();
+      }
+      if (in.bad()) throw cms::Exception("GeometricDetSnapshot") << "Cannot read geometry input " << name;
+      hashBytes(h, reinterpret_cast<char const *>(&size), sizeof(size));
+    }
+    return h;
+  }
+
+  void toRecord(PGeometricDet::Item const & item, Record & r) {
+    double const d[32] = {item._x, item._y, item._z, item._phi, item._rho,
+			  item._a11, item._a12, item._a13, item._a21, item._a22, item._a23, item._a31, item._a32, item._a33,
+			  item._params0, item._params1, item._params2, item._params3, item._params4, item._params5,
+			  item._params6, item._params7, item._params8, item._params9, item._params10,
+			  item._radLength, item._xi, item._pixROCRows, item._pixROCCols, item._pixROCx, item._pixROCy,
+			  item._siliconAPVNum};
+    int32_t const i[18] = {item._level, item._shape, item._type, item._numnt,
+			   item._nt0, item._nt1, item._nt2, item._nt3, item._nt4, item._nt5,
+			   item._nt6, item._nt7, item._nt8, item._nt9, item._nt10,
+			   item._geographicalID, item._stereo, 0};
+    std::memcpy(r.d, d, sizeof(d));
+    std::memcpy(r.i, i, sizeof(i));
+  }
+
+  void fromRecord(Record const & r, char const * strings, PGeometricDet::Item & item) {
+    item._name.assign(strings+r.name, r.nameSize);
+    item._ns.assign(strings+r.ns, r.nsSize);
+    double const * d = r.d;
+    item._x = d[0]; item._y = d[1]; item._z = d[2]; item._phi = d[3]; item._rho = d[4];
+    item._a11 = d[5]; item._a12 = d[6]; item._a13 = d[7];
+    item._a21 = d[8]; item._a22 = d[9]; item._a23 = d[10];
+    item._a31 = d[11]; item._a32 = d[12]; item._a33 = d[13];
+    item._params0 = d[14]; item._params1 = d[15]; item._params2 = d[16]; item._params3 = d[17];
+    item._params4 = d[18]; item._params5 = d[19]; item._params6 = d[20]; item._params7 = d[21];
+    item._params8 = d[22]; item._params9 = d[23]; item._params10 = d[24];
+    item._radLength = d[25]; item._xi = d[26];
+    item._pixROCRows = d[27]; item._pixROCCols = d[28]; item._pixROCx = d[29]; item._pixROCy = d[30];
+    item._siliconAPVNum = d[31];
+    int32_t const * i = r.i;
+    item._level = i[0]; item._shape = i[1]; item._type = i[2]; item._numnt = i[3];
+    item._nt0 = i[4]; item._nt1 = i[5]; item._nt2 = i[6]; item._nt3 = i[7]; item._nt4 = i[8];
+    item._nt5 = i[9]; item._nt6 = i[10]; item._nt7 = i[11]; item._nt8 = i[12]; item._nt9 = i[13]; item._nt10 = i[14];
+    item._geographicalID = i[15];
+    item._stereo = i[16];
+  }
+
+  // same content as PGeometricDetBuilder::putOne
+  void putOne(GeometricDet const * gd, PGeometricDet & pgd, int lev) {
+    PGeometricDet::Item item;
+    const DDTranslation& tran = gd->translation();
+    const DDRotationMatrix& rot = gd->rotation();
+    DD3Vector x, y, z;
+    rot.GetComponents(x, y, z);
+    item._name  = gd->name().name();
+    item._ns    = gd->name().ns();
+    item._level = lev;
+    item._x     = tran.X();
+    item._y     = tran.Y();
+    item._z     = tran.Z();
+    item._phi   = gd->phi();
+    item._rho   = gd->rho();
+    item._a11 = x.X(); item._a12 = y.X(); item._a13 = z.X();
+    item._a21 = x.Y(); item._a22 = y.Y(); item._a23 = z.Y();
+    item._a31 = x.Z(); item._a32 = y.Z(); item._a33 = z.Z();
+    item._shape = static_cast<int>(gd->shape());
+    item._type  = gd->type();
+
+    double params[11] = {0,0,0,0,0,0,0,0,0,0,0};
+    size_t npar = 0;
+    if (gd->shape()==DDSolidShape::ddbox) npar = 3;
+    else if (gd->shape()==DDSolidShape::ddtrap) npar = 11;
+    for (size_t k=0; k<npar; ++k) params[k] = gd->params()[k];
+    item._params0 = params[0]; item._params1 = params[1]; item._params2 = params[2];
+    item._params3 = params[3]; item._params4 = params[4]; item._params5 = params[5];
+    item._params6 = params[6]; item._params7 = params[7]; item._params8 = params[8];
+    item._params9 = params[9]; item._params10 = params[10];
+
+    item._geographicalID = gd->geographicalID();
+    item._radLength      = gd->radLength();
+    item._xi             = gd->xi();
+    item._pixROCRows     = gd->pixROCRows();
+    item._pixROCCols     = gd->pixROCCols();
+    item._pixROCx        = gd->pixROCx();
+    item._pixROCy        = gd->pixROCy();
+    item._stereo         = gd->stereo();
+    item._siliconAPVNum  = gd->siliconAPVNum();
+
+    GeometricDet::nav_type const & nt = gd->navType();
+    item._numnt = nt.size();
+    int tempnt[11] = {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1};
+    for (size_t k=0; k<nt.size() && k<11; ++k) tempnt[k] = nt[k];
+    item._nt0 = tempnt[0]; item._nt1 = tempnt[1]; item._nt2 = tempnt[2]; item._nt3 = tempnt[3];
+    item._nt4 = tempnt[4]; item._nt5 = tempnt[5]; item._nt6 = tempnt[6]; item._nt7 = tempnt[7];
+    item._nt8 = tempnt[8]; item._nt9 = tempnt[9]; item._nt10 = tempnt[10];
+
+    pgd.pgeomdets_.push_back(item);
+
+    for (auto c : gd->components()) putOne(c, pgd, lev+1);
+  }
+
+}
+
+GeometricDetSnapshot::GeometricDetSnapshot(std::string const & fileName, std::vector<std::string> const & inputFiles)
+  : fileName_(fileName), key_(hashInputs(inputFiles))
+{}
+
+void
+GeometricDetSnapshot::fill(GeometricDet const * tracker, PGeometricDet & pgd) {
+  pgd.pgeomdets_.clear();
+  putOne(tracker, pgd, 0);
+}
+
+bool
+GeometricDetSnapshot::read(PGeometricDet & pgd) const {
+  int fd = ::open(fileName_.c_str(), O_RDONLY);
+  if (fd<0) return false;
+  struct stat st;
+  if (::fstat(fd, &st)!=0 || size_t(st.st_size)<sizeof(Header)) { ::close(fd); return false; }
+  size_t size = st.st_size;
+  void * map = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (map==MAP_FAILED) return false;
+
+  char const * base = static_cast<char const *>(map);
+  Header const * header = reinterpret_cast<Header const *>(base);
+  bool ok = std::memcmp(header->magic, magic, sizeof(magic))==0
+    && header->version==formatVersion
+    && header->recordSize==sizeof(Record)
+    && header->key==key_
+    && size==sizeof(Header) + header->nRecords*sizeof(Record) + header->stringsSize;
+
+  if (ok) {
+    Record const * records = reinterpret_cast<Record const *>(base+sizeof(Header));
+    char const * strings = base + sizeof(Header) + header->nRecords*sizeof(Record);
+    pgd.pgeomdets_.resize(header->nRecords);
+    for (uint64_t k=0; k<header->nRecords; ++k) {
+      if (uint64_t(records[k].name)+records[k].nameSize > header->stringsSize ||
+	  uint64_t(records[k].ns)+records[k].nsSize > header->stringsSize) { ok = false; break; }
+      fromRecord(records[k], strings, pgd.pgeomdets_[k]);
+    }
+    if (!ok) pgd.pgeomdets_.clear();
+  }
+
+  ::munmap(map, size);
+  return ok;
+}
+
+void
+GeometricDetSnapshot::write(PGeometricDet const & pgd) const {
+  std::vector<Record> records(pgd.pgeomdets_.size());
+  std::string strings;
+  for (size_t k=0; k<records.size(); ++k) {
+    auto const & item = pgd.pgeomdets_[k];
+    Record & r = records[k];
+    std::memset(&r, 0, sizeof(Record));
+    toRecord(item, r);
+    r.name = strings.size(); r.nameSize = item._name.size(); strings += item._name;
+    r.ns = strings.size(); r.nsSize = item._ns.size(); strings += item._ns;
+  }
+
+  Header header;
+  std::memset(&header, 0, sizeof(Header));
+  std::memcpy(header.magic, magic, sizeof(magic));
+  header.version = formatVersion;
+  header.recordSize = sizeof(Record);
+  header.key = key_;
+  header.nRecords = records.size();
+  header.stringsSize = strings.size();
+
+  // concurrent jobs may write the same snapshot: never expose a partial file
+  std::string tmpName = fileName_ + ".tmp" + std::to_string(::getpid());
+  {
+    std::ofstream out(tmpName, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<char const *>(&header), sizeof(Header));
+    out.write(reinterpret_cast<char const *>(records.data()), records.size()*sizeof(Record));
+    out.write(strings.data(), strings.size());
+    if (!out) {
+      std::remove(tmpName.c_str());
+      throw cms::Exception("GeometricDetSnapshot") << "Cannot write geometry snapshot " << tmpName;
+    }
+  }
+  if (std::rename(tmpName.c_str(), fileName_.c_str())!=0) {
+    std::remove(tmpName.c_str());
+    throw cms::Exception("GeometricDetSnapshot") << "Cannot rename geometry snapshot to " << fileName_;
+  }
+}
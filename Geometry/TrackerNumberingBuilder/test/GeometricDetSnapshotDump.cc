@@ -0,0 +1,66 @@
+// Dump of the tracker numbering geometry in the flat PGeometricDet layout
+// (the content of a GeometricDetSnapshot), one line per GeometricDet with
+// full precision, to compare the DDD build with the snapshot one.
+
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/one/EDAnalyzer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/EventSetup.h"
+#include "FWCore/Framework/interface/ESHandle.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include "CondFormats/GeometryObjects/interface/PGeometricDet.h"
+#include "Geometry/Records/interface/IdealGeometryRecord.h"
+#include "Geometry/TrackerNumberingBuilder/interface/GeometricDet.h"
+#include "Geometry/TrackerNumberingBuilder/interface/GeometricDetSnapshot.h"
+
+#include <fstream>
+#include <iomanip>
+#include <string>
+
+class GeometricDetSnapshotDump : public edm::one::EDAnalyzer<> {
+public:
+  explicit GeometricDetSnapshotDump( const edm::ParameterSet& );
+
+  void analyze( edm::Event const&, edm::EventSetup const& ) override;
+
+private:
+  std::string fileName_;
+};
+
+GeometricDetSnapshotDump::GeometricDetSnapshotDump( const edm::ParameterSet& iConfig )
+  : fileName_( iConfig.getUntrackedParameter<std::string>( "fileName" ))
+{}
+
+void
+GeometricDetSnapshotDump::analyze( const edm::Event&, const edm::EventSetup& iSetup )
+{
+  edm::ESHandle<GeometricDet> pDD;
+  iSetup.get<IdealGeometryRecord>().get( pDD );
+
+  PGeometricDet pgd;
+  GeometricDetSnapshot::fill( pDD.product(), pgd );
+
+  std::ofstream out( fileName_ );
+  if( !out )
+    throw cms::Exception( "GeometricDetSnapshotDump" ) << "Cannot write " << fileName_;
+  out << std::setprecision( 17 );
+  for( auto const & it : pgd.pgeomdets_ )
+  {
+    out << it._level << ' ' << it._ns << ':' << it._name << ' ' << it._geographicalID << ' ' << it._type << ' ' << it._shape
+	<< " pos " << it._x << ' ' << it._y << ' ' << it._z << ' ' << it._phi << ' ' << it._rho
+	<< " rot " << it._a11 << ' ' << it._a12 << ' ' << it._a13 << ' ' << it._a21 << ' ' << it._a22 << ' ' << it._a23
+	<< ' ' << it._a31 << ' ' << it._a32 << ' ' << it._a33
+	<< " par " << it._params0 << ' ' << it._params1 << ' ' << it._params2 << ' ' << it._params3 << ' ' << it._params4
+	<< ' ' << it._params5 << ' ' << it._params6 << ' ' << it._params7 << ' ' << it._params8 << ' ' << it._params9 << ' ' << it._params10
+	<< " mat " << it._radLength << ' ' << it._xi
+	<< " roc " << it._pixROCRows << ' ' << it._pixROCCols << ' ' << it._pixROCx << ' ' << it._pixROCy << ' ' << it._siliconAPVNum
+	<< " stereo " << it._stereo
+	<< " nav " << it._numnt << ' ' << it._nt0 << ' ' << it._nt1 << ' ' << it._nt2 << ' ' << it._nt3 << ' ' << it._nt4 << ' ' << it._nt5
+	<< ' ' << it._nt6 << ' ' << it._nt7 << ' ' << it._nt8 << ' ' << it._nt9 << ' ' << it._nt10 << '\n';
+  }
+}
+
+DEFINE_FWK_MODULE( GeometricDetSnapshotDump );
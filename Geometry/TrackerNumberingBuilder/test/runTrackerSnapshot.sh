@@ -0,0 +1,29 @@
+#!/bin/bash
+
+# The tracker numbering geometry built from the DDD, written to a snapshot and
+# read back from it must be the same; a snapshot of other inputs must be rebuilt.
+
+function die { echo Failure $1: status $2 ; exit $2 ; }
+
+pushd ${LOCAL_TMP_DIR}
+
+  rm -f trackerSnapshot.snapshot
+  cmsRun ${LOCAL_TEST_DIR}/trackerSnapshot_cfg.py mode=ddd dumpFile=trackerSnapshot_ddd.txt || die "cmsRun trackerSnapshot_cfg.py mode=ddd" $?
+
+  cmsRun ${LOCAL_TEST_DIR}/trackerSnapshot_cfg.py mode=snapshot snapshotFile=trackerSnapshot.snapshot dumpFile=trackerSnapshot_write.txt || die "cmsRun trackerSnapshot_cfg.py (write)" $?
+  [ -s trackerSnapshot.snapshot ] || die "snapshot not written" 1
+  diff trackerSnapshot_ddd.txt trackerSnapshot_write.txt || die "comparing the DDD build and the snapshot writing job" $?
+
+  # a rebuilt snapshot is renamed into place, so the inode tells whether it was used
+  inode=$(stat -c %i trackerSnapshot.snapshot)
+  cmsRun ${LOCAL_TEST_DIR}/trackerSnapshot_cfg.py mode=snapshot snapshotFile=trackerSnapshot.snapshot dumpFile=trackerSnapshot_read.txt || die "cmsRun trackerSnapshot_cfg.py (read)" $?
+  [ "$(stat -c %i trackerSnapshot.snapshot)" = "$inode" ] || die "snapshot rebuilt instead of read" 1
+  diff trackerSnapshot_ddd.txt trackerSnapshot_read.txt || die "comparing the DDD build and the snapshot read" $?
+
+  # a snapshot written to a directory that does not exist only gives a warning
+  cmsRun ${LOCAL_TEST_DIR}/trackerSnapshot_cfg.py mode=snapshot snapshotFile=noSuchDirectory/trackerSnapshot.snapshot dumpFile=trackerSnapshot_nowrite.txt || die "cmsRun trackerSnapshot_cfg.py (not writable)" $?
+  diff trackerSnapshot_ddd.txt trackerSnapshot_nowrite.txt || die "comparing the DDD build and the job without snapshot" $?
+
+popd
+
+exit 0
@@ -0,0 +1,102 @@
+#include "Geometry/TrackerNumberingBuilder/interface/GeometricDetSnapshot.h"
+#include "CondFormats/GeometryObjects/interface/PGeometricDet.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+  PGeometricDet makePGeometricDet() {
+    PGeometricDet pgd;
+    for (int k=0; k<100; ++k) {
+      PGeometricDet::Item item;
+      item._name = "Module" + std::to_string(k);
+      item._ns = k%2 ? "tobrod" : "tibstring";
+      item._x = 0.5*k; item._y = -0.25*k; item._z = 1000.+k; item._phi = 0.01*k; item._rho = 20.+k;
+      item._a11 = 1; item._a12 = 0; item._a13 = 0; item._a21 = 0; item._a22 = 1; item._a23 = 0;
+      item._a31 = 0; item._a32 = 0; item._a33 = 1;
+      item._params0 = 3.2; item._params1 = 6.4; item._params2 = 0.015; item._params3 = 0; item._params4 = 0;
+      item._params5 = 0; item._params6 = 0; item._params7 = 0; item._params8 = 0; item._params9 = 0; item._params10 = k;
+      item._radLength = 0.0123; item._xi = 0.004; item._pixROCRows = 80; item._pixROCCols = 52;
+      item._pixROCx = 2; item._pixROCy = 8; item._siliconAPVNum = 6;
+      item._level = k==0 ? 0 : 1 + k%5; item._shape = 1; item._type = 16;
+      item._numnt = 3; item._nt0 = 0; item._nt1 = k; item._nt2 = 2*k; item._nt3 = -1; item._nt4 = -1;
+      item._nt5 = -1; item._nt6 = -1; item._nt7 = -1; item._nt8 = -1; item._nt9 = -1; item._nt10 = -1;
+      item._geographicalID = 0x12000000 + k; item._stereo = k%3==0;
+      pgd.pgeomdets_.push_back(item);
+    }
+    return pgd;
+  }
+
+  bool same(PGeometricDet::Item const & a, PGeometricDet::Item const & b) {
+    return a._name==b._name && a._ns==b._ns
+      && a._x==b._x && a._y==b._y && a._z==b._z && a._phi==b._phi && a._rho==b._rho
+      && a._a11==b._a11 && a._a22==b._a22 && a._a33==b._a33
+      && a._params0==b._params0 && a._params2==b._params2 && a._params10==b._params10
+      && a._radLength==b._radLength && a._xi==b._xi && a._pixROCRows==b._pixROCRows && a._siliconAPVNum==b._siliconAPVNum
+      && a._level==b._level && a._shape==b._shape && a._type==b._type
+      && a._numnt==b._numnt && a._nt1==b._nt1 && a._nt2==b._nt2 && a._nt10==b._nt10
+      && a._geographicalID==b._geographicalID && a._stereo==b._stereo;
+  }
+
+  void writeFile(std::string const & name, std::string const & content) {
+    std::ofstream out(name);
+    out << content;
+  }
+
+}
+
+int main() {
+  std::string fileName = "testGeometricDetSnapshot.bin";
+  std::remove(fileName.c_str());
+
+  PGeometricDet ref = makePGeometricDet();
+
+  std::vector<std::string> inputs = {"testGeometricDetSnapshot_materials.xml", "testGeometricDetSnapshot_trackerParameters.xml"};
+  writeFile(inputs[0], "<Material name=\"Silicon\" density=\"2.33*g/cm3\"/>\n");
+  writeFile(inputs[1], "<Vector name=\"detIdShifts\" type=\"numeric\" nEntries=\"12\"> 2, 0, 0, 0, 0, 0, 2, 0, 0, 0, 0, 0 </Vector>\n");
+
+  GeometricDetSnapshot snapshot(fileName, inputs);
+  PGeometricDet pgd;
+  assert(!snapshot.read(pgd));  // no file yet
+
+  snapshot.write(ref);
+  assert(snapshot.read(pgd));
+  assert(pgd.pgeomdets_.size()==ref.pgeomdets_.size());
+  for (size_t k=0; k<ref.pgeomdets_.size(); ++k) assert(same(pgd.pgeomdets_[k], ref.pgeomdets_[k]));
+
+  // the same inputs under other names give the same key
+  std::vector<std::string> renamed = {"testGeometricDetSnapshot_copy0.xml", "testGeometricDetSnapshot_copy1.xml"};
+  std::rename(inputs[0].c_str(), renamed[0].c_str());
+  std::rename(inputs[1].c_str(), renamed[1].c_str());
+  assert(GeometricDetSnapshot(fileName, renamed).key()==snapshot.key());
+  std::rename(renamed[0].c_str(), inputs[0].c_str());
+  std::rename(renamed[1].c_str(), inputs[1].c_str());
+
+  // a snapshot built from other inputs is ignored: here other detIdShifts
+  writeFile(inputs[1], "<Vector name=\"detIdShifts\" type=\"numeric\" nEntries=\"12\"> 2, 0, 0, 0, 0, 0, 2, 0, 0, 0, 1, 0 </Vector>\n");
+  GeometricDetSnapshot other(fileName, inputs);
+  PGeometricDet pgdOther;
+  assert(other.key()!=snapshot.key());
+  assert(!other.read(pgdOther));
+  assert(pgdOther.pgeomdets_.empty());
+
+  // as well as one built from the inputs in another order
+  assert(GeometricDetSnapshot(fileName, {inputs[1], inputs[0]}).key()!=other.key());
+
+  // a missing input is an error
+  bool thrown = false;
+  try { GeometricDetSnapshot missing(fileName, {"testGeometricDetSnapshot_missing.xml"}); }
+  catch (cms::Exception const &) { thrown = true; }
+  assert(thrown);
+
+  for (auto const & name : inputs) std::remove(name.c_str());
+  std::remove(fileName.c_str());
+  std::cout << "GeometricDetSnapshot round trip OK" << std::endl;
+  return 0;
+}
@@ -0,0 +1,39 @@
+# Validation of the tracker numbering geometry read from a binary snapshot
+# (see runTrackerSnapshot.sh): the geometry is built from the XML with
+#   mode=ddd       no snapshot at all
+#   mode=snapshot  through the snapshot, which is written if missing or stale
+# and dumped to dumpFile in the PGeometricDet layout.
+import FWCore.ParameterSet.Config as cms
+import FWCore.ParameterSet.VarParsing as VarParsing
+
+options = VarParsing.VarParsing()
+options.register("mode", "snapshot", VarParsing.VarParsing.multiplicity.singleton, VarParsing.VarParsing.varType.string,
+                 "ddd or snapshot")
+options.register("snapshotFile", "trackerNumberingGeometry.snapshot", VarParsing.VarParsing.multiplicity.singleton, VarParsing.VarParsing.varType.string,
+                 "snapshot file")
+options.register("dumpFile", "trackerNumberingGeometry.txt", VarParsing.VarParsing.multiplicity.singleton, VarParsing.VarParsing.varType.string,
+                 "dump of the geometry")
+options.parseArguments()
+
+process = cms.Process("GeometryTest")
+process.load("FWCore.MessageLogger.MessageLogger_cfi")
+
+process.load("Geometry.TrackerSimData.trackerSimGeometryXML_cfi")
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(1)
+)
+process.source = cms.Source("EmptySource")
+
+process.TrackerGeometricDetESModule = cms.ESProducer("TrackerGeometricDetESModule",
+                                                     fromDDD = cms.bool(True),
+                                                     snapshotFile = cms.string(""),
+                                                     snapshotInputs = cms.vstring())
+if options.mode == "snapshot":
+    from Geometry.TrackerNumberingBuilder.customiseGeometricDetSnapshot import customiseGeometricDetSnapshot
+    process = customiseGeometricDetSnapshot(process, options.snapshotFile)
+
+process.dump = cms.EDAnalyzer("GeometricDetSnapshotDump",
+                              fileName = cms.untracked.string(options.dumpFile))
+
+process.p1 = cms.Path(process.dump)
@@ -2,6 +2,7 @@
 #define HLTrigger_HLTfilters_TriggerExpressionConstant_h
 
 #include "HLTrigger/HLTcore/interface/TriggerExpressionEvaluator.h"
+#include "HLTrigger/HLTcore/interface/TriggerExpressionProgram.h"
 
 namespace triggerExpression {
 
@@ -24,6 +25,10 @@ public:
     out << (m_value ? "TRUE" : "FALSE");
   }
 
+  void compile(Program & program) override {
+    program.addConstant(m_value);
+  }
+
 private:
   bool m_value;
 };
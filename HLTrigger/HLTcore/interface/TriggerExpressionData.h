@@ -1,6 +1,9 @@
 #ifndef HLTrigger_HLTfilters_TriggerExpressionData_h
 #define HLTrigger_HLTfilters_TriggerExpressionData_h
 
+#include <cstdint>
+#include <vector>
+
 #include "FWCore/Framework/interface/ConsumesCollector.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
@@ -40,6 +43,8 @@ public:
     m_hltMenu(nullptr),
     m_hltCacheID(),
     m_hltUpdated(false),
+    m_hltAcceptBits(),
+    m_hltAcceptBitsValid(false),
     // event values
     m_eventNumber()
   { }
@@ -63,6 +68,8 @@ public:
     m_hltMenu(nullptr),
     m_hltCacheID(),
     m_hltUpdated(false),
+    m_hltAcceptBits(),
+    m_hltAcceptBitsValid(false),
     // event values
     m_eventNumber()
       {
@@ -94,6 +101,8 @@ public:
     m_hltMenu(nullptr),
     m_hltCacheID(),
     m_hltUpdated(false),
+    m_hltAcceptBits(),
+    m_hltAcceptBitsValid(false),
     // event values
     m_eventNumber()
       {
@@ -136,6 +145,9 @@ public:
     return * m_hltResults;
   }
 
+  // the HLT accept decisions, 64 paths per word; computed on first use in each event
+  const std::vector<uint64_t> & hltAcceptBits() const;
+
   const edm::TriggerNames & hltMenu() const {
     return * m_hltMenu;
   }
@@ -191,6 +203,8 @@ public:
   const edm::TriggerNames         * m_hltMenu;
   edm::ParameterSetID               m_hltCacheID;
   bool                              m_hltUpdated;
+  mutable std::vector<uint64_t>     m_hltAcceptBits;
+  mutable bool                      m_hltAcceptBitsValid;
 
   // event values
   edm::EventNumber_t                m_eventNumber;
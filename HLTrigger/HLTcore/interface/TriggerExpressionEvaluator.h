@@ -6,6 +6,7 @@
 namespace triggerExpression {
 
 class Data;
+class Program;
 
 class Evaluator {
 public:
@@ -20,6 +21,9 @@ public:
   // pure virtual, need a concrete implementation
   virtual void dump(std::ostream & out) const = 0;
 
+  // virtual function, add this as an opaque step of the program unless overridden
+  virtual void compile(Program & program);
+
   // virtual destructor
   virtual ~Evaluator() { }
 };
@@ -3,6 +3,7 @@
 
 #include <boost/scoped_ptr.hpp>
 #include "HLTrigger/HLTcore/interface/TriggerExpressionEvaluator.h"
+#include "HLTrigger/HLTcore/interface/TriggerExpressionProgram.h"
 
 namespace triggerExpression {
 
@@ -58,6 +59,11 @@ public:
     out << "NOT ";
     m_arg->dump(out);
   }
+
+  void compile(Program & program) override {
+    m_arg->compile(program);
+    program.addOperator(Program::Op::Not);
+  }
 };
 
 class OperatorAnd : public BinaryOperator {
@@ -78,6 +84,12 @@ public:
     out << " AND ";
     m_arg2->dump(out);
   }
+
+  void compile(Program & program) override {
+    m_arg1->compile(program);
+    m_arg2->compile(program);
+    program.addOperator(Program::Op::And);
+  }
 };
 
 class OperatorOr : public BinaryOperator {
@@ -98,6 +110,12 @@ public:
     out << " OR ";
     m_arg2->dump(out);
   }
+
+  void compile(Program & program) override {
+    m_arg1->compile(program);
+    m_arg2->compile(program);
+    program.addOperator(Program::Op::Or);
+  }
 };
 
 class OperatorXor : public BinaryOperator {
@@ -118,6 +136,12 @@ public:
     out << " XOR ";
     m_arg2->dump(out);
   }
+
+  void compile(Program & program) override {
+    m_arg1->compile(program);
+    m_arg2->compile(program);
+    program.addOperator(Program::Op::Xor);
+  }
 };
 
 } // namespace triggerExpression
@@ -21,6 +21,13 @@ public:
 
   void dump(std::ostream & out) const override;
 
+  void compile(Program & program) override;
+
+  // the HLT paths matching the pattern, with their indices, after init()
+  const std::vector<std::pair<std::string, unsigned int> > & triggers() const {
+    return m_triggers;
+  }
+
 private:
   std::string m_pattern;
   std::vector<std::pair<std::string, unsigned int> > m_triggers;
@@ -22,6 +22,8 @@ public:
     out << "(" << (*m_arg) << " / " << m_prescale << ")";
   }
 
+  void compile(Program & program) override;
+
 private:
   unsigned int m_prescale;
   mutable unsigned int m_counter;
@@ -0,0 +1,80 @@
+#ifndef HLTrigger_HLTfilters_TriggerExpressionProgram_h
+#define HLTrigger_HLTfilters_TriggerExpressionProgram_h
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "DataFormats/Provenance/interface/ParameterSetID.h"
+#include "HLTrigger/HLTcore/interface/TriggerExpressionEvaluator.h"
+
+namespace triggerExpression {
+
+class PathReader;
+
+// An expression tree flattened into a postfix program.
+// The HLT paths are evaluated as bit masks over the HLT accept bits of the event,
+// and the expansion of their patterns is cached for each HLT menu seen in the job;
+// any other evaluator (e.g. the L1 readers) is called as an opaque step.
+class Program : public Evaluator {
+public:
+  enum class Op : unsigned char { Constant, Paths, Evaluate, Not, And, Or, Xor, Prescale };
+
+  struct Instruction {
+    Op           op;
+    unsigned int arg;
+  };
+
+  // takes ownership of the expression tree
+  explicit Program(Evaluator * expression);
+
+  bool operator()(const Data & data) const override;
+
+  void init(const Data & data) override;
+
+  void dump(std::ostream & out) const override;
+
+  // used by Evaluator::compile() to emit the program
+  void addConstant(bool value);
+  void addPaths(PathReader * reader);
+  void addEvaluator(Evaluator * evaluator);
+  void addOperator(Op op);
+  void addPrescaler(unsigned int prescale);
+
+private:
+  typedef std::vector<std::pair<std::string, unsigned int> > Triggers;
+  typedef std::vector<std::pair<unsigned int, uint64_t> >    Masks;     // (word, mask) pairs
+
+  // the expanded HLT paths of each reader, for one HLT menu
+  struct Menu {
+    std::vector<Triggers> triggers;
+    std::vector<Masks>    masks;
+  };
+
+  struct Prescale {
+    unsigned int         prescale;
+    mutable unsigned int counter;
+  };
+
+  void push(int depth);
+
+  std::unique_ptr<Evaluator>            m_expression;
+  std::vector<Instruction>              m_program;
+  std::vector<PathReader *>             m_paths;
+  std::vector<Evaluator *>              m_evaluators;
+  std::vector<Prescale>                 m_prescales;
+  std::map<edm::ParameterSetID, Menu>   m_menus;
+  const Menu *                          m_menu;
+  int                                   m_depth;
+  int                                   m_maxDepth;
+  mutable std::vector<char>             m_stack;
+};
+
+// compile a parsed expression; returns nullptr for a null expression
+Program * compile(Evaluator * expression);
+
+} // namespace triggerExpression
+
+#endif // HLTrigger_HLTfilters_TriggerExpressionProgram_h
@@ -96,6 +96,10 @@ class TriggerSummaryProducerAOD : public edm::stream::EDProducer<edm::GlobalCach
     return std::unique_ptr<GlobalInputTags> (new GlobalInputTags());
   };
 
+  void collectProductIDs(const trigger::TriggerFilterObjectWithRefs& );
+  template <typename C>
+  void collectProductIDs(const std::vector<edm::Ref<C> >& );
+
   template <typename C>
   void fillTriggerObjectCollections(const edm::Event&, edm::GetterOfProducts<C>& );
 
@@ -158,8 +162,12 @@ class TriggerSummaryProducerAOD : public edm::stream::EDProducer<edm::GlobalCach
   /// trigger object collection
   trigger::TriggerObjectCollection toc_;
   std::vector<std::string> tags_;
-  /// global map for indices into toc_: offset per input L3 collection
-  std::map<edm::ProductID,unsigned int> offset_;
+  /// flat index of the L3 collections referenced by the L3 filter objects,
+  /// sorted by ProductID, and the offset of each into toc_ (invalid until packed)
+  std::vector<edm::ProductID> pids_;
+  std::vector<unsigned int> offsets_;
+  /// index of pid in pids_, or pids_.size() if not referenced
+  unsigned int indexOf(const edm::ProductID& pid) const;
 
   /// keys
   trigger::Keys keys_;
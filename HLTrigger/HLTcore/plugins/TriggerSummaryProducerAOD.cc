@@ -9,6 +9,7 @@
 
 #include <ostream>
 #include <algorithm>
+#include <limits>
 #include <memory>
 #include <typeinfo>
 
@@ -56,6 +57,8 @@
 #include "boost/algorithm/string.hpp"
 
 namespace {
+  constexpr unsigned int invalidOffset = std::numeric_limits<unsigned int>::max();
+
   std::vector<std::regex> convertToRegex(std::vector<std::string> const& iPatterns) {
     std::vector<std::regex> result;
 
@@ -84,7 +87,8 @@ TriggerSummaryProducerAOD::TriggerSummaryProducerAOD(const edm::ParameterSet& ps
   collectionTagsStream_(pn_!="*"),
   toc_(),
   tags_(),
-  offset_(),
+  pids_(),
+  offsets_(),
   keys_(),
   ids_(),
   maskFilters_()
@@ -251,6 +255,7 @@ TriggerSummaryProducerAOD::produce(edm::Event& iEvent, const edm::EventSetup& iS
    maskFilters_.resize(nfob);
    filterTagsEvent_.clear();
    collectionTagsEvent_.clear();
+   pids_.clear();
    unsigned int nf(0);
    for (unsigned int ifob=0; ifob!=nfob; ++ifob) {
      maskFilters_[ifob]=false;
@@ -268,8 +273,14 @@ TriggerSummaryProducerAOD::produce(edm::Event& iEvent, const edm::EventSetup& iS
 	 tokenizeTag(collectionTags_[icol],tagLabel,tagInstance,tagProcess);
 	 collectionTagsEvent_.insert(InputTag(tagLabel,tagInstance,pn_));
        }
+       /// gather the collections referenced by this filter
+       collectProductIDs(*fobs[ifob]);
      }
    }
+   /// flat index of all referenced collections, filled with their offsets below
+   sort(pids_.begin(),pids_.end());
+   pids_.erase(unique(pids_.begin(),pids_.end()),pids_.end());
+   offsets_.assign(pids_.size(),invalidOffset);
    /// check uniqueness count
    if (filterTagsEvent_.size()!=nf) {
      LogError("TriggerSummaryProducerAOD")
@@ -310,7 +321,6 @@ TriggerSummaryProducerAOD::produce(edm::Event& iEvent, const edm::EventSetup& iS
    toc_.clear();
    tags_.clear();
    keys_.clear();
-   offset_.clear();
    fillTriggerObjectCollections<          RecoEcalCandidateCollection>(iEvent, getRecoEcalCandidateCollection_);
    fillTriggerObjectCollections<                   ElectronCollection>(iEvent, getElectronCollection_);
    fillTriggerObjectCollections<       RecoChargedCandidateCollection>(iEvent, getRecoChargedCandidateCollection_);
@@ -388,6 +398,58 @@ TriggerSummaryProducerAOD::produce(edm::Event& iEvent, const edm::EventSetup& iS
 
 }
 
+void TriggerSummaryProducerAOD::collectProductIDs(const trigger::TriggerFilterObjectWithRefs& fob) {
+
+  /// this routine gathers the ProductIDs of the collections referenced
+  /// by a filter object, in the same order as they are packed up below
+
+  collectProductIDs(fob.photonRefs());
+  collectProductIDs(fob.electronRefs());
+  collectProductIDs(fob.muonRefs());
+  collectProductIDs(fob.jetRefs());
+  collectProductIDs(fob.compositeRefs());
+  collectProductIDs(fob.basemetRefs());
+  collectProductIDs(fob.calometRefs());
+  collectProductIDs(fob.pixtrackRefs());
+  collectProductIDs(fob.l1emRefs());
+  collectProductIDs(fob.l1muonRefs());
+  collectProductIDs(fob.l1jetRefs());
+  collectProductIDs(fob.l1etmissRefs());
+  collectProductIDs(fob.l1hfringsRefs());
+  collectProductIDs(fob.l1tmuonRefs());
+  collectProductIDs(fob.l1tegammaRefs());
+  collectProductIDs(fob.l1tjetRefs());
+  collectProductIDs(fob.l1ttauRefs());
+  collectProductIDs(fob.l1tetsumRefs());
+  collectProductIDs(fob.pfjetRefs());
+  collectProductIDs(fob.pftauRefs());
+  collectProductIDs(fob.pfmetRefs());
+
+  return;
+}
+
+template <typename C>
+void TriggerSummaryProducerAOD::collectProductIDs(const std::vector<edm::Ref<C> >& refs) {
+
+  for (auto const& ref : refs) {
+    const edm::ProductID pid(ref.id());
+    if (pid.isValid() && (pids_.empty() || !(pids_.back()==pid))) {
+      pids_.push_back(pid);
+    }
+  }
+
+  return;
+}
+
+unsigned int TriggerSummaryProducerAOD::indexOf(const edm::ProductID& pid) const {
+
+  const auto i(std::lower_bound(pids_.begin(),pids_.end(),pid));
+  if ((i==pids_.end()) || !(*i==pid)) {
+    return pids_.size();
+  }
+  return i-pids_.begin();
+}
+
 template <typename C>
 void TriggerSummaryProducerAOD::fillTriggerObjectCollections(const edm::Event& iEvent, edm::GetterOfProducts<C>& getter) {
 
@@ -415,10 +477,13 @@ void TriggerSummaryProducerAOD::fillTriggerObjectCollections(const edm::Event& i
 
     if (collectionTagsEvent_.find(collectionTag)!=collectionTagsEvent_.end()) {
       const ProductID pid(collections[ic].provenance()->productID());
-      if (offset_.find(pid)!=offset_.end()) {
-	LogError("TriggerSummaryProducerAOD") << "Duplicate pid: " << pid;
+      const unsigned int index(indexOf(pid));
+      if (index!=pids_.size()) {
+	if (offsets_[index]!=invalidOffset) {
+	  LogError("TriggerSummaryProducerAOD") << "Duplicate pid: " << pid;
+	}
+	offsets_[index]=toc_.size();
       }
-      offset_[pid]=toc_.size();
       const unsigned int n(collections[ic]->size());
       for (unsigned int i=0; i!=n; ++i) {
 	fillTriggerObject( (*collections[ic])[i] );
@@ -532,9 +597,18 @@ void TriggerSummaryProducerAOD::fillFilterObjectMembers(const edm::Event& iEvent
 					  << ids.size() << " " << refs.size();
   }
 
+  /// consecutive refs usually point to the same collection
+  ProductID lastPid;
+  unsigned int offset(invalidOffset);
+
   const unsigned int n(min(ids.size(),refs.size()));
   for (unsigned int i=0; i!=n; ++i) {
     const ProductID pid(refs[i].id());
+    if (pid.isValid() && !(pid==lastPid)) {
+      const unsigned int index(indexOf(pid));
+      offset = (index==pids_.size()) ? invalidOffset : offsets_[index];
+      lastPid = pid;
+    }
     if (!(pid.isValid())) {
       std::ostringstream ost;
       ost
@@ -550,7 +624,7 @@ void TriggerSummaryProducerAOD::fillFilterObjectMembers(const edm::Event& iEvent
       } else {
 	LogError("TriggerSummaryProducerAOD") << ost.str();
       }
-    } else if (offset_.find(pid)==offset_.end()) {
+    } else if (offset==invalidOffset) {
       const string&    label(iEvent.getProvenance(pid).moduleLabel());
       const string& instance(iEvent.getProvenance(pid).productInstanceName());
       const string&  process(iEvent.getProvenance(pid).processName());
@@ -569,7 +643,7 @@ void TriggerSummaryProducerAOD::fillFilterObjectMembers(const edm::Event& iEvent
 	LogError("TriggerSummaryProducerAOD") << ost.str();
       }
     } else {
-      fillFilterObjectMember(offset_[pid],ids[i],refs[i]);
+      fillFilterObjectMember(offset,ids[i],refs[i]);
     }
   }
   return;
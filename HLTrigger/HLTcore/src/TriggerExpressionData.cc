@@ -48,6 +48,7 @@ bool Data::setEvent(const edm::Event & event, const edm::EventSetup & setup) {
   if (hasHLT()) {
     // cache the HLT TriggerResults
     m_hltResults = & edm::get(event, m_hltResultsToken);
+    m_hltAcceptBitsValid = false;
     if (not m_hltResults)
       return false;
 
@@ -64,4 +65,16 @@ bool Data::setEvent(const edm::Event & event, const edm::EventSetup & setup) {
   return true;
 }
 
+const std::vector<uint64_t> & Data::hltAcceptBits() const {
+  if (not m_hltAcceptBitsValid) {
+    unsigned int size = m_hltResults->size();
+    m_hltAcceptBits.assign((size + 63) / 64, 0);
+    for (unsigned int i = 0; i < size; ++i)
+      if (m_hltResults->accept(i))
+        m_hltAcceptBits[i / 64] |= (uint64_t) 1 << (i % 64);
+    m_hltAcceptBitsValid = true;
+  }
+  return m_hltAcceptBits;
+}
+
 } // namespace triggerExpression
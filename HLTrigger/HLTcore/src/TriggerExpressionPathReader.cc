@@ -8,6 +8,7 @@
 #include "DataFormats/Common/interface/TriggerResults.h"
 #include "HLTrigger/HLTcore/interface/TriggerExpressionPathReader.h"
 #include "HLTrigger/HLTcore/interface/TriggerExpressionData.h"
+#include "HLTrigger/HLTcore/interface/TriggerExpressionProgram.h"
 
 namespace triggerExpression {
 
@@ -37,6 +38,10 @@ void PathReader::dump(std::ostream & out) const {
   }
 }
 
+void PathReader::compile(Program & program) {
+  program.addPaths(this);
+}
+
 // (re)initialize the module
 void PathReader::init(const Data & data) {
   // clear the previous configuration
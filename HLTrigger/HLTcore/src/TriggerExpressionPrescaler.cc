@@ -1,4 +1,5 @@
 #include "HLTrigger/HLTcore/interface/TriggerExpressionPrescaler.h"
+#include "HLTrigger/HLTcore/interface/TriggerExpressionProgram.h"
 
 namespace triggerExpression {
 
@@ -28,4 +29,15 @@ void Prescaler::init(const Data & data) {
   m_counter = data.eventNumber();
 }
 
+void Prescaler::compile(Program & program) {
+  // a prescale factor of 0 never runs the dependent modules
+  if (m_prescale == 0) {
+    program.addConstant(false);
+    return;
+  }
+
+  m_arg->compile(program);
+  program.addPrescaler(m_prescale);
+}
+
 } // namespace triggerExpression
@@ -0,0 +1,227 @@
+#include <algorithm>
+#include <sstream>
+
+#include "FWCore/Common/interface/TriggerNames.h"
+#include "HLTrigger/HLTcore/interface/TriggerExpressionData.h"
+#include "HLTrigger/HLTcore/interface/TriggerExpressionPathReader.h"
+#include "HLTrigger/HLTcore/interface/TriggerExpressionProgram.h"
+
+namespace triggerExpression {
+
+// any evaluator that the program does not know about is called as it is
+void Evaluator::compile(Program & program) {
+  program.addEvaluator(this);
+}
+
+Program::Program(Evaluator * expression) :
+  m_expression(expression),
+  m_program(),
+  m_paths(),
+  m_evaluators(),
+  m_prescales(),
+  m_menus(),
+  m_menu(nullptr),
+  m_depth(0),
+  m_maxDepth(0),
+  m_stack()
+{
+  m_expression->compile(*this);
+  m_stack.resize(m_maxDepth);
+}
+
+void Program::push(int depth) {
+  m_depth += depth;
+  m_maxDepth = std::max(m_maxDepth, m_depth);
+}
+
+void Program::addConstant(bool value) {
+  m_program.push_back(Instruction{ Op::Constant, value });
+  push(1);
+}
+
+void Program::addPaths(PathReader * reader) {
+  m_program.push_back(Instruction{ Op::Paths, (unsigned int) m_paths.size() });
+  m_paths.push_back(reader);
+  push(1);
+}
+
+void Program::addEvaluator(Evaluator * evaluator) {
+  m_program.push_back(Instruction{ Op::Evaluate, (unsigned int) m_evaluators.size() });
+  m_evaluators.push_back(evaluator);
+  push(1);
+}
+
+void Program::addOperator(Op op) {
+  m_program.push_back(Instruction{ op, 0 });
+  push(op == Op::Not ? 0 : -1);
+}
+
+void Program::addPrescaler(unsigned int prescale) {
+  m_program.push_back(Instruction{ Op::Prescale, (unsigned int) m_prescales.size() });
+  m_prescales.push_back(Prescale{ prescale, 0 });
+}
+
+// all the steps are always run, like the operators of the expression tree,
+// otherwise the prescalers won't work properly
+bool Program::operator()(const Data & data) const {
+  char * top = m_stack.data();
+  const std::vector<uint64_t> * bits = nullptr;
+
+  for (auto const & instruction: m_program) {
+    switch (instruction.op) {
+      case Op::Constant:
+        *top++ = instruction.arg;
+        break;
+
+      case Op::Paths: {
+        bool result = false;
+        if (data.hasHLT() and m_menu) {
+          if (not bits)
+            bits = & data.hltAcceptBits();
+          for (auto const & mask: m_menu->masks[instruction.arg])
+            if (mask.first < bits->size() and ((*bits)[mask.first] & mask.second)) {
+              result = true;
+              break;
+            }
+        }
+        *top++ = result;
+        break;
+      }
+
+      case Op::Evaluate:
+        *top++ = (*m_evaluators[instruction.arg])(data);
+        break;
+
+      case Op::Not:
+        top[-1] = not top[-1];
+        break;
+
+      case Op::And:
+        --top;
+        top[-1] = top[-1] and top[0];
+        break;
+
+      case Op::Or:
+        --top;
+        top[-1] = top[-1] or top[0];
+        break;
+
+      case Op::Xor:
+        --top;
+        top[-1] = (top[-1] != 0) xor (top[0] != 0);
+        break;
+
+      case Op::Prescale: {
+        Prescale const & prescale = m_prescales[instruction.arg];
+        // if the prescale factor is 1, we do not need to keep track of the event counter
+        if (top[-1] and prescale.prescale != 1)
+          top[-1] = (++prescale.counter % prescale.prescale) == 0;
+        break;
+      }
+    }
+  }
+
+  return top[-1];
+}
+
+void Program::init(const Data & data) {
+  // expand the HLT paths only the first time each HLT menu is seen
+  if (data.hasHLT() and (data.hltConfigurationUpdated() or not m_menu)) {
+    auto menu = m_menus.find(data.hltMenu().parameterSetID());
+    if (menu == m_menus.end()) {
+      Menu expanded;
+      for (auto reader: m_paths) {
+        reader->init(data);
+        Masks masks;
+        for (auto const & trigger: reader->triggers()) {
+          unsigned int word = trigger.second / 64;
+          uint64_t     bit  = (uint64_t) 1 << (trigger.second % 64);
+          auto entry = std::find_if(masks.begin(), masks.end(), [word](std::pair<unsigned int, uint64_t> const & m) { return m.first == word; });
+          if (entry == masks.end())
+            masks.emplace_back(word, bit);
+          else
+            entry->second |= bit;
+        }
+        expanded.triggers.push_back(reader->triggers());
+        expanded.masks.push_back(std::move(masks));
+      }
+      menu = m_menus.emplace(data.hltMenu().parameterSetID(), std::move(expanded)).first;
+    }
+    m_menu = & menu->second;
+  }
+
+  for (auto evaluator: m_evaluators)
+    evaluator->init(data);
+
+  // initialize the counters to the first event number seen,
+  // in order to avoid all prescalers on different FUs to be syncronous
+  for (auto & prescale: m_prescales)
+    prescale.counter = data.eventNumber();
+}
+
+void Program::dump(std::ostream & out) const {
+  // rebuild the infix expression from the program
+  std::vector<std::string> stack;
+  for (auto const & instruction: m_program) {
+    std::stringstream step;
+    switch (instruction.op) {
+      case Op::Constant:
+        step << (instruction.arg ? "TRUE" : "FALSE");
+        break;
+
+      case Op::Paths:
+        if (not m_menu) {
+          m_paths[instruction.arg]->dump(step);
+        } else {
+          Triggers const & triggers = m_menu->triggers[instruction.arg];
+          if (triggers.empty()) {
+            step << "FALSE";
+          } else if (triggers.size() == 1) {
+            step << triggers[0].first;
+          } else {
+            step << "(" << triggers[0].first;
+            for (unsigned int i = 1; i < triggers.size(); ++i)
+              step << " OR " << triggers[i].first;
+            step << ")";
+          }
+        }
+        break;
+
+      case Op::Evaluate:
+        m_evaluators[instruction.arg]->dump(step);
+        break;
+
+      case Op::Not:
+        step << "NOT " << stack.back();
+        stack.pop_back();
+        break;
+
+      case Op::And:
+      case Op::Or:
+      case Op::Xor: {
+        std::string arg2 = stack.back();
+        stack.pop_back();
+        step << stack.back() << (instruction.op == Op::And ? " AND " : instruction.op == Op::Or ? " OR " : " XOR ") << arg2;
+        stack.pop_back();
+        break;
+      }
+
+      case Op::Prescale:
+        step << "(" << stack.back() << " / " << m_prescales[instruction.arg].prescale << ")";
+        stack.pop_back();
+        break;
+    }
+    stack.push_back(step.str());
+  }
+
+  if (not stack.empty())
+    out << stack.back();
+}
+
+Program * compile(Evaluator * expression) {
+  if (not expression)
+    return nullptr;
+  return new Program(expression);
+}
+
+} // namespace triggerExpression
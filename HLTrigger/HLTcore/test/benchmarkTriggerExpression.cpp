@@ -0,0 +1,146 @@
+// Compare the expression tree and the compiled program of the same trigger
+// expressions on random TriggerResults, and report the evaluations per second.
+//
+// usage: benchmarkTriggerExpression [events]
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "DataFormats/Common/interface/HLTGlobalStatus.h"
+#include "DataFormats/Common/interface/TriggerResults.h"
+#include "FWCore/Common/interface/TriggerNames.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "HLTrigger/HLTcore/interface/TriggerExpressionData.h"
+#include "HLTrigger/HLTcore/interface/TriggerExpressionParser.h"
+#include "HLTrigger/HLTcore/interface/TriggerExpressionProgram.h"
+
+namespace {
+
+  // a menu with groups of paths, to exercise the wildcards
+  std::vector<std::string> makeMenu(unsigned int size) {
+    const char * groups[] = { "Mu", "Ele", "Photon", "Jet", "HT", "MET", "Tau", "BTag" };
+    std::vector<std::string> paths;
+    for (unsigned int i = 0; i < size; ++i) {
+      std::stringstream name;
+      name << "HLT_" << groups[i % 8] << (i / 8) << "_v" << (1 + i % 3);
+      paths.push_back(name.str());
+    }
+    return paths;
+  }
+
+  std::vector<std::string> makeExpressions(unsigned int size) {
+    const char * groups[] = { "Mu", "Ele", "Photon", "Jet", "HT", "MET", "Tau", "BTag" };
+    std::vector<std::string> expressions;
+    for (unsigned int i = 0; i < size; ++i) {
+      std::stringstream expression;
+      switch (i % 4) {
+      case 0:
+        expression << "HLT_" << groups[i % 8] << "*";
+        break;
+      case 1:
+        expression << "HLT_" << groups[i % 8] << (i % 50) << "_v* AND NOT HLT_" << groups[(i + 1) % 8] << "1*";
+        break;
+      case 2:
+        expression << "(HLT_" << groups[i % 8] << "?_v* OR HLT_" << groups[(i + 3) % 8] << (i % 70) << "_v*) / 3";
+        break;
+      case 3:
+        expression << "HLT_" << groups[i % 8] << (i % 60) << "_v* OR (HLT_" << groups[(i + 5) % 8] << "2*_v2 AND TRUE)";
+        break;
+      }
+      expressions.push_back(expression.str());
+    }
+    return expressions;
+  }
+
+}
+
+int main(int argc, char ** argv) {
+  unsigned int events = (argc > 1) ? std::atoi(argv[1]) : 2000;
+  const unsigned int nPaths = 600;
+  const unsigned int nExpressions = 200;
+  const unsigned int nResults = 64;
+
+  edm::ParameterSet menuPSet;
+  menuPSet.addParameter<std::vector<std::string> >("@trigger_paths", makeMenu(nPaths));
+  menuPSet.registerIt();
+  edm::TriggerNames menu(menuPSet);
+
+  // random decisions, about 10% of the paths accept each event
+  uint64_t state = 12345;
+  std::vector<edm::TriggerResults> results;
+  for (unsigned int k = 0; k < nResults; ++k) {
+    edm::HLTGlobalStatus status(nPaths);
+    for (unsigned int i = 0; i < nPaths; ++i) {
+      state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+      status[i] = edm::HLTPathStatus((state >> 33) % 10 == 0 ? edm::hlt::Pass : edm::hlt::Fail);
+    }
+    results.emplace_back(status, menu.parameterSetID());
+  }
+
+  triggerExpression::Data data;
+  data.setHltResultsTag(edm::InputTag("TriggerResults"));
+  data.setThrow(false);
+  data.m_hltMenu = & menu;
+  data.m_hltUpdated = true;
+  data.m_eventNumber = 1;
+  data.m_hltResults = & results[0];
+  data.m_hltAcceptBitsValid = false;
+
+  std::vector<std::unique_ptr<triggerExpression::Evaluator> > trees;
+  std::vector<std::unique_ptr<triggerExpression::Evaluator> > programs;
+  for (auto const & expression: makeExpressions(nExpressions)) {
+    trees.emplace_back(triggerExpression::parse(expression));
+    programs.emplace_back(triggerExpression::compile(triggerExpression::parse(expression)));
+    if (not trees.back() or not programs.back()) {
+      std::cerr << "cannot parse \"" << expression << "\"" << std::endl;
+      return 1;
+    }
+    trees.back()->init(data);
+    programs.back()->init(data);
+  }
+
+  // check that the tree and the program agree, and time them
+  std::vector<char> treeResults;
+  std::vector<char> programResults;
+  treeResults.reserve(events * nExpressions);
+  programResults.reserve(events * nExpressions);
+
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned int e = 0; e < events; ++e) {
+    data.m_hltResults = & results[e % nResults];
+    for (auto const & tree: trees)
+      treeResults.push_back((*tree)(data));
+  }
+  auto treeTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  start = std::chrono::steady_clock::now();
+  for (unsigned int e = 0; e < events; ++e) {
+    data.m_hltResults = & results[e % nResults];
+    data.m_hltAcceptBitsValid = false;
+    for (auto const & program: programs)
+      programResults.push_back((*program)(data));
+  }
+  auto programTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  if (treeResults != programResults) {
+    for (unsigned int i = 0; i < treeResults.size(); ++i)
+      if (treeResults[i] != programResults[i]) {
+        std::cerr << "event " << i / nExpressions << ": the tree and the program differ for "
+                  << *trees[i % nExpressions] << std::endl;
+        break;
+      }
+    return 1;
+  }
+
+  double evaluations = double(events) * nExpressions;
+  std::cout << nExpressions << " expressions on " << nPaths << " paths, " << events << " events" << std::endl;
+  std::cout << "expression tree:    " << evaluations / treeTime    << " expressions/s" << std::endl;
+  std::cout << "compiled program:   " << evaluations / programTime << " expressions/s" << std::endl;
+  return 0;
+}
@@ -23,6 +23,7 @@
 
 #include "HLTrigger/HLTcore/interface/TriggerExpressionEvaluator.h"
 #include "HLTrigger/HLTcore/interface/TriggerExpressionParser.h"
+#include "HLTrigger/HLTcore/interface/TriggerExpressionProgram.h"
 #include "TriggerResultsFilter.h"
 
 //
@@ -79,8 +80,8 @@ void TriggerResultsFilter::parse(const std::vector<std::string> & expressions) {
 }
 
 void TriggerResultsFilter::parse(const std::string & expression) {
-  // parse the logical expressions into functionals
-  m_expression = triggerExpression::parse( expression );
+  // parse the logical expressions into functionals, and flatten them into a program
+  m_expression = triggerExpression::compile( triggerExpression::parse( expression ) );
 
   // check if the expressions were parsed correctly
   if (not m_expression)
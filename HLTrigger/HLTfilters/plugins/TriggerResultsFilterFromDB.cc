@@ -25,6 +25,7 @@
 
 #include "HLTrigger/HLTcore/interface/TriggerExpressionEvaluator.h"
 #include "HLTrigger/HLTcore/interface/TriggerExpressionParser.h"
+#include "HLTrigger/HLTcore/interface/TriggerExpressionProgram.h"
 #include "TriggerResultsFilterFromDB.h"
 
 //
@@ -80,8 +81,8 @@ void TriggerResultsFilterFromDB::parse(const std::vector<std::string> & expressi
 }
 
 void TriggerResultsFilterFromDB::parse(const std::string & expression) {
-  // parse the logical expressions into functionals
-  m_expression = triggerExpression::parse( expression );
+  // parse the logical expressions into functionals, and flatten them into a program
+  m_expression = triggerExpression::compile( triggerExpression::parse( expression ) );
 
   // check if the expressions were parsed correctly
   if (not m_expression)
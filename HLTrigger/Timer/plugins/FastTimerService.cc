@@ -33,6 +33,7 @@
 
 // local headers
 #include "memory_usage.h"
+#include "perf_counters.h"
 #include "processor_model.h"
 
 using namespace std::literals;
@@ -60,6 +61,18 @@ namespace {
   {
     return bytes / 1024;
   }
+
+  // instructions per cycle
+  double ipc(uint64_t instructions, uint64_t cycles)
+  {
+    return cycles ? (double) instructions / cycles : 0.;
+  }
+
+  // events per thousand instructions
+  double mpki(uint64_t misses, uint64_t instructions)
+  {
+    return instructions ? 1000. * misses / instructions : 0.;
+  }
 } // namespace
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -72,23 +85,35 @@ FastTimerService::Resources::Resources() :
   time_thread(boost::chrono::nanoseconds::zero()),
   time_real(boost::chrono::nanoseconds::zero()),
   allocated(0ul),
-  deallocated(0ul)
+  deallocated(0ul),
+  cycles(0ul),
+  instructions(0ul),
+  cache_misses(0ul),
+  branch_misses(0ul)
 { }
 
 void
 FastTimerService::Resources::reset() {
-  time_thread = boost::chrono::nanoseconds::zero();
-  time_real   = boost::chrono::nanoseconds::zero();
-  allocated   = 0ul;
-  deallocated = 0ul;
+  time_thread   = boost::chrono::nanoseconds::zero();
+  time_real     = boost::chrono::nanoseconds::zero();
+  allocated     = 0ul;
+  deallocated   = 0ul;
+  cycles        = 0ul;
+  instructions  = 0ul;
+  cache_misses  = 0ul;
+  branch_misses = 0ul;
 }
 
 FastTimerService::Resources &
 FastTimerService::Resources::operator+=(Resources const& other) {
-  time_thread += other.time_thread;
-  time_real   += other.time_real;
-  allocated   += other.allocated;
-  deallocated += other.deallocated;
+  time_thread   += other.time_thread;
+  time_real     += other.time_real;
+  allocated     += other.allocated;
+  deallocated   += other.deallocated;
+  cycles        += other.cycles;
+  instructions  += other.instructions;
+  cache_misses  += other.cache_misses;
+  branch_misses += other.branch_misses;
   return *this;
 }
 
@@ -108,39 +133,59 @@ FastTimerService::AtomicResources::AtomicResources() :
   time_thread(0ul),
   time_real(0ul),
   allocated(0ul),
-  deallocated(0ul)
+  deallocated(0ul),
+  cycles(0ul),
+  instructions(0ul),
+  cache_misses(0ul),
+  branch_misses(0ul)
 { }
 
 FastTimerService::AtomicResources::AtomicResources(AtomicResources const& other) :
   time_thread(other.time_thread.load()),
   time_real(other.time_real.load()),
   allocated(other.allocated.load()),
-  deallocated(other.deallocated.load())
+  deallocated(other.deallocated.load()),
+  cycles(other.cycles.load()),
+  instructions(other.instructions.load()),
+  cache_misses(other.cache_misses.load()),
+  branch_misses(other.branch_misses.load())
 { }
 
 void
 FastTimerService::AtomicResources::reset() {
-  time_thread = 0ul;
-  time_real   = 0ul;
-  allocated   = 0ul;
-  deallocated = 0ul;
+  time_thread   = 0ul;
+  time_real     = 0ul;
+  allocated     = 0ul;
+  deallocated   = 0ul;
+  cycles        = 0ul;
+  instructions  = 0ul;
+  cache_misses  = 0ul;
+  branch_misses = 0ul;
 }
 
 FastTimerService::AtomicResources &
 FastTimerService::AtomicResources::operator=(AtomicResources const& other) {
-  time_thread = other.time_thread.load();
-  time_real   = other.time_real.load();
-  allocated   = other.allocated.load();
-  deallocated = other.deallocated.load();
+  time_thread   = other.time_thread.load();
+  time_real     = other.time_real.load();
+  allocated     = other.allocated.load();
+  deallocated   = other.deallocated.load();
+  cycles        = other.cycles.load();
+  instructions  = other.instructions.load();
+  cache_misses  = other.cache_misses.load();
+  branch_misses = other.branch_misses.load();
   return *this;
 }
 
 FastTimerService::AtomicResources &
 FastTimerService::AtomicResources::operator+=(AtomicResources const& other) {
-  time_thread += other.time_thread.load();
-  time_real   += other.time_real.load();
-  allocated   += other.allocated.load();
-  deallocated += other.deallocated.load();
+  time_thread   += other.time_thread.load();
+  time_real     += other.time_real.load();
+  allocated     += other.allocated.load();
+  deallocated   += other.deallocated.load();
+  cycles        += other.cycles.load();
+  instructions  += other.instructions.load();
+  cache_misses  += other.cache_misses.load();
+  branch_misses += other.branch_misses.load();
   return *this;
 }
 
@@ -320,6 +365,7 @@ FastTimerService::Measurement::measure() noexcept {
   time_real   = boost::chrono::high_resolution_clock::now();
   allocated   = memory_usage::allocated();
   deallocated = memory_usage::deallocated();
+  perf_counters::read(counters);
 }
 
 void
@@ -331,14 +377,21 @@ FastTimerService::Measurement::measure_and_store(Resources & store) noexcept {
   auto new_time_real   = boost::chrono::high_resolution_clock::now();
   auto new_allocated   = memory_usage::allocated();
   auto new_deallocated = memory_usage::deallocated();
+  perf_counters::values new_counters;
+  perf_counters::read(new_counters);
   store.time_thread = new_time_thread - time_thread;
   store.time_real   = new_time_real   - time_real;
   store.allocated   = new_allocated   - allocated;
   store.deallocated = new_deallocated - deallocated;
+  store.cycles        = new_counters[perf_counters::cycles]        - counters[perf_counters::cycles];
+  store.instructions  = new_counters[perf_counters::instructions]  - counters[perf_counters::instructions];
+  store.cache_misses  = new_counters[perf_counters::cache_misses]  - counters[perf_counters::cache_misses];
+  store.branch_misses = new_counters[perf_counters::branch_misses] - counters[perf_counters::branch_misses];
   time_thread = new_time_thread;
   time_real   = new_time_real;
   allocated   = new_allocated;
   deallocated = new_deallocated;
+  counters    = new_counters;
 }
 
 void
@@ -350,14 +403,21 @@ FastTimerService::Measurement::measure_and_accumulate(Resources & store) noexcep
   auto new_time_real   = boost::chrono::high_resolution_clock::now();
   auto new_allocated   = memory_usage::allocated();
   auto new_deallocated = memory_usage::deallocated();
+  perf_counters::values new_counters;
+  perf_counters::read(new_counters);
   store.time_thread += new_time_thread - time_thread;
   store.time_real   += new_time_real   - time_real;
   store.allocated   += new_allocated   - allocated;
   store.deallocated += new_deallocated - deallocated;
+  store.cycles        += new_counters[perf_counters::cycles]        - counters[perf_counters::cycles];
+  store.instructions  += new_counters[perf_counters::instructions]  - counters[perf_counters::instructions];
+  store.cache_misses  += new_counters[perf_counters::cache_misses]  - counters[perf_counters::cache_misses];
+  store.branch_misses += new_counters[perf_counters::branch_misses] - counters[perf_counters::branch_misses];
   time_thread = new_time_thread;
   time_real   = new_time_real;
   allocated   = new_allocated;
   deallocated = new_deallocated;
+  counters    = new_counters;
 }
 
 void
@@ -369,14 +429,21 @@ FastTimerService::Measurement::measure_and_accumulate(AtomicResources & store) n
   auto new_time_real   = boost::chrono::high_resolution_clock::now();
   auto new_allocated   = memory_usage::allocated();
   auto new_deallocated = memory_usage::deallocated();
+  perf_counters::values new_counters;
+  perf_counters::read(new_counters);
   store.time_thread += boost::chrono::duration_cast<boost::chrono::nanoseconds>(new_time_thread - time_thread).count();
   store.time_real   += boost::chrono::duration_cast<boost::chrono::nanoseconds>(new_time_real   - time_real).count();
   store.allocated   += new_allocated   - allocated;
   store.deallocated += new_deallocated - deallocated;
+  store.cycles        += new_counters[perf_counters::cycles]        - counters[perf_counters::cycles];
+  store.instructions  += new_counters[perf_counters::instructions]  - counters[perf_counters::instructions];
+  store.cache_misses  += new_counters[perf_counters::cache_misses]  - counters[perf_counters::cache_misses];
+  store.branch_misses += new_counters[perf_counters::branch_misses] - counters[perf_counters::branch_misses];
   time_thread = new_time_thread;
   time_real   = new_time_real;
   allocated   = new_allocated;
   deallocated = new_deallocated;
+  counters    = new_counters;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -426,6 +493,30 @@ FastTimerService::PlotsPerElement::book(
     deallocated_.setYTitle(y_title_kB.c_str());
   }
 
+  if (perf_counters::is_available())
+  {
+    ipc_ = booker.book1D(
+        name + " ipc",
+        title + " instructions per cycle",
+        100, 0., 5.);
+    ipc_.setXTitle("instructions per cycle");
+    ipc_.setYTitle("events / 0.05");
+
+    cache_mpki_ = booker.book1D(
+        name + " cache_mpki",
+        title + " cache misses per 1000 instructions",
+        100, 0., 50.);
+    cache_mpki_.setXTitle("cache misses per 1000 instructions");
+    cache_mpki_.setYTitle("events / 0.5");
+
+    branch_mpki_ = booker.book1D(
+        name + " branch_mpki",
+        title + " branch misses per 1000 instructions",
+        100, 0., 50.);
+    branch_mpki_.setXTitle("branch misses per 1000 instructions");
+    branch_mpki_.setYTitle("events / 0.5");
+  }
+
   if (not byls)
     return;
 
@@ -467,6 +558,18 @@ FastTimerService::PlotsPerElement::book(
     deallocated_byls_.setXTitle("lumisection");
     deallocated_byls_.setYTitle("memory [kB]");
   }
+
+  if (perf_counters::is_available())
+  {
+    ipc_byls_ = booker.bookProfile(
+        name + " ipc_byls",
+        title + " instructions per cycle vs. lumisection",
+        lumisections, 0.5, lumisections + 0.5,
+        100, 0., std::numeric_limits<double>::infinity(),
+        " ");
+    ipc_byls_.setXTitle("lumisection");
+    ipc_byls_.setYTitle("instructions per cycle");
+  }
 }
 
 void
@@ -498,6 +601,22 @@ FastTimerService::PlotsPerElement::fill(Resources const& data, unsigned int lumi
 
   if (deallocated_byls_)
     deallocated_byls_.fill(lumisection, kB(data.deallocated));
+
+  // skip the elements that did not run
+  if (data.cycles == 0)
+    return;
+
+  if (ipc_)
+    ipc_.fill(ipc(data.instructions, data.cycles));
+
+  if (ipc_byls_)
+    ipc_byls_.fill(lumisection, ipc(data.instructions, data.cycles));
+
+  if (cache_mpki_)
+    cache_mpki_.fill(mpki(data.cache_misses, data.instructions));
+
+  if (branch_mpki_)
+    branch_mpki_.fill(mpki(data.branch_misses, data.instructions));
 }
 
 void
@@ -529,6 +648,22 @@ FastTimerService::PlotsPerElement::fill(AtomicResources const& data, unsigned in
 
   if (deallocated_byls_)
     deallocated_byls_.fill(lumisection, kB(data.deallocated));
+
+  // skip the elements that did not run
+  if (data.cycles == 0)
+    return;
+
+  if (ipc_)
+    ipc_.fill(ipc(data.instructions, data.cycles));
+
+  if (ipc_byls_)
+    ipc_byls_.fill(lumisection, ipc(data.instructions, data.cycles));
+
+  if (cache_mpki_)
+    cache_mpki_.fill(mpki(data.cache_misses, data.instructions));
+
+  if (branch_mpki_)
+    branch_mpki_.fill(mpki(data.branch_misses, data.instructions));
 }
 
 void
@@ -571,6 +706,22 @@ FastTimerService::PlotsPerElement::fill_fraction(Resources const& data, Resource
 
   if (deallocated_byls_)
     deallocated_byls_.fill(lumisection, total, fraction);
+
+  // the hardware counters are ratios already: fill them for the part alone
+  if (part.cycles == 0)
+    return;
+
+  if (ipc_)
+    ipc_.fill(ipc(part.instructions, part.cycles));
+
+  if (ipc_byls_)
+    ipc_byls_.fill(lumisection, ipc(part.instructions, part.cycles));
+
+  if (cache_mpki_)
+    cache_mpki_.fill(mpki(part.cache_misses, part.instructions));
+
+  if (branch_mpki_)
+    branch_mpki_.fill(mpki(part.branch_misses, part.instructions));
 }
 
 
@@ -619,6 +770,19 @@ FastTimerService::PlotsPerPath::book(
         bins, -0.5, bins - 0.5);
     module_deallocated_total_.setYTitle("memory [kB]");
   }
+  if (perf_counters::is_available())
+  {
+    module_cycles_total_ = booker.book1DD(
+        "module_cycles_total",
+        "total cycles",
+        bins, -0.5, bins - 0.5);
+    module_cycles_total_.setYTitle("cycles");
+    module_instructions_total_ = booker.book1DD(
+        "module_instructions_total",
+        "total instructions",
+        bins, -0.5, bins - 0.5);
+    module_instructions_total_.setYTitle("instructions");
+  }
   for (unsigned int bin: boost::irange(0u, bins)) {
     auto const& module = job[path.modules_and_dependencies_[bin]];
     std::string const& label = module.scheduled_ ? module.module_.moduleLabel() : module.module_.moduleLabel() + " (unscheduled)";
@@ -630,6 +794,11 @@ FastTimerService::PlotsPerPath::book(
       module_allocated_total_  .setBinLabel(bin + 1, label.c_str());
       module_deallocated_total_.setBinLabel(bin + 1, label.c_str());
     }
+    if (perf_counters::is_available())
+    {
+      module_cycles_total_      .setBinLabel(bin + 1, label.c_str());
+      module_instructions_total_.setBinLabel(bin + 1, label.c_str());
+    }
   }
   module_counter_.setBinLabel(bins + 1, "");
 
@@ -659,6 +828,12 @@ FastTimerService::PlotsPerPath::fill(ProcessCallGraph::PathType const& descripti
 
     if (module_deallocated_total_)
       module_deallocated_total_.fill(i, kB(module.total.deallocated));
+
+    if (module_cycles_total_)
+      module_cycles_total_.fill(i, module.total.cycles);
+
+    if (module_instructions_total_)
+      module_instructions_total_.fill(i, module.total.instructions);
   }
   if (module_counter_ and path.status)
     module_counter_.fill(path.last);
@@ -903,6 +1078,11 @@ FastTimerService::FastTimerService(const edm::ParameterSet & config, edm::Activi
   highlight_module_psets_(      config.getUntrackedParameter<std::vector<edm::ParameterSet>>("highlightModules") ),
   highlight_modules_(           highlight_module_psets_.size())         // filled in postBeginJob()
 {
+  // optionally read the hardware performance counters; this must happen before any measurement is taken
+  if (config.getUntrackedParameter<bool>("enablePerfCounters") and not perf_counters::enable())
+    edm::LogWarning("FastTimerService") << "The hardware performance counters are not available, and will not be monitored.\n"
+      << "Check the value of /proc/sys/kernel/perf_event_paranoid .";
+
   // start observing when a thread enters or leaves the TBB global thread arena
   tbb::task_scheduler_observer::observe();
 
@@ -1232,6 +1412,8 @@ FastTimerService::postGlobalEndRun(edm::GlobalContext const& gc)
   auto const& label = (boost::format("Run %d") % gc.luminosityBlockID().run()).str();
   if (print_run_summary_) {
     printSummary(out, run_summary_[index], label);
+    if (perf_counters::is_available())
+      printCounters(out, run_summary_[index], label);
   }
   printTransition(out, run_transition_[index], label);
 
@@ -1270,6 +1452,8 @@ FastTimerService::postEndJob()
   if (print_job_summary_) {
     edm::LogVerbatim out("FastReport");
     printSummary(out, job_summary_, "Job");
+    if (perf_counters::is_available())
+      printCounters(out, job_summary_, "Job");
   }
 }
 
@@ -1474,6 +1658,47 @@ void FastTimerService::printSummary(T& out, ResourcesPerJob const& data, std::st
   }
 }
 
+template <typename T>
+void FastTimerService::printCountersHeader(T& out, std::string const& label) const
+{
+  out << "FastReport     Cycles avg.  Instructions avg.     IPC  Cache MPKI  Branch MPKI  " << label << '\n';
+  //      FastReport  ############  #################  ##.###  ######.###   ######.###  ...
+}
+
+template <typename T>
+void FastTimerService::printCountersLine(T& out, Resources const& data, uint64_t events, std::string const& label) const
+{
+  out << boost::format("FastReport  %12.0f  %17.0f  %6.3f  %10.3f   %10.3f  %s\n")
+    % (events ? (double) data.cycles       / events : 0)
+    % (events ? (double) data.instructions / events : 0)
+    % ipc(data.instructions, data.cycles)
+    % mpki(data.cache_misses,  data.instructions)
+    % mpki(data.branch_misses, data.instructions)
+    % label;
+}
+
+template <typename T>
+void FastTimerService::printCounters(T& out, ResourcesPerJob const& data, std::string const& label) const
+{
+  printHeader(out, label + " Hardware Counters");
+  printCountersHeader(out, "Modules");
+  auto const& source_d = callgraph_.source();
+  auto const& source   = data.modules[source_d.id()];
+  printCountersLine(out, source.total, source.events, source_d.moduleLabel());
+  for (unsigned int i = 0; i < callgraph_.processes().size(); ++i) {
+    auto const& proc_d = callgraph_.processDescription(i);
+    auto const& proc   = data.processes[i];
+    printCountersLine(out, proc.total, data.events, "process " + proc_d.name_);
+    for (unsigned int m: proc_d.modules_) {
+      auto const& module_d = callgraph_.module(m);
+      auto const& module   = data.modules[m];
+      printCountersLine(out, module.total, module.events, "  " + module_d.moduleLabel());
+    }
+  }
+  printCountersLine(out, data.total, data.events, "total");
+  out << '\n';
+}
+
 template <typename T>
 void FastTimerService::printTransition(T& out, AtomicResources const& data, std::string const& label) const
 {
@@ -1839,6 +2064,7 @@ FastTimerService::fillDescriptions(edm::ConfigurationDescriptions & descriptions
   desc.addUntracked<bool>(        "enableDQMbyLumiSection",   false);
   desc.addUntracked<bool>(        "enableDQMbyProcesses",     false);
   desc.addUntracked<bool>(        "enableDQMTransitions",     false);
+  desc.addUntracked<bool>(        "enablePerfCounters",       false)->setComment("Read the cycles, instructions, cache misses and branch misses hardware counters via perf_event_open (Linux only).");
   desc.addUntracked<double>(      "dqmTimeRange",             1000. );   // ms
   desc.addUntracked<double>(      "dqmTimeResolution",           5. );   // ms
   desc.addUntracked<double>(      "dqmMemoryRange",        1000000. );   // kB
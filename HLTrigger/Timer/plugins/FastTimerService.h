@@ -41,6 +41,9 @@
 #include "DQMServices/Core/interface/MonitorElement.h"
 #include "HLTrigger/Timer/interface/ProcessCallGraph.h"
 
+// local headers
+#include "perf_counters.h"
+
 
 /*
 procesing time is divided into
@@ -203,6 +206,7 @@ private:
     boost::chrono::high_resolution_clock::time_point time_real;
     uint64_t                                         allocated;
     uint64_t                                         deallocated;
+    perf_counters::values                            counters;
   };
 
   // highlight a group of modules
@@ -225,6 +229,10 @@ private:
     boost::chrono::nanoseconds time_real;
     uint64_t                   allocated;
     uint64_t                   deallocated;
+    uint64_t                   cycles;
+    uint64_t                   instructions;
+    uint64_t                   cache_misses;
+    uint64_t                   branch_misses;
   };
 
   // atomic version of Resources
@@ -243,6 +251,10 @@ private:
     std::atomic<boost::chrono::nanoseconds::rep> time_real;
     std::atomic<uint64_t> allocated;
     std::atomic<uint64_t> deallocated;
+    std::atomic<uint64_t> cycles;
+    std::atomic<uint64_t> instructions;
+    std::atomic<uint64_t> cache_misses;
+    std::atomic<uint64_t> branch_misses;
   };
 
   struct ResourcesPerModule {
@@ -330,6 +342,10 @@ private:
     ConcurrentMonitorElement allocated_byls_;       // TProfile
     ConcurrentMonitorElement deallocated_;          // TH1F
     ConcurrentMonitorElement deallocated_byls_;     // TProfile
+    ConcurrentMonitorElement ipc_;                  // TH1F
+    ConcurrentMonitorElement ipc_byls_;             // TProfile
+    ConcurrentMonitorElement cache_mpki_;           // TH1F
+    ConcurrentMonitorElement branch_mpki_;          // TH1F
   };
 
   // plots associated to each path or endpath
@@ -355,6 +371,8 @@ private:
     ConcurrentMonitorElement module_time_real_total_;       // TH1D
     ConcurrentMonitorElement module_allocated_total_;       // TH1D
     ConcurrentMonitorElement module_deallocated_total_;     // TH1D
+    ConcurrentMonitorElement module_cycles_total_;          // TH1D
+    ConcurrentMonitorElement module_instructions_total_;    // TH1D
   };
 
   class PlotsPerProcess {
@@ -498,6 +516,15 @@ private:
   template <typename T>
   void printSummary(T& out, ResourcesPerJob const& data, std::string const& label) const;
 
+  template <typename T>
+  void printCountersHeader(T& out, std::string const & label) const;
+
+  template <typename T>
+  void printCountersLine(T& out, Resources const& data, uint64_t events, std::string const& label) const;
+
+  template <typename T>
+  void printCounters(T& out, ResourcesPerJob const& data, std::string const& label) const;
+
   template <typename T>
   void printTransition(T& out, AtomicResources const& data, std::string const& label) const;
 
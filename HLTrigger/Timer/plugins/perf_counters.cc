@@ -0,0 +1,128 @@
+#include <atomic>
+#include <cstring>
+#include <boost/predef/os.h>
+
+#if BOOST_OS_LINUX
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif // BOOST_OS_LINUX
+
+#include "perf_counters.h"
+
+namespace {
+
+  std::atomic<bool> enabled(false);
+
+#if BOOST_OS_LINUX
+  // the counters of the calling thread, opened as a group with "cycles" as the leader,
+  // so that they are always scheduled together and their ratios are meaningful;
+  // the group is pinned, so that it is never multiplexed with other events: the counts
+  // are exact, and the differences between two reads never need to be rescaled
+  class thread_counters {
+  public:
+    thread_counters() {
+      static const uint64_t config[perf_counters::size] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES
+      };
+
+      fds_.fill(-1);
+      for (unsigned int i = 0; i < perf_counters::size; ++i) {
+        struct perf_event_attr attr;
+        std::memset(& attr, 0, sizeof(attr));
+        attr.size           = sizeof(attr);
+        attr.type           = PERF_TYPE_HARDWARE;
+        attr.config         = config[i];
+        attr.read_format    = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        attr.disabled       = (i == 0) ? 1 : 0;
+        attr.pinned         = (i == 0) ? 1 : 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+        // measure the calling thread on any cpu
+        fds_[i] = ::syscall(__NR_perf_event_open, & attr, 0, -1, fds_[0], 0);
+        if (fds_[i] < 0) {
+          close();
+          return;
+        }
+      }
+      ::ioctl(fds_[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+      ::ioctl(fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+
+    ~thread_counters() {
+      close();
+    }
+
+    bool valid() const {
+      return fds_[0] >= 0;
+    }
+
+    void read(perf_counters::values & counters) const {
+      // layout for PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING
+      struct {
+        uint64_t nr;
+        uint64_t time_enabled;
+        uint64_t time_running;
+        uint64_t values[perf_counters::size];
+      } data;
+
+      // a pinned group that could not be kept on the PMU is put in error state and reads
+      // as end-of-file: keep returning the last counts, so that the differences are zero
+      if (not valid() or ::read(fds_[0], & data, sizeof(data)) != sizeof(data)) {
+        counters = last_;
+        return;
+      }
+      for (unsigned int i = 0; i < perf_counters::size; ++i)
+        counters[i] = data.values[i];
+      last_ = counters;
+    }
+
+  private:
+    void close() {
+      for (auto & fd: fds_) {
+        if (fd >= 0)
+          ::close(fd);
+        fd = -1;
+      }
+    }
+
+    std::array<int, perf_counters::size> fds_;
+    mutable perf_counters::values last_ = {};
+  };
+
+  thread_counters const & this_thread_counters() {
+    thread_local const thread_counters counters;
+    return counters;
+  }
+#endif // BOOST_OS_LINUX
+
+} // namespace
+
+bool perf_counters::enable()
+{
+#if BOOST_OS_LINUX
+  // the counters may be unavailable, e.g. inside a virtual machine or if /proc/sys/kernel/perf_event_paranoid is too restrictive
+  enabled = this_thread_counters().valid();
+#endif // BOOST_OS_LINUX
+  return enabled;
+}
+
+bool perf_counters::is_available()
+{
+  return enabled;
+}
+
+void perf_counters::read(values & counters)
+{
+#if BOOST_OS_LINUX
+  if (enabled) {
+    this_thread_counters().read(counters);
+    return;
+  }
+#endif // BOOST_OS_LINUX
+  counters.fill(0);
+}
@@ -0,0 +1,30 @@
+#ifndef perf_counters_h
+#define perf_counters_h
+
+#include <array>
+#include <cstdint>
+
+// per-thread hardware performance counters, read through the Linux perf_event_open interface;
+// the counters are opened lazily as a single group on each thread that reads them, and
+// are reported as zero if they have not been enabled or are not available
+class perf_counters {
+public:
+  enum counter {
+    cycles,
+    instructions,
+    cache_misses,
+    branch_misses,
+    size
+  };
+
+  using values = std::array<uint64_t, size>;
+
+  // try to open the counters on the calling thread; return true if they are available
+  static bool enable();
+  static bool is_available();
+
+  // read the counters for the calling thread
+  static void read(values & counters);
+};
+
+#endif // perf_counters_h
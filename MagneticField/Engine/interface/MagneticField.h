@@ -53,6 +53,12 @@ class MagneticField
   virtual GlobalVector inTeslaUnchecked (const GlobalPoint& gp) const {
     return inTesla(gp);  // default dummy implementation
   }
+
+  /// Field values in Tesla at n points, e.g. the steps of a propagation.
+  /// Derived classes can implement it to amortize lookups over the batch.
+  virtual void inTeslaBatch (const GlobalPoint* gp, GlobalVector* b, unsigned int n) const {
+    for (unsigned int i=0; i<n; ++i) b[i] = inTesla(gp[i]);  // default dummy implementation
+  }
   
   /// The nominal field value for this map in kGauss
   int nominalValue() const {  
@@ -12,6 +12,10 @@
  *  TOSCA = input test tables, searches for the corresponding volume/sector determined from the file name and path.
  *  TOSCAFileList = file with a list of TOSCA tables
  *  TOSCASecorComparison: compare each if the listed TOSCA txt tables with those of the other sectors
+ *
+ *  benchmarkPaths: number of track-like paths used to compare the timing of single-point
+ *  and batch (inTeslaBatch) queries. Paths are read from benchmarkPathFile if set
+ *  (x y z in cm per line, paths separated by empty lines), otherwise they are generated.
  * 
  *  \author N. Amapane - CERN
  */
@@ -43,6 +47,7 @@
 #include <sstream>
 #include <fstream>
 #include <iomanip>
+#include <chrono>
 #include <libgen.h>
 #include <boost/lexical_cast.hpp>
 
@@ -71,6 +76,9 @@ class testMagneticField : public edm::EDAnalyzer {
     OuterRadius = pset.getUntrackedParameter<double>("OuterRadius",900);
     //    half length of test cylinder
     HalfLength = pset.getUntrackedParameter<double>("HalfLength",2400);
+    //    number of paths for the benchmark of batch queries
+    benchmarkPaths = pset.getUntrackedParameter<int>("benchmarkPaths", 0);
+    benchmarkPathFile = pset.getUntrackedParameter<string>("benchmarkPathFile", "");
     
   }
 
@@ -116,6 +124,10 @@ class testMagneticField : public edm::EDAnalyzer {
      validate (inputFile, inputFileType);
    }
 
+   if (benchmarkPaths>0 || benchmarkPathFile!="") {
+     benchmarkBatch();
+   }
+
    // Some ad-hoc test
 //    for (float phi = 0; phi<Geom::twoPi(); phi+=Geom::pi()/48.) {
 //      go(GlobalPoint(Cylindrical2Cartesian<float>(89.,phi,145.892)), magfield.product());
@@ -132,6 +144,7 @@ class testMagneticField : public edm::EDAnalyzer {
   void parseTOSCATablePath(string filename, int& volNo, int& sector, string& type);
   void fillFromTable(string inputFile, vector<GlobalPoint>& p, vector<GlobalVector>& b, string type);
   void compareSectorTables(string file);
+  void benchmarkBatch();
 
  private:
   const MagneticField* field;
@@ -143,6 +156,8 @@ class testMagneticField : public edm::EDAnalyzer {
   double OuterRadius;
   double InnerRadius;
   double HalfLength;
+  int benchmarkPaths;
+  string benchmarkPathFile;
 };
 
 
@@ -328,6 +343,79 @@ void testMagneticField::validateVsTOSCATable(string filename) {
   
 }
 
+void testMagneticField::benchmarkBatch() {
+  vector<vector<GlobalPoint> > paths;
+
+  if (benchmarkPathFile!="") {
+    ifstream file(benchmarkPathFile.c_str());
+    string line;
+    paths.emplace_back();
+    while (getline(file,line)) {
+      if (line=="" || line[0]=='#') {
+        if (!paths.back().empty()) paths.emplace_back();
+        continue;
+      }
+      stringstream linestr(line);
+      float px, py, pz;
+      linestr >> px >> py >> pz;
+      paths.back().emplace_back(px, py, pz);
+    }
+    if (paths.back().empty()) paths.pop_back();
+  } else {
+    // Helices from the origin, 1 cm steps up to the test cylinder boundary
+    GlobalPointProvider p(OuterRadius/2., OuterRadius, -Geom::pi(), Geom::pi(), -HalfLength/2., HalfLength/2.);
+    for (int i = 0; i<benchmarkPaths; ++i) {
+      GlobalVector dir = p.getPoint() - GlobalPoint(0,0,0);
+      float rho = 100.f + 10.f*(i%200); // radius of curvature in cm
+      float sign = (i%2) ? 1.f : -1.f;
+      float tanl = dir.z()/dir.perp();
+      float phi = dir.phi();
+      vector<GlobalPoint> path;
+      for (float s=0; ; s+=1.f) {
+        float alpha = sign*s/rho;                 // turning angle after a path s
+        float chord = 2.f*rho*sin(s/(2.f*rho));   // 2 rho sin(|alpha|/2)
+        float x0 = chord*cos(alpha/2.f), y0 = chord*sin(alpha/2.f);
+        GlobalPoint gp(x0*cos(phi)-y0*sin(phi), x0*sin(phi)+y0*cos(phi), s*tanl);
+        if (gp.perp()>OuterRadius || fabs(gp.z())>HalfLength || s>2*rho*Geom::pi()) break;
+        path.push_back(gp);
+      }
+      paths.push_back(path);
+    }
+  }
+
+  unsigned int npoints = 0;
+  for (auto const& path : paths) npoints += path.size();
+  if (npoints==0) {
+    cout << "benchmarkBatch: no points" << endl;
+    return;
+  }
+
+  vector<GlobalVector> bSingle(npoints), bBatch(npoints);
+  typedef std::chrono::high_resolution_clock Clock;
+
+  auto start = Clock::now();
+  unsigned int k = 0;
+  for (auto const& path : paths) for (auto const& gp : path) bSingle[k++] = field->inTesla(gp);
+  double tSingle = std::chrono::duration<double>(Clock::now()-start).count();
+
+  start = Clock::now();
+  k = 0;
+  for (auto const& path : paths) {
+    field->inTeslaBatch(path.data(), &bBatch[k], path.size());
+    k += path.size();
+  }
+  double tBatch = std::chrono::duration<double>(Clock::now()-start).count();
+
+  float maxdelta = 0.;
+  for (unsigned int i=0; i<npoints; ++i) maxdelta = max(maxdelta, (bSingle[i]-bBatch[i]).mag());
+
+  cout << "benchmarkBatch: " << paths.size() << " paths, " << npoints << " points" << endl
+       << "  single-point queries: " << npoints/tSingle << " points/s" << endl
+       << "  batch queries:        " << npoints/tBatch  << " points/s" << endl
+       << "  max delta: " << maxdelta << endl << endl;
+}
+
+
 // #include <multimap> 
 // typedef multimap<float, pair<int, int> > VolumesByDiscrepancy ;
 
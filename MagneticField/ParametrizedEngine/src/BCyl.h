@@ -100,6 +100,20 @@ namespace magfieldparam {
       Br+=corBr;
       Bz+=corBz;
     }
+
+    // cartesian components for n points (structure of arrays), same units as above.
+    // Branch-free and fully inlined so that the loop can be auto-vectorized
+    // (where the sqrt is not required to set errno, e.g. with -Ofast)
+    void computeBxyz(T const * __restrict__ x, T const * __restrict__ y, T const * __restrict__ z,
+		     T * __restrict__ Bx, T * __restrict__ By, T * __restrict__ Bz, int n) const {
+      for (int i=0; i<n; ++i) {
+	T br, bz;
+	compute(x[i]*x[i]+y[i]*y[i], z[i], br, bz);
+	Bx[i]=br*x[i];
+	By[i]=br*y[i];
+	Bz[i]=bz;
+      }
+    }
     
   private:
     BCylParam<T> pars;
@@ -9,6 +9,8 @@
 
 #include "TkBfield.h"
 
+#include <algorithm>
+
 using namespace std;
 using namespace magfieldparam;
 
@@ -48,6 +50,32 @@ OAEParametrizedMagneticField::inTeslaUnchecked(const GlobalPoint& gp) const {
   return GlobalVector(B[0], B[1], B[2]);
 }
 
+void
+OAEParametrizedMagneticField::inTeslaBatch(const GlobalPoint* gp, GlobalVector* b, unsigned int n) const {
+  // evaluate in chunks of SoA arrays; points outside the validity region are
+  // computed anyway and their result discarded, to keep the kernel branch-free
+  constexpr unsigned int chunk = 64;
+  float x[chunk], y[chunk], z[chunk];
+  float bx[chunk], by[chunk], bz[chunk];
+  for (unsigned int first=0; first<n; first+=chunk) {
+    unsigned int m = std::min(chunk, n-first);
+    for (unsigned int i=0; i<m; ++i) {
+      x[i] = gp[first+i].x()*ooh;
+      y[i] = gp[first+i].y()*ooh;
+      z[i] = gp[first+i].z()*ooh;
+    }
+    theParam.getBxyz(x,y,z,bx,by,bz,m);
+    for (unsigned int i=0; i<m; ++i) {
+      if (isDefined(gp[first+i])) {
+	b[first+i] = GlobalVector(bx[i], by[i], bz[i]);
+      } else {
+	edm::LogWarning("MagneticField|FieldOutsideValidity") << " Point " << gp[first+i] << " is outside the validity region of OAEParametrizedMagneticField";
+	b[first+i] = GlobalVector();
+      }
+    }
+  }
+}
+
 
 bool
 OAEParametrizedMagneticField::isDefined(const GlobalPoint& gp) const {
@@ -7,6 +7,8 @@
 #include <FWCore/ParameterSet/interface/ParameterSet.h>
 #include <FWCore/MessageLogger/interface/MessageLogger.h>
 
+#include <cmath>
+
 using namespace std;
 
 
@@ -55,3 +57,13 @@ inline float ParabolicParametrizedMagneticField::Kr(const float R2) const {
 inline bool ParabolicParametrizedMagneticField::isDefined(const GlobalPoint& gp) const {
   return (gp.perp2()<(13225.f) && fabs(gp.z())<280.f);
 }
+
+void ParabolicParametrizedMagneticField::inTeslaBatch(const GlobalPoint* gp, GlobalVector* b, unsigned int n) const {
+  // same as inTesla, without branches so that the loop can be vectorized
+  for (unsigned int i=0; i<n; ++i) {
+    float z = gp[i].z();
+    float r2 = gp[i].perp2();
+    float bz = B0Z(z)*Kr(r2);
+    b[i] = GlobalVector(0, 0, (r2<13225.f && std::abs(z)<280.f) ? bz : 0.f);
+  }
+}
@@ -29,6 +29,8 @@ class ParabolicParametrizedMagneticField : public MagneticField {
 
   GlobalVector inTeslaUnchecked (const GlobalPoint& gp) const override;
 
+  void inTeslaBatch (const GlobalPoint* gp, GlobalVector* b, unsigned int n) const override;
+
   inline float B0Z(const float a) const;
 
   inline float Kr(const float R2) const;
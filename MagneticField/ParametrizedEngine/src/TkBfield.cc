@@ -39,13 +39,19 @@ namespace {
     return fpars[f-flds];
 
   }
+
+  BCylParam<double> toDouble(BCylParam<float> const & p) {
+    return BCylParam<double>(double(p.prm[0]),double(p.prm[1]),double(p.prm[2]),
+			     double(p.prm[3]),double(p.prm[4]),double(p.prm[5]),
+			     double(p.prm[6]),double(p.prm[7]),double(p.prm[8]));
+  }
   
 }
 
-TkBfield::TkBfield(float fld) : bcyl(findPar(fld)) {
+TkBfield::TkBfield(float fld) : bcyl(findPar(fld)), dbcyl(toDouble(findPar(fld))) {
 }
 
-TkBfield::TkBfield(std::string fld) : bcyl(findPar(fld)) {
+TkBfield::TkBfield(std::string fld) : bcyl(findPar(fld)), dbcyl(toDouble(findPar(fld))) {
 }
 
 
@@ -65,3 +71,13 @@ void TkBfield::getBxyz(float const  * __restrict__ x, float * __restrict__ Bxyz)
   Bxyz[2]=bz;
 }
 
+
+void TkBfield::getBxyz(float const * x, float const * y, float const * z,
+		       float * Bx, float * By, float * Bz, int n) const {
+  bcyl.computeBxyz(x,y,z,Bx,By,Bz,n);
+}
+
+void TkBfield::getBxyz(double const * x, double const * y, double const * z,
+		       double * Bx, double * By, double * Bz, int n) const {
+  dbcyl.computeBxyz(x,y,z,Bx,By,Bz,n);
+}
@@ -37,9 +37,17 @@ namespace magfieldparam {
     /// B out in cylindrical
     void getBrfz(float const  * __restrict__ x, float * __restrict__ Brfz) const;
 
+    /// B out in cartesian for n points given as separate x, y, z arrays (m)
+    void getBxyz(float const * x, float const * y, float const * z,
+		 float * Bx, float * By, float * Bz, int n) const;
+    /// Same in double precision
+    void getBxyz(double const * x, double const * y, double const * z,
+		 double * Bx, double * By, double * Bz, int n) const;
+
   private:
 
     BCycl<float> bcyl;
+    BCycl<double> dbcyl;
 
   };
 }
@@ -0,0 +1,86 @@
+// Compare the batch evaluation of the parametrized fields with the scalar
+// reference (inTesla), report the maximum deviation and the timing.
+
+#include "MagneticField/ParametrizedEngine/src/OAEParametrizedMagneticField.h"
+#include "MagneticField/ParametrizedEngine/src/ParabolicParametrizedMagneticField.h"
+#include "MagneticField/ParametrizedEngine/src/TkBfield.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+  typedef std::chrono::high_resolution_clock Clock;
+
+  std::vector<GlobalPoint> makePoints(unsigned int n) {
+    // inside the validity region of both parametrizations
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> r(0.f, 114.f), phi(-M_PI, M_PI), z(-279.f, 279.f);
+    std::vector<GlobalPoint> points; points.reserve(n);
+    for (unsigned int i=0; i<n; ++i)
+      points.emplace_back(GlobalPoint::Cylindrical(r(rng), phi(rng), z(rng)));
+    return points;
+  }
+
+  float compare(char const * name, MagneticField const & field, std::vector<GlobalPoint> const & points) {
+    std::vector<GlobalVector> ref(points.size()), batch(points.size());
+
+    auto start = Clock::now();
+    for (unsigned int i=0; i<points.size(); ++i) ref[i] = field.inTesla(points[i]);
+    double tRef = std::chrono::duration<double>(Clock::now()-start).count();
+
+    start = Clock::now();
+    field.inTeslaBatch(points.data(), batch.data(), points.size());
+    double tBatch = std::chrono::duration<double>(Clock::now()-start).count();
+
+    float maxdelta = 0;
+    for (unsigned int i=0; i<points.size(); ++i) maxdelta = std::max(maxdelta, (ref[i]-batch[i]).mag());
+
+    std::cout << name << ": max deviation " << maxdelta << " T"
+	      << ", scalar " << points.size()/tRef << " points/s"
+	      << ", batch " << points.size()/tBatch << " points/s" << std::endl;
+    return maxdelta;
+  }
+
+  float compareDouble(std::vector<GlobalPoint> const & points) {
+    magfieldparam::TkBfield param(3.8f);
+    unsigned int n = points.size();
+    std::vector<double> x(n), y(n), z(n), bx(n), by(n), bz(n);
+    for (unsigned int i=0; i<n; ++i) {
+      x[i] = points[i].x()/100.; y[i] = points[i].y()/100.; z[i] = points[i].z()/100.;
+    }
+    param.getBxyz(x.data(), y.data(), z.data(), bx.data(), by.data(), bz.data(), n);
+
+    double maxdelta = 0;
+    for (unsigned int i=0; i<n; ++i) {
+      float xf[3] = {float(x[i]), float(y[i]), float(z[i])};
+      float bf[3];
+      param.getBxyz(xf, bf);
+      double d = std::sqrt((bf[0]-bx[i])*(bf[0]-bx[i]) + (bf[1]-by[i])*(bf[1]-by[i]) + (bf[2]-bz[i])*(bf[2]-bz[i]));
+      maxdelta = std::max(maxdelta, d);
+    }
+    std::cout << "TkBfield double vs float: max deviation " << maxdelta << " T" << std::endl;
+    return maxdelta;
+  }
+
+}
+
+int main() {
+  auto points = makePoints(1000000);
+
+  OAEParametrizedMagneticField oae(3.8f);
+  ParabolicParametrizedMagneticField parabolic;
+
+  // float kernels: only reassociation by the vectorizer is allowed
+  assert(compare("OAEParametrizedMagneticField", oae, points) < 1.e-5f);
+  assert(compare("ParabolicParametrizedMagneticField", parabolic, points) < 1.e-6f);
+  // double precision vs the float reference, which uses a fast approximate exp
+  assert(compareDouble(points) < 1.e-3);
+
+  return 0;
+}
@@ -12,7 +12,6 @@
 #include "DetectorDescription/Core/interface/DDCompactView.h"
 
 #include <vector>
-#include <atomic>
 
 class MagBLayer;
 class MagESector;
@@ -42,9 +41,16 @@ public:
   /// Return field vector at the specified global point
   GlobalVector fieldInTesla(const GlobalPoint & gp) const;
 
+  /// Same as above, using (and updating) a caller-owned cache of the last volume found;
+  /// hint may be nullptr. To be used for sequences of nearby points, e.g. along a track.
+  GlobalVector fieldInTesla(const GlobalPoint & gp, MagVolume const* & hint) const;
+
   /// Find a volume
   MagVolume const * findVolume(const GlobalPoint & gp, double tolerance=0.) const;
 
+  /// Find a volume, trying first the volume pointed by hint (if not nullptr), which is updated.
+  MagVolume const * findVolume(const GlobalPoint & gp, MagVolume const* & hint, double tolerance=0.) const;
+
   // Deprecated, will be removed
   bool isZSymmetric() const {return false;}
 
@@ -60,9 +66,15 @@ private:
   MagVolume const* findVolume1(const GlobalPoint & gp, double tolerance=0.) const;
 
 
+  // Hierarchical search, without any cache
+  MagVolume const* searchVolume(const GlobalPoint & gp, double tolerance) const;
+
+  GlobalVector fieldInVolume(const GlobalPoint & gp, MagVolume const * v) const;
+
   bool inBarrel(const GlobalPoint& gp) const;
 
-  mutable std::atomic<MagVolume const*> lastVolume; // Cache last volume found
+  // Key of this instance in the per-thread cache of the last volume found
+  const unsigned int theCacheId;
 
   std::vector<MagBLayer const*> theBLayers;
   std::vector<MagESector const*> theESectors;
@@ -42,6 +42,10 @@ class VolumeBasedMagneticField : public MagneticField {
 
   GlobalVector inTeslaUnchecked ( const GlobalPoint& g) const override;
 
+  /// Batch evaluation: the volume found for a point is tried first for the next one,
+  /// without touching the cache shared by single-point queries.
+  void inTeslaBatch ( const GlobalPoint* gp, GlobalVector* b, unsigned int n) const override;
+
   const MagVolume * findVolume(const GlobalPoint & gp) const;
 
   bool isDefined(const GlobalPoint& gp) const override;
@@ -17,9 +17,24 @@
 #include "MagneticField/Layers/interface/MagVerbosity.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 
+#include <atomic>
+
 using namespace std;
 using namespace edm;
 
+namespace {
+  // Cache of the last volume found, one per thread to avoid sharing (and thrashing)
+  // a single cache between concurrent streams. The cache is tagged with the id of
+  // the owning MagGeometry so that an entry can never be used by another instance.
+  struct LastVolume {
+    unsigned int cacheId = 0;
+    MagVolume const* volume = nullptr;
+  };
+  thread_local LastVolume lastVolume;
+
+  std::atomic<unsigned int> nextCacheId{1};
+}
+
 MagGeometry::MagGeometry(int geomVersion, const std::vector<MagBLayer *>& tbl,
 			 const std::vector<MagESector *>& tes,
 			 const std::vector<MagVolume6Faces*>& tbv,
@@ -31,7 +46,7 @@ MagGeometry::MagGeometry(int geomVersion, const std::vector<MagBLayer const*>& t
 			 const std::vector<MagESector const*>& tes,
 			 const std::vector<MagVolume6Faces const*>& tbv,
 			 const std::vector<MagVolume6Faces const*>& tev) : 
-  lastVolume(nullptr), theBLayers(tbl), theESectors(tes), theBVolumes(tbv), theEVolumes(tev), cacheLastVolume(true), geometryVersion(geomVersion)
+  theCacheId(nextCacheId++), theBLayers(tbl), theESectors(tes), theBVolumes(tbv), theEVolumes(tev), cacheLastVolume(true), geometryVersion(geomVersion)
 {
   vector<double> rBorders;
 
@@ -76,10 +91,14 @@ MagGeometry::~MagGeometry(){
 
 // Return field vector at the specified global point
 GlobalVector MagGeometry::fieldInTesla(const GlobalPoint & gp) const {
-  MagVolume const * v = nullptr;
+  return fieldInVolume(gp, findVolume(gp));
+}
 
-  
-  v = findVolume(gp);
+GlobalVector MagGeometry::fieldInTesla(const GlobalPoint & gp, MagVolume const* & hint) const {
+  return fieldInVolume(gp, findVolume(gp, hint));
+}
+
+GlobalVector MagGeometry::fieldInVolume(const GlobalPoint & gp, MagVolume const * v) const {
   if (v!=nullptr) {
     return v->fieldInTesla(gp);
   }
@@ -132,15 +151,39 @@ MagGeometry::findVolume1(const GlobalPoint & gp, double tolerance) const {
   return found;
 }
 
-// Use hierarchical structure for fast lookup.
 MagVolume const* 
 MagGeometry::findVolume(const GlobalPoint & gp, double tolerance) const{
-  // Check volume cache
-  auto lastVolumeCheck = lastVolume.load(std::memory_order_acquire);
-  if (lastVolumeCheck!=nullptr && lastVolumeCheck->inside(gp)){
-    return lastVolumeCheck;
+  // Check the volume cache of this thread
+  auto & cache = lastVolume;
+  if (cacheLastVolume) {
+    if (cache.cacheId == theCacheId && cache.volume!=nullptr && cache.volume->inside(gp)){
+      return cache.volume;
+    }
+  }
+
+  MagVolume const* result = searchVolume(gp, tolerance);
+
+  if (cacheLastVolume) {
+    cache.cacheId = theCacheId;
+    cache.volume = result;
   }
 
+  return result;
+}
+
+
+MagVolume const* 
+MagGeometry::findVolume(const GlobalPoint & gp, MagVolume const* & hint, double tolerance) const{
+  if (hint!=nullptr && hint->inside(gp)) return hint;
+  MagVolume const* result = searchVolume(gp, tolerance);
+  if (result!=nullptr) hint = result;
+  return result;
+}
+
+
+// Use hierarchical structure for fast lookup.
+MagVolume const* 
+MagGeometry::searchVolume(const GlobalPoint & gp, double tolerance) const{
   MagVolume const* result=nullptr;
   if (inBarrel(gp)) { // Barrel
     double R = gp.perp();
@@ -172,11 +215,9 @@ MagGeometry::findVolume(const GlobalPoint & gp, double tolerance) const{
     // This is a hack for thin gaps on air-iron boundaries,
     // which will not be present anymore once surfaces are matched.
     if (verbose::debugOut) cout << "Increasing the tolerance to 0.03" <<endl;
-    result = findVolume(gp, 0.03);
+    result = searchVolume(gp, 0.03);
   }
 
-  if (cacheLastVolume) lastVolume.store(result,std::memory_order_release);
-
   return result;
 }
 
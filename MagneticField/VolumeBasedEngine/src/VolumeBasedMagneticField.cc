@@ -56,6 +56,15 @@ GlobalVector VolumeBasedMagneticField::inTeslaUnchecked(const GlobalPoint& gp) c
   return field->fieldInTesla(gp);
 }
 
+void VolumeBasedMagneticField::inTeslaBatch(const GlobalPoint* gp, GlobalVector* b, unsigned int n) const {
+  const MagVolume * hint = nullptr;
+  for (unsigned int i=0; i<n; ++i) {
+    if (paramField && paramField->isDefined(gp[i])) b[i] = paramField->inTeslaUnchecked(gp[i]);
+    else if (!isDefined(gp[i])) b[i] = GlobalVector();
+    else b[i] = field->fieldInTesla(gp[i], hint);
+  }
+}
+
 
 const MagVolume * VolumeBasedMagneticField::findVolume(const GlobalPoint & gp) const
 {
@@ -9,6 +9,7 @@
 #include "DataFormats/Provenance/interface/EventID.h"
 #include "FWCore/Framework/interface/EventPrincipal.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "Mixing/Base/interface/PileUpEventPool.h"
 
 #include "TRandom.h"
 #include "TFile.h"
@@ -63,6 +64,7 @@ namespace edm {
     }
     void dropUnwantedBranches(std::vector<std::string> const& wantedBranches) {
       input_->dropUnwantedBranches(wantedBranches);
+      wantedBranches_ = wantedBranches;
     }
     void beginStream(edm::StreamID);
     void endStream();
@@ -91,6 +93,8 @@ namespace edm {
     std::unique_ptr<CLHEP::RandPoissonQ> const& poissonDistribution(StreamID const& streamID);
     std::unique_ptr<CLHEP::RandPoisson> const& poissonDistr_OOT(StreamID const& streamID);
     CLHEP::HepRandomEngine* randomEngine(StreamID const& streamID);
+    bool poolReady();
+    void readFromPool(CLHEP::HepRandomEngine* engine, int i);
 
     unsigned int  inputType_;
     std::string type_;
@@ -118,6 +122,11 @@ namespace edm {
     int maxBunch_cosmics_;
 
     size_t fileNameHash_;
+    ParameterSet const pset_;
+    std::vector<std::string> wantedBranches_;
+    std::shared_ptr<PileUpEventPool> pool_;
+    PileUpEventPool::Reader poolReader_;
+    std::vector<size_t> poolIndices_;
     std::shared_ptr<ProductRegistry> productRegistry_;
     std::unique_ptr<VectorInputSource> const input_;
     std::shared_ptr<ProcessConfiguration> processConfiguration_;
@@ -140,6 +149,12 @@ namespace edm {
 
     // sequential reading
     bool sequential_;
+
+    // shared in-memory event pool
+    unsigned int poolMaxEvents_;
+    unsigned int poolMaxMemoryMB_;
+    unsigned int poolLoaders_;
+    bool poolWait_;
   };
 
 
@@ -170,6 +185,11 @@ namespace edm {
    *
    *  The "signal" event is optionally used to restrict 
    *  the secondary events used for pileup and mixing.
+   *  With an event pool, the events are drawn from the pool instead. By default
+   *  the first read waits for the pool to be loaded, so that the mixed events
+   *  depend on the seeds only; with eventPoolWait=false they are read from the
+   *  files until then, and the event where mixing switches to the pool depends
+   *  on the loading time.
    */
   template<typename T>
   void
@@ -182,7 +202,14 @@ namespace edm {
     RecordEventID<T> recorder(ids,eventOperator);
     int read = 0;
     CLHEP::HepRandomEngine* engine = (sequential_ ? nullptr : randomEngine(streamID));
-    read = input_->loopOverEvents(*eventPrincipal_, fileNameHash_, pileEventCnt, recorder, engine, &signal);
+    if (poolReady()) {
+      for (; read < pileEventCnt; ++read) {
+        readFromPool(engine, read);
+        recorder(*eventPrincipal_, fileNameHash_);
+      }
+    } else {
+      read = input_->loopOverEvents(*eventPrincipal_, fileNameHash_, pileEventCnt, recorder, engine, &signal);
+    }
     if (read != pileEventCnt)
       edm::LogWarning("PileUp") << "Could not read enough pileup events: only " << read << " out of " << pileEventCnt << " requested.";
   }
@@ -0,0 +1,130 @@
+#ifndef Mixing_Base_PileUpEventPool_h
+#define Mixing_Base_PileUpEventPool_h
+
+/** \class edm::PileUpEventPool
+ *
+ * In-memory pool of secondary events, shared by all the streams mixing from
+ * the same input. Each event is kept as its auxiliary data, its provenance
+ * and one uncompressed ROOT streamer buffer per product, so that using an
+ * event costs a deserialization from memory instead of a read and a
+ * decompression from disk. Every use deserializes fresh products: the
+ * in-place adjustments done by the MixingModule never touch the pool.
+ *
+ * The pool is loaded in the background by several loaders, run as tasks of
+ * the framework's TBB arena. Each loader reads a disjoint subset of the input
+ * files with its own share of the event and memory budgets, in the same way
+ * as random secondary reading: from a random entry of a random file, then
+ * sequentially. The loaders' engines are seeded from the seed of the mixing
+ * module, so that the pool content depends on that seed only: jobs with
+ * different seeds get different pools, a rerun with the same seed the same.
+ */
+
+#include "DataFormats/Provenance/interface/BranchID.h"
+#include "DataFormats/Provenance/interface/BranchListIndex.h"
+#include "DataFormats/Provenance/interface/EventAuxiliary.h"
+#include "DataFormats/Provenance/interface/EventSelectionID.h"
+#include "DataFormats/Provenance/interface/ProcessHistoryRegistry.h"
+#include "DataFormats/Provenance/interface/ProductProvenance.h"
+#include "DataFormats/Provenance/interface/ProductProvenanceRetriever.h"
+#include "FWCore/Framework/interface/DelayedReader.h"
+
+#include "tbb/task_group.h"
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class TClass;
+
+namespace edm {
+  class EventPrincipal;
+  class ParameterSet;
+
+  class PileUpEventPool {
+  public:
+    struct Product {
+      BranchID branchID;
+      TClass* type;
+      int offsetToWrapperBase;
+      std::vector<char> buffer;
+    };
+
+    struct Event {
+      EventAuxiliary aux;
+      EventSelectionIDVector eventSelectionIDs;
+      BranchListIndexes branchListIndexes;
+      std::vector<ProductProvenance> provenance;
+      std::vector<Product> products;  // sorted by BranchID
+      size_t fileNameHash;
+    };
+
+    /// DelayedReader serving the products of one pool event; one per EventPrincipal
+    class Reader : public DelayedReader {
+    public:
+      Reader();
+      ~Reader() override;
+
+      ProductProvenanceRetriever const& setEvent(Event const& event);
+
+      signalslot::Signal<void(StreamContext const&, ModuleCallingContext const&)> const* preEventReadFromSourceSignal() const override { return nullptr; }
+      signalslot::Signal<void(StreamContext const&, ModuleCallingContext const&)> const* postEventReadFromSourceSignal() const override { return nullptr; }
+
+    private:
+      std::unique_ptr<WrapperBase> getProduct_(BranchID const& k, EDProductGetter const* ep) override;
+      void mergeReaders_(DelayedReader*) override {}
+      void reset_() override {}
+
+      Event const* event_;
+      ProductProvenanceRetriever retriever_;
+    };
+
+    PileUpEventPool(ParameterSet const& pset, std::vector<std::string> const& wantedBranches,
+                    unsigned int maxEvents, unsigned int maxMemoryMB, unsigned int nLoaders, std::uint32_t seed);
+    ~PileUpEventPool();
+
+    /// pool shared by all the users of the same secondary input, branches and seed; starts loading on first use
+    static std::shared_ptr<PileUpEventPool> get(ParameterSet const& pset, std::vector<std::string> const& wantedBranches,
+                                                unsigned int maxEvents, unsigned int maxMemoryMB, unsigned int nLoaders,
+                                                std::uint32_t seed);
+
+    /// true once the pool is loaded, never blocks; rethrows the exception of a failed loader
+    bool ready() const;
+
+    /// block until the pool is loaded, running loader tasks meanwhile; rethrows the exception of a failed loader
+    void wait();
+
+    size_t size() const { return events_.size(); }
+    Event const& event(size_t i) const { return events_[i]; }
+
+    /// fill the (cleared) EventPrincipal with event i, served through reader
+    void fill(EventPrincipal& cache, size_t i, Reader& reader) const;
+
+  private:
+    struct LoaderResult {
+      std::vector<Event> events;
+      std::vector<ProcessHistory> processHistories;
+      size_t bytes = 0;
+      std::exception_ptr exception;
+    };
+
+    void merge();
+
+    std::vector<LoaderResult> results_;  // one per loader
+    std::atomic<unsigned int> running_;
+    std::atomic<bool> stop_;
+    std::atomic<bool> loaded_;
+    std::exception_ptr exception_;
+    std::mutex waitMutex_;
+    tbb::task_group loaders_;
+
+    // filled by the last loader to finish, read only once loaded_ is set
+    std::vector<Event> events_;
+    ProcessHistoryRegistry processHistoryRegistry_;
+  };
+}
+
+#endif
@@ -26,6 +26,7 @@
 #include "CondFormats/DataRecord/interface/MixingRcd.h"
 #include "CondFormats/RunInfo/interface/MixingModuleConfig.h"
 
+#include "CLHEP/Random/RandFlat.h"
 #include "CLHEP/Random/RandPoissonQ.h"
 #include "CLHEP/Random/RandPoisson.h"
 
@@ -75,6 +76,11 @@ namespace edm {
     fixed_(type_ == "fixed"),
     none_(type_ == "none"),
     fileNameHash_(0U),
+    pset_(pset),
+    wantedBranches_(),
+    pool_(),
+    poolReader_(),
+    poolIndices_(),
     productRegistry_(new SignallingProductRegistry),
     input_(VectorInputSourceFactory::get()->makeVectorInputSource(pset, VectorInputSourceDescription(
                                                                    productRegistry_, edm::PreallocationConfiguration())).release()),
@@ -88,7 +94,11 @@ namespace edm {
     PoissonDistr_OOT_(),
     randomEngine_(),
     playback_(config->playback_),
-    sequential_(pset.getUntrackedParameter<bool>("sequential", false)) {
+    sequential_(pset.getUntrackedParameter<bool>("sequential", false)),
+    poolMaxEvents_(pset.getUntrackedParameter<unsigned int>("eventPoolMaxEvents", 0U)),
+    poolMaxMemoryMB_(pset.getUntrackedParameter<unsigned int>("eventPoolMaxMemoryMB", 2048U)),
+    poolLoaders_(pset.getUntrackedParameter<unsigned int>("eventPoolLoaders", 4U)),
+    poolWait_(pset.getUntrackedParameter<bool>("eventPoolWait", true)) {
 
     // Use the empty parameter set for the parameter set ID of our "@MIXING" process.
     processConfiguration_->setParameterSetID(ParameterSet::emptyParameterSetID());
@@ -183,6 +193,17 @@ namespace edm {
       provider_->beginJob(*productRegistry_);
       provider_->beginStream(iID, *streamContext_);
     }
+
+    // the pool replaces random reading only: it needs the wanted branches, known by now
+    if (poolMaxEvents_ > 0) {
+      if (playback_ || sequential_ || provider_.get() != nullptr || pset_.getUntrackedParameter<bool>("sameLumiBlock", false)) {
+        edm::LogWarning("MixingModule") << "The pileup event pool is not used with playback, sequential or same-lumi reading, nor with pileup producers";
+      } else {
+        // the pool content is drawn with the seed of the mixing module, the same for all its streams
+        Service<RandomNumberGenerator> rng;
+        pool_ = PileUpEventPool::get(pset_, wantedBranches_, poolMaxEvents_, poolMaxMemoryMB_, poolLoaders_, rng->mySeed());
+      }
+    }
   }
 
   void PileUp::endStream () {
@@ -348,6 +369,35 @@ namespace edm {
     return randomEngine_;
   }
 
+  bool PileUp::poolReady() {
+    if (!pool_) return false;
+    if (poolWait_) {
+      pool_->wait();
+      return true;
+    }
+    return pool_->ready();
+  }
+
+  void PileUp::readFromPool(CLHEP::HepRandomEngine* engine, int i) {
+    size_t n = pool_->size();
+    if (poolIndices_.size() != n) {
+      poolIndices_.resize(n);
+      for (size_t k = 0; k < n; ++k) poolIndices_[k] = k;
+    }
+    // partial Fisher-Yates shuffle: no event is used twice in one call unless more are requested than the pool holds
+    size_t k = i % n;
+    if (i == int(n)) {
+      edm::LogWarning("PileUp") << "Pileup event pool of " << n << " events is too small: events are reused in the same bunch crossing";
+    }
+    size_t j = k + CLHEP::RandFlat::shootInt(engine, n - k);
+    std::swap(poolIndices_[k], poolIndices_[j]);
+
+    size_t index = poolIndices_[k];
+    eventPrincipal_->clearEventPrincipal();
+    pool_->fill(*eventPrincipal_, index, poolReader_);
+    fileNameHash_ = pool_->event(index).fileNameHash;
+  }
+
   void PileUp::CalculatePileup(int MinBunch, int MaxBunch, std::vector<int>& PileupSelection, std::vector<float>& TrueNumInteractions, StreamID const& streamID) {
 
     // if we are managing the distribution of out-of-time pileup separately, select the distribution for bunch
@@ -0,0 +1,289 @@
+#include "Mixing/Base/interface/PileUpEventPool.h"
+#include "DataFormats/Common/interface/RefCoreStreamer.h"
+#include "DataFormats/Common/interface/WrapperBase.h"
+#include "DataFormats/Provenance/interface/BranchIDListHelper.h"
+#include "DataFormats/Provenance/interface/ProcessConfiguration.h"
+#include "DataFormats/Provenance/interface/ThinnedAssociationsHelper.h"
+#include "FWCore/Framework/interface/EventPrincipal.h"
+#include "FWCore/Framework/src/SignallingProductRegistry.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ServiceRegistry/interface/ServiceRegistry.h"
+#include "FWCore/Sources/interface/VectorInputSource.h"
+#include "FWCore/Sources/interface/VectorInputSourceDescription.h"
+#include "FWCore/Sources/interface/VectorInputSourceFactory.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/Utilities/interface/GetPassID.h"
+#include "FWCore/Utilities/interface/getAnyPtr.h"
+#include "FWCore/Version/interface/GetReleaseVersion.h"
+
+#include "CLHEP/Random/MixMaxRng.h"
+
+#include "TBufferFile.h"
+#include "TClass.h"
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <set>
+#include <utility>
+
+namespace {
+
+  std::mutex poolsMutex;
+  std::map<std::string, std::weak_ptr<edm::PileUpEventPool> > pools;
+
+  bool isWanted(edm::BranchDescription const& desc, std::vector<std::string> const& wantedBranches) {
+    if (wantedBranches.empty()) return true;
+    std::string const& name = desc.branchName();
+    for (auto const& wanted : wantedBranches) {
+      if (name.size() > wanted.size() && name.compare(0, wanted.size(), wanted) == 0 && name[wanted.size()] == '_') return true;
+    }
+    return false;
+  }
+
+  // read the events of one subset of the files as random secondary reading does (from a random entry of a
+  // random file, then sequentially), keeping the wanted products as streamer buffers; an event read again
+  // is skipped, and the loader stops once it has read as many events again as it holds
+  template <typename Result>
+  void loadEvents(edm::ParameterSet const& pset, std::vector<std::string> const& wantedBranches,
+                  size_t maxEvents, size_t maxBytes, CLHEP::HepRandomEngine* engine,
+                  std::atomic<bool> const& stop, Result& result) {
+    auto productRegistry = std::make_shared<edm::SignallingProductRegistry>();
+    std::unique_ptr<edm::VectorInputSource> input(edm::VectorInputSourceFactory::get()->makeVectorInputSource(pset,
+        edm::VectorInputSourceDescription(productRegistry, edm::PreallocationConfiguration())));
+    input->dropUnwantedBranches(wantedBranches);
+    productRegistry->setFrozen();
+
+    edm::ProcessConfiguration processConfiguration(std::string("@MIXING"), edm::getReleaseVersion(), edm::getPassID());
+    processConfiguration.setParameterSetID(edm::ParameterSet::emptyParameterSetID());
+    edm::EventPrincipal cache(input->productRegistry(),
+                              std::make_shared<edm::BranchIDListHelper>(),
+                              std::make_shared<edm::ThinnedAssociationsHelper>(),
+                              processConfiguration,
+                              nullptr);
+
+    TClass* wrapperBaseTClass = TClass::GetClass("edm::WrapperBase");
+    std::map<edm::BranchID, std::pair<TClass*, int> > types;
+    size_t fileNameHash = 0U;
+    std::set<std::pair<size_t, edm::EventID> > seen;
+    size_t reread = 0;
+    input->doBeginJob();
+    while (result.events.size() < maxEvents && reread <= result.events.size() && !stop) {
+      edm::PileUpEventPool::Event event;
+      size_t eventBytes = 0;
+      bool duplicate = false;
+      auto store = [&](edm::EventPrincipal const& ep, size_t hash) {
+        if (!seen.emplace(hash, ep.id()).second) {
+          duplicate = true;
+          return;
+        }
+        event.aux = ep.aux();
+        event.eventSelectionIDs = ep.eventSelectionIDs();
+        event.branchListIndexes = ep.branchListIndexes();
+        event.fileNameHash = hash;
+        for (auto const& item : input->productRegistry()->productList()) {
+          edm::BranchDescription const& desc = item.second;
+          if (desc.branchType() != edm::InEvent || !desc.present() || !isWanted(desc, wantedBranches)) continue;
+          std::unique_ptr<edm::WrapperBase> wrapper = ep.reader()->getProduct(desc.branchID(), &ep);
+          if (!wrapper) continue;
+
+          auto type = types.find(desc.branchID());
+          if (type == types.end()) {
+            TClass* cp = TClass::GetClass(desc.wrappedName().c_str());
+            if (cp == nullptr) {
+              throw cms::Exception("PileUpEventPool") << "No dictionary for " << desc.wrappedName();
+            }
+            type = types.emplace(desc.branchID(), std::make_pair(cp, cp->GetBaseClassOffset(wrapperBaseTClass))).first;
+          }
+          TBufferFile buffer(TBuffer::kWrite);
+          if (buffer.WriteObjectAny(dynamic_cast<void const*>(wrapper.get()), type->second.first) != 1) {
+            throw cms::Exception("PileUpEventPool") << "Cannot serialize " << desc.branchName() << " of pileup event " << ep.id();
+          }
+          event.products.push_back({desc.branchID(), type->second.first, type->second.second,
+                                    std::vector<char>(buffer.Buffer(), buffer.Buffer() + buffer.Length())});
+          eventBytes += buffer.Length();
+
+          if (auto const* provenance = ep.productProvenanceRetrieverPtr()->branchIDToProvenance(desc.branchID())) {
+            event.provenance.push_back(*provenance);
+          }
+        }
+        std::sort(event.products.begin(), event.products.end(),
+                  [](edm::PileUpEventPool::Product const& a, edm::PileUpEventPool::Product const& b) { return a.branchID < b.branchID; });
+      };
+      if (input->loopOverEvents(cache, fileNameHash, 1U, store, engine, nullptr, false) == 0U) break;
+      if (duplicate) {
+        ++reread;
+        continue;
+      }
+      reread = 0;
+      if (result.bytes + eventBytes > maxBytes) break;
+      result.bytes += eventBytes;
+      result.events.push_back(std::move(event));
+    }
+    input->doEndJob();
+
+    for (auto const& history : input->processHistoryRegistry()) {
+      result.processHistories.push_back(history.second);
+    }
+  }
+
+}
+
+namespace edm {
+
+  PileUpEventPool::Reader::Reader() : event_(nullptr), retriever_(0U) {
+  }
+
+  PileUpEventPool::Reader::~Reader() {
+  }
+
+  ProductProvenanceRetriever const&
+  PileUpEventPool::Reader::setEvent(Event const& event) {
+    event_ = &event;
+    retriever_.reset();
+    for (auto const& provenance : event.provenance) {
+      retriever_.insertIntoSet(provenance);
+    }
+    return retriever_;
+  }
+
+  std::unique_ptr<WrapperBase>
+  PileUpEventPool::Reader::getProduct_(BranchID const& k, EDProductGetter const* ep) {
+    auto const& products = event_->products;
+    auto product = std::lower_bound(products.begin(), products.end(), k,
+                                    [](Product const& p, BranchID const& id) { return p.branchID < id; });
+    if (product == products.end() || product->branchID != k) {
+      return std::unique_ptr<WrapperBase>();
+    }
+
+    // the buffer is shared by all the streams: it is only read
+    TBufferFile buffer(TBuffer::kRead, product->buffer.size(), const_cast<char*>(product->buffer.data()), kFALSE);
+    setRefCoreStreamer(ep);
+    std::shared_ptr<void> refCoreStreamerGuard(nullptr, [](void*){ setRefCoreStreamer(false); });
+    void* p = buffer.ReadObjectAny(product->type);
+    if (p == nullptr) {
+      throw cms::Exception("PileUpEventPool") << "Cannot deserialize product " << k << " of pileup event " << event_->aux.id();
+    }
+    return getAnyPtr<WrapperBase>(p, product->offsetToWrapperBase);
+  }
+
+  PileUpEventPool::PileUpEventPool(ParameterSet const& pset, std::vector<std::string> const& wantedBranches,
+                                   unsigned int maxEvents, unsigned int maxMemoryMB, unsigned int nLoaders,
+                                   std::uint32_t seed)
+    : running_(0U), stop_(false), loaded_(false) {
+    std::vector<std::string> fileNames = pset.getUntrackedParameter<std::vector<std::string> >("fileNames");
+    unsigned int n = std::max(1U, std::min<unsigned int>(nLoaders, fileNames.size()));
+    size_t maxBytes = size_t(maxMemoryMB) << 20;
+    results_.resize(n);
+    running_ = n;
+
+    // loader k reads files k, k+n, ... with 1/n of the budgets and its own engine; the loader tasks
+    // are run by the threads of the framework's arena, the one beginStream is called from
+    CLHEP::MixMaxRng seeds(seed);
+    ServiceToken token = ServiceRegistry::instance().presentToken();
+    for (unsigned int k = 0; k < n; ++k) {
+      ParameterSet loaderPSet(pset);
+      std::vector<std::string> files;
+      for (size_t i = k; i < fileNames.size(); i += n) files.push_back(fileNames[i]);
+      loaderPSet.addUntrackedParameter<std::vector<std::string> >("fileNames", files);
+      loaderPSet.addUntrackedParameter<bool>("sequential", false);
+      loaderPSet.addUntrackedParameter<bool>("sameLumiBlock", false);
+      size_t events = maxEvents/n + (k < maxEvents%n ? 1 : 0);
+      std::uint32_t loaderSeed = static_cast<std::uint32_t>(seeds);
+      loaders_.run([this, k, token, loaderPSet, wantedBranches, events, maxBytes, n, loaderSeed]() {
+          ServiceRegistry::Operate operate(token);
+          try {
+            CLHEP::MixMaxRng engine(loaderSeed);
+            loadEvents(loaderPSet, wantedBranches, events, maxBytes/n, &engine, stop_, results_[k]);
+          } catch (...) {
+            results_[k].exception = std::current_exception();
+          }
+          if (--running_ == 0U) merge();
+        });
+    }
+  }
+
+  PileUpEventPool::~PileUpEventPool() {
+    // never leave a loader running on a destroyed pool
+    stop_ = true;
+    loaders_.wait();
+  }
+
+  std::shared_ptr<PileUpEventPool>
+  PileUpEventPool::get(ParameterSet const& pset, std::vector<std::string> const& wantedBranches,
+                       unsigned int maxEvents, unsigned int maxMemoryMB, unsigned int nLoaders, std::uint32_t seed) {
+    std::string key = pset.dump();
+    for (auto const& wanted : wantedBranches) key += ' ' + wanted;
+    key += ' ' + std::to_string(maxEvents) + ' ' + std::to_string(maxMemoryMB) + ' ' + std::to_string(nLoaders)
+      + ' ' + std::to_string(seed);
+
+    std::lock_guard<std::mutex> guard(poolsMutex);
+    // forget the pools no module uses any more
+    for (auto it = pools.begin(); it != pools.end();) {
+      if (it->second.expired()) it = pools.erase(it);
+      else ++it;
+    }
+    std::shared_ptr<PileUpEventPool> pool = pools[key].lock();
+    if (!pool) {
+      pool = std::make_shared<PileUpEventPool>(pset, wantedBranches, maxEvents, maxMemoryMB, nLoaders, seed);
+      pools[key] = pool;
+    }
+    return pool;
+  }
+
+  // run by the last loader to finish: the results are merged in loader order, independently of timing
+  void
+  PileUpEventPool::merge() {
+    size_t bytes = 0;
+    for (auto& result : results_) {
+      if (result.exception && !exception_) exception_ = result.exception;
+      for (auto const& history : result.processHistories) {
+        processHistoryRegistry_.registerProcessHistory(history);
+      }
+      std::move(result.events.begin(), result.events.end(), std::back_inserter(events_));
+      bytes += result.bytes;
+    }
+    results_.clear();
+
+    if (!exception_ && events_.empty() && !stop_) {
+      cms::Exception e("PileUpEventPool");
+      e << "No pileup event could be loaded in the event pool";
+      exception_ = std::make_exception_ptr(e);
+    }
+    if (!exception_) {
+      edm::LogInfo("PileUpEventPool") << "Loaded " << events_.size() << " pileup events (" << (bytes >> 20)
+                                      << " MB of products)";
+    }
+    loaded_.store(true, std::memory_order_release);
+  }
+
+  bool
+  PileUpEventPool::ready() const {
+    if (!loaded_.load(std::memory_order_acquire)) return false;
+    if (exception_) std::rethrow_exception(exception_);
+    return true;
+  }
+
+  void
+  PileUpEventPool::wait() {
+    if (!loaded_.load(std::memory_order_acquire)) {
+      std::lock_guard<std::mutex> guard(waitMutex_);
+      loaders_.wait();
+    }
+    ready();
+  }
+
+  void
+  PileUpEventPool::fill(EventPrincipal& cache, size_t i, Reader& reader) const {
+    Event const& event = events_[i];
+    ProductProvenanceRetriever const& retriever = reader.setEvent(event);
+    cache.fillEventPrincipal(event.aux,
+                             processHistoryRegistry_,
+                             EventSelectionIDVector(event.eventSelectionIDs),
+                             BranchListIndexes(event.branchListIndexes),
+                             retriever,
+                             &reader);
+  }
+}
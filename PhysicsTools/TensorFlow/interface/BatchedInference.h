@@ -0,0 +1,93 @@
+/*
+ * Cross-event batching of TensorFlow evaluations.
+ * Requests submitted by the stream modules of a graph (e.g. from acquire() of an ExternalWork
+ * module) are queued and coalesced along their first (batch) dimension into a single session run,
+ * which is done by a dedicated thread once maxBatchSize entries are queued or the oldest request
+ * has waited for maxLatency. The waiting tasks of the requests are released when their outputs are
+ * ready, so that the streams are never blocked while waiting for a batch to fill.
+ */
+
+#ifndef PHYSICSTOOLS_TENSORFLOW_BATCHEDINFERENCE_H
+#define PHYSICSTOOLS_TENSORFLOW_BATCHEDINFERENCE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "FWCore/Concurrency/interface/WaitingTaskWithArenaHolder.h"
+#include "PhysicsTools/TensorFlow/interface/TensorFlow.h"
+
+namespace tensorflow
+{
+
+class BatchedInference
+{
+public:
+    // one evaluation, owned by the caller until its waiting task is released
+    // all inputs have the same first dimension, the batch size of the request, and the outputs are
+    // the slices of the batch outputs that belong to the request
+    struct Request
+    {
+        std::vector<Tensor> inputs;
+        std::vector<Tensor> outputs;
+    };
+
+    // creates a session for graphDef with sessionOptions; constantInputs (e.g. learning phase
+    // flags) are fed unchanged to every run, after the batched inputs named inputNames
+    BatchedInference(const std::string& name, GraphDef* graphDef, SessionOptions& sessionOptions,
+        const std::vector<std::string>& inputNames, const NamedTensorList& constantInputs,
+        const std::vector<std::string>& outputNames, unsigned int maxBatchSize,
+        std::chrono::microseconds maxLatency);
+
+    // runs the requests that are still queued, stops the thread and closes the session
+    ~BatchedInference();
+
+    BatchedInference(const BatchedInference&) = delete;
+    BatchedInference& operator=(const BatchedInference&) = delete;
+
+    // queues a request; holder is released, with the exception of the run if it failed, when
+    // request->outputs are filled
+    void submit(Request* request, edm::WaitingTaskWithArenaHolder holder);
+
+    // logs the histogram of the number of entries per run
+    void report() const;
+
+private:
+    struct Pending
+    {
+        Request* request;
+        edm::WaitingTaskWithArenaHolder holder;
+        std::chrono::steady_clock::time_point time;
+    };
+
+    void serverDoWork();
+    void evaluate(std::vector<Pending>& batch, int64 batchSize);
+
+    const std::string name_;
+    Session* session_;
+    NamedTensorList inputs_;
+    const std::vector<std::string> outputNames_;
+    const int64 maxBatchSize_;
+    const std::chrono::microseconds maxLatency_;
+
+    std::deque<Pending> queue_;
+    int64 queued_;
+    bool stop_;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::unique_ptr<std::thread> thread_;
+
+    // only touched by the server thread, read at the end of the job
+    std::vector<unsigned long> histogram_;
+    unsigned long nRequests_;
+    unsigned long nEntries_;
+};
+
+} // namespace tensorflow
+
+#endif // PHYSICSTOOLS_TENSORFLOW_BATCHEDINFERENCE_H
@@ -19,6 +19,8 @@
 
 #include "FWCore/Utilities/interface/Exception.h"
 
+#include <memory>
+
 namespace tensorflow
 {
 
@@ -70,16 +72,26 @@ Session* createSession(MetaGraphDef* metaGraph, const std::string& exportDir, in
 
 // return a new session that will contain an already loaded graph def, sessionOptions are predefined
 // transfers ownership
-Session* createSession(GraphDef* graphDef, SessionOptions& sessionOptions);
+Session* createSession(const GraphDef* graphDef, SessionOptions& sessionOptions);
 
 // return a new session that will contain an already loaded graph def, threading options are
 // inferred from nThreads
 // transfers ownership
-Session* createSession(GraphDef* graphDef, int nThreads = 1);
+Session* createSession(const GraphDef* graphDef, int nThreads = 1);
 
 // closes a session, calls its destructor, resets the pointer, and returns true on success
 bool closeSession(Session*& session);
 
+// returns the graph def saved as a protobuf file at pbFile, which is loaded once per process and
+// shared by all callers for as long as one of them holds it
+std::shared_ptr<const GraphDef> loadSharedGraphDef(const std::string& pbFile);
+
+// returns a session containing the graph def saved at pbFile, which is created once per process
+// and shared by all callers for as long as one of them holds it, so that the constants of the
+// graph are held in memory only once; the session schedules its operations as tasks in the TBB
+// arena of the framework (the "tbb" thread pool) and can be run concurrently from all streams
+std::shared_ptr<Session> getSharedSession(const std::string& pbFile);
+
 // run the session with inputs, outputNames and targetNodes, and store output tensors
 // throws a cms exception when not successful
 void run(Session* session, const NamedTensorList& inputs,
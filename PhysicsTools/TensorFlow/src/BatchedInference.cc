@@ -0,0 +1,217 @@
+/*
+ * Cross-event batching of TensorFlow evaluations.
+ */
+
+#include "PhysicsTools/TensorFlow/interface/BatchedInference.h"
+
+#include <algorithm>
+#include <exception>
+#include <sstream>
+
+#include "tensorflow/core/framework/tensor_util.h"
+
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+
+namespace tensorflow
+{
+
+BatchedInference::BatchedInference(const std::string& name, GraphDef* graphDef,
+    SessionOptions& sessionOptions, const std::vector<std::string>& inputNames,
+    const NamedTensorList& constantInputs, const std::vector<std::string>& outputNames,
+    unsigned int maxBatchSize, std::chrono::microseconds maxLatency)
+    : name_(name)
+    , session_(createSession(graphDef, sessionOptions))
+    , outputNames_(outputNames)
+    , maxBatchSize_(std::max(1U, maxBatchSize))
+    , maxLatency_(maxLatency)
+    , queued_(0)
+    , stop_(false)
+    , histogram_(maxBatchSize_ + 2, 0)
+    , nRequests_(0)
+    , nEntries_(0)
+{
+    // the batched inputs first, then the constant ones
+    for (const auto& inputName : inputNames)
+    {
+        inputs_.emplace_back(inputName, Tensor());
+    }
+    inputs_.insert(inputs_.end(), constantInputs.begin(), constantInputs.end());
+
+    thread_ = std::make_unique<std::thread>([this]() { serverDoWork(); });
+}
+
+BatchedInference::~BatchedInference()
+{
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        stop_ = true;
+    }
+    cond_.notify_one();
+    thread_->join();
+
+    closeSession(session_);
+}
+
+void BatchedInference::submit(Request* request, edm::WaitingTaskWithArenaHolder holder)
+{
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        queue_.push_back({ request, std::move(holder), std::chrono::steady_clock::now() });
+        queued_ += request->inputs.front().dim_size(0);
+    }
+    cond_.notify_one();
+}
+
+void BatchedInference::serverDoWork()
+{
+    std::unique_lock<std::mutex> lk(mutex_);
+    while (true)
+    {
+        if (queue_.empty())
+        {
+            if (stop_)
+            {
+                return;
+            }
+            cond_.wait(lk);
+            continue;
+        }
+
+        // wait for the batch to fill up, at most until the oldest request is maxLatency old
+        if (queued_ < maxBatchSize_ && !stop_)
+        {
+            auto deadline = queue_.front().time + maxLatency_;
+            if (cond_.wait_until(lk, deadline) == std::cv_status::no_timeout)
+            {
+                continue;
+            }
+        }
+
+        // take whole requests up to maxBatchSize entries; a larger request is run on its own
+        std::vector<Pending> batch;
+        int64 batchSize = 0;
+        while (!queue_.empty())
+        {
+            int64 size = queue_.front().request->inputs.front().dim_size(0);
+            if (!batch.empty() && batchSize + size > maxBatchSize_)
+            {
+                break;
+            }
+            batch.push_back(std::move(queue_.front()));
+            queue_.pop_front();
+            batchSize += size;
+        }
+        queued_ -= batchSize;
+
+        // let the streams queue further requests while this batch is evaluated
+        lk.unlock();
+        evaluate(batch, batchSize);
+        lk.lock();
+    }
+}
+
+void BatchedInference::evaluate(std::vector<Pending>& batch, int64 batchSize)
+{
+    ++histogram_[std::min(batchSize, maxBatchSize_ + 1)];
+    nRequests_ += batch.size();
+    nEntries_ += batchSize;
+
+    std::exception_ptr exceptionPtr;
+    try
+    {
+        // a single request is fed as it is, otherwise its inputs are concatenated
+        for (size_t i = 0; i < batch.front().request->inputs.size(); i++)
+        {
+            if (batch.size() == 1)
+            {
+                inputs_[i].second = batch.front().request->inputs[i];
+                continue;
+            }
+            std::vector<Tensor> slices;
+            slices.reserve(batch.size());
+            for (const auto& pending : batch)
+            {
+                slices.push_back(pending.request->inputs[i]);
+            }
+            Status status = tensor::Concat(slices, &inputs_[i].second);
+            if (!status.ok())
+            {
+                throw cms::Exception("InvalidBatch")
+                    << "error while batching input '" << inputs_[i].first << "' of " << name_
+                    << ": " << status.ToString();
+            }
+        }
+
+        std::vector<Tensor> outputs;
+        run(session_, inputs_, outputNames_, &outputs);
+
+        // hand each request the rows of the outputs that belong to it
+        if (batch.size() == 1)
+        {
+            batch.front().request->outputs = std::move(outputs);
+        }
+        else
+        {
+            std::vector<int64> sizes;
+            sizes.reserve(batch.size());
+            for (const auto& pending : batch)
+            {
+                sizes.push_back(pending.request->inputs.front().dim_size(0));
+                pending.request->outputs.clear();
+            }
+            for (const auto& output : outputs)
+            {
+                std::vector<Tensor> slices;
+                Status status = tensor::Split(output, sizes, &slices);
+                if (!status.ok())
+                {
+                    throw cms::Exception("InvalidBatch")
+                        << "error while splitting the outputs of " << name_ << ": "
+                        << status.ToString();
+                }
+                for (size_t j = 0; j < batch.size(); j++)
+                {
+                    batch[j].request->outputs.push_back(std::move(slices[j]));
+                }
+            }
+        }
+    }
+    catch (...)
+    {
+        exceptionPtr = std::current_exception();
+    }
+
+    // release the references to the input tensors of the requests before handing them back
+    for (size_t i = 0; i < batch.front().request->inputs.size(); i++)
+    {
+        inputs_[i].second = Tensor();
+    }
+    for (auto& pending : batch)
+    {
+        pending.holder.doneWaiting(exceptionPtr);
+    }
+}
+
+void BatchedInference::report() const
+{
+    unsigned long nRuns = 0;
+    std::ostringstream bins;
+    for (size_t n = 0; n < histogram_.size(); n++)
+    {
+        if (histogram_[n] == 0)
+        {
+            continue;
+        }
+        nRuns += histogram_[n];
+        bins << "\n  " << (n <= size_t(maxBatchSize_) ? std::to_string(n) : "> " + std::to_string(maxBatchSize_))
+             << " entries: " << histogram_[n] << " runs";
+    }
+
+    edm::LogInfo("BatchedInference")
+        << name_ << ": " << nRequests_ << " requests evaluated in " << nRuns << " runs, "
+        << (nRuns > 0 ? double(nEntries_) / nRuns : 0.) << " entries per run on average"
+        << " (max batch size " << maxBatchSize_ << ", max latency " << maxLatency_.count()
+        << " us)" << bins.str();
+}
+
+} // namespace tensorflow
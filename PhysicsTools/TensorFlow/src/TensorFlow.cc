@@ -8,9 +8,22 @@
 
 #include "PhysicsTools/TensorFlow/interface/TensorFlow.h"
 
+#include <map>
+#include <mutex>
+
 namespace tensorflow
 {
 
+namespace
+{
+
+// process-wide registries of the shared graph defs and sessions, keyed by the protobuf file
+std::mutex sharedMutex;
+std::map<std::string, std::weak_ptr<const GraphDef>> sharedGraphDefs;
+std::map<std::string, std::weak_ptr<Session>> sharedSessions;
+
+} // namespace
+
 void setLogging(const std::string& level)
 {
     setenv("TF_CPP_MIN_LOG_LEVEL", level.c_str(), 0);
@@ -162,7 +175,7 @@ Session* createSession(MetaGraphDef* metaGraph, const std::string& exportDir, in
     return createSession(metaGraph, exportDir, sessionOptions);
 }
 
-Session* createSession(GraphDef* graphDef, SessionOptions& sessionOptions)
+Session* createSession(const GraphDef* graphDef, SessionOptions& sessionOptions)
 {
     // create a new, empty session
     Session* session = createSession(sessionOptions);
@@ -181,7 +194,7 @@ Session* createSession(GraphDef* graphDef, SessionOptions& sessionOptions)
     return session;
 }
 
-Session* createSession(GraphDef* graphDef, int nThreads)
+Session* createSession(const GraphDef* graphDef, int nThreads)
 {
     // create session options and set thread options
     SessionOptions sessionOptions;
@@ -207,6 +220,40 @@ bool closeSession(Session*& session)
     return status.ok();
 }
 
+std::shared_ptr<const GraphDef> loadSharedGraphDef(const std::string& pbFile)
+{
+    std::lock_guard<std::mutex> guard(sharedMutex);
+    auto& slot = sharedGraphDefs[pbFile];
+    if (auto graphDef = slot.lock())
+    {
+        return graphDef;
+    }
+    std::shared_ptr<const GraphDef> graphDef(loadGraphDef(pbFile));
+    slot = graphDef;
+    return graphDef;
+}
+
+std::shared_ptr<Session> getSharedSession(const std::string& pbFile)
+{
+    // the graph def is only needed to create the session
+    std::shared_ptr<const GraphDef> graphDef = loadSharedGraphDef(pbFile);
+
+    std::lock_guard<std::mutex> guard(sharedMutex);
+    auto& slot = sharedSessions[pbFile];
+    if (auto session = slot.lock())
+    {
+        return session;
+    }
+
+    // one thread and the tbb thread pool let the operations run in the arena of the framework
+    SessionOptions sessionOptions;
+    setThreading(sessionOptions, 1, "tbb");
+    std::shared_ptr<Session> session(createSession(graphDef.get(), sessionOptions),
+        [](Session* session) { closeSession(session); });
+    slot = session;
+    return session;
+}
+
 void run(Session* session, const NamedTensorList& inputs,
     const std::vector<std::string>& outputNames, const std::vector<std::string>& targetNodes,
     std::vector<Tensor>* outputs)
@@ -0,0 +1,294 @@
+/*
+ * Tests for the cross-event batching of TensorFlow evaluations.
+ * Uses the constant graph of createconstantgraph.py, output = (sum(input) + 1) * scale, whose
+ * first dimension is free, with scale fed as a constant input.
+ */
+
+#include <boost/filesystem.hpp>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "FWCore/Concurrency/interface/WaitingTaskList.h"
+#include "FWCore/Concurrency/interface/WaitingTaskWithArenaHolder.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "PhysicsTools/TensorFlow/interface/BatchedInference.h"
+
+std::string cmsswPath(std::string path)
+{
+    if (path.size() > 0 && path.substr(0, 1) != "/")
+    {
+        path = "/" + path;
+    }
+
+    std::string base = std::string(std::getenv("CMSSW_BASE"));
+    std::string releaseBase = std::string(std::getenv("CMSSW_RELEASE_BASE"));
+
+    return (boost::filesystem::exists(base.c_str()) ? base : releaseBase) + path;
+}
+
+class testBatchedInference : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(testBatchedInference);
+    CPPUNIT_TEST(checkThreads);
+    CPPUNIT_TEST(checkMaxBatchSize);
+    CPPUNIT_TEST(checkMaxLatency);
+    CPPUNIT_TEST(checkStop);
+    CPPUNIT_TEST(checkExceptions);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    std::string dataPath;
+    tensorflow::GraphDef* graphDef;
+
+    void setUp();
+    void tearDown();
+    void checkThreads();
+    void checkMaxBatchSize();
+    void checkMaxLatency();
+    void checkStop();
+    void checkExceptions();
+
+private:
+    std::unique_ptr<tensorflow::BatchedInference> makeBatchedInference(unsigned int maxBatchSize,
+        std::chrono::microseconds maxLatency);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(testBatchedInference);
+
+namespace
+{
+    constexpr float scale = 2.;
+
+    // rows x nColumns entries, the first of each row being first + row and the others 0
+    tensorflow::Tensor makeInput(tensorflow::int64 rows, float first, tensorflow::int64 nColumns = 10)
+    {
+        tensorflow::Tensor input(tensorflow::DT_FLOAT, { rows, nColumns });
+        auto m = input.matrix<float>();
+        for (tensorflow::int64 r = 0; r < rows; r++)
+        {
+            for (tensorflow::int64 c = 0; c < nColumns; c++)
+            {
+                m(r, c) = c == 0 ? first + r : 0.;
+            }
+        }
+        return input;
+    }
+
+    // the request has exactly its own rows of the output
+    bool hasOwnOutputs(const tensorflow::BatchedInference::Request& request, tensorflow::int64 rows,
+        float first)
+    {
+        if (request.outputs.size() != 1 || request.outputs[0].dims() != 2
+            || request.outputs[0].dim_size(0) != rows || request.outputs[0].dim_size(1) != 1)
+        {
+            return false;
+        }
+        auto m = request.outputs[0].matrix<float>();
+        for (tensorflow::int64 r = 0; r < rows; r++)
+        {
+            if (m(r, 0) != (first + r + 1.f) * scale)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // a request submitted from the calling thread, waited for with wait()
+    class Submission
+    {
+    public:
+        Submission(tensorflow::BatchedInference& batchedInference, tensorflow::int64 rows,
+            float first, tensorflow::int64 nColumns = 10)
+            : task_(edm::make_empty_waiting_task())
+        {
+            request_.inputs.push_back(makeInput(rows, first, nColumns));
+            // the holder takes the second reference: wait_for_all() returns once it is released
+            task_->set_ref_count(1);
+            batchedInference.submit(&request_, edm::WaitingTaskWithArenaHolder(task_.get()));
+        }
+
+        // the exception handed to doneWaiting, if any
+        std::exception_ptr wait()
+        {
+            task_->wait_for_all();
+            return task_->exceptionPtr() ? *task_->exceptionPtr() : std::exception_ptr();
+        }
+
+        const tensorflow::BatchedInference::Request& request() const { return request_; }
+
+    private:
+        tensorflow::BatchedInference::Request request_;
+        std::unique_ptr<edm::EmptyWaitingTask, edm::waitingtask::TaskDestroyer> task_;
+    };
+
+    double secondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+void testBatchedInference::setUp()
+{
+    dataPath = cmsswPath("/test/" + std::string(getenv("SCRAM_ARCH"))
+        + "/" + boost::filesystem::unique_path().string());
+
+    // create the graph
+    std::string testPath = cmsswPath("/src/PhysicsTools/TensorFlow/test");
+    std::string cmd = "python " + testPath + "/createconstantgraph.py " + dataPath;
+    std::array<char, 128> buffer;
+    std::string result;
+    std::shared_ptr<FILE> pipe(popen(cmd.c_str(), "r"), pclose);
+    if (!pipe)
+    {
+        throw std::runtime_error("popen() failed!");
+    }
+    while (!feof(pipe.get()))
+    {
+        if (fgets(buffer.data(), 128, pipe.get()) != NULL)
+        {
+            result += buffer.data();
+        }
+    }
+    std::cout << std::endl
+              << result << std::endl;
+
+    tensorflow::setLogging();
+    graphDef = tensorflow::loadGraphDef(dataPath + "/constantgraph.pb");
+    CPPUNIT_ASSERT(graphDef != nullptr);
+}
+
+void testBatchedInference::tearDown()
+{
+    delete graphDef;
+    if (boost::filesystem::exists(dataPath))
+    {
+        boost::filesystem::remove_all(dataPath);
+    }
+}
+
+std::unique_ptr<tensorflow::BatchedInference> testBatchedInference::makeBatchedInference(
+    unsigned int maxBatchSize, std::chrono::microseconds maxLatency)
+{
+    tensorflow::SessionOptions sessionOptions;
+    tensorflow::setThreading(sessionOptions, 1);
+    tensorflow::Tensor scaleTensor(tensorflow::DT_FLOAT, {});
+    scaleTensor.scalar<float>()() = scale;
+    return std::make_unique<tensorflow::BatchedInference>("constantgraph", graphDef,
+        sessionOptions, std::vector<std::string>{ "input" },
+        tensorflow::NamedTensorList{ { "scale", scaleTensor } }, std::vector<std::string>{ "output" },
+        maxBatchSize, maxLatency);
+}
+
+// requests of 1 to 7 rows from 8 threads, batched together and split again
+void testBatchedInference::checkThreads()
+{
+    auto batchedInference = makeBatchedInference(16, std::chrono::microseconds(2000));
+
+    constexpr int nThreads = 8;
+    constexpr int nRequests = 50;
+    std::atomic<int> nWrong(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nThreads; t++)
+    {
+        threads.emplace_back([&, t]() {
+            for (int k = 0; k < nRequests; k++)
+            {
+                tensorflow::int64 rows = 1 + (t + k) % 7;
+                float first = 1000. * t + 10. * k;
+                Submission submission(*batchedInference, rows, first);
+                if (submission.wait() || !hasOwnOutputs(submission.request(), rows, first))
+                {
+                    nWrong++;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    batchedInference->report();
+    CPPUNIT_ASSERT(nWrong == 0);
+}
+
+// a full batch is run at once: neither request is run alone before the (very long) latency
+void testBatchedInference::checkMaxBatchSize()
+{
+    auto batchedInference = makeBatchedInference(4, std::chrono::microseconds(600000000));
+    auto start = std::chrono::steady_clock::now();
+
+    // two requests of 2 rows fill the batch together, and are concatenated and split
+    Submission first(*batchedInference, 2, 100.);
+    Submission second(*batchedInference, 2, 200.);
+    CPPUNIT_ASSERT(!first.wait() && hasOwnOutputs(first.request(), 2, 100.));
+    CPPUNIT_ASSERT(!second.wait() && hasOwnOutputs(second.request(), 2, 200.));
+
+    // a request larger than the batch is run on its own
+    Submission large(*batchedInference, 6, 300.);
+    CPPUNIT_ASSERT(!large.wait() && hasOwnOutputs(large.request(), 6, 300.));
+
+    CPPUNIT_ASSERT(secondsSince(start) < 60.);
+}
+
+// a batch that does not fill up is run once its oldest request is maxLatency old
+void testBatchedInference::checkMaxLatency()
+{
+    auto batchedInference = makeBatchedInference(1000, std::chrono::microseconds(200000));
+    auto start = std::chrono::steady_clock::now();
+
+    Submission first(*batchedInference, 3, 100.);
+    Submission second(*batchedInference, 1, 200.);
+    CPPUNIT_ASSERT(!first.wait() && hasOwnOutputs(first.request(), 3, 100.));
+    CPPUNIT_ASSERT(!second.wait() && hasOwnOutputs(second.request(), 1, 200.));
+
+    double seconds = secondsSince(start);
+    CPPUNIT_ASSERT(seconds >= 0.2 && seconds < 60.);
+}
+
+// the requests still queued are run when the batching stops
+void testBatchedInference::checkStop()
+{
+    auto batchedInference = makeBatchedInference(1000, std::chrono::microseconds(600000000));
+    auto start = std::chrono::steady_clock::now();
+
+    Submission first(*batchedInference, 2, 100.);
+    Submission second(*batchedInference, 5, 200.);
+    batchedInference.reset();
+    CPPUNIT_ASSERT(!first.wait() && hasOwnOutputs(first.request(), 2, 100.));
+    CPPUNIT_ASSERT(!second.wait() && hasOwnOutputs(second.request(), 5, 200.));
+
+    CPPUNIT_ASSERT(secondsSince(start) < 60.);
+}
+
+// a failed run hands its exception to all the requests of the batch, and the next batch is fine
+void testBatchedInference::checkExceptions()
+{
+    auto batchedInference = makeBatchedInference(4, std::chrono::microseconds(600000000));
+
+    // inputs that cannot be concatenated
+    Submission first(*batchedInference, 2, 100., 10);
+    Submission second(*batchedInference, 2, 200., 5);
+    std::exception_ptr firstException = first.wait();
+    std::exception_ptr secondException = second.wait();
+    CPPUNIT_ASSERT(firstException && secondException);
+    CPPUNIT_ASSERT_THROW(std::rethrow_exception(firstException), cms::Exception);
+    CPPUNIT_ASSERT_THROW(std::rethrow_exception(secondException), cms::Exception);
+
+    // an input of the wrong shape, run on its own by the session
+    Submission wrong(*batchedInference, 4, 300., 5);
+    std::exception_ptr wrongException = wrong.wait();
+    CPPUNIT_ASSERT(wrongException);
+    CPPUNIT_ASSERT_THROW(std::rethrow_exception(wrongException), cms::Exception);
+
+    Submission good(*batchedInference, 4, 400.);
+    CPPUNIT_ASSERT(!good.wait() && hasOwnOutputs(good.request(), 4, 400.));
+}
@@ -31,6 +31,8 @@ struct DeepDoubleBTFCache {
   }
 
   std::atomic<tensorflow::GraphDef*> graphDef;
+  // with shared_session, the session of the graph shared by all streams and modules (and no graph)
+  std::shared_ptr<tensorflow::Session> session;
 };
 
 class DeepDoubleBTFJetTagsProducer : public edm::stream::EDProducer<edm::GlobalCache<DeepDoubleBTFCache>> {
@@ -70,6 +72,8 @@ class DeepDoubleBTFJetTagsProducer : public edm::stream::EDProducer<edm::GlobalC
 
     // session for TF evaluation
     tensorflow::Session* session_;
+    // owner of session_ when it is the shared one
+    std::shared_ptr<tensorflow::Session> shared_session_;
     // vector of learning phase tensors, i.e., boolean scalar tensors pointing to false
     std::vector<tensorflow::Tensor> lp_tensors_;
     // flag to evaluate model batch or jet by jet
@@ -91,8 +95,13 @@ DeepDoubleBTFJetTagsProducer::DeepDoubleBTFJetTagsProducer(const edm::ParameterS
   tensorflow::SessionOptions sessionOptions;
   tensorflow::setThreading(sessionOptions, nThreads, singleThreadPool);
 
-  // create the session using the meta graph from the cache
-  session_ = tensorflow::createSession(cache->graphDef, sessionOptions);
+  // create the session using the meta graph from the cache, unless the shared one is used
+  if (cache->session) {
+    shared_session_ = cache->session;
+    session_ = shared_session_.get();
+  } else {
+    session_ = tensorflow::createSession(cache->graphDef, sessionOptions);
+  }
 
   // get output names from flav_table
   const auto & flav_pset = iConfig.getParameter<edm::ParameterSet>("flav_table");
@@ -118,8 +127,8 @@ DeepDoubleBTFJetTagsProducer::DeepDoubleBTFJetTagsProducer(const edm::ParameterS
 
 DeepDoubleBTFJetTagsProducer::~DeepDoubleBTFJetTagsProducer()
 {
-  // close and delete the session
-  if (session_ != nullptr) {
+  // close and delete the session, unless it is shared
+  if (session_ != nullptr && !shared_session_) {
     tensorflow::closeSession(session_);
   }
 }
@@ -149,6 +158,9 @@ void DeepDoubleBTFJetTagsProducer::fillDescriptions(edm::ConfigurationDescriptio
 
   desc.add<unsigned int>("nThreads", 1);
   desc.add<std::string>("singleThreadPool", "no_threads");
+  // use the session of the graph shared by the whole process, running in the TBB arena of the
+  // framework, instead of one session per stream (nThreads and singleThreadPool are ignored)
+  desc.add<bool>("shared_session", false);
 
   descriptions.add("pfDeepDoubleBJetTags", desc);
 }
@@ -164,7 +176,11 @@ std::unique_ptr<DeepDoubleBTFCache> DeepDoubleBTFJetTagsProducer::initializeGlob
 
   // load the graph def and save it in the cache
   DeepDoubleBTFCache* cache = new DeepDoubleBTFCache();
-  cache->graphDef = tensorflow::loadGraphDef(pbFile);
+  if (iConfig.getParameter<bool>("shared_session")) {
+    cache->session = tensorflow::getSharedSession(pbFile);
+  } else {
+    cache->graphDef = tensorflow::loadGraphDef(pbFile);
+  }
 
   return std::unique_ptr<DeepDoubleBTFCache>(cache);
 }
@@ -15,6 +15,7 @@
 #include "DataFormats/BTauReco/interface/DeepFlavourTagInfo.h"
 
 #include "PhysicsTools/TensorFlow/interface/TensorFlow.h"
+#include "PhysicsTools/TensorFlow/interface/BatchedInference.h"
 
 #include "RecoBTag/TensorFlow/interface/tensor_fillers.h"
 
@@ -26,14 +27,20 @@
 // make use of a cache struct that can be extended in the future if nedded. In addition, the graph
 // is protected via std::atomic, which should not affect the performance as it is only accessed in
 // the module constructor and not in the actual produce loop.
+// When max_batch_size is set, the cache also holds the session shared by all streams, which
+// evaluates the jets of the events of several streams in common batches.
 struct DeepFlavourTFCache {
   DeepFlavourTFCache() : graphDef(nullptr) {
   }
 
   std::atomic<tensorflow::GraphDef*> graphDef;
+  // with shared_session, the session of the graph shared by all streams and modules (and no graph)
+  std::shared_ptr<tensorflow::Session> session;
+  std::unique_ptr<tensorflow::BatchedInference> batchedInference;
 };
 
-class DeepFlavourTFJetTagsProducer : public edm::stream::EDProducer<edm::GlobalCache<DeepFlavourTFCache>> {
+class DeepFlavourTFJetTagsProducer : public edm::stream::EDProducer<edm::GlobalCache<DeepFlavourTFCache>,
+                                                                    edm::ExternalWork> {
 
   public:
     explicit DeepFlavourTFJetTagsProducer(const edm::ParameterSet&, const DeepFlavourTFCache*);
@@ -62,9 +69,20 @@ class DeepFlavourTFJetTagsProducer : public edm::stream::EDProducer<edm::GlobalC
     typedef reco::JetTagCollection JetTagCollection;
 
     void beginStream(edm::StreamID) override {}
+    void acquire(const edm::Event&, const edm::EventSetup&, edm::WaitingTaskWithArenaHolder) override;
     void produce(edm::Event&, const edm::EventSetup&) override;
     void endStream() override {}
 
+    // creates the input tensors for n_batch_jets jets, without the learning phase tensors
+    tensorflow::NamedTensorList make_inputs(int64_t n_batch_jets) const;
+    // fills the input tensors with the features of the jets starting at first_jet
+    void fill_inputs(const TagInfoCollection& tag_infos, std::size_t first_jet,
+                     tensorflow::NamedTensorList& input_tensors) const;
+    // sets the flavour probabilities of the jets starting at first_jet
+    void fill_outputs(const TagInfoCollection& tag_infos, std::size_t first_jet,
+                      const tensorflow::Tensor& jet_flavour,
+                      std::vector<std::unique_ptr<JetTagCollection>>& output_tags) const;
+
     const edm::EDGetTokenT< TagInfoCollection > src_;
     std::vector<std::pair<std::string,std::vector<unsigned int>>> flav_pairs_;
     std::vector<std::string> input_names_;
@@ -73,10 +91,14 @@ class DeepFlavourTFJetTagsProducer : public edm::stream::EDProducer<edm::GlobalC
 
     // session for TF evaluation
     tensorflow::Session* session_;
+    // owner of session_ when it is the shared one
+    std::shared_ptr<tensorflow::Session> shared_session_;
     // vector of learning phase tensors, i.e., boolean scalar tensors pointing to false
     std::vector<tensorflow::Tensor> lp_tensors_;
     // flag to evaluate model batch or jet by jet
     bool batch_eval_;
+    // the jets of the current event, when evaluated by the batched inference of the cache
+    tensorflow::BatchedInference::Request request_;
 };
 
 DeepFlavourTFJetTagsProducer::DeepFlavourTFJetTagsProducer(const edm::ParameterSet& iConfig,
@@ -94,8 +116,13 @@ DeepFlavourTFJetTagsProducer::DeepFlavourTFJetTagsProducer(const edm::ParameterS
   tensorflow::SessionOptions sessionOptions;
   tensorflow::setThreading(sessionOptions, nThreads, singleThreadPool);
 
-  // create the session using the meta graph from the cache
-  session_ = tensorflow::createSession(cache->graphDef, sessionOptions);
+  // create the session using the meta graph from the cache, unless a shared one is used
+  if (cache->session) {
+    shared_session_ = cache->session;
+    session_ = shared_session_.get();
+  } else if (!cache->batchedInference) {
+    session_ = tensorflow::createSession(cache->graphDef, sessionOptions);
+  }
 
   // get output names from flav_table
   const auto & flav_pset = iConfig.getParameter<edm::ParameterSet>("flav_table");
@@ -121,8 +148,8 @@ DeepFlavourTFJetTagsProducer::DeepFlavourTFJetTagsProducer(const edm::ParameterS
 
 DeepFlavourTFJetTagsProducer::~DeepFlavourTFJetTagsProducer()
 {
-  // close and delete the session
-  if (session_ != nullptr) {
+  // close and delete the session, unless it is shared
+  if (session_ != nullptr && !shared_session_) {
     tensorflow::closeSession(session_);
   }
 }
@@ -156,6 +183,15 @@ void DeepFlavourTFJetTagsProducer::fillDescriptions(edm::ConfigurationDescriptio
 
   desc.add<unsigned int>("nThreads", 1);
   desc.add<std::string>("singleThreadPool", "no_threads");
+  // use the session of the graph shared by the whole process, running in the TBB arena of the
+  // framework, instead of one session per stream (nThreads and singleThreadPool are ignored)
+  desc.add<bool>("shared_session", false);
+
+  // evaluate the jets of several events together, in batches of up to max_batch_size jets
+  // (0 to evaluate each event on its own), waiting at most max_batch_latency seconds for a
+  // batch to fill up
+  desc.add<unsigned int>("max_batch_size", 0);
+  desc.add<double>("max_batch_latency", 0.002);
 
   descriptions.add("pfDeepFlavourJetTags", desc);
 }
@@ -171,40 +207,48 @@ std::unique_ptr<DeepFlavourTFCache> DeepFlavourTFJetTagsProducer::initializeGlob
 
   // load the graph def and save it in the cache
   DeepFlavourTFCache* cache = new DeepFlavourTFCache();
-  cache->graphDef = tensorflow::loadGraphDef(pbFile);
+  unsigned int maxBatchSize = iConfig.getParameter<unsigned int>("max_batch_size");
+  if (maxBatchSize == 0 && iConfig.getParameter<bool>("shared_session")) {
+    cache->session = tensorflow::getSharedSession(pbFile);
+  } else {
+    cache->graphDef = tensorflow::loadGraphDef(pbFile);
+  }
+
+  // a single session evaluating the jets of all streams
+  if (maxBatchSize > 0) {
+    tensorflow::SessionOptions sessionOptions;
+    tensorflow::setThreading(sessionOptions, iConfig.getParameter<unsigned int>("nThreads"),
+                             iConfig.getParameter<std::string>("singleThreadPool"));
+
+    tensorflow::NamedTensorList lp_tensors;
+    for (const auto & lp_name : iConfig.getParameter<std::vector<std::string>>("lp_names")) {
+      tensorflow::Tensor t(tensorflow::DT_BOOL, {});
+      t.scalar<bool>()() = false;
+      lp_tensors.emplace_back(lp_name, t);
+    }
+
+    auto maxLatency = std::chrono::microseconds(
+      static_cast<long>(iConfig.getParameter<double>("max_batch_latency")*1E6));
+    cache->batchedInference = std::make_unique<tensorflow::BatchedInference>(pbFile, cache->graphDef,
+      sessionOptions, iConfig.getParameter<std::vector<std::string>>("input_names"), lp_tensors,
+      iConfig.getParameter<std::vector<std::string>>("output_names"), maxBatchSize, maxLatency);
+  }
 
   return std::unique_ptr<DeepFlavourTFCache>(cache);
 }
 
 void DeepFlavourTFJetTagsProducer::globalEndJob(const DeepFlavourTFCache* cache)
 {
+  if (cache->batchedInference) {
+    cache->batchedInference->report();
+  }
   if (cache->graphDef != nullptr) {
     delete cache->graphDef;
   }
 }
 
-void DeepFlavourTFJetTagsProducer::produce(edm::Event& iEvent, const edm::EventSetup& iSetup)
+tensorflow::NamedTensorList DeepFlavourTFJetTagsProducer::make_inputs(int64_t n_batch_jets) const
 {
-
-  edm::Handle<TagInfoCollection> tag_infos;
-  iEvent.getByToken(src_, tag_infos);
-
-  // initialize output collection
-  std::vector<std::unique_ptr<JetTagCollection>> output_tags;
-  for (std::size_t i=0; i < flav_pairs_.size(); i++) {
-    if (!tag_infos->empty()) {
-      auto jet_ref = tag_infos->begin()->jet();
-      output_tags.emplace_back(std::make_unique<JetTagCollection>(
-            edm::makeRefToBaseProdFrom(jet_ref, iEvent)));
-    } else {
-      output_tags.emplace_back(std::make_unique<JetTagCollection>());
-    }
-  }
-
-  const int64_t n_jets = tag_infos->size();
-  // either all jets or one per batch for the time being
-  const int64_t n_batch_jets = batch_eval_ ?  n_jets : 1;
-
   std::vector<tensorflow::TensorShape> input_sizes {
     {n_batch_jets, 15},         // input_1 - global jet features
     {n_batch_jets, 25, 16},     // input_2 - charged pf
@@ -217,7 +261,7 @@ void DeepFlavourTFJetTagsProducer::produce(edm::Event& iEvent, const edm::EventS
   // prevent element copying that would occur via push_back's
   // the default Tensor constructor creates a scalar so this should be fine w.r.t. to memory
   tensorflow::NamedTensorList input_tensors;
-  input_tensors.resize(input_sizes.size() + lp_tensors_.size());
+  input_tensors.resize(input_sizes.size());
 
   // add actual input tensors that hold physics information
   for (std::size_t i=0; i < input_sizes.size(); i++) {
@@ -225,79 +269,157 @@ void DeepFlavourTFJetTagsProducer::produce(edm::Event& iEvent, const edm::EventS
       input_names_[i], tensorflow::Tensor(tensorflow::DT_FLOAT, input_sizes.at(i)));
   }
 
-  // add learning-phase tensors behind them
-  for (std::size_t i=0; i < lp_tensors_.size(); i++) {
-    input_tensors[input_sizes.size() + i] = tensorflow::NamedTensor(lp_names_[i], lp_tensors_[i]);
+  return input_tensors;
+}
+
+void DeepFlavourTFJetTagsProducer::fill_inputs(const TagInfoCollection& tag_infos,
+  std::size_t first_jet, tensorflow::NamedTensorList& input_tensors) const
+{
+  // tensors have to be zeroed before filling per batch
+  for (std::size_t i=kGlobal; i <= kJetPt; i++) {
+    input_tensors[i].second.flat<float>().setZero();
   }
 
-  std::size_t n_batches = n_jets/n_batch_jets; // either 1 or n_jets
-  for (std::size_t batch_n=0; batch_n < n_batches; batch_n++) {
+  // fill values of the input tensors
+  const std::size_t n_batch_jets = input_tensors.at(kGlobal).second.dim_size(0);
+  for (std::size_t jet_bn=0; jet_bn < n_batch_jets; jet_bn++) {
+
+    // global jet index (jet_bn is the jet batch index)
+    std::size_t jet_n = first_jet + jet_bn;
+
+    // jet and other global features
+    const auto & features = tag_infos.at(jet_n).features();
+    jet_tensor_filler(input_tensors.at(kGlobal).second, jet_bn, features);
 
-    // tensors have to be zeroed before filling per batch
-    for (std::size_t i=0; i < input_sizes.size(); i++) {
-      input_tensors[i].second.flat<float>().setZero();
+    // c_pf candidates
+    auto max_c_pf_n = std::min(features.c_pf_features.size(),
+      (std::size_t) input_tensors.at(kChargedCandidates).second.dim_size(1));
+    for (std::size_t c_pf_n=0; c_pf_n < max_c_pf_n; c_pf_n++) {
+      const auto & c_pf_features = features.c_pf_features.at(c_pf_n);
+      c_pf_tensor_filler(input_tensors.at(kChargedCandidates).second,
+                         jet_bn, c_pf_n, c_pf_features);
     }
 
-    // fill values of the input tensors
-    for (std::size_t jet_bn=0; jet_bn < (std::size_t) n_batch_jets; jet_bn++) {
+    // n_pf candidates
+    auto max_n_pf_n = std::min(features.n_pf_features.size(),
+      (std::size_t) input_tensors.at(kNeutralCandidates).second.dim_size(1));
+    for (std::size_t n_pf_n=0; n_pf_n < max_n_pf_n; n_pf_n++) {
+      const auto & n_pf_features = features.n_pf_features.at(n_pf_n);
+      n_pf_tensor_filler(input_tensors.at(kNeutralCandidates).second,
+                         jet_bn, n_pf_n, n_pf_features);
+    }
 
-      // global jet index (jet_bn is the jet batch index)
-      std::size_t jet_n = batch_n*n_batch_jets + jet_bn;
+    // sv candidates
+    auto max_sv_n = std::min(features.sv_features.size(),
+      (std::size_t) input_tensors.at(kVertices).second.dim_size(1));
+    for (std::size_t sv_n=0; sv_n < max_sv_n; sv_n++) {
+      const auto & sv_features = features.sv_features.at(sv_n);
+      sv_tensor_filler(input_tensors.at(kVertices).second,
+                       jet_bn, sv_n, sv_features);
+    }
 
-      // jet and other global features
-      const auto & features = tag_infos->at(jet_n).features();
-      jet_tensor_filler(input_tensors.at(kGlobal).second, jet_bn, features);
+    // last input: jet pt
+    input_tensors.at(kJetPt).second.matrix<float>()(jet_bn, 0) = features.jet_features.pt;
+  }
+}
 
-      // c_pf candidates
-      auto max_c_pf_n = std::min(features.c_pf_features.size(),
-        (std::size_t) input_sizes.at(kChargedCandidates).dim_size(1));
-      for (std::size_t c_pf_n=0; c_pf_n < max_c_pf_n; c_pf_n++) {
-        const auto & c_pf_features = features.c_pf_features.at(c_pf_n);
-        c_pf_tensor_filler(input_tensors.at(kChargedCandidates).second,
-                           jet_bn, c_pf_n, c_pf_features);
+void DeepFlavourTFJetTagsProducer::fill_outputs(const TagInfoCollection& tag_infos,
+  std::size_t first_jet, const tensorflow::Tensor& jet_flavour,
+  std::vector<std::unique_ptr<JetTagCollection>>& output_tags) const
+{
+  // set output values for flavour probs
+  const std::size_t n_batch_jets = jet_flavour.dim_size(0);
+  for (std::size_t jet_bn=0; jet_bn < n_batch_jets; jet_bn++) {
+
+    // global jet index (jet_bn is the jet batch index)
+    std::size_t jet_n = first_jet + jet_bn;
+
+    const auto & jet_ref = tag_infos.at(jet_n).jet();
+    for (std::size_t flav_n=0; flav_n < flav_pairs_.size(); flav_n++) {
+      const auto & flav_pair = flav_pairs_.at(flav_n);
+      float o_sum = 0.;
+      for (const unsigned int & ind : flav_pair.second) {
+        o_sum += jet_flavour.matrix<float>()(jet_bn, ind);
       }
+      (*(output_tags.at(flav_n)))[jet_ref] = o_sum;
+    }
+  }
+}
 
-      // n_pf candidates
-      auto max_n_pf_n = std::min(features.n_pf_features.size(),
-        (std::size_t) input_sizes.at(kNeutralCandidates).dim_size(1));
-      for (std::size_t n_pf_n=0; n_pf_n < max_n_pf_n; n_pf_n++) {
-        const auto & n_pf_features = features.n_pf_features.at(n_pf_n);
-        n_pf_tensor_filler(input_tensors.at(kNeutralCandidates).second,
-                           jet_bn, n_pf_n, n_pf_features);
-      }
+void DeepFlavourTFJetTagsProducer::acquire(const edm::Event& iEvent, const edm::EventSetup& iSetup,
+  edm::WaitingTaskWithArenaHolder holder)
+{
+  // without batching across events the jets are evaluated in produce
+  if (!globalCache()->batchedInference) {
+    return;
+  }
 
-      // sv candidates
-      auto max_sv_n = std::min(features.sv_features.size(),
-        (std::size_t) input_sizes.at(kVertices).dim_size(1));
-      for (std::size_t sv_n=0; sv_n < max_sv_n; sv_n++) {
-        const auto & sv_features = features.sv_features.at(sv_n);
-        sv_tensor_filler(input_tensors.at(kVertices).second,
-                         jet_bn, sv_n, sv_features);
-      }
+  edm::Handle<TagInfoCollection> tag_infos;
+  iEvent.getByToken(src_, tag_infos);
+  if (tag_infos->empty()) {
+    return;
+  }
+
+  // all jets of the event in one request, which is batched with those of other streams
+  tensorflow::NamedTensorList input_tensors = make_inputs(tag_infos->size());
+  fill_inputs(*tag_infos, 0, input_tensors);
+
+  request_.inputs.clear();
+  for (auto & input_tensor : input_tensors) {
+    request_.inputs.push_back(std::move(input_tensor.second));
+  }
+  globalCache()->batchedInference->submit(&request_, std::move(holder));
+}
+
+void DeepFlavourTFJetTagsProducer::produce(edm::Event& iEvent, const edm::EventSetup& iSetup)
+{
+
+  edm::Handle<TagInfoCollection> tag_infos;
+  iEvent.getByToken(src_, tag_infos);
 
-      // last input: jet pt
-      input_tensors.at(kJetPt).second.matrix<float>()(jet_bn, 0) = features.jet_features.pt;
+  // initialize output collection
+  std::vector<std::unique_ptr<JetTagCollection>> output_tags;
+  for (std::size_t i=0; i < flav_pairs_.size(); i++) {
+    if (!tag_infos->empty()) {
+      auto jet_ref = tag_infos->begin()->jet();
+      output_tags.emplace_back(std::make_unique<JetTagCollection>(
+            edm::makeRefToBaseProdFrom(jet_ref, iEvent)));
+    } else {
+      output_tags.emplace_back(std::make_unique<JetTagCollection>());
     }
+  }
 
-    // run the session
-    std::vector<tensorflow::Tensor> outputs;
-    tensorflow::run(session_, input_tensors, output_names_, &outputs);
+  if (globalCache()->batchedInference) {
 
-    // set output values for flavour probs
-    for (std::size_t jet_bn=0; jet_bn < (std::size_t) n_batch_jets; jet_bn++) {
+    // the outputs were filled by the batched inference while the stream was waiting
+    if (!tag_infos->empty()) {
+      fill_outputs(*tag_infos, 0, request_.outputs.at(kJetFlavour), output_tags);
+    }
+    request_.inputs.clear();
+    request_.outputs.clear();
 
-      // global jet index (jet_bn is the jet batch index)
-      std::size_t jet_n = batch_n*n_batch_jets + jet_bn;
+  } else {
 
-      const auto & jet_ref = tag_infos->at(jet_n).jet();
-      for (std::size_t flav_n=0; flav_n < flav_pairs_.size(); flav_n++) {
-        const auto & flav_pair = flav_pairs_.at(flav_n);
-        float o_sum = 0.;
-        for (const unsigned int & ind : flav_pair.second) {
-          o_sum += outputs.at(kJetFlavour).matrix<float>()(jet_bn, ind);
-        }
-        (*(output_tags.at(flav_n)))[jet_ref] = o_sum;
-      }
+    const int64_t n_jets = tag_infos->size();
+    // either all jets or one per batch for the time being
+    const int64_t n_batch_jets = batch_eval_ ?  n_jets : 1;
+
+    // add learning-phase tensors behind the inputs
+    tensorflow::NamedTensorList input_tensors = make_inputs(n_batch_jets);
+    for (std::size_t i=0; i < lp_tensors_.size(); i++) {
+      input_tensors.emplace_back(lp_names_[i], lp_tensors_[i]);
+    }
+
+    std::size_t n_batches = n_jets/n_batch_jets; // either 1 or n_jets
+    for (std::size_t batch_n=0; batch_n < n_batches; batch_n++) {
+
+      fill_inputs(*tag_infos, batch_n*n_batch_jets, input_tensors);
+
+      // run the session
+      std::vector<tensorflow::Tensor> outputs;
+      tensorflow::run(session_, input_tensors, output_names_, &outputs);
+
+      fill_outputs(*tag_infos, batch_n*n_batch_jets, outputs.at(kJetFlavour), output_tags);
     }
   }
 
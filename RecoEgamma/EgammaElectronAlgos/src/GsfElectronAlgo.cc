@@ -220,6 +220,7 @@ struct GsfElectronAlgo::EventData
   EgammaTowerIsolation * hadDepth2Isolation03Bc, * hadDepth2Isolation04Bc ;
   EgammaRecHitIsolation * ecalBarrelIsol03, * ecalBarrelIsol04 ;
   EgammaRecHitIsolation * ecalEndcapIsol03, * ecalEndcapIsol04 ;
+  EgammaRecHitIndex * ecalBarrelHitIndex, * ecalEndcapHitIndex ;
 
   //Isolation Value Maps for PF and EcalDriven electrons
   typedef std::vector< edm::Handle< edm::ValueMap<double> > > IsolationValueMaps;
@@ -236,7 +237,8 @@ GsfElectronAlgo::EventData::EventData()
    hadDepth1Isolation03Bc(nullptr), hadDepth1Isolation04Bc(nullptr),
    hadDepth2Isolation03Bc(nullptr), hadDepth2Isolation04Bc(nullptr),
    ecalBarrelIsol03(nullptr), ecalBarrelIsol04(nullptr),
-   ecalEndcapIsol03(nullptr), ecalEndcapIsol04(nullptr)
+   ecalEndcapIsol03(nullptr), ecalEndcapIsol04(nullptr),
+   ecalBarrelHitIndex(nullptr), ecalEndcapHitIndex(nullptr)
  {
   electrons = new GsfElectronPtrCollection ;
  }
@@ -255,6 +257,8 @@ GsfElectronAlgo::EventData::~EventData()
   delete ecalBarrelIsol04 ;
   delete ecalEndcapIsol03 ;
   delete ecalEndcapIsol04 ;
+  delete ecalBarrelHitIndex ;
+  delete ecalEndcapHitIndex ;
 
   GsfElectronPtrCollection::const_iterator it ;
   for ( it = electrons->begin() ; it != electrons->end() ; it++ )
@@ -883,6 +887,13 @@ void GsfElectronAlgo::beginEvent( edm::Event & event )
   eventData_->ecalBarrelIsol04 = new EgammaRecHitIsolation(egIsoConeSizeOutLarge,egIsoConeSizeInBarrel,egIsoJurassicWidth,egIsoPtMinBarrel,egIsoEMinBarrel,eventSetupData_->caloGeom,*(eventData_->barrelRecHits),eventSetupData_->sevLevel.product(),DetId::Ecal);
   eventData_->ecalEndcapIsol03 = new EgammaRecHitIsolation(egIsoConeSizeOutSmall,egIsoConeSizeInEndcap,egIsoJurassicWidth,egIsoPtMinEndcap,egIsoEMinEndcap,eventSetupData_->caloGeom,*(eventData_->endcapRecHits),eventSetupData_->sevLevel.product(),DetId::Ecal);
   eventData_->ecalEndcapIsol04 = new EgammaRecHitIsolation(egIsoConeSizeOutLarge,egIsoConeSizeInEndcap,egIsoJurassicWidth,egIsoPtMinEndcap,egIsoEMinEndcap,eventSetupData_->caloGeom,*(eventData_->endcapRecHits),eventSetupData_->sevLevel.product(),DetId::Ecal);
+  // the 03 and 04 isolations select their rechits in the same index
+  eventData_->ecalBarrelHitIndex = new EgammaRecHitIndex(*(eventSetupData_->caloGeom),*(eventData_->barrelRecHits));
+  eventData_->ecalEndcapHitIndex = new EgammaRecHitIndex(*(eventSetupData_->caloGeom),*(eventData_->endcapRecHits));
+  eventData_->ecalBarrelIsol03->setHitIndex(eventData_->ecalBarrelHitIndex);
+  eventData_->ecalBarrelIsol04->setHitIndex(eventData_->ecalBarrelHitIndex);
+  eventData_->ecalEndcapIsol03->setHitIndex(eventData_->ecalEndcapHitIndex);
+  eventData_->ecalEndcapIsol04->setHitIndex(eventData_->ecalEndcapHitIndex);
   eventData_->ecalBarrelIsol03->setUseNumCrystals(generalData_->isoCfg.useNumCrystals);
   eventData_->ecalBarrelIsol03->setVetoClustered(generalData_->isoCfg.vetoClustered);
   eventData_->ecalBarrelIsol03->doSeverityChecks(eventData_->barrelRecHits.product(),generalData_->recHitsCfg.recHitSeverityToBeExcludedBarrel);
@@ -0,0 +1,46 @@
+#ifndef EgammaIsolationAlgos_EgammaRecHitIndex_h
+#define EgammaIsolationAlgos_EgammaRecHitIndex_h
+//*****************************************************************************
+// File:      EgammaRecHitIndex.h
+// ----------------------------------------------------------------------------
+//  The ECAL rechits of one collection sorted in eta (SoA), with the cells of
+//  their crystals. It is built once per event and shared by all the
+//  EgammaRecHitIsolation instances running over that collection (cone sizes,
+//  vetoes, Et and energy sums), replacing the per-candidate geometry look-up
+//  (getCells) and the search of every selected cell among the rechits.
+//=============================================================================
+//*****************************************************************************
+
+#include <cstdint>
+#include <vector>
+
+#include "DataFormats/EcalRecHit/interface/EcalRecHitCollections.h"
+#include "DataFormats/GeometryVector/interface/GlobalPoint.h"
+#include "Geometry/CaloGeometry/interface/CaloCellGeometry.h"
+#include "Geometry/CaloGeometry/interface/CaloGeometry.h"
+
+class EgammaRecHitIndex {
+ public:
+
+  EgammaRecHitIndex(const CaloGeometry& geometry, const EcalRecHitCollection& hits);
+
+  const EcalRecHitCollection& hits() const { return hits_; }
+
+  // cell of the crystal of a hit, nullptr if it is neither in EB nor in EE
+  const CaloCellGeometry* cell(uint32_t hit) const { return cells_[hit]; }
+
+  // indices in the collection (i.e. in DetId order) of the hits whose crystal
+  // is within dR of the point, as selected by CaloSubdetectorGeometry::getCells
+  void select(const GlobalPoint& point, double dR, std::vector<uint32_t>& selected) const;
+
+ private:
+  const EcalRecHitCollection& hits_;
+  std::vector<const CaloCellGeometry*> cells_;
+
+  // SoA sorted in eta
+  std::vector<float> eta_;
+  std::vector<float> phi_;
+  std::vector<uint32_t> hit_;
+};
+
+#endif
@@ -24,6 +24,7 @@
 #include "CondFormats/DataRecord/interface/EcalChannelStatusRcd.h"
 
 #include "DataFormats/EcalRecHit/interface/EcalRecHitCollections.h"
+#include "RecoEgamma/EgammaIsolationAlgos/interface/EgammaRecHitIndex.h"
 
 class EgammaRecHitIsolation {
  public:
@@ -45,6 +46,10 @@ class EgammaRecHitIsolation {
   double getEtSum(const reco::SuperCluster* emObject ) const {return getSum_(emObject,true);}
   double getEnergySum(const reco::SuperCluster * emObject) const{ return  getSum_(emObject,false);}
 
+  // select the rechits with an index built for the same collection, shared by
+  // the isolations of the event, instead of the geometry look-up per candidate
+  void setHitIndex(const EgammaRecHitIndex* index);
+
   void setUseNumCrystals(bool b=true) { useNumCrystals_ = b; }
   void setVetoClustered(bool b=true) { vetoClustered_ = b; }
   void doSeverityChecks(const EcalRecHitCollection *const recHits,
@@ -65,6 +70,9 @@ class EgammaRecHitIsolation {
   ~EgammaRecHitIsolation() ;
   
  private:
+  typedef std::pair<EcalRecHitCollection::const_iterator, const CaloCellGeometry*> SelectedHit;
+  void selectHits_(const GlobalPoint&, std::vector<SelectedHit>&) const;
+
   double getSum_(const reco::Candidate *, bool returnEt ) const;
   double getSum_(const reco::SuperCluster *, bool returnEt ) const;
 
@@ -78,6 +86,7 @@ class EgammaRecHitIsolation {
   edm::ESHandle<CaloGeometry>  theCaloGeom_ ;
   const EcalRecHitCollection&  caloHits_ ;
   const EcalSeverityLevelAlgo* sevLevel_;
+  const EgammaRecHitIndex* hitIndex_;
 
   bool useNumCrystals_;
   bool vetoClustered_;
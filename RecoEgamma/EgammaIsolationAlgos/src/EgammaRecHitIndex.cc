@@ -0,0 +1,61 @@
+//*****************************************************************************
+// File:      EgammaRecHitIndex.cc
+//=============================================================================
+//*****************************************************************************
+
+#include "RecoEgamma/EgammaIsolationAlgos/interface/EgammaRecHitIndex.h"
+#include "DataFormats/EcalDetId/interface/EcalSubdetector.h"
+#include "DataFormats/Math/interface/deltaR.h"
+
+#include <algorithm>
+
+EgammaRecHitIndex::EgammaRecHitIndex(const CaloGeometry& geometry, const EcalRecHitCollection& hits) :
+  hits_(hits),
+  cells_(hits.size(), nullptr)
+{
+  const CaloSubdetectorGeometry* subdet[2] = {geometry.getSubdetectorGeometry(DetId::Ecal,EcalBarrel),
+                                              geometry.getSubdetectorGeometry(DetId::Ecal,EcalEndcap)};
+
+  std::vector<uint32_t> order;
+  order.reserve(hits.size());
+  for (uint32_t k=0; k!=hits.size(); ++k) {
+    DetId id = hits[k].detid();
+    if (id.det()!=DetId::Ecal) continue;
+    const CaloSubdetectorGeometry* g = nullptr;
+    if (id.subdetId()==EcalBarrel) g = subdet[0];
+    else if (id.subdetId()==EcalEndcap) g = subdet[1];
+    if (g==nullptr) continue;
+    cells_[k] = g->getGeometry(id).get();
+    if (cells_[k]!=nullptr) order.push_back(k);
+  }
+  std::stable_sort(order.begin(), order.end(),
+                   [this](uint32_t a, uint32_t b) { return cells_[a]->etaPos() < cells_[b]->etaPos(); });
+
+  eta_.reserve(order.size());
+  phi_.reserve(order.size());
+  hit_.reserve(order.size());
+  for (auto k : order) {
+    eta_.push_back(cells_[k]->etaPos());
+    phi_.push_back(cells_[k]->phiPos());
+    hit_.push_back(k);
+  }
+}
+
+void EgammaRecHitIndex::select(const GlobalPoint& point, double dR, std::vector<uint32_t>& selected) const
+{
+  selected.clear();
+  if (dR <= 0.000001) return;
+
+  // same single precision test as the getCells of the ECAL geometries
+  const float dR2 = dR*dR;
+  const float reta = point.eta();
+  const float rphi = point.phi();
+
+  auto first = std::lower_bound(eta_.begin(), eta_.end(), float(reta-dR));
+  for (auto i = std::size_t(first-eta_.begin()); i!=eta_.size() && eta_[i]<reta+float(dR); ++i) {
+    if (reco::deltaR2(eta_[i], phi_[i], reta, rphi) < dR2) selected.push_back(hit_[i]);
+  }
+
+  // in the order of the rechits, as the DetIdSet of getCells
+  std::sort(selected.begin(), selected.end());
+}
@@ -26,6 +26,7 @@
 #include "DataFormats/EgammaReco/interface/SuperClusterFwd.h"
 #include "DataFormats/RecoCandidate/interface/RecoCandidate.h"
 #include "DataFormats/Math/interface/deltaPhi.h"
+#include "FWCore/Utilities/interface/Exception.h"
 
 using namespace std;
 
@@ -46,6 +47,7 @@ EgammaRecHitIsolation::EgammaRecHitIsolation (double extRadius,
     theCaloGeom_(theCaloGeom) ,  
     caloHits_(caloHits),
     sevLevel_(sl),
+    hitIndex_(nullptr),
     useNumCrystals_(false),
     vetoClustered_(false),
     ecalBarHits_(nullptr),
@@ -66,6 +68,36 @@ EgammaRecHitIsolation::EgammaRecHitIsolation (double extRadius,
 EgammaRecHitIsolation::~EgammaRecHitIsolation ()
 {}
 
+void EgammaRecHitIsolation::setHitIndex(const EgammaRecHitIndex* index)
+{
+  if (index != nullptr && &index->hits() != &caloHits_)
+    throw cms::Exception("Configuration") << "EgammaRecHitIsolation: the rechit index was built for another rechit collection";
+  hitIndex_ = index;
+}
+
+void EgammaRecHitIsolation::selectHits_(const GlobalPoint& pclu, std::vector<SelectedHit>& selected) const {
+
+  if (hitIndex_ != nullptr) {
+    std::vector<uint32_t> indices;
+    hitIndex_->select(pclu,extRadius_,indices);
+    selected.reserve(indices.size());
+    for (auto k : indices)
+      selected.emplace_back(caloHits_.begin()+k, hitIndex_->cell(k));
+    return;
+  }
+
+  for(int subdetnr=0; subdetnr<=1 ; subdetnr++){  // look in barrel and endcap
+    if( nullptr == subdet_[subdetnr] ) continue;
+
+    CaloSubdetectorGeometry::DetIdSet chosen = subdet_[subdetnr]->getCells(pclu,extRadius_);// select cells around cluster
+    for (CaloSubdetectorGeometry::DetIdSet::const_iterator  i = chosen.begin ();i != chosen.end (); ++i){ //loop selected cells
+      EcalRecHitCollection::const_iterator j = caloHits_.find(*i); // find selected cell among rechits
+      if(j != caloHits_.end()) // add rechit only if available
+        selected.emplace_back(j, theCaloGeom_->getGeometry(*i).get());
+    }
+  }
+}
+
 double EgammaRecHitIsolation::getSum_(const reco::Candidate* emObject,bool returnEt) const {
   
   double energySum = 0.;
@@ -82,16 +114,11 @@ double EgammaRecHitIsolation::getSum_(const reco::Candidate* emObject,bool retur
     
     std::vector< std::pair<DetId, float> >::const_iterator rhIt;
     
-    for(int subdetnr=0; subdetnr<=1 ; subdetnr++){  // look in barrel and endcap
-      if( nullptr == subdet_[subdetnr] ) continue;
-
-      CaloSubdetectorGeometry::DetIdSet chosen = subdet_[subdetnr]->getCells(pclu,extRadius_);// select cells around cluster
-      EcalRecHitCollection::const_iterator j = caloHits_.end();
-
-      for (CaloSubdetectorGeometry::DetIdSet::const_iterator  i = chosen.begin ();i != chosen.end (); ++i){ //loop selected cells
-	j = caloHits_.find(*i); // find selected cell among rechits
-	if(j != caloHits_.end()) { // add rechit only if available 
-	  auto cell  = theCaloGeom_->getGeometry(*i);
+    std::vector<SelectedHit> selected;
+    selectHits_(pclu,selected); // select rechits around cluster
+    for (const auto& hit : selected){ //loop selected rechits
+	  EcalRecHitCollection::const_iterator j = hit.first;
+	  const CaloCellGeometry* cell = hit.second;
 	  float eta = cell->etaPos();
 	  float phi = cell->phiPos();
 	  float etaDiff = eta - etaclus;
@@ -127,7 +154,7 @@ double EgammaRecHitIsolation::getSum_(const reco::Candidate* emObject,bool retur
 	    bool isClustered = false;
 	    for(reco::CaloCluster_iterator bcIt = sc->clustersBegin();bcIt != sc->clustersEnd(); ++bcIt) {
 	      for(rhIt = (*bcIt)->hitsAndFractions().begin();rhIt != (*bcIt)->hitsAndFractions().end(); ++rhIt) {
-		if(rhIt->first == *i)
+		if(rhIt->first == j->detid())
 		  isClustered = true;
 		if(isClustered) 
 		  break;
@@ -173,9 +200,7 @@ double EgammaRecHitIsolation::getSum_(const reco::Candidate* emObject,bool retur
 	      energySum += energy;
 	  }
 	  
-	}                //End if not end of list
-      }                  //End loop over rechits
-    }                    //End loop over barrel/endcap
+    }                    //End loop over rechits
   }                        //End if caloHits_
   
   return energySum;
@@ -200,15 +225,11 @@ double EgammaRecHitIsolation::getSum_(const reco::SuperCluster* sc, bool returnE
     std::vector< std::pair<DetId, float> >::const_iterator rhIt;
     
     
-    for(int subdetnr=0; subdetnr<=1 ; subdetnr++){  // look in barrel and endcap
-      if( nullptr == subdet_[subdetnr] ) continue;
-      CaloSubdetectorGeometry::DetIdSet chosen = subdet_[subdetnr]->getCells(pclu,extRadius_);// select cells around cluster
-      EcalRecHitCollection::const_iterator j=caloHits_.end();
-      for (CaloSubdetectorGeometry::DetIdSet::const_iterator  i = chosen.begin ();i!= chosen.end ();++i){//loop selected cells
-	
-	j=caloHits_.find(*i); // find selected cell among rechits
-	if( j!=caloHits_.end()){ // add rechit only if available 
-	  const  GlobalPoint & position = (theCaloGeom_.product())->getPosition(*i);
+    std::vector<SelectedHit> selected;
+    selectHits_(pclu,selected); // select rechits around cluster
+    for (const auto& hit : selected){ //loop selected rechits
+	  EcalRecHitCollection::const_iterator j = hit.first;
+	  const  GlobalPoint & position = hit.second->getPosition();
 	  double eta = position.eta();
 	  double phi = position.phi();
 	  double etaDiff = eta - etaclus;
@@ -237,7 +258,7 @@ double EgammaRecHitIsolation::getSum_(const reco::SuperCluster* sc, bool returnE
 	    bool isClustered = false;
 	    for(reco::CaloCluster_iterator bcIt = sc->clustersBegin();bcIt != sc->clustersEnd(); ++bcIt) {
 	      for(rhIt = (*bcIt)->hitsAndFractions().begin();rhIt != (*bcIt)->hitsAndFractions().end(); ++rhIt) {
-		if( rhIt->first == *i ) isClustered = true;
+		if( rhIt->first == j->detid() ) isClustered = true;
 		if( isClustered ) break;
 	      }
 	      if( isClustered ) break;
@@ -274,9 +295,7 @@ double EgammaRecHitIsolation::getSum_(const reco::SuperCluster* sc, bool returnE
 	    else energySum+=energy;
 	  }
 	  
-	}                //End if not end of list
-      }                  //End loop over rechits
-    }                    //End loop over barrel/endcap
+    }                    //End loop over rechits
   }                      //End if caloHits_
 
   return energySum;
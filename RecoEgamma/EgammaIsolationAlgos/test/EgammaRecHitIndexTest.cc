@@ -0,0 +1,157 @@
+// Compares the ECAL rechit isolation sums obtained through an
+// EgammaRecHitIndex (setHitIndex) with the ones of the getCells look-up, for
+// candidates in the barrel and in the endcaps and the dR 0.3 and 0.4 cones
+// of the electrons. The rechits are generated on the crystals of the geometry.
+
+#include "FWCore/Framework/interface/one/EDAnalyzer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/EventSetup.h"
+#include "FWCore/Framework/interface/ESHandle.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include "DataFormats/EcalDetId/interface/EBDetId.h"
+#include "DataFormats/EcalDetId/interface/EEDetId.h"
+#include "DataFormats/EcalRecHit/interface/EcalRecHitCollections.h"
+#include "DataFormats/EgammaReco/interface/SuperCluster.h"
+#include "DataFormats/EgammaReco/interface/SuperClusterFwd.h"
+#include "DataFormats/RecoCandidate/interface/RecoEcalCandidate.h"
+#include "Geometry/CaloGeometry/interface/CaloGeometry.h"
+#include "Geometry/Records/interface/CaloGeometryRecord.h"
+
+#include "RecoEgamma/EgammaIsolationAlgos/interface/EgammaRecHitIndex.h"
+#include "RecoEgamma/EgammaIsolationAlgos/interface/EgammaRecHitIsolation.h"
+
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+
+class EgammaRecHitIndexTest : public edm::one::EDAnalyzer<> {
+public:
+  explicit EgammaRecHitIndexTest(const edm::ParameterSet&);
+  ~EgammaRecHitIndexTest() override {}
+
+  void analyze(const edm::Event&, const edm::EventSetup&) override;
+
+private:
+  // fraction of the crystals with a rechit, and number of candidates per event
+  double occupancy_;
+  unsigned int nCandidates_;
+};
+
+namespace {
+
+  // a small LCG, so that the rechits only depend on the event number
+  class Random {
+  public:
+    explicit Random(uint64_t seed) : state_(seed*2862933555777941757ULL + 3037000493ULL) {}
+    double operator()() {
+      state_ = state_*6364136223846793005ULL + 1442695040888963407ULL;
+      return (state_ >> 11)*(1./9007199254740992.);
+    }
+  private:
+    uint64_t state_;
+  };
+
+  void addHit(EcalRecHitCollection& hits, DetId id, Random& random) {
+    float energy = -0.2 + 2.*random()*random();
+    // a few hits are flagged as weird, and excluded by the flag check
+    uint32_t flags = random() < 0.02 ? (0x1 << EcalRecHit::kWeird) : 0;
+    hits.push_back(EcalRecHit(id, energy, 0., 0, flags));
+  }
+
+  // isolation in the configuration of the GsfElectrons, or with the cuts in
+  // eta-phi instead of numbers of crystals
+  std::unique_ptr<EgammaRecHitIsolation> makeIsolation(double extRadius, bool endcap, bool numCrystals,
+                                                       edm::ESHandle<CaloGeometry> const& geometry,
+                                                       EcalRecHitCollection const& hits) {
+    std::unique_ptr<EgammaRecHitIsolation> isolation;
+    if (numCrystals) {
+      isolation = std::make_unique<EgammaRecHitIsolation>(extRadius, 3.0, 1.5, endcap ? 0.110 : 0., endcap ? 0. : 0.095,
+                                                           geometry, hits, nullptr, DetId::Ecal);
+    } else {
+      isolation = std::make_unique<EgammaRecHitIsolation>(extRadius, 0.045, 0.02, 0., 0., geometry, hits, nullptr, DetId::Ecal);
+    }
+    isolation->setUseNumCrystals(numCrystals);
+    isolation->doFlagChecks({EcalRecHit::kWeird});
+    return isolation;
+  }
+
+}
+
+EgammaRecHitIndexTest::EgammaRecHitIndexTest(const edm::ParameterSet& iConfig) :
+  occupancy_(iConfig.getParameter<double>("occupancy")),
+  nCandidates_(iConfig.getParameter<unsigned int>("nCandidates"))
+{
+}
+
+void EgammaRecHitIndexTest::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup)
+{
+  edm::ESHandle<CaloGeometry> geometry;
+  iSetup.get<CaloGeometryRecord>().get(geometry);
+
+  Random random(iEvent.id().event());
+  EcalRecHitCollection barrelHits, endcapHits;
+  for (int i = 0; i < EBDetId::kSizeForDenseIndexing; ++i) {
+    if (random() < occupancy_) addHit(barrelHits, EBDetId::unhashIndex(i), random);
+  }
+  for (int i = 0; i < EEDetId::kSizeForDenseIndexing; ++i) {
+    if (random() < occupancy_) addHit(endcapHits, EEDetId::unhashIndex(i), random);
+  }
+  barrelHits.sort();
+  endcapHits.sort();
+
+  // candidates on the front face of ECAL, in the barrel, the endcaps and around the transition
+  reco::SuperClusterCollection superClusters;
+  for (unsigned int i = 0; i < nCandidates_; ++i) {
+    double eta = (random() < 0.5 ? -1. : 1.)*(i % 3 == 0 ? 1.4*random() : i % 3 == 1 ? 1.5 + 1.1*random() : 1.3 + 0.4*random());
+    double phi = M_PI*(2.*random() - 1.);
+    double r = std::abs(eta) < 1.479 ? 129. : 317./std::abs(std::sinh(eta));
+    superClusters.emplace_back(20., math::XYZPoint(r*std::cos(phi), r*std::sin(phi), r*std::sinh(eta)));
+  }
+  std::vector<reco::RecoEcalCandidate> candidates(superClusters.size());
+  for (unsigned int i = 0; i < superClusters.size(); ++i) {
+    candidates[i].setSuperCluster(reco::SuperClusterRef(&superClusters, i));
+  }
+
+  EgammaRecHitIndex barrelIndex(*geometry, barrelHits);
+  EgammaRecHitIndex endcapIndex(*geometry, endcapHits);
+
+  unsigned int nSums = 0, nNonZero = 0;
+  for (double extRadius : {0.3, 0.4}) {
+    for (bool numCrystals : {true, false}) {
+      for (bool endcap : {false, true}) {
+        EcalRecHitCollection const& hits = endcap ? endcapHits : barrelHits;
+        auto cells = makeIsolation(extRadius, endcap, numCrystals, geometry, hits);
+        auto indexed = makeIsolation(extRadius, endcap, numCrystals, geometry, hits);
+        indexed->setHitIndex(endcap ? &endcapIndex : &barrelIndex);
+
+        for (auto const& candidate : candidates) {
+          double et = cells->getEtSum(&candidate), energy = cells->getEnergySum(&candidate);
+          double indexedEt = indexed->getEtSum(&candidate), indexedEnergy = indexed->getEnergySum(&candidate);
+          if (et != indexedEt || energy != indexedEnergy) {
+            throw cms::Exception("EgammaRecHitIndexTest")
+              << "event " << iEvent.id().event() << ", " << (endcap ? "endcap" : "barrel") << " hits, dR " << extRadius
+              << (numCrystals ? " (crystals)" : "") << ", candidate at eta " << candidate.superCluster()->eta()
+              << ": getCells Et " << et << " energy " << energy
+              << ", index Et " << indexedEt << " energy " << indexedEnergy;
+          }
+          ++nSums;
+          if (et != 0.) ++nNonZero;
+        }
+      }
+    }
+  }
+  // the comparison is only meaningful if the cones contain hits
+  if (4*nNonZero < nSums) {
+    throw cms::Exception("EgammaRecHitIndexTest") << "only " << nNonZero << " of " << nSums << " isolation sums are not empty";
+  }
+
+  std::cout << "EgammaRecHitIndexTest: event " << iEvent.id().event() << ", " << barrelHits.size() << " EB and "
+            << endcapHits.size() << " EE hits, " << nSums << " identical isolation sums (" << nNonZero << " not empty)"
+            << std::endl;
+}
+
+DEFINE_FWK_MODULE(EgammaRecHitIndexTest);
@@ -0,0 +1,18 @@
+# Checks that the ECAL rechit isolation sums are the same with the
+# EgammaRecHitIndex and with the getCells look-up, on generated rechits.
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("Test")
+
+process.load("FWCore.MessageService.MessageLogger_cfi")
+process.load("Configuration.Geometry.GeometryExtended2017Reco_cff")
+
+process.maxEvents = cms.untracked.PSet( input = cms.untracked.int32(5) )
+
+process.source = cms.Source("EmptySource")
+
+process.test = cms.EDAnalyzer("EgammaRecHitIndexTest",
+    occupancy = cms.double(0.15),
+    nCandidates = cms.uint32(200)
+)
+process.p = cms.Path(process.test)
@@ -0,0 +1,5 @@
+#!/bin/bash
+
+function die { echo Failure $1: status $2 ; exit $2 ; }
+
+cmsRun ${LOCAL_TEST_DIR}/egammaRecHitIndexTest_cfg.py || die "cmsRun egammaRecHitIndexTest_cfg.py" $?
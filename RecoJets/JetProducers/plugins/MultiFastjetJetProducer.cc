@@ -0,0 +1,334 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// MultiFastjetJetProducer
+// -----------------------
+//
+// Clusters one input collection with several jet definitions (algorithm,
+// radius, pt threshold) in a single module. The inputs are converted to
+// fastjet::PseudoJets and the ghosts of the active area are generated once
+// per event and shared by all the definitions, and the clustering sequences
+// of the definitions run as concurrent tasks. One jet collection is written
+// per definition, with its label as product instance name.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "FWCore/Framework/interface/stream/EDProducer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/EventSetup.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/Utilities/interface/isFinite.h"
+
+#include "DataFormats/Common/interface/Handle.h"
+#include "DataFormats/Common/interface/View.h"
+#include "DataFormats/Candidate/interface/Candidate.h"
+#include "DataFormats/Candidate/interface/CandidateFwd.h"
+#include "DataFormats/JetReco/interface/PFJetCollection.h"
+#include "DataFormats/JetReco/interface/GenJetCollection.h"
+#include "DataFormats/JetReco/interface/BasicJetCollection.h"
+#include "DataFormats/JetReco/interface/PFClusterJetCollection.h"
+
+#include "RecoJets/JetProducers/interface/JetSpecific.h"
+
+#include "fastjet/JetDefinition.hh"
+#include "fastjet/ClusterSequence.hh"
+#include "fastjet/ClusterSequenceArea.hh"
+#include "fastjet/ClusterSequenceActiveAreaExplicitGhosts.hh"
+#include "fastjet/ClusterSequenceVoronoiArea.hh"
+#include "fastjet/GhostedAreaSpec.hh"
+#include "fastjet/PseudoJet.hh"
+
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+class MultiFastjetJetProducer : public edm::stream::EDProducer<>
+{
+public:
+  explicit MultiFastjetJetProducer(const edm::ParameterSet& iConfig);
+  ~MultiFastjetJetProducer() override;
+  static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
+
+  void produce(edm::Event& iEvent, const edm::EventSetup& iSetup) override;
+
+private:
+  // "active": shared explicit ghosts, "passive": fastjet passive area,
+  // "voronoi": Voronoi area (no ghosts), "none": no area
+  enum class AreaType { None, Active, Passive, Voronoi };
+
+  struct JetConfig {
+    std::string                              label;          // product instance name
+    std::unique_ptr<fastjet::JetDefinition>  jetDefinition;
+    double                                   jetPtMin;
+  };
+
+  template< typename T >
+  void produceJets(edm::Event& iEvent, const edm::EventSetup& iSetup);
+
+  template< typename T >
+  std::unique_ptr<std::vector<T> > clusterJets(const JetConfig& config,
+                                               const std::vector<reco::CandidatePtr>& inputs,
+                                               const std::vector<fastjet::PseudoJet>& fjInputs,
+                                               const std::vector<fastjet::PseudoJet>& ghosts,
+                                               const edm::EventSetup& iSetup) const;
+
+  edm::EDGetTokenT<reco::CandidateView> input_candidateview_token_;
+  std::string           jetType_;                   // type of jet (PF,Gen,Basic,PFCluster)
+  double                inputEtMin_;                // minimum et of input constituents
+  double                inputEMin_;                 // minimum e of input constituents
+  AreaType              areaType_;
+  double                voronoiRfact_;              // effective scale factor of the Voronoi area
+  bool                  useDeterministicSeed_;      // use a deterministic seed to fastjet
+  unsigned int          minSeed_;                   // minimum seed to use
+  std::unique_ptr<fastjet::GhostedAreaSpec> fjActiveArea_;  // ghosts of the active and passive areas
+  std::vector<JetConfig> configs_;
+};
+
+
+//______________________________________________________________________________
+MultiFastjetJetProducer::MultiFastjetJetProducer(const edm::ParameterSet& iConfig)
+  : input_candidateview_token_(consumes<reco::CandidateView>(iConfig.getParameter<edm::InputTag>("src")))
+  , jetType_(iConfig.getParameter<std::string>("jetType"))
+  , inputEtMin_(iConfig.getParameter<double>("inputEtMin"))
+  , inputEMin_(iConfig.getParameter<double>("inputEMin"))
+  , voronoiRfact_(iConfig.getParameter<double>("voronoiRfact"))
+  , useDeterministicSeed_(iConfig.getParameter<bool>("useDeterministicSeed"))
+  , minSeed_(iConfig.getParameter<unsigned int>("minSeed"))
+{
+  const std::string& areaType = iConfig.getParameter<std::string>("areaType");
+  if      (areaType == "none")    areaType_ = AreaType::None;
+  else if (areaType == "active")  areaType_ = AreaType::Active;
+  else if (areaType == "passive") areaType_ = AreaType::Passive;
+  else if (areaType == "voronoi") areaType_ = AreaType::Voronoi;
+  else
+    throw cms::Exception("Configuration") << "MultiFastjetJetProducer: invalid areaType " << areaType
+                                          << ", expected none, active, passive or voronoi\n";
+
+  if (areaType_ == AreaType::Voronoi && voronoiRfact_ <= 0)
+    throw cms::Exception("Configuration") << "MultiFastjetJetProducer: voronoiRfact must be positive for the Voronoi area\n";
+
+  if (areaType_ == AreaType::Active || areaType_ == AreaType::Passive)
+    fjActiveArea_ = std::make_unique<fastjet::GhostedAreaSpec>(iConfig.getParameter<double>("Ghost_EtaMax"),
+                                                               1,
+                                                               iConfig.getParameter<double>("GhostArea"));
+
+  // only the sequential recombination algorithms, the cone plugins keep state in their objects
+  for (auto const& pset : iConfig.getParameter<std::vector<edm::ParameterSet> >("jets")) {
+    JetConfig config;
+    config.label    = pset.getParameter<std::string>("label");
+    config.jetPtMin = pset.getParameter<double>("jetPtMin");
+    const std::string& jetAlgorithm = pset.getParameter<std::string>("jetAlgorithm");
+    double rParam = pset.getParameter<double>("rParam");
+    if (jetAlgorithm == "Kt")
+      config.jetDefinition = std::make_unique<fastjet::JetDefinition>(fastjet::kt_algorithm, rParam);
+    else if (jetAlgorithm == "CambridgeAachen")
+      config.jetDefinition = std::make_unique<fastjet::JetDefinition>(fastjet::cambridge_algorithm, rParam);
+    else if (jetAlgorithm == "AntiKt")
+      config.jetDefinition = std::make_unique<fastjet::JetDefinition>(fastjet::antikt_algorithm, rParam);
+    else if (jetAlgorithm == "GeneralizedKt")
+      config.jetDefinition = std::make_unique<fastjet::JetDefinition>(fastjet::genkt_algorithm, rParam, -2);
+    else
+      throw cms::Exception("Configuration") << "MultiFastjetJetProducer: jet algorithm " << jetAlgorithm
+                                            << " of " << config.label << " is not supported\n";
+
+    auto same = [&config](const JetConfig& other) { return other.label == config.label; };
+    if (std::find_if(configs_.begin(), configs_.end(), same) != configs_.end())
+      throw cms::Exception("Configuration") << "MultiFastjetJetProducer: duplicate jet label " << config.label << "\n";
+    configs_.push_back(std::move(config));
+  }
+
+  for (auto const& config : configs_) {
+    if (jetType_ == "PFJet")
+      produces<reco::PFJetCollection>(config.label);
+    else if (jetType_ == "GenJet")
+      produces<reco::GenJetCollection>(config.label);
+    else if (jetType_ == "BasicJet")
+      produces<reco::BasicJetCollection>(config.label);
+    else if (jetType_ == "PFClusterJet")
+      produces<reco::PFClusterJetCollection>(config.label);
+    else
+      throw cms::Exception("Configuration") << "MultiFastjetJetProducer: jetType " << jetType_ << " is not supported\n";
+  }
+
+  // the banner is printed by the first cluster sequence, not from concurrent tasks
+  fastjet::ClusterSequence::print_banner();
+}
+
+//______________________________________________________________________________
+MultiFastjetJetProducer::~MultiFastjetJetProducer()
+{
+}
+
+//______________________________________________________________________________
+void MultiFastjetJetProducer::produce(edm::Event& iEvent, const edm::EventSetup& iSetup)
+{
+  if (jetType_ == "PFJet")
+    produceJets<reco::PFJet>(iEvent, iSetup);
+  else if (jetType_ == "GenJet")
+    produceJets<reco::GenJet>(iEvent, iSetup);
+  else if (jetType_ == "BasicJet")
+    produceJets<reco::BasicJet>(iEvent, iSetup);
+  else
+    produceJets<reco::PFClusterJet>(iEvent, iSetup);
+}
+
+//______________________________________________________________________________
+template< typename T >
+void MultiFastjetJetProducer::produceJets(edm::Event& iEvent, const edm::EventSetup& iSetup)
+{
+  // convert the inputs once for all the jet definitions, with the selection
+  // of VirtualJetProducer::inputTowers
+  edm::Handle<reco::CandidateView> inputsHandle;
+  iEvent.getByToken(input_candidateview_token_, inputsHandle);
+
+  std::vector<reco::CandidatePtr> inputs;
+  std::vector<fastjet::PseudoJet> fjInputs;
+  inputs.reserve(inputsHandle->size());
+  fjInputs.reserve(inputsHandle->size());
+  for (size_t i = 0; i < inputsHandle->size(); ++i) {
+    auto const& input = (*inputsHandle)[i];
+    if (edm::isNotFinite(input.pt()))  continue;
+    if (input.et()     < inputEtMin_)  continue;
+    if (input.energy() < inputEMin_)   continue;
+    if (input.pt() < 100 * std::numeric_limits<double>::epsilon()) continue;
+    fjInputs.emplace_back(input.px(), input.py(), input.pz(), input.energy());
+    fjInputs.back().set_user_index(inputs.size());
+    inputs.push_back(inputsHandle->ptrAt(i));
+  }
+
+  // seed the (global) fastjet random generator as VirtualJetProducer does
+  if (useDeterministicSeed_ && fjActiveArea_) {
+    std::vector<int> seeds(2);
+    unsigned int runNum_uint = static_cast <unsigned int> (iEvent.id().run());
+    unsigned int evNum_uint = static_cast <unsigned int> (iEvent.id().event());
+    seeds[0] = std::max(runNum_uint,minSeed_ + 3) + 3 * evNum_uint;
+    seeds[1] = std::max(runNum_uint,minSeed_ + 5) + 5 * evNum_uint;
+    fjActiveArea_->set_random_status(seeds);
+  }
+
+  // one set of ghosts for all the jet definitions
+  std::vector<fastjet::PseudoJet> ghosts;
+  if (areaType_ == AreaType::Active && !fjInputs.empty())
+    fjActiveArea_->add_ghosts(ghosts);
+
+  // the passive area draws its ghosts from the global generator while
+  // clustering, so its definitions run one after the other to stay reproducible
+  std::vector<std::unique_ptr<std::vector<T> > > jets(configs_.size());
+  if (areaType_ == AreaType::Passive) {
+    for (unsigned i = 0; i < configs_.size(); ++i)
+      jets[i] = clusterJets<T>(configs_[i], inputs, fjInputs, ghosts, iSetup);
+  } else {
+    tbb::parallel_for(tbb::blocked_range<unsigned>(0, configs_.size()),
+                      [&](const tbb::blocked_range<unsigned>& range) {
+                        for (unsigned i = range.begin(); i != range.end(); ++i)
+                          jets[i] = clusterJets<T>(configs_[i], inputs, fjInputs, ghosts, iSetup);
+                      });
+  }
+
+  for (unsigned i = 0; i < configs_.size(); ++i)
+    iEvent.put(std::move(jets[i]), configs_[i].label);
+}
+
+//______________________________________________________________________________
+template< typename T >
+std::unique_ptr<std::vector<T> >
+MultiFastjetJetProducer::clusterJets(const JetConfig& config,
+                                     const std::vector<reco::CandidatePtr>& inputs,
+                                     const std::vector<fastjet::PseudoJet>& fjInputs,
+                                     const std::vector<fastjet::PseudoJet>& ghosts,
+                                     const edm::EventSetup& iSetup) const
+{
+  auto jets = std::make_unique<std::vector<T> >();
+  if (fjInputs.empty())
+    return jets;
+
+  std::unique_ptr<fastjet::ClusterSequence> clusterSequence;
+  switch (areaType_) {
+  case AreaType::Active:
+    clusterSequence = std::make_unique<fastjet::ClusterSequenceActiveAreaExplicitGhosts>(
+      fjInputs, *config.jetDefinition, ghosts, fjActiveArea_->actual_ghost_area());
+    break;
+  case AreaType::Passive:
+    clusterSequence = std::make_unique<fastjet::ClusterSequenceArea>(
+      fjInputs, *config.jetDefinition, fastjet::AreaDefinition(fastjet::passive_area, *fjActiveArea_));
+    break;
+  case AreaType::Voronoi:
+    clusterSequence = std::make_unique<fastjet::ClusterSequenceVoronoiArea>(
+      fjInputs, *config.jetDefinition, fastjet::VoronoiAreaSpec(voronoiRfact_));
+    break;
+  default:
+    clusterSequence = std::make_unique<fastjet::ClusterSequence>(fjInputs, *config.jetDefinition);
+    break;
+  }
+
+  std::vector<fastjet::PseudoJet> fjJets = fastjet::sorted_by_pt(clusterSequence->inclusive_jets(config.jetPtMin));
+  jets->reserve(fjJets.size());
+  for (const fastjet::PseudoJet& fjJet : fjJets) {
+    // with explicit ghosts and a low pt threshold, jets made of ghosts only are returned too
+    if (areaType_ == AreaType::Active && fjJet.is_pure_ghost())
+      continue;
+
+    // the ghosts have no user index
+    std::vector<reco::CandidatePtr> constituents;
+    for (auto const& fjConstituent : fastjet::sorted_by_pt(fjJet.constituents())) {
+      int index = fjConstituent.user_index();
+      if (index >= 0 && static_cast<unsigned int>(index) < inputs.size())
+        constituents.push_back(inputs[index]);
+    }
+
+    jets->emplace_back();
+    auto& jet = jets->back();
+    reco::writeSpecific(jet,
+                        reco::Particle::LorentzVector(fjJet.px(), fjJet.py(), fjJet.pz(), fjJet.E()),
+                        reco::Particle::Point(0,0,0),
+                        constituents, iSetup);
+    jet.setJetArea(areaType_ != AreaType::None && fjJet.has_area() ? fjJet.area() : 0.0);
+    jet.setPileup(0.0);
+  }
+  return jets;
+}
+
+//______________________________________________________________________________
+void MultiFastjetJetProducer::fillDescriptions(edm::ConfigurationDescriptions& descriptions)
+{
+  edm::ParameterSetDescription desc;
+  desc.add<edm::InputTag>("src",                 edm::InputTag("particleFlow"));
+  desc.add<std::string>("jetType",               "PFJet");
+  desc.add<double>("inputEtMin",                 0.0);
+  desc.add<double>("inputEMin",                  0.0);
+  desc.add<std::string>("areaType",              "active");
+  desc.add<double>("voronoiRfact",               0.9);
+  desc.add<double>("Ghost_EtaMax",               5.0);
+  desc.add<double>("GhostArea",                  0.01);
+  desc.add<bool>("useDeterministicSeed",         true);
+  desc.add<unsigned int>("minSeed",              14327);
+
+  edm::ParameterSetDescription jetDesc;
+  jetDesc.add<std::string>("label",              "ak4");
+  jetDesc.add<std::string>("jetAlgorithm",       "AntiKt");
+  jetDesc.add<double>("rParam",                  0.4);
+  jetDesc.add<double>("jetPtMin",                5.0);
+
+  edm::ParameterSet ak4;
+  ak4.addParameter<std::string>("label",         "ak4");
+  ak4.addParameter<std::string>("jetAlgorithm",  "AntiKt");
+  ak4.addParameter<double>("rParam",             0.4);
+  ak4.addParameter<double>("jetPtMin",           5.0);
+  edm::ParameterSet ak8(ak4);
+  ak8.addParameter<std::string>("label",         "ak8");
+  ak8.addParameter<double>("rParam",             0.8);
+  desc.addVPSet("jets", jetDesc, std::vector<edm::ParameterSet>{ak4, ak8});
+
+  descriptions.add("multiFastjetJetProducer", desc);
+}
+
+DEFINE_FWK_MODULE(MultiFastjetJetProducer);
@@ -0,0 +1,80 @@
+// Produces a reco::PFCandidateCollection of a few collimated sprays over a
+// uniform soft background, which only depends on the event number, to run
+// the jet producers without an input file.
+
+#include "FWCore/Framework/interface/global/EDProducer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+
+#include "DataFormats/ParticleFlowCandidate/interface/PFCandidate.h"
+#include "DataFormats/ParticleFlowCandidate/interface/PFCandidateFwd.h"
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+
+class FakePFCandidateProducer : public edm::global::EDProducer<> {
+public:
+  explicit FakePFCandidateProducer(const edm::ParameterSet& iConfig);
+
+  void produce(edm::StreamID, edm::Event& iEvent, const edm::EventSetup& iSetup) const override;
+
+private:
+  unsigned int nSprays_;
+  unsigned int nBackground_;
+};
+
+namespace {
+
+  class Random {
+  public:
+    explicit Random(uint64_t seed) : state_(seed*2862933555777941757ULL + 3037000493ULL) {}
+    double operator()() {
+      state_ = state_*6364136223846793005ULL + 1442695040888963407ULL;
+      return (state_ >> 11)*(1./9007199254740992.);
+    }
+  private:
+    uint64_t state_;
+  };
+
+  void addCandidate(reco::PFCandidateCollection& candidates, double pt, double eta, double phi, Random& random) {
+    static const reco::PFCandidate::ParticleType types[] = {reco::PFCandidate::h, reco::PFCandidate::h, reco::PFCandidate::gamma,
+                                                            reco::PFCandidate::h0, reco::PFCandidate::e, reco::PFCandidate::mu};
+    reco::PFCandidate::ParticleType type = types[int(6*random()) % 6];
+    int charge = (type == reco::PFCandidate::gamma || type == reco::PFCandidate::h0) ? 0 : (random() < 0.5 ? -1 : 1);
+    reco::Particle::LorentzVector p4(pt*std::cos(phi), pt*std::sin(phi), pt*std::sinh(eta), pt*std::cosh(eta));
+    candidates.emplace_back(charge, p4, type);
+  }
+
+}
+
+FakePFCandidateProducer::FakePFCandidateProducer(const edm::ParameterSet& iConfig) :
+  nSprays_(iConfig.getParameter<unsigned int>("nSprays")),
+  nBackground_(iConfig.getParameter<unsigned int>("nBackground"))
+{
+  produces<reco::PFCandidateCollection>();
+}
+
+void FakePFCandidateProducer::produce(edm::StreamID, edm::Event& iEvent, const edm::EventSetup&) const
+{
+  Random random(iEvent.id().event());
+  auto candidates = std::make_unique<reco::PFCandidateCollection>();
+
+  for (unsigned int s = 0; s < nSprays_; ++s) {
+    double eta = 5.*random() - 2.5, phi = M_PI*(2.*random() - 1.);
+    double width = 0.05 + 0.3*random();
+    unsigned int n = 5 + int(30*random());
+    double ptSpray = 20. + 400.*random()*random();
+    for (unsigned int i = 0; i < n; ++i) {
+      addCandidate(*candidates, ptSpray/n*2.*random(), eta + width*(2.*random() - 1.), phi + width*(2.*random() - 1.), random);
+    }
+  }
+  for (unsigned int i = 0; i < nBackground_; ++i) {
+    addCandidate(*candidates, 0.3 + 3.*random()*random(), 9.*random() - 4.5, M_PI*(2.*random() - 1.), random);
+  }
+
+  iEvent.put(std::move(candidates));
+}
+
+DEFINE_FWK_MODULE(FakePFCandidateProducer);
@@ -0,0 +1,82 @@
+// Compares two jet collections made from the same inputs: the same jets in
+// the same order, with the same four-momenta, areas and constituents. Every
+// jet of the "test" collection must have constituents.
+
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+
+#include "DataFormats/Common/interface/Handle.h"
+#include "DataFormats/Common/interface/View.h"
+#include "DataFormats/JetReco/interface/Jet.h"
+
+#include <cmath>
+#include <iostream>
+#include <sstream>
+
+class JetCollectionComparator : public edm::global::EDAnalyzer<> {
+public:
+  explicit JetCollectionComparator(const edm::ParameterSet& iConfig);
+
+  void analyze(edm::StreamID, const edm::Event& iEvent, const edm::EventSetup& iSetup) const override;
+
+private:
+  edm::InputTag referenceTag_;
+  edm::InputTag testTag_;
+  edm::EDGetTokenT<edm::View<reco::Jet> > referenceToken_;
+  edm::EDGetTokenT<edm::View<reco::Jet> > testToken_;
+  double tolerance_;  // relative, on the four-momenta and the areas
+};
+
+JetCollectionComparator::JetCollectionComparator(const edm::ParameterSet& iConfig) :
+  referenceTag_(iConfig.getParameter<edm::InputTag>("reference")),
+  testTag_(iConfig.getParameter<edm::InputTag>("test")),
+  referenceToken_(consumes<edm::View<reco::Jet> >(referenceTag_)),
+  testToken_(consumes<edm::View<reco::Jet> >(testTag_)),
+  tolerance_(iConfig.getParameter<double>("tolerance"))
+{
+}
+
+void JetCollectionComparator::analyze(edm::StreamID, const edm::Event& iEvent, const edm::EventSetup&) const
+{
+  edm::Handle<edm::View<reco::Jet> > reference, test;
+  iEvent.getByToken(referenceToken_, reference);
+  iEvent.getByToken(testToken_, test);
+
+  auto differ = [this](double a, double b) { return std::abs(a - b) > tolerance_*std::max(1., std::max(std::abs(a), std::abs(b))); };
+
+  std::ostringstream errors;
+  if (reference->size() != test->size()) {
+    errors << "\n " << reference->size() << " jets in " << referenceTag_.encode() << ", " << test->size() << " in " << testTag_.encode();
+  }
+  for (unsigned int i = 0; i < std::min(reference->size(), test->size()); ++i) {
+    reco::Jet const& ref = (*reference)[i];
+    reco::Jet const& jet = (*test)[i];
+    if (differ(ref.px(), jet.px()) || differ(ref.py(), jet.py()) || differ(ref.pz(), jet.pz()) || differ(ref.energy(), jet.energy())) {
+      errors << "\n jet " << i << ": pt " << ref.pt() << " eta " << ref.eta() << " phi " << ref.phi()
+             << " in the reference, pt " << jet.pt() << " eta " << jet.eta() << " phi " << jet.phi();
+    }
+    if (differ(ref.jetArea(), jet.jetArea())) {
+      errors << "\n jet " << i << ": area " << ref.jetArea() << " in the reference, " << jet.jetArea();
+    }
+    if (ref.getJetConstituents() != jet.getJetConstituents()) {
+      errors << "\n jet " << i << ": " << ref.numberOfDaughters() << " constituents in the reference, "
+             << jet.numberOfDaughters() << ", or not the same";
+    }
+  }
+  for (unsigned int i = 0; i < test->size(); ++i) {
+    if ((*test)[i].numberOfDaughters() == 0) errors << "\n jet " << i << " of " << testTag_.encode() << " has no constituent";
+  }
+
+  if (!errors.str().empty()) {
+    throw cms::Exception("JetCollectionComparator") << "Event " << iEvent.id() << ": " << testTag_.encode()
+                                                    << " differs from " << referenceTag_.encode() << errors.str();
+  }
+  std::cout << "JetCollectionComparator: event " << iEvent.id().event() << ", " << test->size() << " jets of "
+            << testTag_.encode() << " identical to " << referenceTag_.encode() << std::endl;
+}
+
+DEFINE_FWK_MODULE(JetCollectionComparator);
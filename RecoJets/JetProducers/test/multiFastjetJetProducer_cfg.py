@@ -0,0 +1,61 @@
+# Runs MultiFastjetJetProducer next to the ak4PFJets and ak8PFJets
+# FastjetJetProducers on the same generated PF candidates, with active
+# areas and the same deterministic seeds, and checks that the jets, their
+# constituents and their areas agree. The "ak4all" definition has no pt
+# threshold, so that jets made of ghosts only would be produced.
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("TEST")
+
+process.load("FWCore.MessageService.MessageLogger_cfi")
+
+process.maxEvents = cms.untracked.PSet( input = cms.untracked.int32(20) )
+process.source = cms.Source("EmptySource")
+
+# the fastjet random generator is global: the modules must not run concurrently
+process.options = cms.untracked.PSet(
+    numberOfThreads = cms.untracked.uint32(1),
+    numberOfStreams = cms.untracked.uint32(1)
+)
+
+process.fakePFCandidates = cms.EDProducer("FakePFCandidateProducer",
+    nSprays = cms.uint32(12),
+    nBackground = cms.uint32(600)
+)
+
+from RecoJets.JetProducers.ak4PFJets_cfi import ak4PFJets
+from RecoJets.JetProducers.ak8PFJets_cfi import ak8PFJets
+process.ak4PFJets = ak4PFJets.clone(src = "fakePFCandidates")
+process.ak4PFJetsAll = ak4PFJets.clone(src = "fakePFCandidates", jetPtMin = 0.0)
+process.ak8PFJets = ak8PFJets.clone(src = "fakePFCandidates")
+
+from RecoJets.JetProducers.multiFastjetJetProducer_cfi import multiFastjetJetProducer
+process.multiPFJets = multiFastjetJetProducer.clone(
+    src = "fakePFCandidates",
+    jetType = ak4PFJets.jetType,
+    inputEtMin = ak4PFJets.inputEtMin,
+    inputEMin = ak4PFJets.inputEMin,
+    areaType = "active",
+    Ghost_EtaMax = ak4PFJets.Ghost_EtaMax,
+    GhostArea = ak4PFJets.GhostArea,
+    useDeterministicSeed = ak4PFJets.useDeterministicSeed,
+    minSeed = ak4PFJets.minSeed,
+    jets = cms.VPSet(
+        cms.PSet(label = cms.string("ak4"), jetAlgorithm = ak4PFJets.jetAlgorithm, rParam = ak4PFJets.rParam, jetPtMin = ak4PFJets.jetPtMin),
+        cms.PSet(label = cms.string("ak4all"), jetAlgorithm = ak4PFJets.jetAlgorithm, rParam = ak4PFJets.rParam, jetPtMin = cms.double(0.0)),
+        cms.PSet(label = cms.string("ak8"), jetAlgorithm = ak8PFJets.jetAlgorithm, rParam = ak8PFJets.rParam, jetPtMin = ak8PFJets.jetPtMin)
+    )
+)
+
+process.compareAK4 = cms.EDAnalyzer("JetCollectionComparator",
+    reference = cms.InputTag("ak4PFJets"),
+    test = cms.InputTag("multiPFJets", "ak4"),
+    tolerance = cms.double(1e-9)
+)
+process.compareAK4All = process.compareAK4.clone(reference = "ak4PFJetsAll", test = "multiPFJets:ak4all")
+process.compareAK8 = process.compareAK4.clone(reference = "ak8PFJets", test = "multiPFJets:ak8")
+
+process.p = cms.Path(process.fakePFCandidates *
+                     process.ak4PFJets * process.ak4PFJetsAll * process.ak8PFJets *
+                     process.multiPFJets *
+                     process.compareAK4 * process.compareAK4All * process.compareAK8)
@@ -0,0 +1,5 @@
+#!/bin/bash
+
+function die { echo Failure $1: status $2 ; exit $2 ; }
+
+cmsRun ${LOCAL_TEST_DIR}/multiFastjetJetProducer_cfg.py || die "cmsRun multiFastjetJetProducer_cfg.py" $?
@@ -22,6 +22,7 @@
 
 
 #include <iostream>
+#include <vector>
 
 using namespace std;
 
@@ -146,6 +147,13 @@ void PixelCPEBase::fillDetParams()
    
    m_DetParams.resize(m_detectors);
    LogDebug("PixelCPEBase::fillDetParams():") <<"caching "<<m_detectors<<" pixel detectors"<<endl;
+
+   //--- The field at the centre of all the modules, in one batch query
+   std::vector<GlobalPoint> detPositions(m_detectors);
+   std::vector<GlobalVector> detBfields(m_detectors);
+   for (unsigned i=0; i!=m_detectors;++i) detPositions[i] = dus[i]->surface().position();
+   magfield_->inTeslaBatch(detPositions.data(), detBfields.data(), m_detectors);
+
    for (unsigned i=0; i!=m_detectors;++i) {
       auto & p=m_DetParams[i];
       p.theDet = dynamic_cast<const PixelGeomDetUnit*>(dus[i]);
@@ -194,7 +202,7 @@ void PixelCPEBase::fillDetParams()
       p.thePitchY = pitchxy.second;	     // pitch along y
       
       
-      LocalVector Bfield = p.theDet->surface().toLocal(magfield_->inTesla(p.theDet->surface().position()));
+      LocalVector Bfield = p.theDet->surface().toLocal(detBfields[i]);
       p.bz = Bfield.z();
       p.bx = Bfield.x();
       
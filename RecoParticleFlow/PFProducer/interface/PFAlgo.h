@@ -65,6 +65,12 @@ class PFAlgo {
   void setMuonHandle(const edm::Handle<reco::MuonCollection>&);
   void setDebug( bool debug ) {debug_ = debug; connector_.setDebug(debug_); if (pfegamma_) pfegamma_->setDebug(debug); }
 
+  /// reconstruct the blocks concurrently, each into its own candidate
+  /// collection merged in the serial block order. Ignored in debug mode and
+  /// with the PFElectronAlgo/PFPhotonAlgo, which keep per-block state.
+  /// Uses PFAlgo's own block reconstruction, not an overridden processBlock.
+  void setParallelBlocks( bool parallelBlocks ) {parallelBlocks_ = parallelBlocks;}
+
   void setParameters(double nSigmaECAL,
                      double nSigmaHCAL, 
                      const boost::shared_ptr<PFEnergyCalibration>& calibration,
@@ -248,11 +254,18 @@ class PFAlgo {
   virtual void processBlock( const reco::PFBlockRef& blockref,
                              std::list<reco::PFBlockRef>& hcalBlockRefs, 
                              std::list<reco::PFBlockRef>& ecalBlockRefs ); 
+
+  /// process one block, adding the candidates to pfCandidates. 
+  /// Reads but does not modify the state of PFAlgo, unless the 
+  /// PFElectronAlgo or PFPhotonAlgo are used
+  void reconstructBlock( const reco::PFBlockRef& blockref,
+                         reco::PFCandidateCollection* pfCandidates );
   
   /// Reconstruct a charged particle from a track
-  /// Returns the index of the newly created candidate in pfCandidates_
+  /// Returns the index of the newly created candidate in pfCandidates
   /// Michalis added a flag here to treat muons inside jets
-  unsigned reconstructTrack( const reco::PFBlockElement& elt,bool allowLoose= false);
+  unsigned reconstructTrack( reco::PFCandidateCollection* pfCandidates,
+                             const reco::PFBlockElement& elt,bool allowLoose= false);
 
   /// Reconstruct a neutral particle from a cluster. 
   /// If chargedEnergy is specified, the neutral 
@@ -260,7 +273,8 @@ class PFAlgo {
   /// larger than the chargedEnergy. In this case, the energy of the 
   /// neutral particle is cluster energy - chargedEnergy
 
-  unsigned reconstructCluster( const reco::PFCluster& cluster,
+  unsigned reconstructCluster( reco::PFCandidateCollection* pfCandidates,
+                               const reco::PFCluster& cluster,
                                double particleEnergy,
 			       bool useDirection = false,
 			       double particleX=0.,
@@ -339,6 +353,7 @@ class PFAlgo {
   bool               useHO_;
   int                algo_;
   bool               debug_;
+  bool               parallelBlocks_;
 
   /// Variables for PFElectrons
   std::string mvaWeightFileEleID_;
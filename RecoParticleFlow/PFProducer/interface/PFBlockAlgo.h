@@ -138,8 +138,15 @@ class PFBlockAlgo {
   
   /// compute missing links in the blocks 
   /// (the recursive procedure does not build all links)  
+  /// elements: the indices in bare_elements_ of the block elements
+  /// firstLinks: the links of the first element to the others, by position
   void packLinks(reco::PFBlock& block, 
-		 const std::unordered_map<std::pair<unsigned int,unsigned int>,PFBlockLink>& links) const; 
+		 const unsigned* elements,
+		 const std::vector<std::pair<bool,double> >& firstLinks) const; 
+
+  /// distance of the link from element i to element j>i found while 
+  /// building the blocks; false if not found
+  bool findEdge(unsigned i, unsigned j, double& dist) const;
   
   /// Avoid to check links when not useful
   inline bool linkPrefilter(const reco::PFBlockElement* last, 
@@ -158,6 +165,17 @@ class PFBlockAlgo {
   ElementList       elements_; 
   std::vector<ElementList::value_type::pointer> bare_elements_;
   ElementRanges     ranges_;
+
+  /// links found while building the blocks, as a flat edge list sorted
+  /// by (i,j) with i<j the indices in bare_elements_, in CSR form: the
+  /// edges from element i are edgeTargets_/edgeDists_[edgeOffsets_[i]..edgeOffsets_[i+1])
+  std::vector<unsigned> edgeOffsets_;
+  std::vector<unsigned> edgeTargets_;
+  std::vector<double>   edgeDists_;
+
+  /// the elements of each block, in CSR form
+  std::vector<unsigned> blockOffsets_;
+  std::vector<unsigned> blockElements_;
   
   /// if true, debug printouts activated
   bool   debug_;
@@ -405,6 +405,9 @@ PFProducer::PFProducer(const edm::ParameterSet& iConfig) {
 
   pfAlgo_->setDebug( debug_ );
 
+  // Reconstruct the PF blocks concurrently
+  pfAlgo_->setParallelBlocks( iConfig.getUntrackedParameter<bool>("parallelBlocks",false) );
+
 }
 
 
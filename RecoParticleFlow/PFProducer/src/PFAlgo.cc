@@ -46,6 +46,10 @@
 #include "boost/graph/adjacency_matrix.hpp" 
 #include "boost/graph/graph_utility.hpp" 
 #include <numeric>
+#include <iterator>
+
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
 
 
 using namespace std;
@@ -62,6 +66,7 @@ PFAlgo::PFAlgo()
     nSigmaHCAL_(1),
     algo_(1),
     debug_(false),
+    parallelBlocks_(false),
     pfele_(nullptr),
     pfpho_(nullptr),
     pfegamma_(nullptr),
@@ -520,29 +525,58 @@ void PFAlgo::reconstructParticles( const reco::PFBlockCollection& blocks ) {
   }
 
 
-  // loop on blocks that are not single ecal, 
-  // and not single hcal.
+  if( parallelBlocks_ && !usePFElectrons_ && !usePFPhotons_ && !debug_ ) {
+
+    // the blocks are independent: reconstruct each one into its own 
+    // collection, and append them in the order of the serial loops below
+    std::vector< reco::PFBlockRef > blockRefs;
+    blockRefs.reserve( blocks.size() );
+    blockRefs.insert( blockRefs.end(), otherBlockRefs.begin(), otherBlockRefs.end() );
+    blockRefs.insert( blockRefs.end(), hcalBlockRefs.begin(), hcalBlockRefs.end() );
+    blockRefs.insert( blockRefs.end(), ecalBlockRefs.begin(), ecalBlockRefs.end() );
+
+    std::vector< reco::PFCandidateCollection > blockCandidates( blockRefs.size() );
+    tbb::parallel_for( tbb::blocked_range<unsigned>( 0, blockRefs.size() ),
+                       [&]( const tbb::blocked_range<unsigned>& range ) {
+                         for( unsigned i = range.begin(); i != range.end(); ++i )
+                           reconstructBlock( blockRefs[i], &blockCandidates[i] );
+                       } );
+
+    unsigned nCandidates = 0;
+    for( const auto& candidates : blockCandidates ) nCandidates += candidates.size();
+    pfCandidates_->reserve( nCandidates );
+    for( auto& candidates : blockCandidates )
+      pfCandidates_->insert( pfCandidates_->end(), 
+                             std::make_move_iterator( candidates.begin() ), 
+                             std::make_move_iterator( candidates.end() ) );
+
+  } else {
+
+    // loop on blocks that are not single ecal, 
+    // and not single hcal.
+
+    unsigned nblcks = 0;
+    for( IBR io = otherBlockRefs.begin(); io!=otherBlockRefs.end(); ++io) {
+      if ( debug_ ) std::cout << "Block number " << nblcks++ << std::endl; 
+      processBlock( *io, hcalBlockRefs, ecalBlockRefs );
+    }
 
-  unsigned nblcks = 0;
-  for( IBR io = otherBlockRefs.begin(); io!=otherBlockRefs.end(); ++io) {
-    if ( debug_ ) std::cout << "Block number " << nblcks++ << std::endl; 
-    processBlock( *io, hcalBlockRefs, ecalBlockRefs );
-  }
+    std::list< reco::PFBlockRef > empty;
 
-  std::list< reco::PFBlockRef > empty;
+    unsigned hblcks = 0;
+    // process remaining single hcal blocks
+    for( IBR ih = hcalBlockRefs.begin(); ih!=hcalBlockRefs.end(); ++ih) {
+      if ( debug_ ) std::cout << "HCAL block number " << hblcks++ << std::endl;
+      processBlock( *ih, empty, empty );
+    }
 
-  unsigned hblcks = 0;
-  // process remaining single hcal blocks
-  for( IBR ih = hcalBlockRefs.begin(); ih!=hcalBlockRefs.end(); ++ih) {
-    if ( debug_ ) std::cout << "HCAL block number " << hblcks++ << std::endl;
-    processBlock( *ih, empty, empty );
-  }
+    unsigned eblcks = 0;
+    // process remaining single ecal blocks
+    for( IBR ie = ecalBlockRefs.begin(); ie!=ecalBlockRefs.end(); ++ie) {
+      if ( debug_ ) std::cout << "ECAL block number " << eblcks++ << std::endl;
+      processBlock( *ie, empty, empty );
+    }
 
-  unsigned eblcks = 0;
-  // process remaining single ecal blocks
-  for( IBR ie = ecalBlockRefs.begin(); ie!=ecalBlockRefs.end(); ++ie) {
-    if ( debug_ ) std::cout << "ECAL block number " << eblcks++ << std::endl;
-    processBlock( *ie, empty, empty );
   }
 
   // Post HF Cleaning
@@ -560,6 +594,13 @@ void PFAlgo::reconstructParticles( const reco::PFBlockCollection& blocks ) {
 void PFAlgo::processBlock( const reco::PFBlockRef& blockref,
                            std::list<reco::PFBlockRef>& hcalBlockRefs, 
                            std::list<reco::PFBlockRef>& ecalBlockRefs ) { 
+
+  reconstructBlock( blockref, pfCandidates_.get() );
+}
+
+
+void PFAlgo::reconstructBlock( const reco::PFBlockRef& blockref,
+                               reco::PFCandidateCollection* pfCandidates ) { 
   
   // debug_ = false;
   assert(!blockref.isNull() );
@@ -633,7 +674,7 @@ void PFAlgo::processBlock( const reco::PFBlockRef& blockref,
       unsigned int extracand =0;
       PFCandidateCollection::const_iterator cand = pfPhotonCandidates_->begin();      
       for( ; cand != pfPhotonCandidates_->end(); ++cand, ++extracand) {
-	pfCandidates_->push_back(*cand);
+	pfCandidates->push_back(*cand);
 	pfPhotonExtra_.push_back(pfPhotonExtraCand[extracand]);
       }
       
@@ -644,7 +685,7 @@ void PFAlgo::processBlock( const reco::PFBlockRef& blockref,
   
   if (usePFElectrons_) {
     for ( std::vector<reco::PFCandidate>::const_iterator ec=tempElectronCandidates.begin();   ec != tempElectronCandidates.end(); ++ec ){
-      pfCandidates_->push_back(*ec);  
+      pfCandidates->push_back(*ec);  
     } 
     tempElectronCandidates.clear();
   }
@@ -769,7 +810,7 @@ void PFAlgo::processBlock( const reco::PFBlockRef& blockref,
 	    }
 	  }
 
-	  pfCandidates_->push_back(myPFElectron);
+	  pfCandidates->push_back(myPFElectron);
 
 	}
 	else {
@@ -811,7 +852,7 @@ void PFAlgo::processBlock( const reco::PFBlockRef& blockref,
 	    if(egmLocalBlockDebug||(debug_&&egmLocalDebug))
 	      cout << " Elements used " <<  ieb->second << endl;
 	  }
-	  pfCandidates_->push_back(myPFPhoton);
+	  pfCandidates->push_back(myPFPhoton);
 
 	} // end isSafe
       } // end isGoodPhoton
@@ -954,8 +995,8 @@ void PFAlgo::processBlock( const reco::PFBlockRef& blockref,
       if (isPrimaryTrack) {
 	if (debug_) cout << "Primary Track reconstructed alone" << endl;
 
-	unsigned tmpi = reconstructTrack(elements[iEle]);
-	(*pfCandidates_)[tmpi].addElementInBlock( blockref, iEle );
+	unsigned tmpi = reconstructTrack( pfCandidates, elements[iEle]);
+	(*pfCandidates)[tmpi].addElementInBlock( blockref, iEle );
 	active[iTrack] = false;
       }
     }
@@ -1261,7 +1302,7 @@ void PFAlgo::processBlock( const reco::PFBlockRef& blockref,
       if ( rejectFake ) continue;
 
       // Create a track candidate       
-      // unsigned tmpi = reconstructTrack( elements[iTrack] );
+      // unsigned tmpi = reconstructTrack( pfCandidates, elements[iTrack] );
       //active[iTrack] = false;
       std::vector<unsigned> tmpi;
       std::vector<unsigned> kTrack;
@@ -1292,19 +1333,19 @@ void PFAlgo::processBlock( const reco::PFBlockRef& blockref,
       }
 
 
-      tmpi.push_back(reconstructTrack( elements[iTrack]));
+      tmpi.push_back(reconstructTrack( pfCandidates, elements[iTrack]));
 
       kTrack.push_back(iTrack);
       active[iTrack] = false;
 
       // No ECAL cluster either ... continue...
       if ( ecalElems.empty() ) { 
-	(*pfCandidates_)[tmpi[0]].setEcalEnergy( 0., 0. );
-	(*pfCandidates_)[tmpi[0]].setHcalEnergy( 0., 0. );
-	(*pfCandidates_)[tmpi[0]].setHoEnergy( 0., 0. );
-	(*pfCandidates_)[tmpi[0]].setPs1Energy( 0 );
-	(*pfCandidates_)[tmpi[0]].setPs2Energy( 0 );
-	(*pfCandidates_)[tmpi[0]].addElementInBlock( blockref, kTrack[0] );
+	(*pfCandidates)[tmpi[0]].setEcalEnergy( 0., 0. );
+	(*pfCandidates)[tmpi[0]].setHcalEnergy( 0., 0. );
+	(*pfCandidates)[tmpi[0]].setHoEnergy( 0., 0. );
+	(*pfCandidates)[tmpi[0]].setPs1Energy( 0 );
+	(*pfCandidates)[tmpi[0]].setPs2Energy( 0 );
+	(*pfCandidates)[tmpi[0]].addElementInBlock( blockref, kTrack[0] );
 	continue;
       }
           
@@ -1316,13 +1357,13 @@ void PFAlgo::processBlock( const reco::PFBlockRef& blockref,
 
       // Set ECAL energy for muons
       if ( thisIsAMuon ) { 
-	(*pfCandidates_)[tmpi[0]].setEcalEnergy( clusterRef->energy(),
+	(*pfCandidates)[tmpi[0]].setEcalEnergy( clusterRef->energy(),
 						 std::min(clusterRef->energy(), muonECAL_[0]) );
-	(*pfCandidates_)[tmpi[0]].setHcalEnergy( 0., 0. );
-	(*pfCandidates_)[tmpi[0]].setHoEnergy( 0., 0. );
-	(*pfCandidates_)[tmpi[0]].setPs1Energy( 0 );
-	(*pfCandidates_)[tmpi[0]].setPs2Energy( 0 );
-	(*pfCandidates_)[tmpi[0]].addElementInBlock( blockref, kTrack[0] );
+	(*pfCandidates)[tmpi[0]].setHcalEnergy( 0., 0. );
+	(*pfCandidates)[tmpi[0]].setHoEnergy( 0., 0. );
+	(*pfCandidates)[tmpi[0]].setPs1Energy( 0 );
+	(*pfCandidates)[tmpi[0]].setPs2Energy( 0 );
+	(*pfCandidates)[tmpi[0]].addElementInBlock( blockref, kTrack[0] );
       }
       
       double slopeEcal = 1.;
@@ -1345,12 +1386,12 @@ void PFAlgo::processBlock( const reco::PFBlockRef& blockref,
           if (debug_) cout << " the closest track to ECAL " << thisEcal << " is " << sortedTracks.begin()->second << " (distance " << sortedTracks.begin()->first << ")" << endl;
           if (sortedTracks.begin()->second != iTrack) {
             if (debug_) cout << " the closest track to ECAL " << thisEcal << " is " << sortedTracks.begin()->second << " which is not the one being processed. Will skip ECAL linking for this track" << endl;
-            (*pfCandidates_)[tmpi[0]].setEcalEnergy( 0., 0. );
-            (*pfCandidates_)[tmpi[0]].setHcalEnergy( 0., 0. );
-            (*pfCandidates_)[tmpi[0]].setHoEnergy( 0., 0. );
-            (*pfCandidates_)[tmpi[0]].setPs1Energy( 0 );
-            (*pfCandidates_)[tmpi[0]].setPs2Energy( 0 );
-            (*pfCandidates_)[tmpi[0]].addElementInBlock( blockref, kTrack[0] );
+            (*pfCandidates)[tmpi[0]].setEcalEnergy( 0., 0. );
+            (*pfCandidates)[tmpi[0]].setHcalEnergy( 0., 0. );
+            (*pfCandidates)[tmpi[0]].setHoEnergy( 0., 0. );
+            (*pfCandidates)[tmpi[0]].setPs1Energy( 0 );
+            (*pfCandidates)[tmpi[0]].setPs2Energy( 0 );
+            (*pfCandidates)[tmpi[0]].addElementInBlock( blockref, kTrack[0] );
             continue;
           } else {
             if (debug_) cout << " the closest track to ECAL " << thisEcal << " is " << sortedTracks.begin()->second << " which is the one being processed. Will skip ECAL linking for all other track" << endl;
@@ -1431,20 +1472,20 @@ void PFAlgo::processBlock( const reco::PFBlockRef& blockref,
 
 	// And create a charged particle candidate !
 
-	tmpi.push_back(reconstructTrack( elements[jTrack] ));
+	tmpi.push_back(reconstructTrack( pfCandidates, elements[jTrack] ));
 
 
 	kTrack.push_back(jTrack);
 	active[jTrack] = false;
 
 	if ( thatIsAMuon ) { 
-	  (*pfCandidates_)[tmpi.back()].setEcalEnergy(clusterRef->energy(),
+	  (*pfCandidates)[tmpi.back()].setEcalEnergy(clusterRef->energy(),
 						      std::min(clusterRef->energy(),muonECAL_[0]));
-	  (*pfCandidates_)[tmpi.back()].setHcalEnergy( 0., 0. );
-	  (*pfCandidates_)[tmpi.back()].setHoEnergy( 0., 0. );
-	  (*pfCandidates_)[tmpi.back()].setPs1Energy( 0 );
-	  (*pfCandidates_)[tmpi.back()].setPs2Energy( 0 );
-	  (*pfCandidates_)[tmpi.back()].addElementInBlock( blockref, kTrack.back() );
+	  (*pfCandidates)[tmpi.back()].setHcalEnergy( 0., 0. );
+	  (*pfCandidates)[tmpi.back()].setHoEnergy( 0., 0. );
+	  (*pfCandidates)[tmpi.back()].setPs1Energy( 0 );
+	  (*pfCandidates)[tmpi.back()].setPs2Energy( 0 );
+	  (*pfCandidates)[tmpi.back()].addElementInBlock( blockref, kTrack.back() );
 	}
       }
 
@@ -1546,21 +1587,21 @@ void PFAlgo::processBlock( const reco::PFBlockRef& blockref,
 				    reco::PFBlock::LINKTEST_ALL );
 
 
-	  unsigned tmpe = reconstructCluster( *clusterRef, ecalEnergy ); 
-	  (*pfCandidates_)[tmpe].setEcalEnergy( clusterRef->energy(), ecalEnergy );
-	  (*pfCandidates_)[tmpe].setHcalEnergy( 0., 0. );
-	  (*pfCandidates_)[tmpe].setHoEnergy( 0., 0. );
-	  (*pfCandidates_)[tmpe].setPs1Energy( ps1Ene[0] );
-	  (*pfCandidates_)[tmpe].setPs2Energy( ps2Ene[0] );
-	  (*pfCandidates_)[tmpe].addElementInBlock( blockref, index );
+	  unsigned tmpe = reconstructCluster( pfCandidates, *clusterRef, ecalEnergy ); 
+	  (*pfCandidates)[tmpe].setEcalEnergy( clusterRef->energy(), ecalEnergy );
+	  (*pfCandidates)[tmpe].setHcalEnergy( 0., 0. );
+	  (*pfCandidates)[tmpe].setHoEnergy( 0., 0. );
+	  (*pfCandidates)[tmpe].setPs1Energy( ps1Ene[0] );
+	  (*pfCandidates)[tmpe].setPs2Energy( ps2Ene[0] );
+	  (*pfCandidates)[tmpe].addElementInBlock( blockref, index );
 	  // Check that there is at least one track
 	  if(!assTracks.empty()) {
-	    (*pfCandidates_)[tmpe].addElementInBlock( blockref, assTracks.begin()->second );
+	    (*pfCandidates)[tmpe].addElementInBlock( blockref, assTracks.begin()->second );
 	    
 	    // Assign the position of the track at the ECAL entrance
 	    const ::math::XYZPointF& chargedPosition = 
 	      dynamic_cast<const reco::PFBlockElementTrack*>(&elements[assTracks.begin()->second])->positionAtECALEntrance();
-	    (*pfCandidates_)[tmpe].setPositionAtECALEntrance(chargedPosition);
+	    (*pfCandidates)[tmpe].setPositionAtECALEntrance(chargedPosition);
 	  }
 	  break;
 	}
@@ -1570,7 +1611,7 @@ void PFAlgo::processBlock( const reco::PFBlockRef& blockref,
 	iEcal = index;
 	active[index] = false;
 	for (unsigned ic=0; ic<tmpi.size();++ic)  
-	  (*pfCandidates_)[tmpi[ic]].addElementInBlock( blockref, iEcal ); 
+	  (*pfCandidates)[tmpi[ic]].addElementInBlock( blockref, iEcal ); 
 
 
       } // Loop ecal elements
@@ -1621,48 +1662,48 @@ void PFAlgo::processBlock( const reco::PFBlockRef& blockref,
 	resol *= trackMomentum;
 	if ( neutralEnergy > std::max(0.5,nSigmaECAL_*resol) ) {
 	  neutralEnergy /= slopeEcal;
-	  unsigned tmpj = reconstructCluster( *pivotalRef, neutralEnergy ); 
-	  (*pfCandidates_)[tmpj].setEcalEnergy( pivotalRef->energy(), neutralEnergy );
-	  (*pfCandidates_)[tmpj].setHcalEnergy( 0., 0. );
-	  (*pfCandidates_)[tmpj].setHoEnergy( 0., 0. );
-	  (*pfCandidates_)[tmpj].setPs1Energy( 0. );
-	  (*pfCandidates_)[tmpj].setPs2Energy( 0. );
-	  (*pfCandidates_)[tmpj].addElementInBlock(blockref, iEcal);
+	  unsigned tmpj = reconstructCluster( pfCandidates, *pivotalRef, neutralEnergy ); 
+	  (*pfCandidates)[tmpj].setEcalEnergy( pivotalRef->energy(), neutralEnergy );
+	  (*pfCandidates)[tmpj].setHcalEnergy( 0., 0. );
+	  (*pfCandidates)[tmpj].setHoEnergy( 0., 0. );
+	  (*pfCandidates)[tmpj].setPs1Energy( 0. );
+	  (*pfCandidates)[tmpj].setPs2Energy( 0. );
+	  (*pfCandidates)[tmpj].addElementInBlock(blockref, iEcal);
 	  bNeutralProduced = true;
 	  for (unsigned ic=0; ic<kTrack.size();++ic) 
-	    (*pfCandidates_)[tmpj].addElementInBlock( blockref, kTrack[ic] ); 
+	    (*pfCandidates)[tmpj].addElementInBlock( blockref, kTrack[ic] ); 
 	} // End neutral energy
 
 	// Set elements in blocks and ECAL energies to all tracks
       	for (unsigned ic=0; ic<tmpi.size();++ic) { 
 	  
 	  // Skip muons
-	  if ( (*pfCandidates_)[tmpi[ic]].particleId() == reco::PFCandidate::mu ) continue; 
+	  if ( (*pfCandidates)[tmpi[ic]].particleId() == reco::PFCandidate::mu ) continue; 
 
-	  double fraction = trackMomentum > 0 ? (*pfCandidates_)[tmpi[ic]].trackRef()->p()/trackMomentum : 0;
+	  double fraction = trackMomentum > 0 ? (*pfCandidates)[tmpi[ic]].trackRef()->p()/trackMomentum : 0;
 	  double ecalCal = bNeutralProduced ? 
 	    (calibEcal-neutralEnergy*slopeEcal)*fraction : calibEcal*fraction;
 	  double ecalRaw = totalEcal*fraction;
 
 	  if (debug_) cout << "The fraction after photon supression is " << fraction << " calibrated ecal = " << ecalCal << endl;
 
-	  (*pfCandidates_)[tmpi[ic]].setEcalEnergy( ecalRaw, ecalCal );
-	  (*pfCandidates_)[tmpi[ic]].setHcalEnergy( 0., 0. );
-	  (*pfCandidates_)[tmpi[ic]].setHoEnergy( 0., 0. );
-	  (*pfCandidates_)[tmpi[ic]].setPs1Energy( 0 );
-	  (*pfCandidates_)[tmpi[ic]].setPs2Energy( 0 );
-	  (*pfCandidates_)[tmpi[ic]].addElementInBlock( blockref, kTrack[ic] );
+	  (*pfCandidates)[tmpi[ic]].setEcalEnergy( ecalRaw, ecalCal );
+	  (*pfCandidates)[tmpi[ic]].setHcalEnergy( 0., 0. );
+	  (*pfCandidates)[tmpi[ic]].setHoEnergy( 0., 0. );
+	  (*pfCandidates)[tmpi[ic]].setPs1Energy( 0 );
+	  (*pfCandidates)[tmpi[ic]].setPs2Energy( 0 );
+	  (*pfCandidates)[tmpi[ic]].addElementInBlock( blockref, kTrack[ic] );
 	}
 
       } // End connected ECAL
 
       // Fill the element_in_block for tracks that are eventually linked to no ECAL clusters at all.
       for (unsigned ic=0; ic<tmpi.size();++ic) { 
-	const PFCandidate& pfc = (*pfCandidates_)[tmpi[ic]];
+	const PFCandidate& pfc = (*pfCandidates)[tmpi[ic]];
 	const PFCandidate::ElementsInBlocks& eleInBlocks = pfc.elementsInBlocks();
 	if ( eleInBlocks.empty() ) { 
 	  if ( debug_ )std::cout << "Single track / Fill element in block! " << std::endl;
-	  (*pfCandidates_)[tmpi[ic]].addElementInBlock( blockref, kTrack[ic] );
+	  (*pfCandidates)[tmpi[ic]].addElementInBlock( blockref, kTrack[ic] );
 	}
       }
 
@@ -1729,13 +1770,13 @@ void PFAlgo::processBlock( const reco::PFBlockRef& blockref,
 							 clusterRef->positionREP().Eta(),
 							 clusterRef->positionREP().Phi()); 
 	}
-	tmpi = reconstructCluster( *clusterRef, energyHF );     
-	(*pfCandidates_)[tmpi].setEcalEnergy( uncalibratedenergyHF, energyHF );
-	(*pfCandidates_)[tmpi].setHcalEnergy( 0., 0.);
-	(*pfCandidates_)[tmpi].setHoEnergy( 0., 0.);
-	(*pfCandidates_)[tmpi].setPs1Energy( 0. );
-	(*pfCandidates_)[tmpi].setPs2Energy( 0. );
-	(*pfCandidates_)[tmpi].addElementInBlock( blockref, hfEmIs[0] );
+	tmpi = reconstructCluster( pfCandidates, *clusterRef, energyHF );     
+	(*pfCandidates)[tmpi].setEcalEnergy( uncalibratedenergyHF, energyHF );
+	(*pfCandidates)[tmpi].setHcalEnergy( 0., 0.);
+	(*pfCandidates)[tmpi].setHoEnergy( 0., 0.);
+	(*pfCandidates)[tmpi].setPs1Energy( 0. );
+	(*pfCandidates)[tmpi].setPs2Energy( 0. );
+	(*pfCandidates)[tmpi].addElementInBlock( blockref, hfEmIs[0] );
 	//std::cout << "HF EM alone ! " << energyHF << std::endl;
 	break;
       case PFLayer::HF_HAD:
@@ -1747,13 +1788,13 @@ void PFAlgo::processBlock( const reco::PFBlockRef& blockref,
 							 clusterRef->positionREP().Eta(),
 							 clusterRef->positionREP().Phi()); 
 	}
-	tmpi = reconstructCluster( *clusterRef, energyHF );     
-	(*pfCandidates_)[tmpi].setHcalEnergy( uncalibratedenergyHF, energyHF );
-	(*pfCandidates_)[tmpi].setEcalEnergy( 0., 0.);
-	(*pfCandidates_)[tmpi].setHoEnergy( 0., 0.);
-	(*pfCandidates_)[tmpi].setPs1Energy( 0. );
-	(*pfCandidates_)[tmpi].setPs2Energy( 0. );
-	(*pfCandidates_)[tmpi].addElementInBlock( blockref, hfHadIs[0] );
+	tmpi = reconstructCluster( pfCandidates, *clusterRef, energyHF );     
+	(*pfCandidates)[tmpi].setHcalEnergy( uncalibratedenergyHF, energyHF );
+	(*pfCandidates)[tmpi].setEcalEnergy( 0., 0.);
+	(*pfCandidates)[tmpi].setHoEnergy( 0., 0.);
+	(*pfCandidates)[tmpi].setPs1Energy( 0. );
+	(*pfCandidates)[tmpi].setPs2Energy( 0. );
+	(*pfCandidates)[tmpi].addElementInBlock( blockref, hfHadIs[0] );
 	//std::cout << "HF Had alone ! " << energyHF << std::endl;
 	break;
       default:
@@ -1791,14 +1832,14 @@ void PFAlgo::processBlock( const reco::PFBlockRef& blockref,
 							     c1->positionREP().Eta(),
 							     c1->positionREP().Phi()); 
       }
-      unsigned tmpi = reconstructCluster( *chad, energyHfEm+energyHfHad );     
-      (*pfCandidates_)[tmpi].setEcalEnergy( uncalibratedenergyHFEm, energyHfEm );
-      (*pfCandidates_)[tmpi].setHcalEnergy( uncalibratedenergyHFHad, energyHfHad);
-      (*pfCandidates_)[tmpi].setHoEnergy( 0., 0.);
-      (*pfCandidates_)[tmpi].setPs1Energy( 0. );
-      (*pfCandidates_)[tmpi].setPs2Energy( 0. );
-      (*pfCandidates_)[tmpi].addElementInBlock( blockref, hfEmIs[0] );
-      (*pfCandidates_)[tmpi].addElementInBlock( blockref, hfHadIs[0] );
+      unsigned tmpi = reconstructCluster( pfCandidates, *chad, energyHfEm+energyHfHad );     
+      (*pfCandidates)[tmpi].setEcalEnergy( uncalibratedenergyHFEm, energyHfEm );
+      (*pfCandidates)[tmpi].setHcalEnergy( uncalibratedenergyHFHad, energyHfHad);
+      (*pfCandidates)[tmpi].setHoEnergy( 0., 0.);
+      (*pfCandidates)[tmpi].setPs1Energy( 0. );
+      (*pfCandidates)[tmpi].setPs2Energy( 0. );
+      (*pfCandidates)[tmpi].addElementInBlock( blockref, hfEmIs[0] );
+      (*pfCandidates)[tmpi].addElementInBlock( blockref, hfHadIs[0] );
       //std::cout << "HF EM+HAD found ! " << energyHfEm << " " << energyHfHad << std::endl;     
     }
     else {
@@ -1980,11 +2021,11 @@ void PFAlgo::processBlock( const reco::PFBlockRef& blockref,
 
 	// Create a muon.
 
-	unsigned tmpi = reconstructTrack( elements[iTrack] );
+	unsigned tmpi = reconstructTrack( pfCandidates, elements[iTrack] );
 
 
-	(*pfCandidates_)[tmpi].addElementInBlock( blockref, iTrack );
-	(*pfCandidates_)[tmpi].addElementInBlock( blockref, iHcal );
+	(*pfCandidates)[tmpi].addElementInBlock( blockref, iTrack );
+	(*pfCandidates)[tmpi].addElementInBlock( blockref, iHcal );
 	double muonHcal = std::min(muonHCAL_[0]+muonHCAL_[1],totalHcal);
 
 	// if muon is isolated and muon momentum exceeds the calo energy, absorb the calo energy	
@@ -2012,9 +2053,9 @@ void PFAlgo::processBlock( const reco::PFBlockRef& blockref,
 	    }
 	  }
 
-	  // std::cout << "muon p / total calo = " << muonRef->p() << " "  << (pfCandidates_->back()).p() << " " << totalCaloEnergy << std::endl;
+	  // std::cout << "muon p / total calo = " << muonRef->p() << " "  << (pfCandidates->back()).p() << " " << totalCaloEnergy << std::endl;
 	  //if(muonRef->p() > totalCaloEnergy ) letMuonEatCaloEnergy = true;
-	  if( (pfCandidates_->back()).p() > totalCaloEnergy ) letMuonEatCaloEnergy = true;
+	  if( (pfCandidates->back()).p() > totalCaloEnergy ) letMuonEatCaloEnergy = true;
 	}
 
 	if(letMuonEatCaloEnergy) muonHcal = totalHcal;
@@ -2023,12 +2064,12 @@ void PFAlgo::processBlock( const reco::PFBlockRef& blockref,
 	if( !sortedEcals.empty() ) { 
 	  iEcal = sortedEcals.begin()->second; 
 	  PFClusterRef eclusterref = elements[iEcal].clusterRef();
-	  (*pfCandidates_)[tmpi].addElementInBlock( blockref, iEcal);
+	  (*pfCandidates)[tmpi].addElementInBlock( blockref, iEcal);
 	  muonEcal = std::min(muonECAL_[0]+muonECAL_[1],eclusterref->energy());
 	  if(letMuonEatCaloEnergy) muonEcal = eclusterref->energy();
 	  // If the muon expected energy accounts for the whole ecal cluster energy, lock the ecal cluster
 	  if ( eclusterref->energy() - muonEcal  < 0.2 ) active[iEcal] = false;
-	  (*pfCandidates_)[tmpi].setEcalEnergy(eclusterref->energy(), muonEcal);
+	  (*pfCandidates)[tmpi].setEcalEnergy(eclusterref->energy(), muonEcal);
 	}
 	unsigned iHO = 0;
 	double muonHO =0.;
@@ -2036,18 +2077,18 @@ void PFAlgo::processBlock( const reco::PFBlockRef& blockref,
 	  if( !sortedHOs.empty() ) { 
 	    iHO = sortedHOs.begin()->second; 
 	    PFClusterRef hoclusterref = elements[iHO].clusterRef();
-	    (*pfCandidates_)[tmpi].addElementInBlock( blockref, iHO);
+	    (*pfCandidates)[tmpi].addElementInBlock( blockref, iHO);
 	    muonHO = std::min(muonHO_[0]+muonHO_[1],hoclusterref->energy());
 	    if(letMuonEatCaloEnergy) muonHO = hoclusterref->energy();
 	    // If the muon expected energy accounts for the whole HO cluster energy, lock the HO cluster
 	    if ( hoclusterref->energy() - muonHO  < 0.2 ) active[iHO] = false;	    
-	    (*pfCandidates_)[tmpi].setHcalEnergy(totalHcal, muonHcal);
-	    (*pfCandidates_)[tmpi].setHoEnergy(hoclusterref->energy(), muonHO);
+	    (*pfCandidates)[tmpi].setHcalEnergy(totalHcal, muonHcal);
+	    (*pfCandidates)[tmpi].setHoEnergy(hoclusterref->energy(), muonHO);
 	  }
 	} else {
-	  (*pfCandidates_)[tmpi].setHcalEnergy(totalHcal, muonHcal);
+	  (*pfCandidates)[tmpi].setHcalEnergy(totalHcal, muonHcal);
 	}
-        setHcalDepthInfo((*pfCandidates_)[tmpi], *hclusterref);
+        setHcalDepthInfo((*pfCandidates)[tmpi], *hclusterref);
 
 	if(letMuonEatCaloEnergy){
 	  muonHCALEnergy += totalHcal;
@@ -2361,29 +2402,29 @@ void PFAlgo::processBlock( const reco::PFBlockRef& blockref,
 				    reco::PFBlock::LINKTEST_ALL );
 
 	  //Here allow for loose muons! 
-	  unsigned tmpi = reconstructTrack( elements[iTrack],true);
+	  unsigned tmpi = reconstructTrack( pfCandidates, elements[iTrack],true);
 
-	  (*pfCandidates_)[tmpi].addElementInBlock( blockref, iTrack );
-	  (*pfCandidates_)[tmpi].addElementInBlock( blockref, iHcal );
+	  (*pfCandidates)[tmpi].addElementInBlock( blockref, iTrack );
+	  (*pfCandidates)[tmpi].addElementInBlock( blockref, iHcal );
 	  double muonHcal = std::min(muonHCAL_[0]+muonHCAL_[1],totalHcal-totalHO);
 	  double muonHO = 0.;
-	  (*pfCandidates_)[tmpi].setHcalEnergy(totalHcal,muonHcal);
+	  (*pfCandidates)[tmpi].setHcalEnergy(totalHcal,muonHcal);
 	  if( !sortedEcals.empty() ) { 
 	    unsigned iEcal = sortedEcals.begin()->second; 
 	    PFClusterRef eclusterref = elements[iEcal].clusterRef();
-	    (*pfCandidates_)[tmpi].addElementInBlock( blockref, iEcal);
+	    (*pfCandidates)[tmpi].addElementInBlock( blockref, iEcal);
 	    double muonEcal = std::min(muonECAL_[0]+muonECAL_[1],eclusterref->energy());
-	    (*pfCandidates_)[tmpi].setEcalEnergy(eclusterref->energy(),muonEcal);
+	    (*pfCandidates)[tmpi].setEcalEnergy(eclusterref->energy(),muonEcal);
 	  }
 	  if( useHO_ && !sortedHOs.empty() ) { 
 	    unsigned iHO = sortedHOs.begin()->second; 
 	    PFClusterRef hoclusterref = elements[iHO].clusterRef();
-	    (*pfCandidates_)[tmpi].addElementInBlock( blockref, iHO);
+	    (*pfCandidates)[tmpi].addElementInBlock( blockref, iHO);
 	    muonHO = std::min(muonHO_[0]+muonHO_[1],hoclusterref->energy());
-	    (*pfCandidates_)[tmpi].setHcalEnergy(max(totalHcal-totalHO,0.0),muonHcal);
-	    (*pfCandidates_)[tmpi].setHoEnergy(hoclusterref->energy(),muonHO);
+	    (*pfCandidates)[tmpi].setHcalEnergy(max(totalHcal-totalHO,0.0),muonHcal);
+	    (*pfCandidates)[tmpi].setHoEnergy(hoclusterref->energy(),muonHO);
 	  }
-          setHcalDepthInfo((*pfCandidates_)[tmpi], *hclusterref);
+          setHcalDepthInfo((*pfCandidates)[tmpi], *hclusterref);
 	  // Remove it from the block
 	  const ::math::XYZPointF& chargedPosition = 
 	    dynamic_cast<const reco::PFBlockElementTrack*>(&elements[it->second.first])->positionAtECALEntrance();	  
@@ -2550,17 +2591,17 @@ void PFAlgo::processBlock( const reco::PFBlockRef& blockref,
       reco::TrackRef trackRef = elements[iTrack].trackRef();
       double trackMomentum = trackRef->p();
       double Dp = trackRef->qoverpError()*trackMomentum*trackMomentum;
-      unsigned tmpi = reconstructTrack( elements[iTrack] );
+      unsigned tmpi = reconstructTrack( pfCandidates, elements[iTrack] );
 
 
-      (*pfCandidates_)[tmpi].addElementInBlock( blockref, iTrack );
-      (*pfCandidates_)[tmpi].addElementInBlock( blockref, iHcal );
-      setHcalDepthInfo((*pfCandidates_)[tmpi], *hclusterref);
+      (*pfCandidates)[tmpi].addElementInBlock( blockref, iTrack );
+      (*pfCandidates)[tmpi].addElementInBlock( blockref, iHcal );
+      setHcalDepthInfo((*pfCandidates)[tmpi], *hclusterref);
       std::pair<II,II> myEcals = associatedEcals.equal_range(iTrack);
       for (II ii=myEcals.first; ii!=myEcals.second; ++ii ) { 
 	unsigned iEcal = ii->second.second;
 	if ( active[iEcal] ) continue;
-	(*pfCandidates_)[tmpi].addElementInBlock( blockref, iEcal );
+	(*pfCandidates)[tmpi].addElementInBlock( blockref, iEcal );
       }
       
       if (useHO_) {
@@ -2568,12 +2609,12 @@ void PFAlgo::processBlock( const reco::PFBlockRef& blockref,
 	for (II ii=myHOs.first; ii!=myHOs.second; ++ii ) { 
 	  unsigned iHO = ii->second.second;
 	  if ( active[iHO] ) continue;
-	  (*pfCandidates_)[tmpi].addElementInBlock( blockref, iHO );
+	  (*pfCandidates)[tmpi].addElementInBlock( blockref, iHO );
 	}
       }
 
       if ( iTrack == corrTrack ) { 
-	(*pfCandidates_)[tmpi].rescaleMomentum(corrFact);
+	(*pfCandidates)[tmpi].rescaleMomentum(corrFact);
 	trackMomentum *= corrFact;
       }
       chargedHadronsIndices.push_back( tmpi );
@@ -2664,7 +2705,7 @@ void PFAlgo::processBlock( const reco::PFBlockRef& blockref,
             //      unsigned iTrack = trackInfos[i].index;
             unsigned ich = chargedHadronsIndices[i];
             double rescaleFactor =  x(i)/hcalP[i];
-            (*pfCandidates_)[ich].rescaleMomentum( rescaleFactor );
+            (*pfCandidates)[ich].rescaleMomentum( rescaleFactor );
 
             if(debug_){
               cout<<"\t\t\told p "<<hcalP[i]
@@ -2838,7 +2879,7 @@ void PFAlgo::processBlock( const reco::PFBlockRef& blockref,
 		    << particleEnergy[iPivot] << std::endl;
 	
 	bool useDirection = true;
-	unsigned tmpi = reconstructCluster( *pivotalClusterRef[iPivot], 
+	unsigned tmpi = reconstructCluster( pfCandidates, *pivotalClusterRef[iPivot], 
 					    particleEnergy[iPivot], 
 					    useDirection,
 	                                    particleDirection[iPivot].X(),
@@ -2846,33 +2887,33 @@ void PFAlgo::processBlock( const reco::PFBlockRef& blockref,
 					    particleDirection[iPivot].Z()); 
 
       
-	(*pfCandidates_)[tmpi].setEcalEnergy( rawecalEnergy[iPivot],ecalEnergy[iPivot] );
+	(*pfCandidates)[tmpi].setEcalEnergy( rawecalEnergy[iPivot],ecalEnergy[iPivot] );
 	if ( !useHO_ ) { 
-	  (*pfCandidates_)[tmpi].setHcalEnergy( rawhcalEnergy[iPivot],hcalEnergy[iPivot] );
-	  (*pfCandidates_)[tmpi].setHoEnergy(0., 0.);
+	  (*pfCandidates)[tmpi].setHcalEnergy( rawhcalEnergy[iPivot],hcalEnergy[iPivot] );
+	  (*pfCandidates)[tmpi].setHoEnergy(0., 0.);
 	} else { 
-	  (*pfCandidates_)[tmpi].setHcalEnergy( max(rawhcalEnergy[iPivot]-totalHO,0.0),hcalEnergy[iPivot]*(1.-totalHO/rawhcalEnergy[iPivot]));
-	  (*pfCandidates_)[tmpi].setHoEnergy(totalHO, totalHO * hcalEnergy[iPivot]/rawhcalEnergy[iPivot]);
+	  (*pfCandidates)[tmpi].setHcalEnergy( max(rawhcalEnergy[iPivot]-totalHO,0.0),hcalEnergy[iPivot]*(1.-totalHO/rawhcalEnergy[iPivot]));
+	  (*pfCandidates)[tmpi].setHoEnergy(totalHO, totalHO * hcalEnergy[iPivot]/rawhcalEnergy[iPivot]);
 	} 
-	(*pfCandidates_)[tmpi].setPs1Energy( 0. );
-	(*pfCandidates_)[tmpi].setPs2Energy( 0. );
-	(*pfCandidates_)[tmpi].set_mva_nothing_gamma( -1. );
-	//       (*pfCandidates_)[tmpi].addElement(&elements[iPivotal]);
-	// (*pfCandidates_)[tmpi].addElementInBlock(blockref, iPivotal[iPivot]);
-	(*pfCandidates_)[tmpi].addElementInBlock( blockref, iHcal );
+	(*pfCandidates)[tmpi].setPs1Energy( 0. );
+	(*pfCandidates)[tmpi].setPs2Energy( 0. );
+	(*pfCandidates)[tmpi].set_mva_nothing_gamma( -1. );
+	//       (*pfCandidates)[tmpi].addElement(&elements[iPivotal]);
+	// (*pfCandidates)[tmpi].addElementInBlock(blockref, iPivotal[iPivot]);
+	(*pfCandidates)[tmpi].addElementInBlock( blockref, iHcal );
 	for ( unsigned ich=0; ich<chargedHadronsInBlock.size(); ++ich) { 
 	  unsigned iTrack = chargedHadronsInBlock[ich];
-	  (*pfCandidates_)[tmpi].addElementInBlock( blockref, iTrack );
+	  (*pfCandidates)[tmpi].addElementInBlock( blockref, iTrack );
 	  // Assign the position of the track at the ECAL entrance
 	  const ::math::XYZPointF& chargedPosition = 
 	    dynamic_cast<const reco::PFBlockElementTrack*>(&elements[iTrack])->positionAtECALEntrance();
-	  (*pfCandidates_)[tmpi].setPositionAtECALEntrance(chargedPosition);
+	  (*pfCandidates)[tmpi].setPositionAtECALEntrance(chargedPosition);
 
 	  std::pair<II,II> myEcals = associatedEcals.equal_range(iTrack);
 	  for (II ii=myEcals.first; ii!=myEcals.second; ++ii ) { 
 	    unsigned iEcal = ii->second.second;
 	    if ( active[iEcal] ) continue;
-	    (*pfCandidates_)[tmpi].addElementInBlock( blockref, iEcal );
+	    (*pfCandidates)[tmpi].addElementInBlock( blockref, iEcal );
 	  }
 	}
 
@@ -2910,13 +2951,13 @@ void PFAlgo::processBlock( const reco::PFBlockRef& blockref,
     double chargedHadronsTotalEnergy = 0;
     for( unsigned ich=0; ich<chargedHadronsIndices.size(); ++ich ) {
       unsigned index = chargedHadronsIndices[ich];
-      reco::PFCandidate& chargedHadron = (*pfCandidates_)[index];
+      reco::PFCandidate& chargedHadron = (*pfCandidates)[index];
       chargedHadronsTotalEnergy += chargedHadron.energy();
     }
 
     for( unsigned ich=0; ich<chargedHadronsIndices.size(); ++ich ) {
       unsigned index = chargedHadronsIndices[ich];
-      reco::PFCandidate& chargedHadron = (*pfCandidates_)[index];
+      reco::PFCandidate& chargedHadron = (*pfCandidates)[index];
       float fraction = chargedHadron.energy()/chargedHadronsTotalEnergy;
 
       if ( !useHO_ ) { 
@@ -2954,14 +2995,14 @@ void PFAlgo::processBlock( const reco::PFBlockRef& blockref,
 				reco::PFBlock::LINKTEST_ALL );
 
       // Create a photon
-      unsigned tmpi = reconstructCluster( *eclusterref, sqrt(is->second.second.Mag2()) ); 
-      (*pfCandidates_)[tmpi].setEcalEnergy( eclusterref->energy(),sqrt(is->second.second.Mag2()) );
-      (*pfCandidates_)[tmpi].setHcalEnergy( 0., 0. );
-      (*pfCandidates_)[tmpi].setHoEnergy( 0., 0. );
-      (*pfCandidates_)[tmpi].setPs1Energy( associatedPSs[iEcal].first );
-      (*pfCandidates_)[tmpi].setPs2Energy( associatedPSs[iEcal].second );
-      (*pfCandidates_)[tmpi].addElementInBlock( blockref, iEcal );
-      (*pfCandidates_)[tmpi].addElementInBlock( blockref, sortedTracks.begin()->second) ;
+      unsigned tmpi = reconstructCluster( pfCandidates, *eclusterref, sqrt(is->second.second.Mag2()) ); 
+      (*pfCandidates)[tmpi].setEcalEnergy( eclusterref->energy(),sqrt(is->second.second.Mag2()) );
+      (*pfCandidates)[tmpi].setHcalEnergy( 0., 0. );
+      (*pfCandidates)[tmpi].setHoEnergy( 0., 0. );
+      (*pfCandidates)[tmpi].setPs1Energy( associatedPSs[iEcal].first );
+      (*pfCandidates)[tmpi].setPs2Energy( associatedPSs[iEcal].second );
+      (*pfCandidates)[tmpi].addElementInBlock( blockref, iEcal );
+      (*pfCandidates)[tmpi].addElementInBlock( blockref, sortedTracks.begin()->second) ;
     }
 
 
@@ -3198,25 +3239,25 @@ void PFAlgo::processBlock( const reco::PFBlockRef& blockref,
     // double particleEnergy = totalEcal + calibHcal;
     // particleEnergy /= (1.-0.724/sqrt(particleEnergy)-0.0226/particleEnergy);
 
-    unsigned tmpi = reconstructCluster( *hclusterRef, 
+    unsigned tmpi = reconstructCluster( pfCandidates, *hclusterRef, 
                                         calibEcal+calibHcal ); 
 
     
-    (*pfCandidates_)[tmpi].setEcalEnergy( totalEcal, calibEcal );
+    (*pfCandidates)[tmpi].setEcalEnergy( totalEcal, calibEcal );
     if ( !useHO_ ) { 
-      (*pfCandidates_)[tmpi].setHcalEnergy( totalHcal, calibHcal );
-      (*pfCandidates_)[tmpi].setHoEnergy(0.,0.);
+      (*pfCandidates)[tmpi].setHcalEnergy( totalHcal, calibHcal );
+      (*pfCandidates)[tmpi].setHoEnergy(0.,0.);
     } else { 
-      (*pfCandidates_)[tmpi].setHcalEnergy( max(totalHcal-totalHO,0.0), calibHcal*(1.-totalHO/totalHcal));
-      (*pfCandidates_)[tmpi].setHoEnergy(totalHO,totalHO*calibHcal/totalHcal);
+      (*pfCandidates)[tmpi].setHcalEnergy( max(totalHcal-totalHO,0.0), calibHcal*(1.-totalHO/totalHcal));
+      (*pfCandidates)[tmpi].setHoEnergy(totalHO,totalHO*calibHcal/totalHcal);
     }
-    (*pfCandidates_)[tmpi].setPs1Energy( 0. );
-    (*pfCandidates_)[tmpi].setPs2Energy( 0. );
-    (*pfCandidates_)[tmpi].addElementInBlock( blockref, iHcal );
+    (*pfCandidates)[tmpi].setPs1Energy( 0. );
+    (*pfCandidates)[tmpi].setPs2Energy( 0. );
+    (*pfCandidates)[tmpi].addElementInBlock( blockref, iHcal );
     for (unsigned iec=0; iec<ecalRefs.size(); ++iec) 
-      (*pfCandidates_)[tmpi].addElementInBlock( blockref, ecalRefs[iec] );
+      (*pfCandidates)[tmpi].addElementInBlock( blockref, ecalRefs[iec] );
     for (unsigned iho=0; iho<hoRefs.size(); ++iho) 
-      (*pfCandidates_)[tmpi].addElementInBlock( blockref, hoRefs[iho] );
+      (*pfCandidates)[tmpi].addElementInBlock( blockref, hoRefs[iho] );
       
   }//loop hcal elements
 
@@ -3254,15 +3295,15 @@ void PFAlgo::processBlock( const reco::PFBlockRef& blockref,
     // float ecalEnergy = calibration_->energyEm( clusterref->energy() );
     double particleEnergy = ecalEnergy;
     
-    unsigned tmpi = reconstructCluster( *clusterref, 
+    unsigned tmpi = reconstructCluster( pfCandidates, *clusterref, 
                                         particleEnergy );
  
-    (*pfCandidates_)[tmpi].setEcalEnergy( clusterref->energy(),ecalEnergy );
-    (*pfCandidates_)[tmpi].setHcalEnergy( 0., 0. );
-    (*pfCandidates_)[tmpi].setHoEnergy( 0., 0. );
-    (*pfCandidates_)[tmpi].setPs1Energy( 0. );
-    (*pfCandidates_)[tmpi].setPs2Energy( 0. );
-    (*pfCandidates_)[tmpi].addElementInBlock( blockref, iEcal );
+    (*pfCandidates)[tmpi].setEcalEnergy( clusterref->energy(),ecalEnergy );
+    (*pfCandidates)[tmpi].setHcalEnergy( 0., 0. );
+    (*pfCandidates)[tmpi].setHoEnergy( 0., 0. );
+    (*pfCandidates)[tmpi].setPs1Energy( 0. );
+    (*pfCandidates)[tmpi].setPs2Energy( 0. );
+    (*pfCandidates)[tmpi].addElementInBlock( blockref, iEcal );
     
 
   }  // end loop on ecal elements iEcal = ecalIs[i]
@@ -3270,7 +3311,8 @@ void PFAlgo::processBlock( const reco::PFBlockRef& blockref,
 }  // end processBlock
 
 /////////////////////////////////////////////////////////////////////
-unsigned PFAlgo::reconstructTrack( const reco::PFBlockElement& elt, bool allowLoose) {
+unsigned PFAlgo::reconstructTrack( reco::PFCandidateCollection* pfCandidates,
+                                   const reco::PFBlockElement& elt, bool allowLoose) {
 
   const reco::PFBlockElementTrack* eltTrack 
     = dynamic_cast<const reco::PFBlockElementTrack*>(&elt);
@@ -3295,22 +3337,22 @@ unsigned PFAlgo::reconstructTrack( const reco::PFBlockElement& elt, bool allowLo
     = reco::PFCandidate::h;
 
   // Add it to the stack
-  pfCandidates_->push_back( PFCandidate( charge, 
+  pfCandidates->push_back( PFCandidate( charge, 
                                          momentum,
                                          particleType ) );
   //Set vertex and stuff like this
-  pfCandidates_->back().setVertexSource( PFCandidate::kTrkVertex );
-  pfCandidates_->back().setTrackRef( trackRef );
-  pfCandidates_->back().setPositionAtECALEntrance( eltTrack->positionAtECALEntrance());
+  pfCandidates->back().setVertexSource( PFCandidate::kTrkVertex );
+  pfCandidates->back().setTrackRef( trackRef );
+  pfCandidates->back().setPositionAtECALEntrance( eltTrack->positionAtECALEntrance());
   if( muonRef.isNonnull())
-    pfCandidates_->back().setMuonRef( muonRef );
+    pfCandidates->back().setMuonRef( muonRef );
 
 
   //Set time
-  if (elt.isTimeValid()) pfCandidates_->back().setTime( elt.time(), elt.timeError() );
+  if (elt.isTimeValid()) pfCandidates->back().setTime( elt.time(), elt.timeError() );
 
   //OK Now try to reconstruct the particle as a muon
-  bool isMuon=pfmu_->reconstructMuon(pfCandidates_->back(),muonRef,allowLoose);
+  bool isMuon=pfmu_->reconstructMuon(pfCandidates->back(),muonRef,allowLoose);
   bool isFromDisp = isFromSecInt(elt, "secondary");
 
 
@@ -3334,23 +3376,24 @@ unsigned PFAlgo::reconstructTrack( const reco::PFBlockElement& elt, bool allowLo
       if (debug_) 
 	cout << "Refitted px = " << px << " py = " << py << " pz = " << pz << " energy = " << energy << endl; 
     }
-    pfCandidates_->back().setFlag( reco::PFCandidate::T_FROM_DISP, true);
-    pfCandidates_->back().setDisplacedVertexRef( eltTrack->displacedVertexRef(reco::PFBlockElement::T_FROM_DISP)->displacedVertexRef(), reco::PFCandidate::T_FROM_DISP);
+    pfCandidates->back().setFlag( reco::PFCandidate::T_FROM_DISP, true);
+    pfCandidates->back().setDisplacedVertexRef( eltTrack->displacedVertexRef(reco::PFBlockElement::T_FROM_DISP)->displacedVertexRef(), reco::PFCandidate::T_FROM_DISP);
   }
 
   // do not label as primary a track which would be recognised as a muon. A muon cannot produce NI. It is with high probability a fake
   if(isFromSecInt(elt, "primary") && !isMuon) {
-    pfCandidates_->back().setFlag( reco::PFCandidate::T_TO_DISP, true);
-    pfCandidates_->back().setDisplacedVertexRef( eltTrack->displacedVertexRef(reco::PFBlockElement::T_TO_DISP)->displacedVertexRef(), reco::PFCandidate::T_TO_DISP);
+    pfCandidates->back().setFlag( reco::PFCandidate::T_TO_DISP, true);
+    pfCandidates->back().setDisplacedVertexRef( eltTrack->displacedVertexRef(reco::PFBlockElement::T_TO_DISP)->displacedVertexRef(), reco::PFCandidate::T_TO_DISP);
   }
 
   // returns index to the newly created PFCandidate
-  return pfCandidates_->size()-1;
+  return pfCandidates->size()-1;
 }
 
 
 unsigned 
-PFAlgo::reconstructCluster(const reco::PFCluster& cluster,
+PFAlgo::reconstructCluster(reco::PFCandidateCollection* pfCandidates,
+                           const reco::PFCluster& cluster,
                            double particleEnergy, 
                            bool useDirection, 
 			   double particleX,
@@ -3436,30 +3479,30 @@ PFAlgo::reconstructCluster(const reco::PFCluster& cluster,
   }
 
   // The pf candidate
-  pfCandidates_->push_back( PFCandidate( charge, 
+  pfCandidates->push_back( PFCandidate( charge, 
                                          tmp, 
                                          particleType ) );
 
   // The position at ECAL entrance (well: watch out, it is not true
   // for HCAL clusters... to be fixed)
-  pfCandidates_->back().
+  pfCandidates->back().
     setPositionAtECALEntrance(::math::XYZPointF(cluster.position().X(),
 					      cluster.position().Y(),
 					      cluster.position().Z()));
 
   //Set the cnadidate Vertex
-  pfCandidates_->back().setVertex(vertexPos);  
+  pfCandidates->back().setVertex(vertexPos);  
 
   // depth info
-  setHcalDepthInfo(pfCandidates_->back(), cluster);
+  setHcalDepthInfo(pfCandidates->back(), cluster);
 
   //*TODO* cluster time is not reliable at the moment, so only use track timing
 
   if(debug_) 
-    cout<<"** candidate: "<<pfCandidates_->back()<<endl; 
+    cout<<"** candidate: "<<pfCandidates->back()<<endl; 
 
   // returns index to the newly created PFCandidate
-  return pfCandidates_->size()-1;
+  return pfCandidates->size()-1;
 
 }
 
@@ -3851,7 +3894,7 @@ PFAlgo::checkCleaning( const reco::PFRecHitCollection& cleanedHits ) {
       const PFRecHit& hit = cleanedHits[hitsToBeAdded[j]];
       PFCluster cluster(hit.layer(), hit.energy(),
 			hit.position().x(), hit.position().y(), hit.position().z() );
-      reconstructCluster(cluster,hit.energy());
+      reconstructCluster(pfCandidates_.get(),cluster,hit.energy());
       if ( debug_ ) { 
 	std::cout << pfCandidates_->back() << ". time = " << hit.time() << std::endl;
       }
@@ -9,6 +9,7 @@
 
 #include <stdexcept>
 #include <algorithm>
+#include <numeric>
 #include "TMath.h"
 
 using namespace std;
@@ -164,7 +165,11 @@ void PFBlockAlgo::findBlocks() {
 
   QuickUnion qu(bare_elements_.size());
   const auto elem_size = bare_elements_.size();
+  edgeOffsets_.resize(elem_size+1);
+  edgeTargets_.clear();
+  edgeDists_.clear();
   for( unsigned i = 0; i < elem_size; ++i ) {
+    edgeOffsets_[i] = edgeTargets_.size();
     for( unsigned j = 0; j < elem_size; ++j ) {
       if( qu.connected(i,j) || j == i ) continue;
       if( !linkTests_[linkTestSquare_[bare_elements_[i]->type()][bare_elements_[j]->type()]] ) {
@@ -180,62 +185,74 @@ void PFBlockAlgo::findBlocks() {
         // compute linking info if it is possible
         if( dist > -0.5 ) {
           qu.unite(i,j);
+          // the blocks repeat this test with the elements in this order
+          if( i < j ) {
+            edgeTargets_.push_back(j);
+            edgeDists_.push_back(dist);
+          }
         }
       }
     }
   }
-  
-  std::unordered_multimap<unsigned,unsigned> blocksmap(elements_.size());
-  std::vector<unsigned> keys;
-  keys.reserve(elements_.size());
-  for( unsigned i = 0; i < elements_.size(); ++i ) {
+  edgeOffsets_[elem_size] = edgeTargets_.size();
+
+  // one block per root, in increasing order of the roots; the elements of 
+  // a block are in decreasing order, as the multimap used to give them
+  std::vector<unsigned> roots(elem_size);
+  blockOffsets_.assign(elem_size+1,0);
+  for( unsigned i = 0; i < elem_size; ++i ) {
     unsigned key = i; 
     while( key != qu.find(key) ) key = qu.find(key); // make sure we always find the root node...
-    auto pos  = std::lower_bound(keys.begin(),keys.end(),key);
-    if( pos == keys.end() || *pos != key ) {
-      keys.insert(pos,key);      
-    }
-    blocksmap.emplace(key,i);
+    roots[i] = key;
+    ++blockOffsets_[key+1];
+  }
+  std::partial_sum(blockOffsets_.begin(),blockOffsets_.end(),blockOffsets_.begin());
+  blockElements_.resize(elem_size);
+  std::vector<unsigned> slots(blockOffsets_.begin(),blockOffsets_.end()-1);
+  for( unsigned i = elem_size; i-- > 0; ) {
+    blockElements_[slots[roots[i]]++] = i;
   }
 
-  PFBlockLink::Type linktype = PFBlockLink::NONE;
-  PFBlock::LinkTest linktest = PFBlock::LINKTEST_RECHIT;
-  for( auto key : keys ) {
+  std::vector<std::pair<bool,double> > firstLinks;
+  for( unsigned key = 0; key < elem_size; ++key ) {
+    const unsigned begin = blockOffsets_[key];
+    const unsigned block_size = blockOffsets_[key+1] - begin;
+    if( block_size == 0 ) continue;
     blocks_->push_back( reco::PFBlock() );
-    auto range = blocksmap.equal_range(key);
     auto& the_block = blocks_->back();
-    ElementList::value_type::pointer p1(bare_elements_[range.first->second]);
+    const unsigned* elements = &blockElements_[begin];
+    ElementList::value_type::pointer p1(bare_elements_[elements[0]]);
     the_block.addElement(p1);
-    const unsigned block_size = blocksmap.count(key) + 1;
-    //reserve up to 1M or 8MB; pay rehash cost for more
-    std::unordered_map<std::pair<unsigned int,unsigned int>, PFBlockLink > links(min(1000000u,block_size*block_size));
-    auto itr = range.first;
-    ++itr;
-    for( ; itr != range.second; ++itr ) {
-      ElementList::value_type::pointer p2(bare_elements_[itr->second]);
-      const PFBlockElement::Type type1 = p1->type();
-      const PFBlockElement::Type type2 = p2->type();        
+    firstLinks.assign(block_size,std::make_pair(false,-1.));
+    for( unsigned k = 1; k < block_size; ++k ) {
+      ElementList::value_type::pointer p2(bare_elements_[elements[k]]);
       the_block.addElement(p2);
-      linktest = PFBlock::LINKTEST_RECHIT; //rechit by default 
-      linktype = static_cast<PFBlockLink::Type>(1<<(type1-1)|1<<(type2-1));
-      const unsigned index = linkTestSquare_[type1][type2];
+      const unsigned index = linkTestSquare_[p1->type()][p2->type()];
       if( nullptr != linkTests_[index] ) {
-        const double dist = linkTests_[index]->testLink(p1,p2);
-        links.emplace( std::make_pair(p1->index(), p2->index()) ,
-                       PFBlockLink( linktype, linktest, dist,
-                                    p1->index(), p2->index() ) );
+        firstLinks[k] = std::make_pair(true,linkTests_[index]->testLink(p1,p2));
       }
     }
-    packLinks( the_block, links );    
+    packLinks( the_block, elements, firstLinks );    
   }
   
   bare_elements_.clear();
   elements_.clear();
 }
 
+bool
+PFBlockAlgo::findEdge(unsigned i, unsigned j, double& dist) const {
+  const auto begin = edgeTargets_.begin() + edgeOffsets_[i];
+  const auto end = edgeTargets_.begin() + edgeOffsets_[i+1];
+  const auto pos = std::lower_bound(begin,end,j);
+  if( pos == end || *pos != j ) return false;
+  dist = edgeDists_[pos - edgeTargets_.begin()];
+  return true;
+}
+
 void 
 PFBlockAlgo::packLinks( reco::PFBlock& block, 
-			   const std::unordered_map<std::pair<unsigned int,unsigned int>,PFBlockLink>& links ) const {
+			   const unsigned* elements,
+			   const std::vector<std::pair<bool,double> >& firstLinks ) const {
   constexpr unsigned rowsize = reco::PFBlockElement::kNBETypes;
   
   const edm::OwnVector< reco::PFBlockElement >& els = block.elements();
@@ -256,13 +273,16 @@ PFBlockAlgo::packLinks( reco::PFBlock& block,
 	= PFBlock::LINKTEST_RECHIT; 
 
       // are these elements already linked ?
-      // this can be optimized
-      const auto link_itr = links.find(std::make_pair(i2,i1));
-      if( link_itr != links.end() ) {
-	dist = link_itr->second.dist();
-	linktest = link_itr->second.test();
+      if( i2 == 0 && firstLinks[i1].first ) {
+	dist = firstLinks[i1].second;
 	linked = true;
       }      
+
+      // the same test as below was done while building the blocks:
+      // elements are in decreasing order, so elements[i1] < elements[i2]
+      if( !linked && findEdge(elements[i1],elements[i2],dist) ) {
+	linked = true;
+      }
       
       if(!linked) {
         const PFBlockElement::Type type1 = els[i1].type();
@@ -0,0 +1,110 @@
+//
+// Class: PFCandidateExactComparator.cc
+//
+// Info: Checks that two PFCandidate collections are identical, candidate by
+//       candidate and bit by bit, e.g. the output of the serial and of the
+//       concurrent block reconstruction of PFAlgo.
+//
+
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/one/EDAnalyzer.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+
+#include "DataFormats/ParticleFlowCandidate/interface/PFCandidate.h"
+#include "DataFormats/ParticleFlowCandidate/interface/PFCandidateFwd.h"
+
+class PFCandidateExactComparator : public edm::one::EDAnalyzer<> {
+ public:
+  explicit PFCandidateExactComparator(const edm::ParameterSet&);
+
+  void analyze(const edm::Event&, const edm::EventSetup&) override;
+  void endJob() override;
+
+ private:
+  bool identical(const reco::PFCandidate& a, const reco::PFCandidate& b) const;
+
+  edm::EDGetTokenT<reco::PFCandidateCollection> tokenReference_;
+  edm::EDGetTokenT<reco::PFCandidateCollection> tokenTest_;
+  unsigned int maxPrintout_;
+
+  unsigned int nEvents_;
+  unsigned int nBadEvents_;
+  unsigned long nCandidates_;
+};
+
+PFCandidateExactComparator::PFCandidateExactComparator(const edm::ParameterSet& iConfig) :
+  tokenReference_(consumes<reco::PFCandidateCollection>(iConfig.getParameter<edm::InputTag>("reference"))),
+  tokenTest_(consumes<reco::PFCandidateCollection>(iConfig.getParameter<edm::InputTag>("test"))),
+  maxPrintout_(iConfig.getUntrackedParameter<unsigned int>("maxPrintout",10)),
+  nEvents_(0),
+  nBadEvents_(0),
+  nCandidates_(0) {
+}
+
+bool PFCandidateExactComparator::identical(const reco::PFCandidate& a, const reco::PFCandidate& b) const {
+
+  if( a.particleId() != b.particleId() ||
+      a.charge() != b.charge() ||
+      a.p4() != b.p4() ||
+      a.vertex() != b.vertex() ||
+      a.rawEcalEnergy() != b.rawEcalEnergy() ||
+      a.ecalEnergy() != b.ecalEnergy() ||
+      a.rawHcalEnergy() != b.rawHcalEnergy() ||
+      a.hcalEnergy() != b.hcalEnergy() ||
+      a.rawHoEnergy() != b.rawHoEnergy() ||
+      a.pS1Energy() != b.pS1Energy() ||
+      a.pS2Energy() != b.pS2Energy() ||
+      a.trackRef() != b.trackRef() ||
+      a.muonRef() != b.muonRef() )
+    return false;
+
+  const reco::PFCandidate::ElementsInBlocks& ea = a.elementsInBlocks();
+  const reco::PFCandidate::ElementsInBlocks& eb = b.elementsInBlocks();
+  if( ea.size() != eb.size() ) return false;
+  for( unsigned i=0; i<ea.size(); ++i ) {
+    if( ea[i].first != eb[i].first || ea[i].second != eb[i].second ) return false;
+  }
+  return true;
+}
+
+void PFCandidateExactComparator::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup) {
+
+  edm::Handle<reco::PFCandidateCollection> reference;
+  iEvent.getByToken(tokenReference_, reference);
+  edm::Handle<reco::PFCandidateCollection> test;
+  iEvent.getByToken(tokenTest_, test);
+
+  ++nEvents_;
+  nCandidates_ += reference->size();
+
+  bool bad = false;
+  if( reference->size() != test->size() ) {
+    bad = true;
+    if( nBadEvents_ < maxPrintout_ )
+      edm::LogError("PFCandidateExactComparator") << "Event " << iEvent.id() << ": "
+                                                  << reference->size() << " reference candidates, "
+                                                  << test->size() << " test candidates";
+  } else {
+    for( unsigned i=0; i<reference->size(); ++i ) {
+      if( !identical((*reference)[i], (*test)[i]) ) {
+        bad = true;
+        if( nBadEvents_ < maxPrintout_ )
+          edm::LogError("PFCandidateExactComparator") << "Event " << iEvent.id() << ", candidate " << i << " differs:\n"
+                                                      << "  reference " << (*reference)[i] << "\n"
+                                                      << "  test      " << (*test)[i];
+        break;
+      }
+    }
+  }
+  if( bad ) ++nBadEvents_;
+}
+
+void PFCandidateExactComparator::endJob() {
+  edm::LogVerbatim("PFCandidateExactComparator") << nBadEvents_ << " of " << nEvents_ << " events differ ("
+                                                 << nCandidates_ << " reference candidates)";
+}
+
+DEFINE_FWK_MODULE(PFCandidateExactComparator);
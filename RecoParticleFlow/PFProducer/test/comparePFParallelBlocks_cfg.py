@@ -0,0 +1,54 @@
+##############################################################################
+# Serial vs concurrent PF block reconstruction in PFAlgo.
+#   cmsRun comparePFParallelBlocks_cfg.py inputFiles=file:step3_RECODEBUG.root threads=8
+# The input must hold the inputs of particleFlowTmp (particleFlowBlock, muons,
+# vertices and the GED e/gamma collections), e.g. a RECODEBUG/FEVTDEBUG file.
+# The comparator reports the number of events whose candidates differ (expected
+# 0); the speedup is the ratio of the "particleFlowSerial" and
+# "particleFlowParallel" times in the FastTimerService summary.
+
+import FWCore.ParameterSet.Config as cms
+from FWCore.ParameterSet.VarParsing import VarParsing
+
+options = VarParsing('analysis')
+options.register('threads', 1, VarParsing.multiplicity.singleton, VarParsing.varType.int,
+                 "number of threads")
+options.parseArguments()
+
+process = cms.Process("PFCOMPARE")
+
+process.load("FWCore.MessageService.MessageLogger_cfi")
+process.MessageLogger.cerr.FwkReport.reportEvery = 100
+process.MessageLogger.categories.append("PFCandidateExactComparator")
+process.load("Configuration.StandardSequences.Services_cff")
+process.load("Configuration.StandardSequences.GeometryRecoDB_cff")
+process.load("Configuration.StandardSequences.MagneticField_cff")
+process.load("Configuration.StandardSequences.FrontierConditions_GlobalTag_cff")
+from Configuration.AlCa.GlobalTag import GlobalTag
+process.GlobalTag = GlobalTag(process.GlobalTag, 'auto:run2_mc', '')
+
+process.source = cms.Source("PoolSource",
+    fileNames = cms.untracked.vstring(options.inputFiles)
+)
+process.maxEvents = cms.untracked.PSet(input = cms.untracked.int32(options.maxEvents))
+process.options = cms.untracked.PSet(
+    numberOfThreads = cms.untracked.uint32(options.threads),
+    numberOfStreams = cms.untracked.uint32(0)
+)
+
+from RecoParticleFlow.PFProducer.particleFlow_cfi import particleFlowTmp
+process.particleFlowSerial = particleFlowTmp.clone(parallelBlocks = False)
+process.particleFlowParallel = particleFlowTmp.clone(parallelBlocks = True)
+
+process.comparePFCandidates = cms.EDAnalyzer("PFCandidateExactComparator",
+    reference = cms.InputTag("particleFlowSerial"),
+    test = cms.InputTag("particleFlowParallel"),
+    maxPrintout = cms.untracked.uint32(10)
+)
+
+process.load("HLTrigger.Timer.FastTimerService_cfi")
+process.FastTimerService.enableDQM = False
+process.FastTimerService.printRunSummary = False
+process.FastTimerService.printJobSummary = True
+
+process.p = cms.Path(process.particleFlowSerial * process.particleFlowParallel * process.comparePFCandidates)
@@ -129,5 +129,6 @@ private:
     const float caThetaCut = 0.00125f;
     const float caPhiCut = 0.1f;
     const float caHardPtCut = 0.f;
+    const bool caParallel = false;
 };
 #endif
@@ -171,13 +171,19 @@ public:
   
   
   int areAlignedRZ(float r1, float z1, float ro, float zo, const float ptmin, const float thetaCut) const
+  {
+    return areAlignedRZ(r1, z1, getInnerR(), getInnerZ(), ro, zo, ptmin, thetaCut);
+  }
+  
+  // (r2,z2) is the inner hit of the outer cell, shared with the inner cell
+  static int areAlignedRZ(float r1, float z1, float r2, float z2, float ro, float zo, const float ptmin, const float thetaCut)
   {
     float radius_diff = std::abs(r1 - ro);
     float distance_13_squared = radius_diff*radius_diff + (z1 - zo)*(z1 - zo);
     
     float pMin = ptmin*std::sqrt(distance_13_squared); //this needs to be divided by radius_diff later
     
-    float tan_12_13_half_mul_distance_13_squared = fabs(z1 * (getInnerR() - ro) + getInnerZ() * (ro - r1) + zo * (r1 - getInnerR())) ;
+    float tan_12_13_half_mul_distance_13_squared = fabs(z1 * (r2 - ro) + z2 * (ro - r1) + zo * (r1 - r2)) ;
     return tan_12_13_half_mul_distance_13_squared * pMin <= thetaCut * distance_13_squared * radius_diff;
   }
   
@@ -186,21 +192,24 @@ public:
   {
     theOuterNeighbors.push_back(otherCell);
   }
+
+  const CAntuple & getOuterNeighbors() const
+  {
+    return theOuterNeighbors;
+  }
   
   
   bool haveSimilarCurvature(const CACell & otherCell, const float ptmin,
 			    const float region_origin_x, const float region_origin_y, const float region_origin_radius, const float phiCut, const float hardPtCut) const
   {
-    
-    
-    auto x1 = otherCell.getInnerX();
-    auto y1 = otherCell.getInnerY();
-    
-    auto x2 = getInnerX();
-    auto y2 = getInnerY();
-    
-    auto x3 = getOuterX();
-    auto y3 = getOuterY();
+    return haveSimilarCurvature(otherCell.getInnerX(), otherCell.getInnerY(), getInnerX(), getInnerY(), getOuterX(), getOuterY(),
+				ptmin, region_origin_x, region_origin_y, region_origin_radius, phiCut, hardPtCut);
+  }
+  
+  // (x1,y1) is the inner hit of the inner cell, (x2,y2) and (x3,y3) the hits of the outer one
+  static bool haveSimilarCurvature(float x1, float y1, float x2, float y2, float x3, float y3, const float ptmin,
+				   const float region_origin_x, const float region_origin_y, const float region_origin_radius, const float phiCut, const float hardPtCut)
+  {
     
     float distance_13_squared = (x1 - x3)*(x1 - x3) + (y1 - y3)*(y1 - y3);
     float tan_12_13_half_mul_distance_13_squared = std::abs(y1 * (x2 - x3) + y2 * (x3 - x1) + y3 * (x1 - x2)) ;
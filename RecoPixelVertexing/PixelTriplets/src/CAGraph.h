@@ -25,6 +25,8 @@ struct CALayer
   std::vector<int> theOuterLayers;
   std::vector<int> theInnerLayers;
   std::vector<std::vector<unsigned int>> isOuterHitOfCell;
+  // only sized and filled by the parallel CellularAutomaton
+  std::vector<std::vector<unsigned int>> isInnerHitOfCell;
 
 private:
   std::string theName;
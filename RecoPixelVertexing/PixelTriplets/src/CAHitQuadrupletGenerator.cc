@@ -34,7 +34,8 @@ fitFastCircleChi2Cut(cfg.getParameter<bool>("fitFastCircleChi2Cut")),
 useBendingCorrection(cfg.getParameter<bool>("useBendingCorrection")),
 caThetaCut(cfg.getParameter<double>("CAThetaCut")),
 caPhiCut(cfg.getParameter<double>("CAPhiCut")),
-caHardPtCut(cfg.getParameter<double>("CAHardPtCut"))
+caHardPtCut(cfg.getParameter<double>("CAHardPtCut")),
+caParallel(cfg.getUntrackedParameter<bool>("CAParallel", false))
 {
   edm::ParameterSet comparitorPSet = cfg.getParameter<edm::ParameterSet>("SeedComparitorPSet");
   std::string comparitorName = comparitorPSet.getParameter<std::string>("ComponentName");
@@ -52,6 +53,7 @@ void CAHitQuadrupletGenerator::fillDescriptions(edm::ParameterSetDescription& de
   desc.add<double>("CAThetaCut", 0.00125);
   desc.add<double>("CAPhiCut", 10);
   desc.add<double>("CAHardPtCut", 0);
+  desc.addUntracked<bool>("CAParallel", false)->setComment("Connect, evolve and follow the cells concurrently (same quadruplets as the serial cellular automaton)");
   desc.addOptional<bool>("CAOnlyOneLastHitPerLayerFilter")->setComment("Deprecated and has no effect. To be fully removed later when the parameter is no longer used in HLT configurations.");
   edm::ParameterSetDescription descMaxChi2;
   descMaxChi2.add<double>("pt1", 0.2);
@@ -110,6 +112,7 @@ namespace {
 		g.theLayers[i].theOuterLayers.clear();
 		g.theLayers[i].theOuterLayerPairs.clear();
 		for (auto & v : g.theLayers[i].isOuterHitOfCell) v.clear();
+		for (auto & v : g.theLayers[i].isInnerHitOfCell) v.clear();
 	}
 
   }
@@ -196,7 +199,7 @@ void CAHitQuadrupletGenerator::hitNtuplets(const IntermediateHitDoublets& region
 
 	  fillGraph(layers, regionLayerPairs, g, hitDoublets);
 
-	CellularAutomaton ca(g);
+	CellularAutomaton ca(g, caParallel);
 
 	ca.createAndConnectCells(hitDoublets, region, caThetaCut,
 			caPhiCut, caHardPtCut);
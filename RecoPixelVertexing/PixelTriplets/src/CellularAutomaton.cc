@@ -1,5 +1,9 @@
+#include <iterator>
 #include <queue>
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
 #include "CellularAutomaton.h"
 
 void CellularAutomaton::createAndConnectCells(
@@ -9,6 +13,12 @@ void CellularAutomaton::createAndConnectCells(
     const float phiCut,
     const float hardPtCut)
 {
+  if (theParallel) {
+    createCells(hitDoublets);
+    connectCellsParallel(hitDoublets, region, thetaCut, phiCut, hardPtCut);
+    return;
+  }
+
   int tsize = 0;
   for (auto hd : hitDoublets) {
     tsize += hd->size();
@@ -87,6 +97,19 @@ void CellularAutomaton::evolve(const unsigned int minHitsPerNtuplet)
   unsigned int numberOfIterations = minHitsPerNtuplet - 2;
   // keeping the last iteration for later
   for (unsigned int iteration = 0; iteration < numberOfIterations - 1; ++iteration) {
+    if (theParallel) {
+      // lockstep: all the cells are evolved before any state is updated
+      tbb::parallel_for(tbb::blocked_range<unsigned int>(0, allCells.size()),
+                        [&](const tbb::blocked_range<unsigned int>& range) {
+                          for (auto i = range.begin(); i != range.end(); ++i) allCells[i].evolve(i, allStatus);
+                        });
+      tbb::parallel_for(tbb::blocked_range<unsigned int>(0, allCells.size()),
+                        [&](const tbb::blocked_range<unsigned int>& range) {
+                          for (auto i = range.begin(); i != range.end(); ++i) allStatus[i].updateState();
+                        });
+      continue;
+    }
+
     for (auto & layerPair : theLayerGraph.theLayerPairs) {
       for (auto i = layerPair.theFoundCells[0]; i < layerPair.theFoundCells[1]; ++i) {
         allCells[i].evolve(i, allStatus);
@@ -102,13 +125,40 @@ void CellularAutomaton::evolve(const unsigned int minHitsPerNtuplet)
 
   // last iteration
 
+  // the states are updated in place: a root cell can see the new state of the cells of
+  // another root layer pair, so that this is done in parallel only if none follows a root layer
+  bool parallelLastIteration = theParallel;
+  for (int rootLayerId : theLayerGraph.theRootLayers) {
+    for (int rootLayerPair : theLayerGraph.theLayers[rootLayerId].theOuterLayerPairs) {
+      for (int otherRootLayerId : theLayerGraph.theRootLayers) {
+        if (theLayerGraph.theLayerPairs[rootLayerPair].theLayers[1] == otherRootLayerId) parallelLastIteration = false;
+      }
+    }
+  }
+  if (parallelLastIteration) {
+    for (int rootLayerId : theLayerGraph.theRootLayers) {
+      for (int rootLayerPair : theLayerGraph.theLayers[rootLayerId].theOuterLayerPairs) {
+        auto foundCells = theLayerGraph.theLayerPairs[rootLayerPair].theFoundCells;
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(foundCells[0], foundCells[1]),
+                          [&](const tbb::blocked_range<unsigned int>& range) {
+                            for (auto i = range.begin(); i != range.end(); ++i) {
+                              allCells[i].evolve(i, allStatus);
+                              allStatus[i].updateState();
+                            }
+                          });
+      }
+    }
+  }
+
   for (int rootLayerId : theLayerGraph.theRootLayers) {
     for (int rootLayerPair : theLayerGraph.theLayers[rootLayerId].theOuterLayerPairs) {
       auto foundCells = theLayerGraph.theLayerPairs[rootLayerPair].theFoundCells;
       for (auto i = foundCells[0]; i < foundCells[1]; ++i) {
         auto & cell = allStatus[i];
-        allCells[i].evolve(i, allStatus);
-        cell.updateState();
+        if (!parallelLastIteration) {
+          allCells[i].evolve(i, allStatus);
+          cell.updateState();
+        }
         if (cell.isRootCell(minHitsPerNtuplet - 2)) {
           theRootCells.push_back(i);
         }
@@ -119,6 +169,11 @@ void CellularAutomaton::evolve(const unsigned int minHitsPerNtuplet)
 
 void CellularAutomaton::findNtuplets(std::vector<CACell::CAntuplet> & foundNtuplets, const unsigned int minHitsPerNtuplet)
 {
+  if (theParallel) {
+    findNtupletsParallel(foundNtuplets, minHitsPerNtuplet);
+    return;
+  }
+
   CACell::CAntuple tmpNtuplet;
   tmpNtuplet.reserve(minHitsPerNtuplet);
 
@@ -208,3 +263,137 @@ void CellularAutomaton::findTriplets(
     }
   }
 }
+
+void CellularAutomaton::createCells(const std::vector<const HitDoublets *> & hitDoublets)
+{
+  int tsize = 0;
+  for (auto hd : hitDoublets) {
+    tsize += hd->size();
+  }
+  allCells.reserve(tsize);
+  unsigned int cellId = 0;
+
+  for (auto & layer : theLayerGraph.theLayers) {
+    layer.isInnerHitOfCell.resize(layer.isOuterHitOfCell.size());
+  }
+
+  std::vector<bool> alreadyVisitedLayerPairs(theLayerGraph.theLayerPairs.size(), false);
+  for (int rootVertex : theLayerGraph.theRootLayers) {
+    std::queue<int> LayerPairsToVisit;
+
+    for (int LayerPair : theLayerGraph.theLayers[rootVertex].theOuterLayerPairs) {
+      LayerPairsToVisit.push(LayerPair);
+    }
+
+    while (not LayerPairsToVisit.empty()) {
+      auto currentLayerPair = LayerPairsToVisit.front();
+      auto & currentLayerPairRef  = theLayerGraph.theLayerPairs[currentLayerPair];
+      auto & currentInnerLayerRef = theLayerGraph.theLayers[currentLayerPairRef.theLayers[0]];
+      auto & currentOuterLayerRef = theLayerGraph.theLayers[currentLayerPairRef.theLayers[1]];
+      bool allInnerLayerPairsAlreadyVisited{true};
+
+      for (auto innerLayerPair : currentInnerLayerRef.theInnerLayerPairs) {
+        allInnerLayerPairsAlreadyVisited &= alreadyVisitedLayerPairs[innerLayerPair];
+      }
+
+      if (alreadyVisitedLayerPairs[currentLayerPair] == false and allInnerLayerPairsAlreadyVisited) {
+        const HitDoublets *doubletLayerPairId = hitDoublets[currentLayerPair];
+        auto numberOfDoublets = doubletLayerPairId->size();
+        currentLayerPairRef.theFoundCells[0] = cellId;
+        currentLayerPairRef.theFoundCells[1] = cellId + numberOfDoublets;
+        for (unsigned int i = 0; i < numberOfDoublets; ++i) {
+          allCells.emplace_back(doubletLayerPairId, i,
+                                doubletLayerPairId->innerHitId(i),
+                                doubletLayerPairId->outerHitId(i));
+
+          currentOuterLayerRef.isOuterHitOfCell[doubletLayerPairId->outerHitId(i)].push_back(cellId);
+          currentInnerLayerRef.isInnerHitOfCell[doubletLayerPairId->innerHitId(i)].push_back(cellId);
+
+          cellId++;
+        }
+        for (auto outerLayerPair : currentOuterLayerRef.theOuterLayerPairs) {
+          LayerPairsToVisit.push(outerLayerPair);
+        }
+
+        alreadyVisitedLayerPairs[currentLayerPair] = true;
+      }
+      LayerPairsToVisit.pop();
+    }
+  }
+}
+
+void CellularAutomaton::connectCellsParallel(
+    const std::vector<const HitDoublets *> & hitDoublets,
+    const TrackingRegion & region,
+    const float thetaCut,
+    const float phiCut,
+    const float hardPtCut)
+{
+  float ptmin = region.ptMin();
+  float region_origin_x = region.origin().x();
+  float region_origin_y = region.origin().y();
+  float region_origin_radius = region.originRBound();
+
+  // the coordinates of the hits of the cells (SoA), read many times below
+  auto ncells = allCells.size();
+  std::vector<float> innerX(ncells), innerY(ncells), innerR(ncells), innerZ(ncells);
+  std::vector<float> outerX(ncells), outerY(ncells), outerR(ncells), outerZ(ncells);
+  tbb::parallel_for(tbb::blocked_range<unsigned int>(0, ncells),
+                    [&](const tbb::blocked_range<unsigned int>& range) {
+                      for (auto i = range.begin(); i != range.end(); ++i) {
+                        auto const & cell = allCells[i];
+                        innerX[i] = cell.getInnerX(); innerY[i] = cell.getInnerY();
+                        innerR[i] = cell.getInnerR(); innerZ[i] = cell.getInnerZ();
+                        outerX[i] = cell.getOuterX(); outerY[i] = cell.getOuterY();
+                        outerR[i] = cell.getOuterR(); outerZ[i] = cell.getOuterZ();
+                      }
+                    });
+
+  // The serial connection tags an inner cell from each of the outer cells that start from its
+  // outer hit, in increasing id of the outer cells. Here each inner cell collects them itself,
+  // in the same order, so that the cells are connected per layer pair concurrently without
+  // sharing any neighbour list.
+  tbb::parallel_for(tbb::blocked_range<std::size_t>(0, theLayerGraph.theLayerPairs.size(), 1),
+                    [&](const tbb::blocked_range<std::size_t>& layerPairs) {
+    for (auto layerPair = layerPairs.begin(); layerPair != layerPairs.end(); ++layerPair) {
+      auto const & layerPairRef = theLayerGraph.theLayerPairs[layerPair];
+      auto const & outerLayerRef = theLayerGraph.theLayers[layerPairRef.theLayers[1]];
+      const HitDoublets *doublets = hitDoublets[layerPair];
+      auto firstCell = layerPairRef.theFoundCells[0];
+      tbb::parallel_for(tbb::blocked_range<unsigned int>(firstCell, layerPairRef.theFoundCells[1]),
+                        [&](const tbb::blocked_range<unsigned int>& range) {
+        for (auto ic = range.begin(); ic != range.end(); ++ic) {
+          auto & innerCell = allCells[ic];
+          for (auto oc : outerLayerRef.isInnerHitOfCell[doublets->outerHitId(ic - firstCell)]) {
+            if (CACell::areAlignedRZ(innerR[ic], innerZ[ic], innerR[oc], innerZ[oc], outerR[oc], outerZ[oc], ptmin, thetaCut) &&
+                CACell::haveSimilarCurvature(innerX[ic], innerY[ic], innerX[oc], innerY[oc], outerX[oc], outerY[oc], ptmin,
+                                             region_origin_x, region_origin_y, region_origin_radius, phiCut, hardPtCut)) {
+              innerCell.tagAsOuterNeighbor(oc);
+            }
+          }
+        }
+      });
+    }
+  });
+}
+
+void CellularAutomaton::findNtupletsParallel(std::vector<CACell::CAntuplet> & foundNtuplets, const unsigned int minHitsPerNtuplet)
+{
+  // one list per root cell, merged in the order of the root cells
+  std::vector<std::vector<CACell::CAntuplet>> ntupletsOfRootCell(theRootCells.size());
+  tbb::parallel_for(tbb::blocked_range<std::size_t>(0, theRootCells.size()),
+                    [&](const tbb::blocked_range<std::size_t>& range) {
+                      CACell::CAntuple tmpNtuplet;
+                      tmpNtuplet.reserve(minHitsPerNtuplet);
+                      for (auto k = range.begin(); k != range.end(); ++k) {
+                        tmpNtuplet.clear();
+                        tmpNtuplet.push_back(theRootCells[k]);
+                        allCells[theRootCells[k]].findNtuplets(allCells, ntupletsOfRootCell[k], tmpNtuplet, minHitsPerNtuplet);
+                      }
+                    });
+
+  for (auto & ntuplets : ntupletsOfRootCell) {
+    foundNtuplets.insert(foundNtuplets.end(), std::make_move_iterator(ntuplets.begin()),
+                         std::make_move_iterator(ntuplets.end()));
+  }
+}
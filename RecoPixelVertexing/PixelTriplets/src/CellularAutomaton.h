@@ -12,8 +12,11 @@
 class CellularAutomaton
 {
 public:
-  CellularAutomaton(CAGraph& graph)
-    : theLayerGraph(graph)
+  // in parallel mode the cells are connected, evolved and followed concurrently
+  // (tbb), with the same cells, neighbours and ntuplets, in the same order, as
+  // in the serial mode; findTriplets is always serial
+  CellularAutomaton(CAGraph& graph, bool parallel = false)
+    : theLayerGraph(graph), theParallel(parallel)
   { }
   
   std::vector<CACell> & getAllCells() { return allCells; }
@@ -27,7 +30,14 @@ public:
 		    const float thetaCut, const float phiCut, const float hardPtCut);
   
 private:
+  // creates the cells of the layer pairs in the order of createAndConnectCells, not connected
+  void createCells(const std::vector<const HitDoublets *>&);
+  void connectCellsParallel(const std::vector<const HitDoublets *>&,
+			    const TrackingRegion&, const float, const float, const float);
+  void findNtupletsParallel(std::vector<CACell::CAntuplet>&, const unsigned int);
+
   CAGraph & theLayerGraph;
+  const bool theParallel;
 
   std::vector<CACell> allCells;
   std::vector<CACellStatus> allStatus;
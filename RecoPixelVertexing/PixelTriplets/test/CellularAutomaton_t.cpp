@@ -0,0 +1,155 @@
+// Checks that the parallel mode of the CellularAutomaton gives the same
+// cells, neighbours and quadruplets, in the same order, as the serial mode,
+// on the doublets of a synthetic five-layer graph with one and two root
+// layers (with two, the last evolution stays serial).
+
+#include "RecoPixelVertexing/PixelTriplets/src/CellularAutomaton.h"
+#include "RecoTracker/TkTrackingRegions/interface/GlobalTrackingRegion.h"
+#include "TrackingTools/DetLayers/interface/DetLayer.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+  // only isBarrel() is used by RecHitsSortedInPhi
+  class BarrelLayer final : public DetLayer {
+  public:
+    BarrelLayer() : DetLayer(false, true) {}
+    const BoundSurface& surface() const override { throw cms::Exception("BarrelLayer") << "no surface"; }
+    const std::vector<const GeometricSearchDet*>& components() const override { return theComponents; }
+    const std::vector<const GeomDet*>& basicComponents() const override { return theBasicComponents; }
+    std::pair<bool, TrajectoryStateOnSurface> compatible(const TrajectoryStateOnSurface&, const Propagator&,
+                                                         const MeasurementEstimator&) const override {
+      throw cms::Exception("BarrelLayer") << "no compatible dets";
+    }
+    SubDetector subDetector() const override { return GeomDetEnumerators::PixelBarrel; }
+    Location location() const override { return GeomDetEnumerators::barrel; }
+  private:
+    std::vector<const GeometricSearchDet*> theComponents;
+    std::vector<const GeomDet*> theBasicComponents;
+  };
+
+  struct TestHit { float phi, x, y, z, r; };
+
+  // the hits are filled directly in the SoA of the layer, without rechits
+  std::unique_ptr<RecHitsSortedInPhi> makeLayer(std::vector<TestHit> hits, DetLayer const& detLayer) {
+    std::sort(hits.begin(), hits.end(), [](TestHit const& a, TestHit const& b) { return a.phi < b.phi; });
+    auto layer = std::make_unique<RecHitsSortedInPhi>(std::vector<RecHitsSortedInPhi::Hit>(), GlobalPoint(0, 0, 0), &detLayer);
+    for (auto const& h : hits) {
+      layer->theHits.emplace_back(nullptr, h.phi);
+      layer->x.push_back(h.x); layer->y.push_back(h.y); layer->z.push_back(h.z);
+      layer->u.push_back(h.r); layer->v.push_back(h.z);
+    }
+    return layer;
+  }
+
+  struct Result {
+    std::vector<CACell> cells;
+    std::vector<std::array<unsigned int, 2> > foundCells;
+    std::vector<CACell::CAntuplet> quadruplets;
+  };
+
+  // the layer pairs 0-1, 1-2, 2-3, 2-4, 1-3 and 3-4 on the doublets
+  constexpr int nLayerPairs = 6;
+  constexpr int layerPairs[nLayerPairs][2] = {{0,1}, {1,2}, {2,3}, {2,4}, {1,3}, {3,4}};
+
+  Result run(std::vector<std::unique_ptr<RecHitsSortedInPhi> > const& layers, std::vector<const HitDoublets*> const& doublets,
+             std::vector<int> const& rootLayers, bool parallel) {
+    CAGraph graph;
+    for (unsigned int l = 0; l < layers.size(); ++l) graph.theLayers.emplace_back(std::to_string(l), layers[l]->size());
+    graph.theRootLayers = rootLayers;
+    for (int k = 0; k < nLayerPairs; ++k) {
+      auto inner = layerPairs[k][0], outer = layerPairs[k][1];
+      graph.theLayerPairs.emplace_back(inner, outer);
+      graph.theLayers[outer].theInnerLayers.push_back(inner);
+      graph.theLayers[inner].theOuterLayers.push_back(outer);
+      graph.theLayers[outer].theInnerLayerPairs.push_back(k);
+      graph.theLayers[inner].theOuterLayerPairs.push_back(k);
+    }
+
+    CellularAutomaton ca(graph, parallel);
+    GlobalTrackingRegion region(0.5f, GlobalPoint(0.01, -0.02, 0.), 0.2f, 15.f, true);
+    ca.createAndConnectCells(doublets, region, 0.002f, 0.2f, 0.f);
+    ca.evolve(4);
+    std::vector<CACell::CAntuplet> quadruplets;
+    ca.findNtuplets(quadruplets, 4);
+    std::vector<std::array<unsigned int, 2> > foundCells;
+    for (auto const& layerPair : graph.theLayerPairs) foundCells.push_back(layerPair.theFoundCells);
+    // the cells are not assignable
+    return Result{ca.getAllCells(), foundCells, quadruplets};
+  }
+
+  bool compare(const char* name, Result const& serial, Result const& parallel) {
+    bool ok = serial.foundCells == parallel.foundCells && serial.cells.size() == parallel.cells.size();
+    unsigned int nNeighbors = 0;
+    for (unsigned int i = 0; i < serial.cells.size(); ++i) {
+      nNeighbors += serial.cells[i].getOuterNeighbors().size();
+    }
+    for (unsigned int i = 0; ok && i < serial.cells.size(); ++i) {
+      auto const& s = serial.cells[i];
+      auto const& p = parallel.cells[i];
+      ok = s.getInnerX() == p.getInnerX() && s.getInnerY() == p.getInnerY() && s.getInnerZ() == p.getInnerZ() &&
+           s.getOuterX() == p.getOuterX() && s.getOuterY() == p.getOuterY() && s.getOuterZ() == p.getOuterZ() &&
+           s.getOuterNeighbors() == p.getOuterNeighbors();
+    }
+    ok = ok && serial.quadruplets == parallel.quadruplets;
+    std::cout << name << ": " << serial.cells.size() << " cells, " << nNeighbors << " neighbours, "
+              << serial.quadruplets.size() << " quadruplets: " << (ok ? "identical" : "DIFFERENT") << std::endl;
+    // an empty graph would prove nothing
+    return ok && nNeighbors > 0 && !serial.quadruplets.empty();
+  }
+
+}
+
+int main() {
+  std::mt19937 gen(1);
+  std::uniform_real_distribution<float> uniform(0.f, 1.f);
+
+  // straight-ish tracks from the beam spot through five barrel layers
+  constexpr int nLayers = 5;
+  const float radii[nLayers] = {2.9f, 6.8f, 10.9f, 16.0f, 20.0f};
+  std::vector<std::vector<TestHit> > hits(nLayers);
+  for (int t = 0; t < 6000; ++t) {
+    float phi0 = uniform(gen)*6.28f - 3.14f, eta = uniform(gen)*4.f - 2.f;
+    float z0 = (uniform(gen) - 0.5f)*10.f, curvature = (uniform(gen) - 0.5f)*0.004f;
+    for (int l = 0; l < nLayers; ++l) {
+      float r = radii[l];
+      float phi = phi0 + curvature*r + (uniform(gen) - 0.5f)*0.001f;
+      if (phi > 3.14159f) phi -= 6.2832f;
+      if (phi < -3.14159f) phi += 6.2832f;
+      hits[l].push_back({phi, r*std::cos(phi), r*std::sin(phi), z0 + r*std::sinh(eta) + (uniform(gen) - 0.5f)*0.01f, r});
+    }
+  }
+  BarrelLayer detLayer;
+  std::vector<std::unique_ptr<RecHitsSortedInPhi> > layers;
+  for (auto const& h : hits) layers.push_back(makeLayer(h, detLayer));
+
+  // all the pairs compatible in phi and roughly pointing to the beam spot in z
+  std::vector<std::unique_ptr<HitDoublets> > doubletsOfLayerPair;
+  std::vector<const HitDoublets*> doublets;
+  for (auto const& layerPair : layerPairs) {
+    auto const& inner = *layers[layerPair[0]];
+    auto const& outer = *layers[layerPair[1]];
+    doubletsOfLayerPair.push_back(std::make_unique<HitDoublets>(inner, outer));
+    for (unsigned int o = 0; o < outer.size(); ++o) {
+      auto b = std::lower_bound(inner.theHits.begin(), inner.theHits.end(), outer.phi(o) - 0.01f, RecHitsSortedInPhi::HitLessPhi());
+      auto e = std::upper_bound(b, inner.theHits.end(), outer.phi(o) + 0.01f, RecHitsSortedInPhi::HitLessPhi());
+      for (auto i = b - inner.theHits.begin(); i != e - inner.theHits.begin(); ++i) {
+        if (std::abs(inner.z[i]*outer.u[o]/inner.u[i] - outer.z[o]) < 3.f) doubletsOfLayerPair.back()->add(i, o);
+      }
+    }
+    doublets.push_back(doubletsOfLayerPair.back().get());
+  }
+
+  bool ok = true;
+  ok &= compare("one root layer", run(layers, doublets, {0}, false), run(layers, doublets, {0}, true));
+  ok &= compare("two root layers", run(layers, doublets, {0, 1}, false), run(layers, doublets, {0, 1}, true));
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,180 @@
+import FWCore.ParameterSet.Config as cms
+
+# Regional mode of the iterative tracking, for skims and reprocessing that
+# only need the tracks near some objects of interest (leptons, jets, ...).
+#
+# The global tracking regions of the iterations are replaced by
+# RectangularEtaPhiTrackingRegions (CandidateSeededTrackingRegionsEDProducer,
+# as in the HLT) in the directions of the candidates of regionInput, which are
+# expected to be sorted in decreasing pt. Each iteration keeps its pt
+# threshold, origin radius and z extent. The pattern recognition only follows
+# the seeds, so the tracks, the cluster masks passed from one iteration to the
+# next and the vertices are all regional, while the MeasurementTrackerEvent and
+# the masks are built and chained as in the full tracking.
+#
+# Only the region producers of the iterTrackingTask are converted, unless the
+# labels to convert are given explicitly: the pixel tracks and vertices, the
+# HLT, the heavy-ion and the other reconstruction sequences keep their regions.
+# A region with settings that the candidate-seeded regions cannot reproduce
+# (multiple scattering, fake or no vertices, the occupancy scaling of the
+# heavy-ion regions, ...) is an error rather than silently changed.
+#
+# The regions with vertices keep one region per object and vertex. Without a
+# valid vertex, the global regions fall back to nSigmaZ times the sigmaZ of the
+# beam spot, which the candidate-seeded regions do not read (they use the
+# error on its z0): the fallback is a fixed half length of nSigmaZ times
+# beamSpotSigmaZ, in cm, which must then be given. The regions on all the
+# vertices (maxNVertices = -1) stay on all of them, without a limit on the
+# number of regions, unless maxNVertices is given.
+#
+# Not converted: the JetCoreRegionalStep regions (already around jets) and the
+# pixel inactive-area recovery regions of PixelPairStep (phase 1).
+#
+# Usage:
+#   from RecoTracker.Configuration.customizeRegionalTracking import customizeRegionalTracking
+#   process = customizeRegionalTracking(process, "selectedMuons", deltaEta=0.3, deltaPhi=0.3, beamSpotSigmaZ=3.5)
+#   process = customizeRegionalTracking(process, "selectedMuons", labels=["initialStepTrackingRegions"])
+
+# the largest int32: no limit on the vertices or the regions
+_unlimited = 2**31-1
+
+_globalRegionTypes = [
+    "GlobalTrackingRegionFromBeamSpotEDProducer",
+    "GlobalTrackingRegionWithVerticesEDProducer",
+]
+
+# RegionPSet parameters of the global regions, with the value they must have
+# when it cannot be reproduced (None: mapped or not used)
+_beamSpotParameters = dict(
+    precise = None,
+    useMultipleScattering = False,
+    nSigmaZ = None,
+    originHalfLength = None,
+    originRadius = None,
+    ptMin = None,
+    beamSpot = None,
+)
+_withVerticesParameters = dict(
+    precise = None,
+    useMultipleScattering = False,
+    beamSpot = None,
+    useFixedError = None,
+    originRadius = None,
+    sigmaZVertex = None,
+    fixedError = None,
+    VertexCollection = None,
+    ptMin = None,
+    useFoundVertices = True,
+    useFakeVertices = False,
+    maxNVertices = None,
+    nSigmaZ = None,
+    # only used by the occupancy scaling of the heavy-ion regions
+    pixelClustersForScaling = None,
+    originRScaling4BigEvts = False,
+    ptMinScaling4BigEvts = False,
+    halfLengthScaling4BigEvts = False,
+    minOriginR = None,
+    maxPtMin = None,
+    minHalfLength = None,
+    scalingStartNPix = None,
+    scalingEndNPix = None,
+)
+_regionParameters = {
+    "GlobalTrackingRegionFromBeamSpotEDProducer" : _beamSpotParameters,
+    "GlobalTrackingRegionWithVerticesEDProducer" : _withVerticesParameters,
+}
+
+def _checkRegion(label, module):
+    cppType = module.type_()
+    if module.parameterNames_() != ["RegionPSet"]:
+        raise Exception("customizeRegionalTracking: %s has parameters other than RegionPSet: %s" % (label, ", ".join(module.parameterNames_())))
+    region = module.RegionPSet
+    parameters = _regionParameters[cppType]
+    unknown = [p for p in region.parameterNames_() if p not in parameters]
+    if len(unknown) > 0:
+        raise Exception("customizeRegionalTracking: %s (%s) has RegionPSet parameters that cannot be mapped: %s" % (label, cppType, ", ".join(unknown)))
+    unsupported = [p for p in region.parameterNames_() if parameters[p] is not None and getattr(region, p).value() != parameters[p]]
+    if cppType == "GlobalTrackingRegionFromBeamSpotEDProducer" and \
+       hasattr(region, "nSigmaZ") and region.nSigmaZ.value() > 0 and \
+       hasattr(region, "originHalfLength") and region.originHalfLength.value() > 0:
+        # the half length would be the larger of the two
+        unsupported.extend(["nSigmaZ", "originHalfLength"])
+    if len(unsupported) > 0:
+        raise Exception("customizeRegionalTracking: %s (%s) has settings that the candidate-seeded regions do not support: %s" % (label, cppType, ", ".join("%s = %s" % (p, getattr(region, p).value()) for p in unsupported)))
+
+def _regionalRegionPSet(cppType, region, regionInput, deltaEta, deltaPhi, maxNRegions, maxNVertices, beamSpotSigmaZ):
+    pset = cms.PSet(
+        input = cms.InputTag(regionInput),
+        maxNRegions = cms.int32(maxNRegions),
+        beamSpot = cms.InputTag("offlineBeamSpot"),
+        vertexCollection = cms.InputTag("firstStepPrimaryVertices"),
+        maxNVertices = cms.int32(1),
+        ptMin = cms.double(region.ptMin.value()),
+        originRadius = cms.double(region.originRadius.value()),
+        zErrorBeamSpot = cms.double(24.2),
+        deltaEta = cms.double(deltaEta),
+        deltaPhi = cms.double(deltaPhi),
+        precise = cms.bool(region.precise.value() if hasattr(region, "precise") else True),
+        nSigmaZVertex = cms.double(3.0),
+        zErrorVetex = cms.double(0.2),
+        nSigmaZBeamSpot = cms.double(4.0),
+        # the seeding layers apply the cluster masks of the iteration
+        whereToUseMeasurementTracker = cms.string("Never"),
+        measurementTrackerName = cms.InputTag(""),
+        searchOpt = cms.bool(False),
+    )
+    if hasattr(region, "beamSpot"):
+        pset.beamSpot = region.beamSpot.value()
+
+    if cppType == "GlobalTrackingRegionWithVerticesEDProducer":
+        # one region per object and vertex
+        nVertices = region.maxNVertices.value()
+        if nVertices < 0:
+            nVertices = maxNVertices if maxNVertices is not None else _unlimited
+        pset.mode = cms.string("VerticesFixed" if region.useFixedError.value() else "VerticesSigma")
+        pset.vertexCollection = region.VertexCollection.value()
+        pset.maxNVertices = nVertices
+        pset.maxNRegions = min(maxNRegions*nVertices, _unlimited)
+        pset.zErrorVetex = region.fixedError.value()
+        pset.nSigmaZVertex = region.sigmaZVertex.value()
+        # without a vertex: the fixed half length of the global regions
+        pset.nSigmaZBeamSpot = -1.
+        pset.zErrorBeamSpot = max(region.nSigmaZ.value(), 0.)*beamSpotSigmaZ
+    elif hasattr(region, "nSigmaZ") and region.nSigmaZ.value() > 0:
+        pset.mode = cms.string("BeamSpotSigma")
+        pset.nSigmaZBeamSpot = region.nSigmaZ.value()
+    else:
+        pset.mode = cms.string("BeamSpotFixed")
+        pset.zErrorBeamSpot = region.originHalfLength.value() if hasattr(region, "originHalfLength") else 0.
+    return pset
+
+def _iterationRegionLabels(process):
+    if not hasattr(process, "iterTrackingTask"):
+        raise Exception("customizeRegionalTracking: the process has no iterTrackingTask, give the labels of the tracking regions to convert")
+    producers = process.producers_()
+    return sorted(label for label in process.iterTrackingTask.moduleNames()
+                  if label in producers and producers[label].type_() in _globalRegionTypes)
+
+def customizeRegionalTracking(process, regionInput, deltaEta=0.5, deltaPhi=0.5, maxNRegions=10, maxNVertices=None, beamSpotSigmaZ=None, labels=None):
+    if labels is None:
+        labels = _iterationRegionLabels(process)
+    producers = process.producers_()
+    for label in labels:
+        if label not in producers:
+            raise Exception("customizeRegionalTracking: %s is not a producer of the process" % label)
+        module = producers[label]
+        if module.type_() not in _globalRegionTypes:
+            raise Exception("customizeRegionalTracking: %s is a %s, not one of %s" % (label, module.type_(), ", ".join(_globalRegionTypes)))
+        _checkRegion(label, module)
+        if module.type_() == "GlobalTrackingRegionWithVerticesEDProducer" and beamSpotSigmaZ is None:
+            raise Exception("customizeRegionalTracking: %s (%s) falls back to nSigmaZ times the sigmaZ of the beam spot without vertices, give beamSpotSigmaZ (cm)" % (label, module.type_()))
+    if maxNVertices is not None and maxNVertices <= 0:
+        raise Exception("customizeRegionalTracking: maxNVertices = %s, it must be positive" % maxNVertices)
+    for label in labels:
+        module = producers[label]
+        regional = cms.EDProducer("CandidateSeededTrackingRegionsEDProducer",
+            RegionPSet = _regionalRegionPSet(module.type_(), module.RegionPSet, regionInput,
+                                             deltaEta, deltaPhi, maxNRegions, maxNVertices, beamSpotSigmaZ)
+        )
+        setattr(process, label, regional)
+    return process
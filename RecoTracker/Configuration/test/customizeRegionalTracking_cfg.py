@@ -0,0 +1,53 @@
+# Builds the reconstruction with the regional iterative tracking of
+# customizeRegionalTracking, around the calorimeter jets used by the tracking,
+# and checks that only the global tracking regions of the iterations are
+# converted. testRegionalTracking.sh dumps it with edmConfigDump.
+
+import FWCore.ParameterSet.Config as cms
+from FWCore.ParameterSet.VarParsing import VarParsing
+
+options = VarParsing()
+options.register("era", "Run2_2018", VarParsing.multiplicity.singleton, VarParsing.varType.string,
+                 "era of the reconstruction")
+options.parseArguments()
+
+from Configuration.StandardSequences.Eras import eras
+process = cms.Process("RECO", getattr(eras, options.era))
+
+process.load("Configuration.StandardSequences.Services_cff")
+process.load("FWCore.MessageService.MessageLogger_cfi")
+process.load("Configuration.StandardSequences.GeometryRecoDB_cff")
+process.load("Configuration.StandardSequences.MagneticField_cff")
+process.load("Configuration.StandardSequences.RawToDigi_cff")
+process.load("Configuration.StandardSequences.Reconstruction_cff")
+
+process.maxEvents = cms.untracked.PSet(input = cms.untracked.int32(1))
+process.source = cms.Source("EmptySource")
+
+process.raw2digi_step = cms.Path(process.RawToDigi)
+process.reconstruction_step = cms.Path(process.reconstruction)
+
+_globalRegionTypes = ["GlobalTrackingRegionFromBeamSpotEDProducer", "GlobalTrackingRegionWithVerticesEDProducer"]
+before = dict((label, module.type_()) for label, module in process.producers_().items())
+
+from RecoTracker.Configuration.customizeRegionalTracking import customizeRegionalTracking
+process = customizeRegionalTracking(process, "ak4CaloJetsForTrk", deltaEta=0.3, deltaPhi=0.3, beamSpotSigmaZ=3.5)
+
+after = dict((label, module.type_()) for label, module in process.producers_().items())
+iterations = process.iterTrackingTask.moduleNames()
+for label in before:
+    converted = (label in iterations and before[label] in _globalRegionTypes)
+    expected = "CandidateSeededTrackingRegionsEDProducer" if converted else before[label]
+    if after[label] != expected:
+        raise Exception("%s is a %s after customizeRegionalTracking, it should be a %s" % (label, after[label], expected))
+if after["initialStepTrackingRegions"] != "CandidateSeededTrackingRegionsEDProducer":
+    raise Exception("initialStepTrackingRegions is not converted")
+if after["pixelTracksTrackingRegions"] != before["pixelTracksTrackingRegions"]:
+    raise Exception("pixelTracksTrackingRegions is converted")
+
+# without vertices, the fixed half length of the global regions (nSigmaZ = 4)
+for label in iterations:
+    if before.get(label) == "GlobalTrackingRegionWithVerticesEDProducer":
+        region = process.producers_()[label].RegionPSet
+        if region.nSigmaZBeamSpot.value() > 0 or region.zErrorBeamSpot.value() != 4.*3.5:
+            raise Exception("%s falls back to nSigmaZBeamSpot = %s, zErrorBeamSpot = %s without vertices" % (label, region.nSigmaZBeamSpot.value(), region.zErrorBeamSpot.value()))
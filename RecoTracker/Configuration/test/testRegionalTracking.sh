@@ -0,0 +1,18 @@
+#!/bin/bash
+
+function die { echo Failure $1: status $2 ; exit $2 ; }
+
+pushd ${LOCAL_TMP_DIR}
+
+  # the customised reconstruction, dumped and read back
+  edmConfigDump ${LOCAL_TEST_DIR}/customizeRegionalTracking_cfg.py > regionalTracking_dump.py || die 'Failure dumping customizeRegionalTracking_cfg.py' $?
+  python regionalTracking_dump.py || die 'Failure reading the dump of customizeRegionalTracking_cfg.py' $?
+
+  # with trackingLowPU the pixel tracks use a beam-spot region, which stays global
+  python ${LOCAL_TEST_DIR}/customizeRegionalTracking_cfg.py era=Run2_2016_trackingLowPU || die 'Failure using customizeRegionalTracking_cfg.py with Run2_2016_trackingLowPU' $?
+
+  # the occupancy scaling of the heavy-ion regions cannot be converted
+  python ${LOCAL_TEST_DIR}/customizeRegionalTracking_cfg.py era=Run2_2018_pp_on_AA > regionalTracking_pp_on_AA.log 2>&1 && die 'customizeRegionalTracking converted the Run2_2018_pp_on_AA regions' 1
+  grep -q "Scaling4BigEvts" regionalTracking_pp_on_AA.log || die 'customizeRegionalTracking failed with Run2_2018_pp_on_AA for another reason' 1
+
+popd
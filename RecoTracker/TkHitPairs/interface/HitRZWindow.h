@@ -0,0 +1,114 @@
+#ifndef RecoTracker_TkHitPairs_HitRZWindow_h
+#define RecoTracker_TkHitPairs_HitRZWindow_h
+
+/** The r-z window of the inner hits compatible with an outer hit.
+ *  It is taken once per outer hit from the HitRZCompatibility given by the
+ *  region (a window in z at the radius of the hit for a barrel inner layer,
+ *  in r at its z for a forward one) and evaluated without branches over
+ *  the SoA (u, v, dv) of RecHitsSortedInPhi, so that the loop over the inner
+ *  hits vectorizes.  The arithmetic is the one of HitZCheck::range() and
+ *  HitRCheck::range(), so the same hits are selected.
+ */
+
+#include "RecoTracker/TkTrackingRegions/interface/HitRZCompatibility.h"
+#include "RecoTracker/TkTrackingRegions/interface/HitEtaCheck.h"
+#include "RecoTracker/TkTrackingRegions/interface/HitRCheck.h"
+#include "RecoTracker/TkTrackingRegions/interface/HitZCheck.h"
+
+#include "RecoTracker/TkHitPairs/interface/RecHitsSortedInPhi.h"
+
+#include <algorithm>
+
+class HitRZWindow {
+public:
+
+  HitRZWindow() {}
+  explicit HitRZWindow(const HitRZCompatibility & checkRZ) { set(checkRZ); }
+
+  void set(const HitRZCompatibility & checkRZ) {
+    switch (checkRZ.algo()) {
+    case (HitRZCompatibility::zAlgo) : {
+      auto const & check = static_cast<const HitZCheck &>(checkRZ);
+      set(true, check.constraint(), check.tolerance().left(), check.tolerance().right());
+      break;
+    }
+    case (HitRZCompatibility::rAlgo) : {
+      auto const & check = static_cast<const HitRCheck &>(checkRZ);
+      set(false, check.constraint(), check.tolerance().left(), check.tolerance().right());
+      break;
+    }
+    case (HitRZCompatibility::etaAlgo) : {
+      auto const & check = static_cast<const HitEtaCheck &>(checkRZ);
+      set(check.barrel(), check.constraint(), 0.f, 0.f);
+      break;
+    }
+    }
+  }
+
+  // true if the window is in z (barrel inner layer), in r otherwise
+  bool zWindow() const { return theZWindow; }
+
+  // ok[i-b]: compatibility of the inner hits in [b,e)
+  void operator()(int b, int e, const float * u, const float * v, const float * dv, bool * ok) const {
+    if (theZWindow) zCheck(b,e,u,v,dv,ok);
+    else rCheck(b,e,u,v,dv,ok);
+  }
+
+  void operator()(int b, int e, const RecHitsSortedInPhi & innerHitsMap, bool * ok) const {
+    (*this)(b,e, innerHitsMap.u.data(), innerHitsMap.v.data(), innerHitsMap.dv.data(), ok);
+  }
+
+private:
+
+  void set(bool zWindow, const HitRZConstraint & rz, float tolLeft, float tolRight) {
+    theZWindow = zWindow;
+    rL = rz.lineLeft().origin().r(); zL = rz.lineLeft().origin().z(); cotL = rz.lineLeft().cotLine();
+    rR = rz.lineRight().origin().r(); zR = rz.lineRight().origin().z(); cotR = rz.lineRight().cotLine();
+    theTolLeft = tolLeft; theTolRight = tolRight;
+  }
+
+  // HitZCheck::range(u) intersected with v -/+ nSigmaRZ*dv
+  void zCheck(int b, int e, const float * __restrict__ u, const float * __restrict__ v,
+	      const float * __restrict__ dv, bool * __restrict__ ok) const {
+    constexpr float nSigmaRZ = 3.46410161514f; // std::sqrt(12.f);
+    const float zl = zL, rl = rL, cotl = cotL, tolLeft = theTolLeft;
+    const float zr = zR, rr = rR, cotr = cotR, tolRight = theTolRight;
+    for (int i=b; i!=e; ++i) {
+      float aMin = zl + (u[i]-rl)*cotl - tolLeft;
+      float aMax = zr + (u[i]-rr)*cotr + tolRight;
+      float vErr = nSigmaRZ * dv[i];
+      float lo = std::max(aMin, v[i]-vErr);
+      float hi = std::min(aMax, v[i]+vErr);
+      ok[i-b] = !(hi < lo);
+    }
+  }
+
+  // HitRCheck::range(u) intersected with v -/+ nSigmaRZ*dv
+  void rCheck(int b, int e, const float * __restrict__ u, const float * __restrict__ v,
+	      const float * __restrict__ dv, bool * __restrict__ ok) const {
+    constexpr float nSigmaRZ = 3.46410161514f; // std::sqrt(12.f);
+    constexpr float rBig = 150.; //something above the detector ranges
+    const float zl = zL, rl = rL, cotl = cotL, tolLeft = theTolLeft;
+    const float zr = zR, rr = rR, cotr = cotR, tolRight = theTolRight;
+    for (int i=b; i!=e; ++i) {
+      float rRi = rr + (u[i]-zr)/cotr;
+      float rLi = rl + (u[i]-zl)/cotl;
+      float rMin = (rRi<rLi) ? rRi : rLi;
+      float rMax = (rRi<rLi) ? rLi : rRi;
+      float aMin = (rMin>0) ? rMin : rMax;
+      float aMax = (rMin>0) ? rMax : rBig;
+      aMin = (rMax>0) ? aMin : rBig;
+      float vErr = nSigmaRZ * dv[i];
+      float lo = std::max(aMin-tolLeft, v[i]-vErr);
+      float hi = std::min(aMax+tolRight, v[i]+vErr);
+      ok[i-b] = !(hi < lo);
+    }
+  }
+
+  bool theZWindow = true;
+  float rL=0, zL=0, cotL=0;
+  float rR=0, zR=0, cotR=0;
+  float theTolLeft=0, theTolRight=0;
+};
+
+#endif
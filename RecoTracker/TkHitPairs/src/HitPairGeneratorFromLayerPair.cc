@@ -9,6 +9,7 @@
 #include "RecoTracker/TkTrackingRegions/interface/TrackingRegion.h"
 #include "RecoTracker/TkTrackingRegions/interface/TrackingRegionBase.h"
 #include "RecoTracker/TkHitPairs/interface/OrderedHitPairs.h"
+#include "RecoTracker/TkHitPairs/interface/HitRZWindow.h"
 #include "RecoTracker/TkHitPairs/src/InnerDeltaPhi.h"
 
 #include "FWCore/Framework/interface/Event.h"
@@ -40,38 +41,6 @@ HitPairGeneratorFromLayerPair::HitPairGeneratorFromLayerPair(
 
 HitPairGeneratorFromLayerPair::~HitPairGeneratorFromLayerPair() {}
 
-// devirtualizer
-#include<tuple>
-namespace {
-
-  template<typename Algo>
-  struct Kernel {
-    using  Base = HitRZCompatibility;
-    void set(Base const * a) {
-      assert( a->algo()==Algo::me);
-      checkRZ=reinterpret_cast<Algo const *>(a);
-    }
-    
-    void operator()(int b, int e, const RecHitsSortedInPhi & innerHitsMap, bool * ok) const {
-      constexpr float nSigmaRZ = 3.46410161514f; // std::sqrt(12.f);
-      for (int i=b; i!=e; ++i) {
-	Range allowed = checkRZ->range(innerHitsMap.u[i]);
-	float vErr = nSigmaRZ * innerHitsMap.dv[i];
-	Range hitRZ(innerHitsMap.v[i]-vErr, innerHitsMap.v[i]+vErr);
-	Range crossRange = allowed.intersection(hitRZ);
-	ok[i-b] = ! crossRange.empty() ;
-      }
-    }
-    Algo const * checkRZ;
-    
-  };
-
-
-  template<typename ... Args> using Kernels = std::tuple<Kernel<Args>...>;
-
-}
-
-
 void HitPairGeneratorFromLayerPair::hitPairs(
 					     const TrackingRegion & region, OrderedHitPairs & result,
 					     const edm::Event& iEvent, const edm::EventSetup& iSetup, Layers layers) {
@@ -139,7 +108,9 @@ void HitPairGeneratorFromLayerPair::doublets(const TrackingRegion& region,
 						       );
     if(!checkRZ) continue;
 
-    Kernels<HitZCheck,HitRCheck,HitEtaCheck> kernels;
+    // the window in r-z of the hit, evaluated on the SoA of the inner hits
+    HitRZWindow window(*checkRZ);
+    delete checkRZ;
 
     auto innerRange = innerHitsMap.doubleRange(phiRange.min(), phiRange.max());
     LogDebug("HitPairGeneratorFromLayerPair")<<
@@ -147,33 +118,22 @@ void HitPairGeneratorFromLayerPair::doublets(const TrackingRegion& region,
 				      <<" inner and: "<< outerHitsMap.theHits.size()<<" outter";
     for(int j=0; j<3; j+=2) {
       auto b = innerRange[j]; auto e=innerRange[j+1];
+      if (b==e) continue;
       bool ok[e-b];
-      switch (checkRZ->algo()) {
-	case (HitRZCompatibility::zAlgo) :
-	  std::get<0>(kernels).set(checkRZ);
-	  std::get<0>(kernels)(b,e,innerHitsMap, ok);
-	  break;
-	case (HitRZCompatibility::rAlgo) :
-	  std::get<1>(kernels).set(checkRZ);
-	  std::get<1>(kernels)(b,e,innerHitsMap, ok);
-	  break;
-	case (HitRZCompatibility::etaAlgo) :
-	  std::get<2>(kernels).set(checkRZ);
-	  std::get<2>(kernels)(b,e,innerHitsMap, ok);
-	  break;
+      window(b,e,innerHitsMap, ok);
+      int n=0;
+      for (int i=0; i!=e-b; ++i) n+=ok[i];
+      if (n==0) continue;
+      // as if the pairs were added one by one
+      if (theMaxElement!=0 && result.size()+n > theMaxElement){
+	result.clear();
+	edm::LogError("TooManyPairs")<<"number of pairs exceed maximum, no pairs produced";
+	return;
       }
       for (int i=0; i!=e-b; ++i) {
-	if (!ok[i]) continue;
-	if (theMaxElement!=0 && result.size() >= theMaxElement){
-	  result.clear();
-	  edm::LogError("TooManyPairs")<<"number of pairs exceed maximum, no pairs produced";
-	  delete checkRZ;
-	  return;
-	}
-        result.add(b+i,io);
+	if (ok[i]) result.add(b+i,io);
       }
     }
-    delete checkRZ;
   }
   LogDebug("HitPairGeneratorFromLayerPair")<<" total number of pairs provided back: "<<result.size();
   result.shrink_to_fit();
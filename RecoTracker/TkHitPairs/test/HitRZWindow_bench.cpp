@@ -0,0 +1,136 @@
+// Benchmark of the r-z window of the doublet search (HitRZWindow) against
+// the HitRZCompatibility::range() it replaces, on pixel layers with the
+// occupancy of 200 pileup events. The selection of the same hits is checked
+// by HitRZWindow_t.cpp, with the default flags.
+// The hits are generated in the SoA layout of RecHitsSortedInPhi (sorted
+// in phi, u=r v=z in the barrel, u=z v=r in the forward) and the regions
+// are the ones of GlobalTrackingRegion (beam spot with +-15 cm in z).
+
+#include "RecoTracker/TkHitPairs/interface/HitRZWindow.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace {
+
+  struct Layer {
+    bool isBarrel;
+    std::vector<float> phi, u, v, du, dv;
+  };
+
+  // barrel at radius pos and min<z<max, or forward at z=pos and min<r<max
+  Layer makeLayer(bool isBarrel, float pos, float min, float max, int nHits, std::mt19937 & gen) {
+    std::uniform_real_distribution<float> phi(-M_PI,M_PI), w(min,max), s(-0.01f,0.01f);
+    std::vector<float> phis(nHits);
+    for (auto & p : phis) p = phi(gen);
+    std::sort(phis.begin(),phis.end());
+    Layer l; l.isBarrel=isBarrel; l.phi=phis;
+    for (int i=0; i!=nHits; ++i) {
+      l.u.push_back(pos+s(gen));
+      l.v.push_back(w(gen));
+      l.du.push_back(0.002f);
+      l.dv.push_back(isBarrel ? 0.003f : 0.002f);
+    }
+    return l;
+  }
+
+  // as GlobalTrackingRegion::checkRZ in precise mode, the outer hit at (r,z)
+  std::unique_ptr<HitRZCompatibility> checkRZ(bool innerBarrel, bool outerBarrel, float r, float z, bool eta) {
+    constexpr float rBound = 0.2f, zBound = 15.f, d = 3*0.003f;
+    PixelRecoPointRZ outer(r,z);
+    PixelRecoPointRZ vtxR = (z > zBound) ? PixelRecoPointRZ(-rBound, zBound) : PixelRecoPointRZ(rBound, zBound);
+    PixelRecoPointRZ vtxL = (z < -zBound) ? PixelRecoPointRZ(-rBound, -zBound) : PixelRecoPointRZ(rBound, -zBound);
+    if (eta) {
+      return std::make_unique<HitEtaCheck>(innerBarrel, outer, SimpleLineRZ(vtxL,outer).cotLine(), SimpleLineRZ(vtxR,outer).cotLine());
+    }
+    PixelRecoPointRZ outerL, outerR;
+    if (outerBarrel) { outerL = PixelRecoPointRZ(r, z-d); outerR = PixelRecoPointRZ(r, z+d); }
+    else if (z > 0) { outerL = PixelRecoPointRZ(r+d, z); outerR = PixelRecoPointRZ(r-d, z); }
+    else { outerL = PixelRecoPointRZ(r-d, z); outerR = PixelRecoPointRZ(r+d, z); }
+    HitRZConstraint rz(SimpleLineRZ(vtxL,outerL), SimpleLineRZ(vtxR,outerR));
+    if (innerBarrel) return std::make_unique<HitZCheck>(rz, HitZCheck::Margin(d,d));
+    return std::make_unique<HitRCheck>(rz, HitRCheck::Margin(d,d));
+  }
+
+  // the loop before HitRZWindow: a range() per inner hit
+  void reference(HitRZCompatibility const & check, int b, int e, Layer const & inner, bool * ok) {
+    constexpr float nSigmaRZ = 3.46410161514f; // std::sqrt(12.f);
+    for (int i=b; i!=e; ++i) {
+      HitRZCompatibility::Range allowed = check.range(inner.u[i]);
+      float vErr = nSigmaRZ * inner.dv[i];
+      HitRZCompatibility::Range hitRZ(inner.v[i]-vErr, inner.v[i]+vErr);
+      ok[i-b] = ! allowed.intersection(hitRZ).empty();
+    }
+  }
+
+  void run(const char * name, Layer const & inner, Layer const & outer, bool eta) {
+    constexpr float dphi = 0.05f;
+    constexpr int nRep = 10;
+    std::vector<std::unique_ptr<HitRZCompatibility>> checks;
+    std::vector<std::pair<int,int>> ranges;
+    for (unsigned int io=0; io!=outer.phi.size(); ++io) {
+      float r = outer.isBarrel ? outer.u[io] : outer.v[io];
+      float z = outer.isBarrel ? outer.v[io] : outer.u[io];
+      checks.push_back(checkRZ(inner.isBarrel, outer.isBarrel, r, z, eta));
+      auto b = std::lower_bound(inner.phi.begin(), inner.phi.end(), outer.phi[io]-dphi);
+      auto e = std::upper_bound(b, inner.phi.end(), outer.phi[io]+dphi);
+      ranges.emplace_back(b-inner.phi.begin(), e-inner.phi.begin());
+    }
+
+    long long nTested=0;
+    std::unique_ptr<bool[]> ok(new bool[inner.phi.size()]);
+    long long nRef=0, nNew=0;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int k=0; k!=nRep; ++k) {
+      for (unsigned int io=0; io!=checks.size(); ++io) {
+	auto b = ranges[io].first, e = ranges[io].second;
+	reference(*checks[io], b, e, inner, ok.get());
+	nRef += std::accumulate(ok.get(), ok.get()+(e-b), 0);
+	if (k==0) nTested += e-b;
+      }
+    }
+    auto tRef = std::chrono::high_resolution_clock::now()-start;
+
+    start = std::chrono::high_resolution_clock::now();
+    for (int k=0; k!=nRep; ++k) {
+      for (unsigned int io=0; io!=checks.size(); ++io) {
+	auto b = ranges[io].first, e = ranges[io].second;
+	HitRZWindow window(*checks[io]);
+	window(b, e, inner.u.data(), inner.v.data(), inner.dv.data(), ok.get());
+	nNew += std::accumulate(ok.get(), ok.get()+(e-b), 0);
+      }
+    }
+    auto tNew = std::chrono::high_resolution_clock::now()-start;
+
+    using ms = std::chrono::duration<double, std::milli>;
+    std::cout << name << ": " << inner.phi.size() << " inner x " << outer.phi.size() << " outer hits, "
+	      << nTested << " tested, " << nRef/nRep << " (range()) " << nNew/nRep << " (HitRZWindow) doublets; "
+	      << "range() " << ms(tRef).count()/nRep << " ms, HitRZWindow " << ms(tNew).count()/nRep << " ms"
+	      << std::endl;
+  }
+
+}
+
+int main() {
+  std::mt19937 gen(42);
+
+  // phase-1 pixel layers at 200 pileup
+  Layer bpix1 = makeLayer(true,  2.9f, -26.7f, 26.7f, 20000, gen);
+  Layer bpix2 = makeLayer(true,  6.8f, -26.7f, 26.7f, 12000, gen);
+  Layer fpix1 = makeLayer(false, 32.f,   4.5f, 16.1f,  5000, gen);
+  Layer fpix2 = makeLayer(false, 39.5f,  4.5f, 16.1f,  5000, gen);
+
+  run("BPix1-BPix2 (z)", bpix1, bpix2, false);
+  run("BPix1-FPix1 (z)", bpix1, fpix1, false);
+  run("FPix1-FPix2 (r)", fpix1, fpix2, false);
+  run("BPix1-BPix2 (eta)", bpix1, bpix2, true);
+  run("FPix1-FPix2 (eta)", fpix1, fpix2, true);
+  return 0;
+}
@@ -0,0 +1,123 @@
+// Checks that the r-z window of the doublet search (HitRZWindow) selects
+// the same inner hits as the HitRZCompatibility::range() it replaces, for
+// barrel and forward layers on both sides, the z, r and eta checks of
+// GlobalTrackingRegion and outer hits inside and outside of the +-15 cm of
+// the beam spot. Built with the default flags: the timing is in
+// HitRZWindow_bench.cpp.
+
+#include "RecoTracker/TkHitPairs/interface/HitRZWindow.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+  struct Layer {
+    bool isBarrel;
+    std::vector<float> phi, u, v, du, dv;
+  };
+
+  // barrel at radius pos and min<z<max, or forward at z=pos and min<r<max
+  Layer makeLayer(bool isBarrel, float pos, float min, float max, int nHits, std::mt19937 & gen) {
+    std::uniform_real_distribution<float> phi(-M_PI,M_PI), w(min,max), s(-0.01f,0.01f);
+    std::vector<float> phis(nHits);
+    for (auto & p : phis) p = phi(gen);
+    std::sort(phis.begin(),phis.end());
+    Layer l; l.isBarrel=isBarrel; l.phi=phis;
+    for (int i=0; i!=nHits; ++i) {
+      l.u.push_back(pos+s(gen));
+      l.v.push_back(w(gen));
+      l.du.push_back(0.002f);
+      l.dv.push_back(isBarrel ? 0.003f : 0.002f);
+    }
+    return l;
+  }
+
+  // as GlobalTrackingRegion::checkRZ in precise mode, the outer hit at (r,z)
+  std::unique_ptr<HitRZCompatibility> checkRZ(bool innerBarrel, bool outerBarrel, float r, float z, bool eta) {
+    constexpr float rBound = 0.2f, zBound = 15.f, d = 3*0.003f;
+    PixelRecoPointRZ outer(r,z);
+    PixelRecoPointRZ vtxR = (z > zBound) ? PixelRecoPointRZ(-rBound, zBound) : PixelRecoPointRZ(rBound, zBound);
+    PixelRecoPointRZ vtxL = (z < -zBound) ? PixelRecoPointRZ(-rBound, -zBound) : PixelRecoPointRZ(rBound, -zBound);
+    if (eta) {
+      return std::make_unique<HitEtaCheck>(innerBarrel, outer, SimpleLineRZ(vtxL,outer).cotLine(), SimpleLineRZ(vtxR,outer).cotLine());
+    }
+    PixelRecoPointRZ outerL, outerR;
+    if (outerBarrel) { outerL = PixelRecoPointRZ(r, z-d); outerR = PixelRecoPointRZ(r, z+d); }
+    else if (z > 0) { outerL = PixelRecoPointRZ(r+d, z); outerR = PixelRecoPointRZ(r-d, z); }
+    else { outerL = PixelRecoPointRZ(r-d, z); outerR = PixelRecoPointRZ(r+d, z); }
+    HitRZConstraint rz(SimpleLineRZ(vtxL,outerL), SimpleLineRZ(vtxR,outerR));
+    if (innerBarrel) return std::make_unique<HitZCheck>(rz, HitZCheck::Margin(d,d));
+    return std::make_unique<HitRCheck>(rz, HitRCheck::Margin(d,d));
+  }
+
+  // the loop before HitRZWindow: a range() per inner hit
+  bool reference(HitRZCompatibility const & check, Layer const & inner, int i) {
+    constexpr float nSigmaRZ = 3.46410161514f; // std::sqrt(12.f);
+    HitRZCompatibility::Range allowed = check.range(inner.u[i]);
+    float vErr = nSigmaRZ * inner.dv[i];
+    HitRZCompatibility::Range hitRZ(inner.v[i]-vErr, inner.v[i]+vErr);
+    return ! allowed.intersection(hitRZ).empty();
+  }
+
+  bool run(const char * name, Layer const & inner, Layer const & outer, bool eta) {
+    constexpr float dphi = 0.1f;
+    std::unique_ptr<bool[]> ok(new bool[inner.phi.size()]);
+    long long nTested=0, nOk=0, nDiff=0;
+    for (unsigned int io=0; io!=outer.phi.size(); ++io) {
+      float r = outer.isBarrel ? outer.u[io] : outer.v[io];
+      float z = outer.isBarrel ? outer.v[io] : outer.u[io];
+      auto check = checkRZ(inner.isBarrel, outer.isBarrel, r, z, eta);
+      int b = std::lower_bound(inner.phi.begin(), inner.phi.end(), outer.phi[io]-dphi) - inner.phi.begin();
+      int e = std::upper_bound(inner.phi.begin()+b, inner.phi.end(), outer.phi[io]+dphi) - inner.phi.begin();
+
+      HitRZWindow window(*check);
+      if (window.zWindow() != inner.isBarrel) {
+        std::cout << name << ": window in " << (window.zWindow() ? "z" : "r") << " for a "
+                  << (inner.isBarrel ? "barrel" : "forward") << " inner layer" << std::endl;
+        return false;
+      }
+      window(b, e, inner.u.data(), inner.v.data(), inner.dv.data(), ok.get());
+      for (int i=b; i!=e; ++i) {
+        bool okRef = reference(*check, inner, i);
+        if (okRef != ok[i-b] && ++nDiff <= 10) {
+          std::cout << name << ": outer hit (r,z) = (" << r << "," << z << "), inner hit (u,v) = ("
+                    << inner.u[i] << "," << inner.v[i] << "): range() " << okRef << ", HitRZWindow " << ok[i-b] << std::endl;
+        }
+        nOk += okRef;
+      }
+      nTested += e-b;
+    }
+    std::cout << name << ": " << nTested << " tested, " << nOk << " doublets, " << nDiff << " different" << std::endl;
+    // both outcomes must be exercised for the comparison to mean something
+    return nDiff == 0 && nOk > 0 && nOk < nTested;
+  }
+
+}
+
+int main() {
+  std::mt19937 gen(42);
+
+  // phase-1 pixel layers, with forward disks on both sides
+  Layer bpix1 = makeLayer(true,   2.9f, -26.7f, 26.7f, 2000, gen);
+  Layer bpix2 = makeLayer(true,   6.8f, -26.7f, 26.7f, 1200, gen);
+  Layer fpix1p = makeLayer(false, 32.f,    4.5f, 16.1f,  500, gen);
+  Layer fpix2p = makeLayer(false, 39.5f,   4.5f, 16.1f,  500, gen);
+  Layer fpix1m = makeLayer(false, -32.f,   4.5f, 16.1f,  500, gen);
+  Layer fpix2m = makeLayer(false, -39.5f,  4.5f, 16.1f,  500, gen);
+
+  bool ok = true;
+  for (bool eta : {false, true}) {
+    ok &= run(eta ? "BPix1-BPix2 (eta)" : "BPix1-BPix2 (z)", bpix1, bpix2, eta);
+    ok &= run(eta ? "BPix1-FPix1+ (eta)" : "BPix1-FPix1+ (z)", bpix1, fpix1p, eta);
+    ok &= run(eta ? "BPix1-FPix1- (eta)" : "BPix1-FPix1- (z)", bpix1, fpix1m, eta);
+    ok &= run(eta ? "FPix1+-FPix2+ (eta)" : "FPix1+-FPix2+ (r)", fpix1p, fpix2p, eta);
+    ok &= run(eta ? "FPix1--FPix2- (eta)" : "FPix1--FPix2- (r)", fpix1m, fpix2m, eta);
+  }
+  if (!ok) std::cout << "HitRZWindow and range() select DIFFERENT doublets" << std::endl;
+  return ok ? 0 : 1;
+}
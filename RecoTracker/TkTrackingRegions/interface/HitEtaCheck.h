@@ -36,6 +36,9 @@ public:
         HitZCheck(theRZ).range(rORz) : HitRCheck(theRZ).range(rORz);
   }
   HitEtaCheck* clone() const override { return new HitEtaCheck(*this); }
+
+  bool barrel() const { return isBarrel; }
+  const HitRZConstraint & constraint() const { return theRZ; }
 private:
   bool isBarrel;
   HitRZConstraint theRZ;
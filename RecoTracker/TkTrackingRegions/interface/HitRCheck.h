@@ -26,6 +26,9 @@ public:
 
   void setTolerance(const Margin & tolerance) { theTolerance = tolerance; }
 
+  const HitRZConstraint & constraint() const { return theRZ; }
+  const Margin & tolerance() const { return theTolerance; }
+
 private:
   HitRZConstraint theRZ;
   Margin theTolerance;
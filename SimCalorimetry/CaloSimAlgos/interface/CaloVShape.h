@@ -18,6 +18,15 @@ class CaloVShape
   virtual double       operator () (double) const = 0 ;
   virtual double       timeToRise()         const = 0 ;
 
+  /// the shape at n times, from time in steps of step: one call per pulse
+  /// instead of one per sample, tabulated shapes override it
+  virtual void evaluate(double time, double step, unsigned int n, double* values) const {
+    for (unsigned int i = 0; i != n; ++i) {
+      values[i] = (*this)(time);
+      time += step;
+    }
+  }
+
  protected:
 
  private:
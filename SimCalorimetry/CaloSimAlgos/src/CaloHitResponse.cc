@@ -17,6 +17,7 @@
 #include "CLHEP/Units/GlobalSystemOfUnits.h" 
 
 #include<iostream>
+#include<vector>
 
 CaloHitResponse::CaloHitResponse(const CaloVSimParameterMap * parametersMap, 
                                  const CaloVShape * shape)
@@ -131,26 +132,27 @@ CaloSamples CaloHitResponse::makeAnalogSignal(const PCaloHit & hit, CLHEP::HepRa
 			 - jitter 
 			 - BUNCHSPACE*( parameters.binOfMaximum()
 					- thePhaseShift_          ) ) ;
-  double binTime = tzero;
-
   CaloSamples result(makeBlankSignal(detId));
 
   if(storePrecise){
     result.resetPrecise();
     int sampleBin(0);
     //use 1ns binning for precise sample
-    for(int bin = 0; bin < result.size()*BUNCHSPACE; bin++) {
+    int nbins = result.size()*BUNCHSPACE;
+    std::vector<double> values(nbins);
+    shape->evaluate(tzero, 1.0, nbins, values.data());
+    for(int bin = 0; bin < nbins; bin++) {
       sampleBin = bin/BUNCHSPACE;
-      double pulseBit = (*shape)(binTime)* signal;
+      double pulseBit = values[bin]* signal;
       result[sampleBin] += pulseBit;
       result.preciseAtMod(bin) += pulseBit;
-      binTime += 1.0;
     }
   }
   else {
+    std::vector<double> values(result.size());
+    shape->evaluate(tzero, BUNCHSPACE, result.size(), values.data());
     for(int bin = 0; bin < result.size(); bin++) {
-      result[bin] += (*shape)(binTime)* signal;
-      binTime += BUNCHSPACE;
+      result[bin] += values[bin]* signal;
     }
   }
   return result;
@@ -102,6 +102,8 @@ class EcalHitResponse
 
       double timeOfFlight( const DetId& detId ) const ;
 
+      double* shapeValues( unsigned int size ) ; // work buffer for CaloVShape::evaluate
+
       double phaseShift() const ;
 
       void blankOutUsedSamples() ;
@@ -141,6 +143,8 @@ class EcalHitResponse
       CalibCache                     m_laserCalibCache;
 
       VecInd m_index ;
+
+      std::vector<double> m_shapeValues ;
 };
 
 #endif
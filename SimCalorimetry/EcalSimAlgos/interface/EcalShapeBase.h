@@ -33,6 +33,8 @@ class EcalShapeBase : public CaloVShape
 
       double operator() ( double aTime ) const override ;
 
+      void evaluate( double time, double step, unsigned int n, double* values ) const override ;
+
       double         timeOfThr()  const ;
       double         timeOfMax()  const ;
       double timeToRise() const override ;
@@ -111,14 +111,16 @@ EBHitResponse::putAPDSignal( const DetId& detId  ,
 			- BUNCHSPACE*( parameters.binOfMaximum()
 				       - phaseShift()            ) ) ;
 
-   double binTime ( tzero ) ;
-
    EcalSamples& result ( *findSignal( detId ) );
 
-   for( unsigned int bin ( 0 ) ; bin != result.size(); ++bin )
+   const unsigned int rsize ( result.size() ) ;
+
+   double* values ( shapeValues( rsize ) ) ;
+   apdShape()->evaluate( tzero, BUNCHSPACE, rsize, values ) ;
+
+   for( unsigned int bin ( 0 ) ; bin != rsize; ++bin )
    {
-      result[bin] += (*apdShape())(binTime)*signal ;
-      binTime += BUNCHSPACE ;
+      result[bin] += values[bin]*signal ;
    }
 }
 
@@ -220,19 +220,26 @@ EcalHitResponse::putAnalogSignal( const PCaloHit& hit, CLHEP::HepRandomEngine* e
 			  - jitter 
 			  - BUNCHSPACE*( parameters->binOfMaximum()
 					 - m_phaseShift             ) ) ;
-   double binTime ( tzero ) ;
-
    EcalSamples& result ( *findSignal( detId ) ) ;
 
    const unsigned int rsize ( result.size() ) ;
 
+   double* values ( shapeValues( rsize ) ) ;
+   shape()->evaluate( tzero, BUNCHSPACE, rsize, values ) ;
+
    for( unsigned int bin ( 0 ) ; bin != rsize ; ++bin )
    {
-      result[ bin ] += (*shape())( binTime )*signal ;
-      binTime += BUNCHSPACE ;
+      result[ bin ] += values[ bin ]*signal ;
    }
 }
 
+double*
+EcalHitResponse::shapeValues( unsigned int size )
+{
+   if( m_shapeValues.size() < size ) m_shapeValues.resize( size ) ;
+   return m_shapeValues.data() ;
+}
+
 double
 EcalHitResponse::findLaserConstant(const DetId& detId) const
 {
@@ -154,6 +154,18 @@ EcalShapeBase::operator() ( double aTime ) const
    return ( m_denseArraySize == index ? 0 : m_shape[ index ] ) ;
 }
 
+void
+EcalShapeBase::evaluate( double time, double step, unsigned int n, double* values ) const
+{
+   // same lookup as operator(), without a virtual call per sample
+   for( unsigned int i ( 0 ) ; i != n ; ++i )
+   {
+      const unsigned int index ( timeIndex( time ) ) ;
+      values[i] = ( m_denseArraySize == index ? 0 : m_shape[ index ] ) ;
+      time += step ;
+   }
+}
+
 double 
 EcalShapeBase::derivative( double aTime ) const
 {
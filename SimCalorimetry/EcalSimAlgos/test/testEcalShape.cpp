@@ -5,6 +5,7 @@
 #include "SimCalorimetry/EcalSimAlgos/interface/EBShape.h"
 #include "SimCalorimetry/EcalSimAlgos/interface/EEShape.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include<cassert>
 #include<iostream>
 #include<iomanip>
 
@@ -138,6 +139,16 @@ int main()
 	 std::cout << (*theShape)(tzero + iSample*25.0) << std::endl; 
       }
 
+      // the batched evaluation must reproduce the sample by sample one
+      double values[10] ;
+      theShape->evaluate( tzero, 25., 10, values ) ;
+      double binTime ( tzero ) ;
+      for( unsigned int iSample ( 0 ) ; iSample != 10 ; ++iSample ) 
+      {
+	 assert( values[iSample] == (*theShape)(binTime) ) ;
+	 binTime += 25. ;
+      }
+
       showShape->Divide(2,1);
       showShape->cd(1);
       gPad->SetGrid();
@@ -16,6 +16,7 @@ public:
   ~HFShape() override{}
   
   double operator () (double time) const override;
+  void evaluate(double time, double step, unsigned int n, double* values) const override;
   double timeToRise() const override;
 
  private:
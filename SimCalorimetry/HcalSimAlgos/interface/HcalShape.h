@@ -18,6 +18,7 @@ public:
   HcalShape();
   void setShape(int shapeType);
   double operator () (double time) const override;
+  void evaluate(double time, double step, unsigned int n, double* values) const override;
   double timeToRise() const override;
 private:
   HcalPulseShapes::Shape shape_;
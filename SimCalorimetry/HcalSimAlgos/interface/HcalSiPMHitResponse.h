@@ -43,6 +43,11 @@ public:
 
   virtual void addPEnoise(CLHEP::HepRandomEngine* engine);
 
+  /// draw the dark current PEs of a whole frame at once instead of per precise bin:
+  /// faster, but a different random sequence, and RandPoissonQ only approximates
+  /// the Poisson distribution at the larger mean of a frame
+  void setFramePENoise(bool fn) { framePENoise = fn; }
+
   virtual CaloSamples makeBlankSignal(const DetId & detId) const;
 
   virtual void setDetIds(const std::vector<DetId> & detIds);
@@ -53,9 +58,13 @@ protected:
   virtual CaloSamples makeSiPMSignal(DetId const& id, photonTimeHist const& photons, CLHEP::HepRandomEngine*);
 
 private:
+  /// the photon time histogram of a channel, created empty with nPreciseBins bins if needed
+  photonTimeHist& channelPhotons(DetId const& id, int nPreciseBins);
+
   HcalSiPM theSiPM;
   bool PreMixDigis;
   bool HighFidelityPreMix;
+  bool framePENoise;
   int nbins;
   double dt, invdt;
 
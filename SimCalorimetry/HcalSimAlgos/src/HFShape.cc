@@ -16,3 +16,11 @@ double HFShape::operator () (double time) const
   return shape_.at(time);
 }
   
+
+void HFShape::evaluate(double time, double step, unsigned int n, double* values) const
+{
+  for (unsigned int i = 0; i != n; ++i) {
+    values[i] = shape_.at(time);
+    time += step;
+  }
+}
@@ -23,4 +23,10 @@ double HcalShape::operator () (double time_) const
   return shape_.at(time_);
 }
 
-
+void HcalShape::evaluate(double time, double step, unsigned int n, double* values) const
+{
+  for (unsigned int i = 0; i != n; ++i) {
+    values[i] = shape_.at(time);
+    time += step;
+  }
+}
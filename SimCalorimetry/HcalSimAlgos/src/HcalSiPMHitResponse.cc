@@ -11,14 +11,15 @@
 #include "FWCore/Utilities/interface/isFinite.h"
 #include "CalibCalorimetry/HcalAlgos/interface/HcalPulseShapes.h"
 
+#include "CLHEP/Random/RandFlat.h"
 #include "CLHEP/Random/RandPoissonQ.h"
 
 #include <cmath>
-#include <list>
+#include <vector>
 
 HcalSiPMHitResponse::HcalSiPMHitResponse(const CaloVSimParameterMap * parameterMap,
 					 const CaloShapes * shapes, bool PreMix1, bool HighFidelity) :
-  CaloHitResponse(parameterMap, shapes), theSiPM(), PreMixDigis(PreMix1), HighFidelityPreMix(HighFidelity),
+  CaloHitResponse(parameterMap, shapes), theSiPM(), PreMixDigis(PreMix1), HighFidelityPreMix(HighFidelity), framePENoise(false),
   nbins((PreMixDigis and HighFidelityPreMix) ? 1 : BUNCHSPACE*HcalPulseShapes::invDeltaTSiPM_), 
   dt(HcalPulseShapes::deltaTSiPM_), invdt(HcalPulseShapes::invDeltaTSiPM_)
 {
@@ -110,14 +111,8 @@ void HcalSiPMHitResponse::add(const PCaloHit& hit, CLHEP::HepRandomEngine* engin
       double time( hit.time() );
       if(ignoreTime) time = tof;
 
-      if (photons > 0)
-        if (precisionTimedPhotons.find(id)==precisionTimedPhotons.end()) {
-          precisionTimedPhotons.insert(
-            std::pair<DetId, photonTimeHist >(id, 
-              photonTimeHist(nbins * getReadoutFrameSize(id), 0)
-            )
-          );
-        }
+      photonTimeHist* photonTimes(nullptr);
+      if (photons > 0) photonTimes = &channelPhotons(id, nbins * getReadoutFrameSize(id));
 
       LogDebug("HcalSiPMHitResponse") << id;
       LogDebug("HcalSiPMHitResponse") << " fCtoGeV: " << pars.fCtoGeV(id)
@@ -146,12 +141,21 @@ void HcalSiPMHitResponse::add(const PCaloHit& hit, CLHEP::HepRandomEngine* engin
         LogDebug("HcalSiPMHitResponse") << "t_pe: " << t_pe << " t_pe + tzero: " << (t_pe+tzero_bin*dt)
                   << " t_bin: " << t_bin << '\n';
         if ((t_bin >= 0) && 
-            (static_cast<unsigned int>(t_bin) < precisionTimedPhotons[id].size()))
-            precisionTimedPhotons[id][t_bin] += 1;
+            (static_cast<unsigned int>(t_bin) < photonTimes->size()))
+            (*photonTimes)[t_bin] += 1;
       }
     }
 }
 
+HcalSiPMHitResponse::photonTimeHist& HcalSiPMHitResponse::channelPhotons(DetId const& id, int nPreciseBins) {
+  photonTimeMap::iterator channel(precisionTimedPhotons.find(id));
+  if (channel==precisionTimedPhotons.end()) {
+    channel = precisionTimedPhotons.insert
+      (std::pair<DetId, photonTimeHist >(id, photonTimeHist(nPreciseBins, 0) ) ).first;
+  }
+  return channel->second;
+}
+
 void HcalSiPMHitResponse::addPEnoise(CLHEP::HepRandomEngine* engine)
 {
   // Add SiPM dark current noise to all cells
@@ -171,25 +175,30 @@ void HcalSiPMHitResponse::addPEnoise(CLHEP::HepRandomEngine* engine)
     int nPreciseBins = nbins * getReadoutFrameSize(id);
 
     unsigned int sumnoisePE(0);
-    double  elapsedTime(0.);
-    for (int tprecise(0); tprecise < nPreciseBins; ++tprecise) {
-      int noisepe = CLHEP::RandPoissonQ::shoot(engine, dc_pe_avg); // add dark current noise
-
-      if (noisepe > 0) {
-	if (precisionTimedPhotons.find(id)==precisionTimedPhotons.end()) {
-	  photonTimeHist photons(nPreciseBins, 0);
-	  photons[tprecise] = noisepe;
-	  precisionTimedPhotons.insert
-	    (std::pair<DetId, photonTimeHist >(id, photons ) );
-	} else {
-	  precisionTimedPhotons[id][tprecise] += noisepe;
+    if (framePENoise) {
+      // the dark current PEs of the whole frame in one draw, each PE then lands
+      // in a uniformly chosen precise bin; this would match one Poisson per bin
+      // with an exact generator, but RandPoissonQ is approximate at large means
+      sumnoisePE = CLHEP::RandPoissonQ::shoot(engine, dc_pe_avg*nPreciseBins); // add dark current noise
+
+      if (sumnoisePE > 0) {
+	photonTimeHist& photons(channelPhotons(id, nPreciseBins));
+	for (unsigned int pe(0); pe < sumnoisePE; ++pe) {
+	  photons[CLHEP::RandFlat::shootInt(engine, nPreciseBins)] += 1;
 	}
-
-	sumnoisePE += noisepe;
       }
-      elapsedTime += dt;
-
-    } // precise time loop
+    } else {
+      photonTimeHist* photons(nullptr);
+      for (int tprecise(0); tprecise < nPreciseBins; ++tprecise) {
+	int noisepe = CLHEP::RandPoissonQ::shoot(engine, dc_pe_avg); // add dark current noise
+
+	if (noisepe > 0) {
+	  if (!photons) photons = &channelPhotons(id, nPreciseBins);
+	  (*photons)[tprecise] += noisepe;
+	  sumnoisePE += noisepe;
+	}
+      } // precise time loop
+    }
 
     LogDebug("HcalSiPMHitResponse") << id;
     LogDebug("HcalSiPMHitResponse") << " total noise (PEs): " << sumnoisePE;
@@ -227,9 +236,8 @@ CaloSamples HcalSiPMHitResponse::makeSiPMSignal(DetId const& id,
 
   auto& sipmPulseShape(shapeMap[pars.signalShape(id)]);
 
-  std::list< std::pair<double, double> > pulses;
-  std::list< std::pair<double, double> >::iterator pulse;
-  double timeDiff, pulseBit;
+  std::vector< std::pair<double, double> > pulses;
+  double timeDiff, pulseBit, pulseShape;
   LogDebug("HcalSiPMHitResponse") << "makeSiPMSignal for " << HcalDetId(id);
 
   for (unsigned int tbin(0); tbin < photonTimeBins.size(); ++tbin) {
@@ -267,22 +275,24 @@ CaloSamples HcalSiPMHitResponse::makeSiPMSignal(DetId const& id,
     }
     
     if (pars.doSiPMSmearing()) {
-      pulse = pulses.begin();
-      while (pulse != pulses.end()) {
-	timeDiff = elapsedTime - pulse->first;
-	pulseBit = sipmPulseShape(timeDiff)*pulse->second;
-	LogDebug("HcalSiPMHitResponse") << " pulse t: " << pulse->first 
-					<< " pulse A: " << pulse->second
+      // the pulses that have decayed are dropped, keeping the others in order
+      unsigned int nKept(0);
+      for (unsigned int ipulse(0); ipulse < pulses.size(); ++ipulse) {
+	const std::pair<double, double> pulse(pulses[ipulse]);
+	timeDiff = elapsedTime - pulse.first;
+	pulseShape = sipmPulseShape(timeDiff);
+	pulseBit = pulseShape*pulse.second;
+	LogDebug("HcalSiPMHitResponse") << " pulse t: " << pulse.first 
+					<< " pulse A: " << pulse.second
 					<< " timeDiff: " << timeDiff
 					<< " pulseBit: " << pulseBit;
 	signal[sampleBin] += pulseBit;
 	signal.preciseAtMod(preciseBin) += pulseBit*invdt;
 
-	if (timeDiff > 1 && sipmPulseShape(timeDiff) < 1e-7)
-	  pulse = pulses.erase(pulse);
-	else
-	  ++pulse;
+	if (!(timeDiff > 1 && pulseShape < 1e-7))
+	  pulses[nKept++] = pulse;
       }
+      pulses.resize(nKept);
     }
     elapsedTime += dt;
   }
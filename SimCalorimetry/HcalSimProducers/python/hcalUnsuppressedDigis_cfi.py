@@ -29,6 +29,10 @@ hcalSimBlock = cms.PSet(
     minFCToDelay=cms.double(5.), # old TC model! set to 5 for the new one
     debugCaloSamples=cms.bool(False),
     ignoreGeantTime=cms.bool(False),
+    # draw the SiPM dark current PEs of a frame at once instead of per precise bin:
+    # faster, but a different random sequence and only approximately the same
+    # distribution (RandPoissonQ is approximate at the larger mean of a frame)
+    framePENoise=cms.bool(False),
     # settings for SimHit test injection
     injectTestHits = cms.bool(False),
     # if no time is specified for injected hits, t = 0 will be used
@@ -201,6 +201,12 @@ HcalDigitizer::HcalDigitizer(const edm::ParameterSet& ps, edm::ConsumesCollector
     theZDCDigitizer->setDebugCaloSamples(true);
   }
 
+  //option to draw the SiPM dark current noise once per frame (faster, different random sequence)
+  if(ps.getParameter<bool>("framePENoise")){
+    theHBHESiPMResponse->setFramePENoise(true);
+    theHOSiPMResponse->setFramePENoise(true);
+  }
+
   //option to ignore Geant time distribution in SimHits, for debugging
   if(ignoreTime_){
     theHBHEResponse->setIgnoreGeantTime(ignoreTime_);
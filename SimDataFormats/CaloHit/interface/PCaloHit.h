@@ -37,6 +37,7 @@ public:
 
   //Geant track number
   int geantTrackId() const { return myItra; }
+  void setGeantTrackId(int i) { myItra = i; }
 
   //DetId where the Hit is recorded
   void setID(unsigned int id) { detId = id; }
@@ -101,6 +101,8 @@ public:
    */
   unsigned int trackId()      const {return theTrackId;}
 
+  void setTrackId(unsigned int trackId) { theTrackId = trackId; }
+
 
   EncodedEventId eventId()      const {return theEventId;}
 
@@ -0,0 +1,80 @@
+#ifndef SimG4CMS_CaloHitMap_h
+#define SimG4CMS_CaloHitMap_h
+///////////////////////////////////////////////////////////////////////////////
+// File: CaloHitMap.h
+// Description: Open-addressing map from CaloHitID to the hit being filled,
+//              used by CaloSD in place of std::map<CaloHitID,CaloG4Hit*>.
+//              Two IDs are the same key when unit, track, depth and time
+//              slice all match, as for the ordering of CaloHitID.
+//              clear() is O(1): slots are tagged with the generation
+//              (event) they were filled in.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SimG4CMS/Calo/interface/CaloHitID.h"
+
+#include <cstdint>
+#include <vector>
+
+class CaloG4Hit;
+
+class CaloHitMap {
+
+public:
+
+  CaloHitMap();
+
+  CaloG4Hit*   find(const CaloHitID& id) const {
+    Key key(id);
+    for (uint32_t b = bucket(key); ; b = (b+1) & mask_) {
+      const Slot& s = slots_[b];
+      if (s.generation != generation_) return nullptr;
+      if (s.hit != nullptr && s.key == key) return s.hit;
+    }
+  }
+  void         insert(const CaloHitID& id, CaloG4Hit* hit);
+  void         erase(const CaloHitID& id);
+  void         clear();
+
+  unsigned int size() const { return size_; }
+  unsigned int capacity() const { return slots_.size(); }
+
+private:
+
+  struct Key {
+    Key() : unitID(0), trackID(0), timeSliceID(0), depth(0) {}
+    explicit Key(const CaloHitID& id) : unitID(id.unitID()), trackID(id.trackID()),
+                                        timeSliceID(id.timeSliceID()), depth(id.depth()) {}
+    bool operator==(const Key& k) const {
+      return (unitID == k.unitID && trackID == k.trackID &&
+              timeSliceID == k.timeSliceID && depth == k.depth);
+    }
+    uint32_t unitID;
+    int32_t  trackID;
+    int32_t  timeSliceID;
+    uint32_t depth;
+  };
+
+  // a used slot of the current generation with a null hit is a deleted entry
+  struct Slot {
+    Key        key;
+    CaloG4Hit* hit;
+    uint32_t   generation;
+  };
+
+  uint32_t bucket(const Key& k) const {
+    uint64_t h = (uint64_t(k.unitID) << 32) ^ (uint32_t(k.trackID) * 0x9E3779B1u)
+      ^ (uint64_t(uint32_t(k.timeSliceID)) << 16) ^ k.depth;
+    h ^= h >> 29;
+    return uint32_t((h * 0xBF58476D1CE4E5B9ull) >> shift_);
+  }
+  void     rehash(unsigned int bits);
+
+  std::vector<Slot> slots_;
+  uint32_t          mask_;
+  uint32_t          shift_;
+  uint32_t          generation_;
+  unsigned int      size_;   // live entries
+  unsigned int      used_;   // live and deleted entries
+};
+
+#endif
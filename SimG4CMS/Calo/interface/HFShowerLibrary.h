@@ -9,6 +9,7 @@
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 #include "Geometry/HcalCommonData/interface/HcalDDDSimConstants.h"
 #include "SimG4CMS/Calo/interface/HFFibre.h"
+#include "SimG4CMS/Calo/interface/HFShowerPhotonTable.h"
 #include "SimDataFormats/CaloHit/interface/HFShowerPhoton.h"
 #include "DetectorDescription/Core/interface/DDsvalues.h"
 
@@ -58,6 +59,8 @@ protected:
   void                interpolate(int, double);
   void                extrapolate(int, double);
   void                storePhoton(int j);
+  int                 nPhotons() const;
+  void                loadTable(const std::string&, const std::string&);
   std::vector<double> getDDDArray(const std::string&, const DDsvalues_type&,
                                   int&);
 
@@ -81,5 +84,9 @@ private:
   HFShowerPhotonCollection* photo;
   HFShowerPhotonCollection photon;
 
+  // flat photon table shared by all threads, replacing the ROOT branches
+  std::shared_ptr<const HFShowerPhotonTable> table;
+  HFShowerPhotonTable::Range                 tableRecord;
+
 };
 #endif
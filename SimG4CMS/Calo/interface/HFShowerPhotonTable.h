@@ -0,0 +1,69 @@
+#ifndef SimG4CMS_HFShowerPhotonTable_h
+#define SimG4CMS_HFShowerPhotonTable_h 1
+///////////////////////////////////////////////////////////////////////////////
+// File: HFShowerPhotonTable.h
+// Description: Flat, memory-mapped copy of the photons of the HF shower
+//              library, shared read-only by all the HFShowerLibrary objects
+//              of a job (and by all the jobs using the same table file)
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+class HFShowerPhotonTable {
+
+public:
+
+  struct Photon {
+    float x, y, z, lambda, t;
+  };
+
+  // type 0 (em) or 1 (had), record 1 ... nRecords as in HFShowerLibrary
+  typedef std::function<void(int type, int record, std::vector<Photon>&)> Reader;
+  typedef std::pair<const Photon*, const Photon*> Range;
+
+  static constexpr uint32_t formatVersion = 1;
+
+  // return the table shared by the whole process; the table file is mapped
+  // if it matches the configuration, otherwise it is (re)built with reader.
+  // An empty fileName gives a private table in a temporary file.
+  static std::shared_ptr<const HFShowerPhotonTable> get(const std::string & fileName,
+                                                         const std::string & configuration,
+                                                         int nRecords, const Reader & reader);
+
+  // FNV-1a hash of the contents of a file, to put the library in the
+  // configuration; computed once per process for a given file
+  static uint64_t hashFile(const std::string & fileName);
+
+  ~HFShowerPhotonTable();
+
+  HFShowerPhotonTable(const HFShowerPhotonTable&) = delete;
+  HFShowerPhotonTable& operator=(const HFShowerPhotonTable&) = delete;
+
+  Range               record(int type, int record) const {
+    const uint64_t* off = offsets_ + type*nRecords_ + record - 1;
+    return Range(photons_ + off[0], photons_ + off[1]);
+  }
+  int                 nRecords() const { return nRecords_; }
+  uint64_t            nPhotons() const { return offsets_[2*nRecords_]; }
+  size_t              bytes() const { return size_; }
+
+private:
+
+  HFShowerPhotonTable() = default;
+
+  bool                map(const std::string & fileName, uint64_t key, int nRecords);
+  static void         write(const std::string & fileName, uint64_t key, int nRecords,
+                            const Reader & reader);
+
+  void *              base_ = nullptr;
+  size_t              size_ = 0;
+  int                 nRecords_ = 0;
+  const uint64_t *    offsets_ = nullptr;
+  const Photon *      photons_ = nullptr;
+};
+#endif
@@ -0,0 +1,84 @@
+///////////////////////////////////////////////////////////////////////////////
+// File: CaloHitMap.cc
+// Description: Open-addressing map from CaloHitID to CaloG4Hit
+///////////////////////////////////////////////////////////////////////////////
+#include "SimG4CMS/Calo/interface/CaloHitMap.h"
+
+namespace {
+  // initial size, enough for most events in a single detector
+  constexpr unsigned int initialBits = 12;
+}
+
+CaloHitMap::CaloHitMap() : mask_(0), shift_(64), generation_(1), size_(0), used_(0) {
+  rehash(initialBits);
+}
+
+void CaloHitMap::insert(const CaloHitID& id, CaloG4Hit* hit) {
+  // keep the load (including deleted entries) below 1/2
+  if (2*(used_+1) > slots_.size()) {
+    unsigned int bits = 64 - shift_;
+    rehash(2*(size_+1) > slots_.size()/2 ? bits+1 : bits);
+  }
+  Key key(id);
+  uint32_t b = bucket(key);
+  int free = -1;
+  for (; slots_[b].generation == generation_; b = (b+1) & mask_) {
+    Slot& s = slots_[b];
+    if (s.hit == nullptr) {
+      if (free < 0) free = b;
+    } else if (s.key == key) {
+      // as std::map::insert: an existing entry is not replaced
+      return;
+    }
+  }
+  if (free < 0) { free = b; ++used_; }
+  slots_[free].key        = key;
+  slots_[free].hit        = hit;
+  slots_[free].generation = generation_;
+  ++size_;
+}
+
+void CaloHitMap::erase(const CaloHitID& id) {
+  Key key(id);
+  for (uint32_t b = bucket(key); slots_[b].generation == generation_; b = (b+1) & mask_) {
+    Slot& s = slots_[b];
+    if (s.hit != nullptr && s.key == key) {
+      s.hit = nullptr;
+      --size_;
+      return;
+    }
+  }
+}
+
+void CaloHitMap::clear() {
+  size_ = used_ = 0;
+  if (++generation_ == 0) {
+    // wrap-around of the generation: really clean the slots
+    for (auto& s : slots_) s.generation = 0;
+    generation_ = 1;
+  }
+}
+
+void CaloHitMap::rehash(unsigned int bits) {
+  std::vector<Slot> old;
+  old.swap(slots_);
+  Slot empty;
+  empty.hit = nullptr;
+  empty.generation = 0;
+  slots_.assign(1u << bits, empty);
+  mask_  = (1u << bits) - 1;
+  shift_ = 64 - bits;
+  uint32_t oldGeneration = generation_;
+  generation_ = 1;
+  size_ = used_ = 0;
+  for (const auto& s : old) {
+    if (s.generation == oldGeneration && s.hit != nullptr) {
+      uint32_t b = bucket(s.key);
+      while (slots_[b].generation == generation_) b = (b+1) & mask_;
+      slots_[b] = s;
+      slots_[b].generation = generation_;
+      ++size_;
+      ++used_;
+    }
+  }
+}
@@ -331,9 +331,9 @@ bool CaloSD::checkHit() {
   //look in the HitContainer whether a hit with the same ID already exists:
   bool found = false;
   if (useMap) {
-    std::map<CaloHitID,CaloG4Hit*>::const_iterator it = hitMap.find(currentID);
-    if (it != hitMap.end()) {
-      currentHit = it->second;
+    CaloG4Hit* hit = hitMap.find(currentID);
+    if (hit != nullptr) {
+      currentHit = hit;
       found      = true;
     }
   } else if (nCheckedHits > 0) {
@@ -378,10 +378,11 @@ CaloG4Hit* CaloSD::createNewHit(const G4Step* aStep) {
   
   CaloG4Hit* aHit;
   if (!reusehit.empty()) {
-    aHit = reusehit[0];
+    // all the content of the hit is reset below: take the cheapest one
+    aHit = reusehit.back();
     aHit->setEM(0.f);
     aHit->setHadr(0.f);
-    reusehit.erase(reusehit.begin());
+    reusehit.pop_back();
   } else {
     aHit = new CaloG4Hit;
   }
@@ -410,7 +411,8 @@ CaloG4Hit* CaloSD::createNewHit(const G4Step* aStep) {
       trkInfo->putInHistory();
     }
   } else {
-    TrackWithHistory * trkh = tkMap[currentID.trackID()];
+    auto it = tkMap.find(currentID.trackID());
+    TrackWithHistory * trkh = (it != tkMap.end()) ? it->second : nullptr;
 #ifdef DebugLog
     edm::LogVerbatim("CaloSim") << "CaloSD : TrackwithHistory pointer for " 
                             << currentID.trackID() << " is " << trkh;
@@ -573,11 +575,11 @@ void CaloSD::update(const ::EndOfEvent * ) {
 			  << " Zglob= " << zglob << " Zloc= " << zloc
 			  << " ";
 
-  tkMap.erase (tkMap.begin(), tkMap.end());
+  tkMap.clear();
 }
 
 void CaloSD::clearHits() {  
-  if (useMap) hitMap.erase (hitMap.begin(), hitMap.end());
+  if (useMap) hitMap.clear();
   for (unsigned int i = 0; i<reusehit.size(); ++i) delete reusehit[i];
   std::vector<CaloG4Hit*>().swap(reusehit);
   cleanIndex  = 0;
@@ -666,7 +668,7 @@ void CaloSD::storeHit(CaloG4Hit* hit) {
   }
   
   theHC->insert(hit);
-  if (useMap) hitMap.insert(std::pair<CaloHitID,CaloG4Hit*>(previousID,hit));
+  if (useMap) hitMap.insert(previousID,hit);
 }
 
 bool CaloSD::saveHit(CaloG4Hit* aHit) {  
@@ -44,6 +44,8 @@ HFShowerLibrary::HFShowerLibrary(const std::string & name, const DDCompactView &
   std::string branchPost   = m_HS.getUntrackedParameter<std::string>("BranchPost","_R.obj");
   verbose                  = m_HS.getUntrackedParameter<bool>("Verbosity",false);
   applyFidCut              = m_HS.getParameter<bool>("ApplyFiducialCut");
+  bool useFlatTable        = m_HS.getUntrackedParameter<bool>("UseFlatTable",false);
+  std::string flatTable    = m_HS.getUntrackedParameter<std::string>("FlatTableFile","");
 
   if (pTreeName.find(".") == 0) pTreeName.erase(0,2);
   const char* nTree = pTreeName.c_str();
@@ -117,8 +119,16 @@ HFShowerLibrary::HFShowerLibrary(const std::string & name, const DDCompactView &
                            << probMax << "  Back propagation of light prob. "
                            << backProb;
   
-  fibre = new HFFibre(name, cpv, p);
   photo = new HFShowerPhotonCollection;
+  if (useFlatTable) {
+    // the table depends on the contents of the library and on how its branches are read
+    std::stringstream config;
+    config << std::hex << HFShowerPhotonTable::hashFile(pTreeName) << std::dec
+           << " " << emName << " " << hadName << " " << branchPre << " "
+           << branchPost << " " << totEvents << " " << newForm << v3version;
+    loadTable(flatTable, config.str());
+  }
+  fibre = new HFFibre(name, cpv, p);
 }
 
 HFShowerLibrary::~HFShowerLibrary() {
@@ -367,6 +377,10 @@ bool HFShowerLibrary::rInside(double r) {
 
 void HFShowerLibrary::getRecord(int type, int record) {
 
+  if (table) {
+    tableRecord = table->record(type, record);
+    return;
+  }
   int nrc     = record-1;
   photon.clear();
   photo->clear();
@@ -513,7 +527,7 @@ void HFShowerLibrary::interpolate(int type, double pin) {
   for (int ir=0; ir < 2; ir++) {
     if (irc[ir]>0) {
       getRecord (type, irc[ir]);
-      int nPhoton = (newForm) ? photo->size() : photon.size();
+      int nPhoton = nPhotons();
       npold      += nPhoton;
       for (int j=0; j<nPhoton; j++) {
         r = G4UniformRand();
@@ -579,7 +593,7 @@ void HFShowerLibrary::extrapolate(int type, double pin) {
   for (int ir=0; ir<nrec; ir++) {
     if (irc[ir]>0) {
       getRecord (type, irc[ir]);
-      int nPhoton = (newForm) ? photo->size() : photon.size();
+      int nPhoton = nPhotons();
       npold      += nPhoton;
       for (int j=0; j<nPhoton; j++) {
         double r = G4UniformRand();
@@ -616,8 +630,14 @@ void HFShowerLibrary::extrapolate(int type, double pin) {
 
 void HFShowerLibrary::storePhoton(int j) {
 
-  if (newForm) pe.push_back(photo->at(j));
-  else         pe.push_back(photon[j]);
+  if (table) {
+    const HFShowerPhotonTable::Photon & ph = tableRecord.first[j];
+    pe.emplace_back(ph.x, ph.y, ph.z, ph.lambda, ph.t);
+  } else if (newForm) {
+    pe.push_back(photo->at(j));
+  } else {
+    pe.push_back(photon[j]);
+  }
 #ifdef DebugLog
   LogDebug("HFShower") << "HFShowerLibrary: storePhoton " << j << " npe " 
                        << npe << " " << pe[npe];
@@ -625,6 +645,39 @@ void HFShowerLibrary::storePhoton(int j) {
   npe++;
 }
 
+int HFShowerLibrary::nPhotons() const {
+
+  if (table) return tableRecord.second - tableRecord.first;
+  return (newForm) ? photo->size() : photon.size();
+}
+
+void HFShowerLibrary::loadTable(const std::string & fileName,
+                                const std::string & config) {
+
+  // the ROOT branches are read only if the table has to be built
+  auto reader = [this](int type, int record,
+                       std::vector<HFShowerPhotonTable::Photon> & photons) {
+    getRecord(type, record);
+    int nPhoton = nPhotons();
+    photons.reserve(nPhoton);
+    for (int j=0; j<nPhoton; ++j) {
+      const HFShowerPhoton & ph = (newForm) ? photo->at(j) : photon[j];
+      photons.push_back({ph.x(), ph.y(), ph.z(), ph.lambda(), ph.t()});
+    }
+  };
+  table = HFShowerPhotonTable::get(fileName, config, totEvents, reader);
+  edm::LogVerbatim("HFShower") << "HFShowerLibrary: uses the flat photon table with "
+                               << table->nPhotons() << " photons";
+
+  // the library file is not needed any more
+  hf->Close();
+  delete hf;
+  hf = nullptr;
+  emBranch = hadBranch = nullptr;
+  photo->clear();
+  photon.clear();
+}
+
 std::vector<double> HFShowerLibrary::getDDDArray(const std::string & str, 
                                                  const DDsvalues_type & sv, 
                                                  int & nmin) {
@@ -0,0 +1,220 @@
+///////////////////////////////////////////////////////////////////////////////
+// File: HFShowerPhotonTable.cc
+// Description: Flat, memory-mapped table of the HF shower library photons
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SimG4CMS/Calo/interface/HFShowerPhotonTable.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+  constexpr char magic[8] = {'C','M','S','H','F','L','I','B'};
+
+  struct Header {
+    char     magic[8];
+    uint32_t version;
+    uint32_t photonSize;
+    uint64_t key;
+    uint64_t nRecords;
+    uint64_t nPhotons;
+  };
+  static_assert(sizeof(Header)==40, "HFShowerPhotonTable header layout changed: bump formatVersion");
+  static_assert(sizeof(HFShowerPhotonTable::Photon)==20, "HFShowerPhotonTable photon layout changed: bump formatVersion");
+
+  // FNV-1a
+  constexpr uint64_t fnvOffset = 14695981039346656037ULL;
+  void hashBytes(uint64_t & h, const char * p, size_t n) {
+    for (size_t k=0; k<n; ++k) { h ^= static_cast<unsigned char>(p[k]); h *= 1099511628211ULL; }
+  }
+
+  uint64_t hashConfiguration(const std::string & s) {
+    uint64_t h = fnvOffset;
+    hashBytes(h, s.data(), s.size());
+    return h;
+  }
+
+  // file hashes, by name, device, inode, size and modification time: every
+  // HFShowerLibrary of the job hashes the same library
+  std::mutex hashesMutex;
+  std::map<std::string, uint64_t> hashes;
+
+  // one table per (file, configuration) in the process
+  std::mutex tablesMutex;
+  std::map<std::string, std::weak_ptr<const HFShowerPhotonTable> > tables;
+
+}
+
+std::shared_ptr<const HFShowerPhotonTable>
+HFShowerPhotonTable::get(const std::string & fileName, const std::string & configuration,
+                         int nRecords, const Reader & reader) {
+
+  std::lock_guard<std::mutex> guard(tablesMutex);
+  std::string id = fileName + "\n" + configuration;
+  auto & slot = tables[id];
+  if (auto table = slot.lock()) return table;
+
+  uint64_t key = hashConfiguration(configuration);
+  std::shared_ptr<HFShowerPhotonTable> table(new HFShowerPhotonTable);
+  if (!fileName.empty() && table->map(fileName, key, nRecords)) {
+    edm::LogVerbatim("HFShower") << "HFShowerPhotonTable: mapped " << table->nPhotons()
+                                 << " photons in " << 2*nRecords << " records from "
+                                 << fileName;
+  } else {
+    std::string name = fileName;
+    if (name.empty()) {
+      const char* tmpdir = std::getenv("TMPDIR");
+      name = std::string((tmpdir && *tmpdir) ? tmpdir : "/tmp") + "/HFShowerPhotonTable_XXXXXX";
+      int fd = ::mkstemp(&name[0]);
+      if (fd < 0)
+        throw cms::Exception("Unknown", "HFShowerPhotonTable")
+          << "Cannot create a temporary file for the shower library table\n";
+      ::close(fd);
+    }
+    write(name, key, nRecords, reader);
+    bool ok = table->map(name, key, nRecords);
+    // a private table lives only as long as its mapping
+    if (fileName.empty()) std::remove(name.c_str());
+    if (!ok)
+      throw cms::Exception("Unknown", "HFShowerPhotonTable")
+        << "Cannot map the shower library table " << name << "\n";
+    edm::LogVerbatim("HFShower") << "HFShowerPhotonTable: converted " << table->nPhotons()
+                                 << " photons in " << 2*nRecords << " records ("
+                                 << table->bytes()/(1024*1024) << " MB) into "
+                                 << (fileName.empty() ? std::string("a private table") : fileName);
+  }
+  slot = table;
+  return table;
+}
+
+uint64_t HFShowerPhotonTable::hashFile(const std::string & fileName) {
+
+  struct stat st;
+  if (::stat(fileName.c_str(), &st) != 0)
+    throw cms::Exception("Unknown", "HFShowerPhotonTable")
+      << "Cannot stat the shower library " << fileName << "\n";
+  std::string id = fileName + "\n" + std::to_string(st.st_dev) + " " + std::to_string(st.st_ino)
+    + " " + std::to_string(st.st_size) + " " + std::to_string(st.st_mtime);
+
+  std::lock_guard<std::mutex> guard(hashesMutex);
+  auto found = hashes.find(id);
+  if (found != hashes.end()) return found->second;
+
+  // the contents followed by the size, as the hash of the geometry inputs
+  uint64_t h = fnvOffset;
+  std::ifstream in(fileName, std::ios::binary);
+  std::vector<char> buffer(1<<16);
+  uint64_t size = 0;
+  while (in) {
+    in.read(buffer.data(), buffer.size());
+    hashBytes(h, buffer.data(), in.gcount());
+    size += in.gcount();
+  }
+  if (in.bad() || size != uint64_t(st.st_size))
+    throw cms::Exception("Unknown", "HFShowerPhotonTable")
+      << "Cannot read the shower library " << fileName << "\n";
+  hashBytes(h, reinterpret_cast<const char*>(&size), sizeof(size));
+  hashes[id] = h;
+  return h;
+}
+
+HFShowerPhotonTable::~HFShowerPhotonTable() {
+  if (base_) ::munmap(base_, size_);
+}
+
+bool HFShowerPhotonTable::map(const std::string & fileName, uint64_t key, int nRecords) {
+
+  int fd = ::open(fileName.c_str(), O_RDONLY);
+  if (fd < 0) return false;
+  struct stat st;
+  if (::fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(Header)) { ::close(fd); return false; }
+  size_t size = st.st_size;
+  // shared mapping: the pages are in the page cache once for all the jobs on the node
+  void* base = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (base == MAP_FAILED) return false;
+
+  const char* data = static_cast<const char*>(base);
+  const Header* header = reinterpret_cast<const Header*>(data);
+  size_t nOffsets = 2*size_t(nRecords) + 1;
+  bool ok = (std::memcmp(header->magic, magic, sizeof(magic)) == 0 &&
+             header->version == formatVersion &&
+             header->photonSize == sizeof(Photon) &&
+             header->key == key &&
+             header->nRecords == uint64_t(nRecords) &&
+             size == sizeof(Header) + nOffsets*sizeof(uint64_t) + header->nPhotons*sizeof(Photon));
+  const uint64_t* offsets = reinterpret_cast<const uint64_t*>(data + sizeof(Header));
+  ok = ok && offsets[0] == 0 && offsets[nOffsets-1] == header->nPhotons;
+  if (!ok) {
+    ::munmap(base, size);
+    return false;
+  }
+  ::madvise(base, size, MADV_WILLNEED);
+
+  base_     = base;
+  size_     = size;
+  nRecords_ = nRecords;
+  offsets_  = offsets;
+  photons_  = reinterpret_cast<const Photon*>(data + sizeof(Header) + nOffsets*sizeof(uint64_t));
+  return true;
+}
+
+void HFShowerPhotonTable::write(const std::string & fileName, uint64_t key, int nRecords,
+                                const Reader & reader) {
+
+  std::vector<uint64_t> offsets(2*size_t(nRecords) + 1, 0);
+  Header header;
+  std::memset(&header, 0, sizeof(Header));
+  std::memcpy(header.magic, magic, sizeof(magic));
+  header.version    = formatVersion;
+  header.photonSize = sizeof(Photon);
+  header.key        = key;
+  header.nRecords   = nRecords;
+
+  // concurrent jobs may build the same table: never expose a partial file
+  std::string tmpName = fileName + ".tmp" + std::to_string(::getpid());
+  {
+    std::ofstream out(tmpName, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+    out.write(reinterpret_cast<const char*>(offsets.data()), offsets.size()*sizeof(uint64_t));
+
+    // photons are streamed record by record, the header and the offsets are rewritten at the end
+    std::vector<Photon> photons;
+    uint64_t nPhotons = 0;
+    for (int type = 0; type < 2 && out; ++type) {
+      for (int record = 1; record <= nRecords; ++record) {
+        photons.clear();
+        reader(type, record, photons);
+        out.write(reinterpret_cast<const char*>(photons.data()), photons.size()*sizeof(Photon));
+        nPhotons += photons.size();
+        offsets[type*nRecords + record] = nPhotons;
+      }
+    }
+    header.nPhotons = nPhotons;
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+    out.write(reinterpret_cast<const char*>(offsets.data()), offsets.size()*sizeof(uint64_t));
+    if (!out) {
+      std::remove(tmpName.c_str());
+      throw cms::Exception("Unknown", "HFShowerPhotonTable")
+        << "Cannot write the shower library table " << tmpName << "\n";
+    }
+  }
+  if (std::rename(tmpName.c_str(), fileName.c_str()) != 0) {
+    std::remove(tmpName.c_str());
+    throw cms::Exception("Unknown", "HFShowerPhotonTable")
+      << "Cannot rename the shower library table to " << fileName << "\n";
+  }
+}
@@ -0,0 +1,193 @@
+// Checks CaloHitMap against the std::map<CaloHitID,CaloG4Hit*> it replaces
+// in CaloSD, on random sequences of insert, find, erase and clear: with
+// IDs differing only in the time inside a slice, with churn at constant
+// size (deleted entries reused, no growth), with clears of full tables
+// (nothing of the previous generation comes back) and with growth under
+// load.
+
+#include "SimG4CMS/Calo/interface/CaloHitMap.h"
+#include "SimG4CMS/Calo/interface/CaloHitID.h"
+
+#include <iostream>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace {
+
+  // the hits are never dereferenced: distinct addresses are enough
+  class Hits {
+  public:
+    Hits() : storage_(1<<22) {}
+    CaloG4Hit* next() { return reinterpret_cast<CaloG4Hit*>(&storage_[n_++ % storage_.size()]); }
+  private:
+    std::vector<char> storage_;
+    size_t n_ = 0;
+  };
+
+  // IDs from a small set, so that the same keys come back often; the time
+  // is anywhere inside its 1 ns slice
+  CaloHitID randomID(std::mt19937 & gen, int nUnits) {
+    std::uniform_int_distribution<int> unit(0, nUnits-1), track(-1, 19), depth(0, 2), slice(0, 9);
+    std::uniform_real_distribution<double> inSlice(0.05, 0.95);
+    uint32_t unitID = 0x44000000u + 0x1234u*unit(gen);
+    return CaloHitID(unitID, slice(gen) + inSlice(gen), track(gen), depth(gen));
+  }
+
+  typedef std::map<CaloHitID, CaloG4Hit*> Reference;
+
+  bool check(const char * name, long step, const CaloHitMap & map, const Reference & reference) {
+    if (map.size() != reference.size()) {
+      std::cout << name << ": step " << step << " size " << map.size() << " instead of "
+                << reference.size() << std::endl;
+      return false;
+    }
+    for (auto const & entry : reference) {
+      if (map.find(entry.first) != entry.second) {
+        std::cout << name << ": step " << step << " wrong hit for " << entry.first << std::endl;
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // insert, find and erase with a clear now and then
+  bool randomOperations(std::mt19937 & gen, Hits & hits) {
+    CaloHitMap map;
+    Reference reference;
+    std::uniform_int_distribution<int> operation(0, 99);
+    for (long step = 0; step < 400000; ++step) {
+      CaloHitID id = randomID(gen, 200);
+      int op = operation(gen);
+      if (op < 45) {
+        CaloG4Hit* hit = hits.next();
+        map.insert(id, hit);
+        reference.insert(std::make_pair(id, hit));
+      } else if (op < 75) {
+        auto found = reference.find(id);
+        if (map.find(id) != (found == reference.end() ? nullptr : found->second)) {
+          std::cout << "random operations: step " << step << " find " << id << " differs" << std::endl;
+          return false;
+        }
+      } else if (op < 99 || step % 1000 != 0) {
+        map.erase(id);
+        reference.erase(id);
+      } else {
+        map.clear();
+        reference.clear();
+      }
+      if (step % 20000 == 0 && !check("random operations", step, map, reference)) return false;
+    }
+    std::cout << "random operations: " << map.size() << " entries in " << map.capacity()
+              << " slots at the end" << std::endl;
+    return check("random operations", -1, map, reference);
+  }
+
+  // at constant size the deleted entries are reused or dropped in place
+  bool churn(std::mt19937 & gen, Hits & hits) {
+    CaloHitMap map;
+    Reference reference;
+    unsigned int capacity = map.capacity();
+    for (long step = 0; step < 400000; ++step) {
+      CaloHitID id = randomID(gen, 20);
+      if (reference.size() < 500) {
+        CaloG4Hit* hit = hits.next();
+        map.insert(id, hit);
+        reference.insert(std::make_pair(id, hit));
+      } else {
+        map.erase(reference.begin()->first);
+        reference.erase(reference.begin());
+      }
+      if (map.capacity() != capacity) {
+        std::cout << "churn: step " << step << " grew to " << map.capacity() << " slots with "
+                  << map.size() << " entries" << std::endl;
+        return false;
+      }
+      if (step % 20000 == 0 && !check("churn", step, map, reference)) return false;
+    }
+    std::cout << "churn: " << map.size() << " entries in " << map.capacity() << " slots" << std::endl;
+    return check("churn", -1, map, reference);
+  }
+
+  // after a clear, nothing of the previous events is found, in a table
+  // that keeps its size
+  bool clears(std::mt19937 & gen, Hits & hits) {
+    CaloHitMap map;
+    std::vector<CaloHitID> previous;
+    for (int event = 0; event < 2000; ++event) {
+      unsigned int capacity = map.capacity();
+      map.clear();
+      if (map.size() != 0 || map.capacity() != capacity) {
+        std::cout << "clears: event " << event << " size " << map.size() << " and "
+                  << map.capacity() << " slots after the clear" << std::endl;
+        return false;
+      }
+      for (auto const & id : previous) {
+        if (map.find(id) != nullptr) {
+          std::cout << "clears: event " << event << " finds " << id << " of the previous event" << std::endl;
+          return false;
+        }
+      }
+      Reference reference;
+      int nHits = (event % 100 == 0) ? 3000 : 50;
+      for (int k = 0; k < nHits; ++k) {
+        CaloHitID id = randomID(gen, 200);
+        CaloG4Hit* hit = hits.next();
+        map.insert(id, hit);
+        reference.insert(std::make_pair(id, hit));
+      }
+      if (!check("clears", event, map, reference)) return false;
+      previous.clear();
+      for (auto const & entry : reference) previous.push_back(entry.first);
+    }
+    return true;
+  }
+
+  // many distinct keys: the table grows and keeps its load below 1/2
+  bool growth(std::mt19937 & gen, Hits & hits) {
+    CaloHitMap map;
+    Reference reference;
+    unsigned int initial = map.capacity();
+    for (int k = 0; k < 200000; ++k) {
+      CaloHitID id = randomID(gen, 20000);
+      CaloG4Hit* hit = hits.next();
+      map.insert(id, hit);
+      reference.insert(std::make_pair(id, hit));
+      if (2*map.size() > map.capacity()) {
+        std::cout << "growth: " << map.size() << " entries in " << map.capacity() << " slots" << std::endl;
+        return false;
+      }
+      // erase a third of the keys on the way
+      if (k % 3 == 0) {
+        CaloHitID old = randomID(gen, 20000);
+        map.erase(old);
+        reference.erase(old);
+      }
+    }
+    std::cout << "growth: " << map.size() << " entries in " << map.capacity() << " slots, from "
+              << initial << std::endl;
+    return map.capacity() > initial && check("growth", -1, map, reference);
+  }
+
+}
+
+int main() {
+  std::mt19937 gen(33);
+  Hits hits;
+
+  // same unit, track, depth and slice: the same key
+  CaloHitMap map;
+  CaloG4Hit* hit = hits.next();
+  map.insert(CaloHitID(0x44000001u, 5.1, 3, 1), hit);
+  map.insert(CaloHitID(0x44000001u, 5.9, 3, 1), hits.next());
+  bool ok = map.size() == 1 && map.find(CaloHitID(0x44000001u, 5.5, 3, 1)) == hit &&
+    map.find(CaloHitID(0x44000001u, 6.1, 3, 1)) == nullptr;
+  if (!ok) std::cout << "IDs in the same time slice are not the same key" << std::endl;
+
+  ok &= randomOperations(gen, hits);
+  ok &= churn(gen, hits);
+  ok &= clears(gen, hits);
+  ok &= growth(gen, hits);
+  if (!ok) std::cout << "CaloHitMap and std::map DIFFER" << std::endl;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,160 @@
+// Checks that the flat photon table of the HF shower library gives, for
+// every record, the same photons as the ROOT branches of the library, once
+// converted and once mapped back from the table file; that a table with
+// another key is rebuilt; and that the key follows the contents of the
+// library file, not its name or size.
+
+#include "SimG4CMS/Calo/interface/HFShowerPhotonTable.h"
+#include "SimDataFormats/CaloHit/interface/HFShowerPhoton.h"
+#include "FWCore/ParameterSet/interface/FileInPath.h"
+
+#include "TFile.h"
+#include "TTree.h"
+#include "TBranch.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+namespace {
+
+  // the library as read by HFShowerLibrary::getRecord with the default
+  // (new form) configuration: no event info, 16 bins of 5000 showers
+  constexpr int totEvents = 16*5000;
+
+  class Library {
+  public:
+    explicit Library(const std::string & name) : file_(TFile::Open(name.c_str())) {
+      TTree* tree = file_ ? (TTree*) file_->Get("HFSimHits") : nullptr;
+      if (tree) {
+        branch_[0] = tree->GetBranch("emParticles");
+        branch_[1] = tree->GetBranch("hadParticles");
+      }
+    }
+    bool ok() const { return branch_[0] && branch_[1]; }
+
+    void read(int type, int record, std::vector<HFShowerPhotonTable::Photon> & photons) const {
+      TBranch* branch = branch_[type];
+      Long64_t entry = (type > 0) ? record-1+totEvents : record-1;
+      if (branch->GetClassName() == std::string("vector<float>")) {
+        std::vector<float> t;
+        std::vector<float>* tp = &t;
+        branch->SetAddress(&tp);
+        branch->GetEntry(entry);
+        size_t n = t.size()/5;
+        for (size_t i=0; i<n; ++i) photons.push_back({t[i], t[n+i], t[2*n+i], t[3*n+i], t[4*n+i]});
+      } else {
+        HFShowerPhotonCollection collection;
+        HFShowerPhotonCollection* cp = &collection;
+        branch->SetAddress(&cp);
+        branch->GetEntry(entry);
+        for (auto const & ph : collection) photons.push_back({ph.x(), ph.y(), ph.z(), ph.lambda(), ph.t()});
+      }
+      branch->ResetAddress();
+    }
+
+  private:
+    std::unique_ptr<TFile> file_;
+    TBranch* branch_[2] = {nullptr, nullptr};
+  };
+
+  bool same(const HFShowerPhotonTable::Photon & a, const HFShowerPhotonTable::Photon & b) {
+    return a.x == b.x && a.y == b.y && a.z == b.z && a.lambda == b.lambda && a.t == b.t;
+  }
+
+  // every record of the table against the branches
+  bool compare(const char * name, const HFShowerPhotonTable & table, const Library & library) {
+    std::vector<HFShowerPhotonTable::Photon> photons;
+    uint64_t nPhotons = 0;
+    int nDiff = 0;
+    for (int type=0; type<2; ++type) {
+      for (int record=1; record<=totEvents; ++record) {
+        photons.clear();
+        library.read(type, record, photons);
+        auto range = table.record(type, record);
+        bool ok = size_t(range.second - range.first) == photons.size();
+        for (size_t j=0; ok && j<photons.size(); ++j) ok = same(range.first[j], photons[j]);
+        if (!ok && ++nDiff <= 10)
+          std::cout << name << ": type " << type << " record " << record << " has "
+                    << range.second - range.first << " photons in the table and "
+                    << photons.size() << " in the library, or different ones" << std::endl;
+        nPhotons += photons.size();
+      }
+    }
+    std::cout << name << ": " << nPhotons << " photons in " << 2*totEvents << " records, "
+              << nDiff << " different" << std::endl;
+    return nDiff == 0 && nPhotons > 0 && nPhotons == table.nPhotons();
+  }
+
+  std::string writeFile(const std::string & name, const std::string & contents) {
+    std::ofstream(name, std::ios::binary) << contents;
+    return name;
+  }
+
+}
+
+int main() {
+  const char* tmp = std::getenv("LOCAL_TMP_DIR");
+  std::string dir = (tmp && *tmp) ? tmp : "/tmp";
+  std::string prefix = dir + "/HFShowerPhotonTable_t_" + std::to_string(::getpid());
+  bool ok = true;
+
+  // same size, different contents / same contents, different name
+  std::string a = writeFile(prefix + ".a", "HF shower library 1");
+  std::string b = writeFile(prefix + ".b", "HF shower library 2");
+  std::string c = writeFile(prefix + ".c", "HF shower library 1");
+  if (HFShowerPhotonTable::hashFile(a) == HFShowerPhotonTable::hashFile(b) ||
+      HFShowerPhotonTable::hashFile(a) != HFShowerPhotonTable::hashFile(c)) {
+    std::cout << "the file hash does not follow the contents" << std::endl;
+    ok = false;
+  }
+  for (auto const & name : {a, b, c}) std::remove(name.c_str());
+
+  std::string libraryName = edm::FileInPath("SimG4CMS/Calo/data/HFShowerLibrary_npmt_noatt_eta4_16en_v4.root").fullPath();
+  Library library(libraryName);
+  if (!library.ok()) {
+    std::cout << "cannot read the branches of " << libraryName << std::endl;
+    return 1;
+  }
+  std::stringstream config;
+  config << std::hex << HFShowerPhotonTable::hashFile(libraryName);
+  std::string tableName = prefix + ".table";
+
+  int nRead = 0;
+  auto reader = [&](int type, int record, std::vector<HFShowerPhotonTable::Photon> & photons) {
+    ++nRead;
+    library.read(type, record, photons);
+  };
+
+  // converted from the branches
+  auto table = HFShowerPhotonTable::get(tableName, config.str(), totEvents, reader);
+  ok &= (nRead == 2*totEvents) && compare("converted", *table, library);
+
+  // mapped from the table file, without reading the branches
+  table.reset();
+  nRead = 0;
+  table = HFShowerPhotonTable::get(tableName, config.str(), totEvents, reader);
+  if (nRead != 0) std::cout << "mapped: the table was rebuilt" << std::endl;
+  ok &= (nRead == 0) && compare("mapped", *table, library);
+
+  // a table built for another library is not used
+  table.reset();
+  nRead = 0;
+  table = HFShowerPhotonTable::get(tableName, config.str() + " other", totEvents,
+                                   [&](int, int, std::vector<HFShowerPhotonTable::Photon> &) { ++nRead; });
+  if (nRead != 2*totEvents || table->nPhotons() != 0) {
+    std::cout << "another key: the table was not rebuilt" << std::endl;
+    ok = false;
+  }
+  table.reset();
+  std::remove(tableName.c_str());
+
+  return ok ? 0 : 1;
+}
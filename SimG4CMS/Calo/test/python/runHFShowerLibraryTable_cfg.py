@@ -0,0 +1,78 @@
+# Benchmark of the HF shower library with and without the flat photon table:
+#   cmsRun runHFShowerLibraryTable_cfg.py flatTable=0 threads=4
+#   cmsRun runHFShowerLibraryTable_cfg.py flatTable=1 threads=4 tableFile=hflib.table
+# and compare the g4SimHits time in the Timing/TimeReport summaries
+import FWCore.ParameterSet.Config as cms
+from FWCore.ParameterSet.VarParsing import VarParsing
+
+options = VarParsing('analysis')
+options.register('flatTable', 1, VarParsing.multiplicity.singleton, VarParsing.varType.int,
+                 "use the flat photon table")
+options.register('tableFile', '', VarParsing.multiplicity.singleton, VarParsing.varType.string,
+                 "file of the photon table (empty: private temporary table)")
+options.register('threads', 1, VarParsing.multiplicity.singleton, VarParsing.varType.int,
+                 "number of threads")
+options.setDefault('maxEvents', 200)
+options.parseArguments()
+
+process = cms.Process("PROD")
+process.load("SimGeneral.HepPDTESSource.pythiapdt_cfi")
+process.load("IOMC.EventVertexGenerators.VtxSmearedGauss_cfi")
+process.load("Configuration.Geometry.GeometryExtended2018Reco_cff")
+process.load("Configuration.StandardSequences.MagneticField_cff")
+process.load("Configuration.EventContent.EventContent_cff")
+process.load('Configuration.StandardSequences.Generator_cff')
+process.load('Configuration.StandardSequences.SimIdeal_cff')
+process.load("Configuration.StandardSequences.FrontierConditions_GlobalTag_cff")
+from Configuration.AlCa.autoCond import autoCond
+process.GlobalTag.globaltag = autoCond['run2_mc']
+
+process.load("FWCore.MessageService.MessageLogger_cfi")
+process.MessageLogger.categories.append('HFShower')
+process.MessageLogger.cerr.FwkReport.reportEvery = 50
+
+process.load("IOMC.RandomEngine.IOMC_cff")
+process.RandomNumberGeneratorService.generator.initialSeed = 456789
+process.RandomNumberGeneratorService.g4SimHits.initialSeed = 9876
+process.RandomNumberGeneratorService.VtxSmeared.initialSeed = 123456789
+
+process.Timing = cms.Service("Timing",
+    summaryOnly = cms.untracked.bool(True)
+)
+
+process.options = cms.untracked.PSet(
+    numberOfThreads = cms.untracked.uint32(options.threads),
+    numberOfStreams = cms.untracked.uint32(0),
+    wantSummary     = cms.untracked.bool(True)
+)
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(options.maxEvents)
+)
+
+process.source = cms.Source("EmptySource",
+    firstRun        = cms.untracked.uint32(1),
+    firstEvent      = cms.untracked.uint32(1)
+)
+
+# HF-heavy events: pions and electrons in the HF acceptance over the library energy range
+process.generator = cms.EDProducer("FlatRandomEGunProducer",
+    PGunParameters = cms.PSet(
+        PartID = cms.vint32(211, 11, 211, -211),
+        MinEta = cms.double(3.00),
+        MaxEta = cms.double(4.80),
+        MinPhi = cms.double(-3.1415926),
+        MaxPhi = cms.double(3.1415926),
+        MinE   = cms.double(10.00),
+        MaxE   = cms.double(1000.00)
+    ),
+    Verbosity       = cms.untracked.int32(0),
+    AddAntiParticle = cms.bool(True)
+)
+
+process.p1 = cms.Path(process.generator*process.VtxSmeared*process.g4SimHits)
+process.g4SimHits.HCalSD.UseShowerLibrary        = True
+process.g4SimHits.HFShower.UseShowerLibrary      = True
+process.g4SimHits.HFShowerLibrary.FileName       = 'SimG4CMS/Calo/data/HFShowerLibrary_npmt_noatt_eta4_16en_v4.root'
+process.g4SimHits.HFShowerLibrary.UseFlatTable   = cms.untracked.bool(bool(options.flatTable))
+process.g4SimHits.HFShowerLibrary.FlatTableFile  = cms.untracked.string(options.tableFile)
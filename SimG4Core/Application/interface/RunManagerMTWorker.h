@@ -6,8 +6,12 @@
 
 #include "SimG4Core/Generators/interface/Generator.h"
 #include "SimDataFormats/Forward/interface/LHCTransportLinkContainer.h"
+#include "SimDataFormats/TrackingHit/interface/PSimHitContainer.h"
+#include "SimDataFormats/CaloHit/interface/PCaloHitContainer.h"
 
+#include <map>
 #include <memory>
+#include <string>
 
 namespace edm {
   class ParameterSet;
@@ -48,7 +52,15 @@ public:
   void abortEvent();
   void abortRun(bool softAbort=false);
 
-  inline G4SimEvent * simEvent() { return m_simEvent.get(); }
+  G4SimEvent * simEvent();
+
+  // With NumberOfSubEvents > 1 the primaries of an event are split among 
+  // sub-events, simulated as concurrent tasks each with the Geant4 state of 
+  // the thread it runs on; the hits of the sub-events are then merged here
+  // instead of being read from the sensitive detectors of the stream
+  bool splitsEvents() const { return m_nSubEvents > 1; }
+  void fillHits(edm::PSimHitContainer& c, const std::string& name);
+  void fillHits(edm::PCaloHitContainer& c, const std::string& name);
 
   void Connect(RunAction*);
   void Connect(EventAction*);
@@ -69,6 +81,16 @@ private:
   void initializeRun();
   void terminateRun();
 
+  void initializeThreadAndRun(const edm::Event& inpevt, const edm::EventSetup& es,
+                              RunManagerMT& runManagerMaster);
+
+  struct SubEvent;
+  void produceSubEvents(const edm::Event& inpevt, const edm::EventSetup& es,
+                        RunManagerMT& runManagerMaster);
+  void simulateSubEvent(const edm::Event& inpevt, const edm::EventSetup& es,
+                        RunManagerMT& runManagerMaster, const HepMC::GenEvent* genEvent,
+                        const edm::LHCTransportLinkContainer* lhcTlink, SubEvent& sub);
+
   G4Event *generateEvent(const edm::Event& inpevt);
   void resetGenParticleId(const edm::Event& inpevt);
 
@@ -80,6 +102,7 @@ private:
   bool m_pUseMagneticField;
   bool m_hasWatchers;
   int  m_EvtMgrVerbosity;
+  unsigned int m_nSubEvents;
 
   edm::ParameterSet m_pField;
   edm::ParameterSet m_pRunAction;
@@ -95,6 +118,9 @@ private:
 
   std::unique_ptr<G4SimEvent> m_simEvent;
   std::unique_ptr<CMSSteppingVerbose> m_sVerbose;
+
+  std::map<std::string, edm::PSimHitContainer> m_subEventTkHits;
+  std::map<std::string, edm::PCaloHitContainer> m_subEventCaloHits;
 };
 
 #endif
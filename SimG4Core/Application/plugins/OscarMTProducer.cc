@@ -207,7 +207,8 @@ void OscarMTProducer::produce(edm::Event & e, const edm::EventSetup & es)
 
       std::unique_ptr<edm::PSimHitContainer>
 	product(new edm::PSimHitContainer);
-      tracker->fillHits(*product,name);
+      if(m_runManagerWorker->splitsEvents()) { m_runManagerWorker->fillHits(*product,name); }
+      else { tracker->fillHits(*product,name); }
       e.put(std::move(product),name);
     }
   }
@@ -219,7 +220,8 @@ void OscarMTProducer::produce(edm::Event & e, const edm::EventSetup & es)
 
       std::unique_ptr<edm::PCaloHitContainer>
 	product(new edm::PCaloHitContainer);
-      calo->fillHits(*product,name);
+      if(m_runManagerWorker->splitsEvents()) { m_runManagerWorker->fillHits(*product,name); }
+      else { calo->fillHits(*product,name); }
       e.put(std::move(product),name);
     }
   }
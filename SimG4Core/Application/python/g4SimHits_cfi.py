@@ -43,6 +43,7 @@ common_UseLuminosity = cms.PSet(
 g4SimHits = cms.EDProducer("OscarMTProducer",
     NonBeamEvent = cms.bool(False),
     G4EventManagerVerbosity = cms.untracked.int32(0),
+    NumberOfSubEvents = cms.untracked.uint32(1), # >1 simulates the primaries of an event as concurrent sub-events
     G4StackManagerVerbosity = cms.untracked.int32(0),
     G4TrackingManagerVerbosity = cms.untracked.int32(0),
     UseMagneticField = cms.bool(True),
@@ -44,6 +44,16 @@
 #include "SimG4Core/Physics/interface/PhysicsList.h"
 
 #include "SimG4Core/SensitiveDetector/interface/AttachSD.h"
+#include "SimG4Core/SensitiveDetector/interface/SensitiveTkDetector.h"
+#include "SimG4Core/SensitiveDetector/interface/SensitiveCaloDetector.h"
+
+#include "FWCore/ServiceRegistry/interface/ServiceRegistry.h"
+
+#include "CLHEP/Random/MixMaxRng.h"
+#include "Randomize.hh"
+
+#include "tbb/task_arena.h"
+#include "tbb/task_group.h"
 
 #include "G4Event.hh"
 #include "G4Run.hh"
@@ -55,6 +65,7 @@
 #include "G4StateManager.hh"
 #include "G4TransportationManager.hh"
 
+#include <algorithm>
 #include <atomic>
 #include <thread>
 #include <sstream>
@@ -117,11 +128,21 @@ struct RunManagerMTWorker::TLSData {
   std::unique_ptr<G4Run> currentRun;
   std::unique_ptr<G4Event> currentEvent;
   std::unique_ptr<G4RunManagerKernel> kernel;
+  std::unique_ptr<Generator> generator; // for the sub-events simulated on this thread
+  G4SimEvent* currentSubEvent = nullptr;
   edm::RunNumber_t currentRunNumber = 0;
   bool threadInitialized = false;
   bool runTerminated = false;
 };
 
+struct RunManagerMTWorker::SubEvent {
+  unsigned int index = 0;
+  long seed = 0;
+  std::unique_ptr<G4SimEvent> simEvent;
+  std::map<std::string, edm::PSimHitContainer> tkHits;
+  std::map<std::string, edm::PCaloHitContainer> caloHits;
+};
+
 thread_local RunManagerMTWorker::TLSData *RunManagerMTWorker::m_tls = nullptr;
 
 RunManagerMTWorker::RunManagerMTWorker(const edm::ParameterSet& iConfig, edm::ConsumesCollector&& iC):
@@ -131,6 +152,7 @@ RunManagerMTWorker::RunManagerMTWorker(const edm::ParameterSet& iConfig, edm::Co
   m_nonBeam(iConfig.getParameter<bool>("NonBeamEvent")),
   m_pUseMagneticField(iConfig.getParameter<bool>("UseMagneticField")),
   m_EvtMgrVerbosity(iConfig.getUntrackedParameter<int>("G4EventManagerVerbosity",0)),
+  m_nSubEvents(std::max(1U, iConfig.getUntrackedParameter<unsigned int>("NumberOfSubEvents",1))),
   m_pField(iConfig.getParameter<edm::ParameterSet>("MagneticField")),
   m_pRunAction(iConfig.getParameter<edm::ParameterSet>("RunAction")),
   m_pEventAction(iConfig.getParameter<edm::ParameterSet>("EventAction")),
@@ -146,6 +168,12 @@ RunManagerMTWorker::RunManagerMTWorker(const edm::ParameterSet& iConfig, edm::Co
   std::vector<edm::ParameterSet> watchers = 
     iConfig.getParameter<std::vector<edm::ParameterSet> >("Watchers");
   m_hasWatchers = (watchers.empty()) ? false : true;
+
+  if(m_nSubEvents > 1 && (m_hasWatchers || m_nonBeam)) {
+    // watchers and SimProducers keep per-thread event state which is not merged
+    throw edm::Exception(edm::errors::Configuration)
+      << "RunManagerMTWorker: NumberOfSubEvents > 1 is not supported with Watchers or for NonBeamEvent";
+  }
 }
 
 RunManagerMTWorker::~RunManagerMTWorker() {
@@ -360,6 +388,12 @@ void  RunManagerMTWorker::Connect(SteppingAction* steppingAction)
   steppingAction->m_g4StepSignal.connect(m_tls->registry->g4StepSignal_);
 }
 
+G4SimEvent* RunManagerMTWorker::simEvent() {
+  // a sub-event fills its own G4SimEvent, merged at the end of the event
+  if(m_tls && m_tls->currentSubEvent) { return m_tls->currentSubEvent; }
+  return m_simEvent.get();
+}
+
 SimTrackManager* RunManagerMTWorker::GetSimTrackManager() {
   initializeTLS();
   return m_tls->trackManager.get();
@@ -399,17 +433,8 @@ void RunManagerMTWorker::terminateRun() {
   m_tls->runTerminated = true;
 }
 
-void RunManagerMTWorker::produce(const edm::Event& inpevt, const edm::EventSetup& es, 
-                                 RunManagerMT& runManagerMaster) {
-  // The initialization and begin/end run is a bit convoluted due to
-  // - Geant4 deals per-thread
-  // - OscarMTProducer deals per-stream
-  // and framework/TBB is free to schedule work in streams to the
-  // threads as it likes.
-  //
-  // We have to do the per-thread initialization, and per-thread
-  // per-run initialization here by ourselves. 
-
+void RunManagerMTWorker::initializeThreadAndRun(const edm::Event& inpevt, const edm::EventSetup& es,
+                                                RunManagerMT& runManagerMaster) {
   if(!(m_tls && m_tls->threadInitialized)) {
     LogDebug("SimG4CoreApplication") 
       << "RunManagerMTWorker::produce(): stream " 
@@ -426,8 +451,27 @@ void RunManagerMTWorker::produce(const edm::Event& inpevt, const edm::EventSetup
     initializeRun();
     m_tls->currentRunNumber = inpevt.id().run();
   }
+}
+
+void RunManagerMTWorker::produce(const edm::Event& inpevt, const edm::EventSetup& es, 
+                                 RunManagerMT& runManagerMaster) {
+  // The initialization and begin/end run is a bit convoluted due to
+  // - Geant4 deals per-thread
+  // - OscarMTProducer deals per-stream
+  // and framework/TBB is free to schedule work in streams to the
+  // threads as it likes.
+  //
+  // We have to do the per-thread initialization, and per-thread
+  // per-run initialization here by ourselves. 
+
+  initializeThreadAndRun(inpevt, es, runManagerMaster);
   m_tls->runInterface->setRunManagerMTWorker(this); // For UserActions
 
+  if(m_nSubEvents > 1) {
+    produceSubEvents(inpevt, es, runManagerMaster);
+    return;
+  }
+
   m_tls->currentEvent.reset(generateEvent(inpevt));
 
   m_simEvent.reset(new G4SimEvent());
@@ -473,6 +517,145 @@ void RunManagerMTWorker::produce(const edm::Event& inpevt, const edm::EventSetup
   } 
 }
 
+void RunManagerMTWorker::produceSubEvents(const edm::Event& inpevt, const edm::EventSetup& es,
+                                          RunManagerMT& runManagerMaster) {
+  m_tls->currentEvent.reset();
+  m_simEvent.reset();
+  m_subEventTkHits.clear();
+  m_subEventCaloHits.clear();
+
+  edm::Handle<edm::HepMCProduct> HepMCEvt;
+  inpevt.getByToken(m_InToken, HepMCEvt);
+  edm::Handle<edm::LHCTransportLinkContainer> theLHCTlink;
+  inpevt.getByToken(m_theLHCTlinkToken, theLHCTlink);
+  const edm::LHCTransportLinkContainer* lhcTlink = theLHCTlink.isValid() ? theLHCTlink.product() : nullptr;
+
+  // the seeds come from the engine of the stream, so that the result 
+  // does not depend on the threads the sub-events run on
+  std::vector<SubEvent> subEvents(m_nSubEvents);
+  for(unsigned int i = 0; i < m_nSubEvents; ++i) {
+    subEvents[i].index = i;
+    subEvents[i].seed = (long)(G4UniformRand()*2147483647.);
+  }
+
+  edm::LogVerbatim("SimG4CoreApplication")
+    << " RunManagerMTWorker::produce: start Event " << inpevt.id().event() 
+    << " stream id " << inpevt.streamID()
+    << " split in " << m_nSubEvents << " sub-events";
+
+  // A thread only picks up a sub-event while its own Geant4 state is idle:
+  // the isolation keeps this thread from running other tasks while it waits
+  edm::ServiceToken token = edm::ServiceRegistry::instance().presentToken();
+  const HepMC::GenEvent* genEvent = HepMCEvt->GetEvent();
+  tbb::this_task_arena::isolate([&] {
+      tbb::task_group group;
+      for(auto& sub : subEvents) {
+        group.run([&, token] {
+            edm::ServiceRegistry::Operate operate(token);
+            simulateSubEvent(inpevt, es, runManagerMaster, genEvent, lhcTlink, sub);
+          });
+      }
+      group.wait();
+    });
+
+  // merge, shifting the track IDs of each sub-event beyond the previous ones
+  m_simEvent.reset(new G4SimEvent());
+  m_simEvent->hepEvent(subEvents[0].simEvent->hepEvent());
+  m_simEvent->weight(subEvents[0].simEvent->weight());
+  m_simEvent->collisionPoint(subEvents[0].simEvent->collisionPoint());
+  int trackIdOffset = 0;
+  for(auto& sub : subEvents) {
+    int maxTrackId = 0;
+    for(unsigned int i = 1; i <= sub.simEvent->nTracks(); ++i) {
+      maxTrackId = std::max(maxTrackId, sub.simEvent->g4track(i).id());
+    }
+    for(auto& hits : sub.tkHits) {
+      for(auto& hit : hits.second) {
+        maxTrackId = std::max(maxTrackId, int(hit.trackId()));
+        if(hit.trackId() > 0) { hit.setTrackId(hit.trackId() + trackIdOffset); }
+      }
+      auto& merged = m_subEventTkHits[hits.first];
+      merged.insert(merged.end(), hits.second.begin(), hits.second.end());
+    }
+    for(auto& hits : sub.caloHits) {
+      for(auto& hit : hits.second) {
+        maxTrackId = std::max(maxTrackId, hit.geantTrackId());
+        if(hit.geantTrackId() > 0) { hit.setGeantTrackId(hit.geantTrackId() + trackIdOffset); }
+      }
+      auto& merged = m_subEventCaloHits[hits.first];
+      merged.insert(merged.end(), hits.second.begin(), hits.second.end());
+    }
+    m_simEvent->merge(*sub.simEvent, trackIdOffset);
+    trackIdOffset += maxTrackId;
+  }
+
+  edm::LogVerbatim("SimG4CoreApplication")
+    << " RunManagerMTWorker::produce: ended Event " << inpevt.id().event()
+    << " with " << m_simEvent->nTracks() << " tracks and "
+    << m_simEvent->nVertices() << " vertices";
+}
+
+void RunManagerMTWorker::simulateSubEvent(const edm::Event& inpevt, const edm::EventSetup& es,
+                                          RunManagerMT& runManagerMaster, const HepMC::GenEvent* genEvent,
+                                          const edm::LHCTransportLinkContainer* lhcTlink, SubEvent& sub) {
+  // the Geant4 engine is per thread: use the one of the sub-event meanwhile
+  CLHEP::MixMaxRng engine(sub.seed);
+  CLHEP::HepRandomEngine* previousEngine = G4Random::getTheEngine();
+  G4Random::setTheEngine(&engine);
+  std::shared_ptr<void> engineGuard(nullptr, [previousEngine](void*) { G4Random::setTheEngine(previousEngine); });
+
+  initializeThreadAndRun(inpevt, es, runManagerMaster);
+  m_tls->runInterface->setRunManagerMTWorker(this); // For UserActions
+  if(!m_tls->generator) {
+    m_tls->generator.reset(new Generator(m_p.getParameter<edm::ParameterSet>("Generator")));
+  }
+  if(lhcTlink) { m_tls->trackManager->setLHCTransportLink(lhcTlink); }
+
+  G4Event* evt = new G4Event((G4int)inpevt.id().event());
+  m_tls->currentEvent.reset(evt);
+  Generator& generator = *(m_tls->generator);
+  generator.setGenEvent(genEvent);
+  generator.HepMC2G4(genEvent, evt, sub.index, m_nSubEvents);
+
+  sub.simEvent.reset(new G4SimEvent());
+  sub.simEvent->hepEvent(generator.genEvent());
+  sub.simEvent->weight(generator.eventWeight());
+  if (generator.genVertex() != nullptr ) {
+    auto genVertex = generator.genVertex();
+    sub.simEvent->collisionPoint(
+      math::XYZTLorentzVectorD(genVertex->x()/centimeter,
+			       genVertex->y()/centimeter,
+			       genVertex->z()/centimeter,
+			       genVertex->t()/second));
+  }
+
+  m_tls->currentSubEvent = sub.simEvent.get();
+  std::shared_ptr<void> subEventGuard(nullptr, [](void*) { m_tls->currentSubEvent = nullptr; });
+  m_tls->kernel->GetEventManager()->ProcessOneEvent(evt);
+
+  // the sensitive detectors of this thread are reset by its next event
+  for (auto& tracker : m_tls->sensTkDets) {
+    for (auto& name : tracker->getNames()) {
+      tracker->fillHits(sub.tkHits[name], name);
+    }
+  }
+  for (auto& calo : m_tls->sensCaloDets) {
+    for (auto& name : calo->getNames()) {
+      calo->fillHits(sub.caloHits[name], name);
+    }
+  }
+}
+
+void RunManagerMTWorker::fillHits(edm::PSimHitContainer& c, const std::string& name) {
+  auto hits = m_subEventTkHits.find(name);
+  if(hits != m_subEventTkHits.end()) { c.swap(hits->second); }
+}
+
+void RunManagerMTWorker::fillHits(edm::PCaloHitContainer& c, const std::string& name) {
+  auto hits = m_subEventCaloHits.find(name);
+  if(hits != m_subEventCaloHits.end()) { c.swap(hits->second); }
+}
+
 void RunManagerMTWorker::abortEvent() {
   if(m_tls->runTerminated) { return; }
   G4Track* t = m_tls->kernel->GetEventManager()->GetTrackingManager()->GetTrack();
@@ -0,0 +1,114 @@
+// Checks that the SimTrack, SimVertex, PSimHit and PCaloHit collections of
+// an event are consistent, as they must be after the sub-events of
+// RunManagerMTWorker are merged: unique track IDs, vertices and hits
+// pointing at existing tracks, tracks pointing at existing vertices and
+// each generator particle simulated once. Prints the primaries of the
+// event, which do not depend on the number of sub-events.
+
+#include "FWCore/Framework/interface/one/EDAnalyzer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "DataFormats/Common/interface/Handle.h"
+
+#include "SimDataFormats/Track/interface/SimTrackContainer.h"
+#include "SimDataFormats/Vertex/interface/SimVertexContainer.h"
+#include "SimDataFormats/TrackingHit/interface/PSimHitContainer.h"
+#include "SimDataFormats/CaloHit/interface/PCaloHitContainer.h"
+
+#include <algorithm>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <vector>
+
+class SimSubEventChecker : public edm::one::EDAnalyzer<> {
+public:
+  explicit SimSubEventChecker(const edm::ParameterSet&);
+  ~SimSubEventChecker() override {}
+
+  void analyze(const edm::Event&, const edm::EventSetup&) override;
+
+private:
+  edm::EDGetTokenT<edm::SimTrackContainer> tkToken_;
+  edm::EDGetTokenT<edm::SimVertexContainer> vtxToken_;
+};
+
+SimSubEventChecker::SimSubEventChecker(const edm::ParameterSet& iConfig) :
+  tkToken_(consumes<edm::SimTrackContainer>(iConfig.getParameter<edm::InputTag>("moduleLabelTk"))),
+  vtxToken_(consumes<edm::SimVertexContainer>(iConfig.getParameter<edm::InputTag>("moduleLabelVtx")))
+{
+  consumesMany<edm::PSimHitContainer>();
+  consumesMany<edm::PCaloHitContainer>();
+}
+
+void SimSubEventChecker::analyze(const edm::Event& iEvent, const edm::EventSetup&)
+{
+  edm::Handle<edm::SimTrackContainer> tracks;
+  edm::Handle<edm::SimVertexContainer> vertices;
+  iEvent.getByToken(tkToken_, tracks);
+  iEvent.getByToken(vtxToken_, vertices);
+
+  std::ostringstream errors;
+  std::set<unsigned int> trackIds;
+  std::vector<int> primaries;
+  for (auto const& trk : *tracks) {
+    if (!trackIds.insert(trk.trackId()).second) {
+      errors << "\n track ID " << trk.trackId() << " is used twice";
+    }
+    if (!trk.noVertex() && (trk.vertIndex() < 0 || trk.vertIndex() >= int(vertices->size()))) {
+      errors << "\n track " << trk.trackId() << " has no vertex " << trk.vertIndex();
+    }
+    if (trk.genpartIndex() >= 0) primaries.push_back(trk.genpartIndex());
+  }
+  std::sort(primaries.begin(), primaries.end());
+  if (std::adjacent_find(primaries.begin(), primaries.end()) != primaries.end()) {
+    errors << "\n a generator particle is simulated twice";
+  }
+
+  unsigned int nPrimaryVertices = 0;
+  for (auto const& vtx : *vertices) {
+    if (vtx.noParent()) { ++nPrimaryVertices; }
+    else if (trackIds.count(vtx.parentIndex()) == 0) {
+      errors << "\n vertex " << vtx.vertexId() << " has no parent track " << vtx.parentIndex();
+    }
+  }
+
+  unsigned int nTkHits = 0, nCaloHits = 0;
+  std::vector<edm::Handle<edm::PSimHitContainer> > tkHits;
+  iEvent.getManyByType(tkHits);
+  for (auto const& hits : tkHits) {
+    for (auto const& hit : *hits) {
+      ++nTkHits;
+      if (trackIds.count(hit.trackId()) == 0) {
+        errors << "\n " << hits.provenance()->productInstanceName() << " hit has no track " << hit.trackId();
+      }
+    }
+  }
+  std::vector<edm::Handle<edm::PCaloHitContainer> > caloHits;
+  iEvent.getManyByType(caloHits);
+  for (auto const& hits : caloHits) {
+    for (auto const& hit : *hits) {
+      ++nCaloHits;
+      if (trackIds.count(hit.geantTrackId()) == 0) {
+        errors << "\n " << hits.provenance()->productInstanceName() << " hit has no track " << hit.geantTrackId();
+      }
+    }
+  }
+
+  if (!errors.str().empty()) {
+    throw cms::Exception("SimSubEventChecker") << "Event " << iEvent.id() << " is inconsistent:" << errors.str();
+  }
+
+  std::cout << "SimSubEventChecker: event " << iEvent.id().event() << " primary vertices " << nPrimaryVertices
+            << " primaries";
+  for (int p : primaries) std::cout << " " << p;
+  std::cout << std::endl;
+  std::cout << "SimSubEventChecker: event " << iEvent.id().event() << " " << tracks->size() << " tracks "
+            << vertices->size() << " vertices " << nTkHits << " tracker hits " << nCaloHits << " calo hits"
+            << std::endl;
+}
+
+DEFINE_FWK_MODULE(SimSubEventChecker);
@@ -0,0 +1,74 @@
+# Simulates a few particle-gun events with the primaries split among
+# NumberOfSubEvents concurrent sub-events, and checks that the merged
+# SimTrack/SimVertex/PSimHit/PCaloHit collections are consistent.
+#   cmsRun simSubEvents_cfg.py subEvents=3
+import FWCore.ParameterSet.Config as cms
+from FWCore.ParameterSet.VarParsing import VarParsing
+
+options = VarParsing()
+options.register('subEvents', 1, VarParsing.multiplicity.singleton, VarParsing.varType.int,
+                 "NumberOfSubEvents of g4SimHits")
+options.register('threads', 4, VarParsing.multiplicity.singleton, VarParsing.varType.int,
+                 "number of threads")
+options.parseArguments()
+
+process = cms.Process("SIM")
+process.load("FWCore.MessageService.MessageLogger_cfi")
+process.load("SimGeneral.HepPDTESSource.pythiapdt_cfi")
+process.load("IOMC.EventVertexGenerators.VtxSmearedGauss_cfi")
+process.load("Configuration.Geometry.GeometryExtended2017_cff")
+process.load("Configuration.StandardSequences.MagneticField_cff")
+process.load('Configuration.StandardSequences.Generator_cff')
+process.load('Configuration.StandardSequences.SimIdeal_cff')
+process.load("Configuration.StandardSequences.FrontierConditions_GlobalTag_cff")
+from Configuration.AlCa.autoCond import autoCond
+process.GlobalTag.globaltag = autoCond['phase1_2017_realistic']
+
+process.load("IOMC.RandomEngine.IOMC_cff")
+process.RandomNumberGeneratorService.generator.initialSeed = 456789
+process.RandomNumberGeneratorService.g4SimHits.initialSeed = 9876
+process.RandomNumberGeneratorService.VtxSmeared.initialSeed = 123456789
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(5)
+)
+process.options = cms.untracked.PSet(
+    numberOfThreads = cms.untracked.uint32(options.threads),
+    numberOfStreams = cms.untracked.uint32(1)
+)
+
+process.source = cms.Source("EmptySource",
+    firstRun        = cms.untracked.uint32(1),
+    firstEvent      = cms.untracked.uint32(1)
+)
+
+# several primaries per event, to be shared among the sub-events
+process.generator = cms.EDProducer("FlatRandomEGunProducer",
+    PGunParameters = cms.PSet(
+        PartID = cms.vint32(211, -211, 11, -13, 22, 2212),
+        MinEta = cms.double(-2.5),
+        MaxEta = cms.double(2.5),
+        MinPhi = cms.double(-3.14159265359),
+        MaxPhi = cms.double(3.14159265359),
+        MinE   = cms.double(10.0),
+        MaxE   = cms.double(50.0)
+    ),
+    Verbosity       = cms.untracked.int32(0),
+    AddAntiParticle = cms.bool(False)
+)
+
+process.g4SimHits.NumberOfSubEvents = options.subEvents
+
+process.checker = cms.EDAnalyzer("SimSubEventChecker",
+    moduleLabelTk = cms.InputTag('g4SimHits'),
+    moduleLabelVtx = cms.InputTag('g4SimHits')
+)
+
+process.generation_step = cms.Path(process.pgen)
+process.simulation_step = cms.Path(process.psim)
+process.analysis_step   = cms.Path(process.checker)
+
+process.schedule = cms.Schedule(process.generation_step,
+                                process.simulation_step,
+                                process.analysis_step,
+                                )
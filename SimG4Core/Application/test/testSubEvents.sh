@@ -0,0 +1,18 @@
+#!/bin/bash
+
+# The same events simulated in one and in three sub-events: the merged
+# collections are checked by SimSubEventChecker, and the primaries and
+# primary vertices must be the same.
+
+function die { echo Failure $1: status $2 ; exit $2 ; }
+
+cd ${LOCAL_TMP_DIR}
+
+for n in 1 3; do
+  cmsRun ${LOCAL_TEST_DIR}/simSubEvents_cfg.py subEvents=$n > subEvents_$n.log 2>&1 || { tail -50 subEvents_$n.log; die "cmsRun simSubEvents_cfg.py subEvents=$n" $?; }
+  grep "SimSubEventChecker: event" subEvents_$n.log
+  grep "SimSubEventChecker: event .* primaries" subEvents_$n.log > primaries_$n.txt
+  [ $(wc -l < primaries_$n.txt) -eq 5 ] || die "checked events with subEvents=$n" 1
+done
+
+diff primaries_1.txt primaries_3.txt || die "primaries differ between 1 and 3 sub-events" $?
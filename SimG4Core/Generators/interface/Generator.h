@@ -25,6 +25,10 @@ public:
   void setGenEvent( const HepMC::GenEvent* inpevt ) 
     { evt_ = (HepMC::GenEvent*)inpevt; return ; }
   void HepMC2G4(const HepMC::GenEvent * g,G4Event * e);
+  // only the primaries of sub-event subEvent out of nSubEvents, which share 
+  // the primary energy of the GenEvent about evenly
+  void HepMC2G4(const HepMC::GenEvent * g,G4Event * e,
+		unsigned int subEvent, unsigned int nSubEvents);
   void nonBeamEvent2G4(const HepMC::GenEvent * g,G4Event * e);
   virtual const HepMC::GenEvent*  genEvent() const { return evt_; }
   virtual const math::XYZTLorentzVector* genVertex() const { return vtx_; }
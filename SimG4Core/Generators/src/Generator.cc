@@ -17,6 +17,7 @@
 #include "G4PhysicalConstants.hh"
 #include "G4Log.hh"
 
+#include <algorithm>
 #include <sstream>
 
 using namespace edm;
@@ -103,6 +104,16 @@ Generator::~Generator()
 
 void Generator::HepMC2G4(const HepMC::GenEvent * evt_orig, G4Event * g4evt)
 {
+  HepMC2G4(evt_orig, g4evt, 0, 1);
+}
+
+void Generator::HepMC2G4(const HepMC::GenEvent * evt_orig, G4Event * g4evt,
+			 unsigned int subEvent, unsigned int nSubEvents)
+{
+  // each accepted primary goes to the sub-event with the least energy so far;
+  // the assignment only depends on the GenEvent, so that every sub-event 
+  // finds the same one
+  std::vector<double> subEventEnergy(nSubEvents, 0.0);
 
   HepMC::GenEvent *evt=new HepMC::GenEvent(*evt_orig);
 
@@ -399,6 +410,15 @@ void Generator::HepMC2G4(const HepMC::GenEvent * evt_orig, G4Event * g4evt)
           g4prim->SetCharge(charge);  
         }
 
+	if (nSubEvents > 1) {
+	  auto lightest = std::min_element(subEventEnergy.begin(), subEventEnergy.end());
+	  *lightest += (*pitr)->momentum().e();
+	  if (lightest - subEventEnergy.begin() != int(subEvent)) {
+	    delete g4prim;
+	    continue;
+	  }
+	}
+
 	// V.I. do not use SetWeight but the same code
         // value of the code compute inside TrackWithHistory        
         //g4prim->SetWeight( 10000*(*vpitr)->barcode() ) ;
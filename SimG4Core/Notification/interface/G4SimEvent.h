@@ -33,6 +33,9 @@ public:
     const std::vector<float> & param() const { return param_; }
     void add(G4SimTrack * t) { g4tracks.push_back(t); }
     void add(G4SimVertex * v) { g4vertices.push_back(v); }
+    // copy in the tracks and vertices of a sub-event of this event, with the
+    // track IDs shifted by trackIdOffset; the primary vertices are shared
+    void merge(const G4SimEvent & sub, int trackIdOffset);
     const G4SimTrack & g4track(int i) const { return *g4tracks[i-1]; }
     const G4SimVertex & g4vertex(int i) const { return *g4vertices[i-1]; }
 protected:
@@ -93,3 +93,47 @@ void G4SimEvent::load(edm::SimVertexContainer & c) const
     }
 }
 
+
+void G4SimEvent::merge(const G4SimEvent & sub, int trackIdOffset)
+{
+    // vertex indices of the sub-event in this event
+    std::vector<int> index(sub.g4vertices.size());
+    for (unsigned int i=0; i<sub.g4vertices.size(); i++)
+    {
+	const G4SimVertex * vtx = sub.g4vertices[i];
+	int parent = vtx->parentIndex();
+	index[i] = -1;
+	if (parent < 0)
+	{
+	    // same tolerance as SimTrackManager to identify vertices
+	    for (unsigned int j=0; j<g4vertices.size(); j++)
+	    {
+		if (g4vertices[j]->parentIndex() < 0 &&
+		    (g4vertices[j]->vertexPosition()-vtx->vertexPosition()).Mag2() < 0.001*0.001)
+		{
+		    index[i] = j;
+		    break;
+		}
+	    }
+	}
+	else if (parent > 0)
+	{
+	    parent += trackIdOffset;
+	}
+	if (index[i] < 0)
+	{
+	    index[i] = g4vertices.size();
+	    g4vertices.push_back(new G4SimVertex(vtx->vertexPosition(),vtx->vertexGlobalTime(),
+						 parent,vtx->processType()));
+	}
+    }
+
+    for (unsigned int i=0; i<sub.g4tracks.size(); i++)
+    {
+	const G4SimTrack * trk = sub.g4tracks[i];
+	int iv = trk->ivert() < 0 ? trk->ivert() : index[trk->ivert()];
+	g4tracks.push_back(new G4SimTrack(trk->id()+trackIdOffset,trk->part(),trk->momentum(),
+					  trk->energy(),iv,trk->igenpart(),trk->parentMomentum(),
+					  trk->trackerSurfacePosition(),trk->trackerSurfaceMomentum()));
+    }
+}
@@ -0,0 +1,61 @@
+##############################################################################
+# Mixing throughput with and without the in-memory pileup event pool.
+#   cmsRun benchmarkPileUpPool_cfg.py inputFiles=file:signal.root pileupFiles=file:minbias.root threads=8
+#   cmsRun benchmarkPileUpPool_cfg.py inputFiles=file:signal.root pileupFiles=file:minbias.root threads=8 poolEvents=20000
+# poolEvents=0 reads the pileup from the files, as in production.
+# With a pool, the first events wait for it to be loaded (poolWait=1, the
+# default of the mixing module); poolWait=0 mixes from the files meanwhile.
+# Compare the per-module time of "mix" in the FastTimerService summary.
+
+import FWCore.ParameterSet.Config as cms
+from FWCore.ParameterSet.VarParsing import VarParsing
+
+options = VarParsing('analysis')
+options.register('pileupFiles', '', VarParsing.multiplicity.list, VarParsing.varType.string,
+                 "minimum bias files")
+options.register('pileup', 35., VarParsing.multiplicity.singleton, VarParsing.varType.float,
+                 "average number of pileup interactions")
+options.register('threads', 1, VarParsing.multiplicity.singleton, VarParsing.varType.int,
+                 "number of threads")
+options.register('poolEvents', 0, VarParsing.multiplicity.singleton, VarParsing.varType.int,
+                 "maximum number of events in the pileup pool (0: no pool)")
+options.register('poolMemoryMB', 2048, VarParsing.multiplicity.singleton, VarParsing.varType.int,
+                 "memory budget of the pileup pool")
+options.register('poolLoaders', 4, VarParsing.multiplicity.singleton, VarParsing.varType.int,
+                 "number of loaders of the pileup pool")
+options.register('poolWait', 1, VarParsing.multiplicity.singleton, VarParsing.varType.int,
+                 "wait for the pileup pool to be loaded before mixing")
+options.parseArguments()
+
+process = cms.Process("MixingBenchmark")
+
+process.load("FWCore.MessageService.MessageLogger_cfi")
+process.MessageLogger.cerr.FwkReport.reportEvery = 100
+process.MessageLogger.categories.append("PileUpEventPool")
+process.load("Configuration.StandardSequences.Services_cff")
+
+# mixing only: the crossing frames, without digitizers
+process.load("SimGeneral.MixingModule.mix_POISSON_average_cfi")
+process.mix.digitizers = cms.PSet()
+process.mix.input.nbPileupEvents.averageNumber = options.pileup
+process.mix.input.fileNames = cms.untracked.vstring(options.pileupFiles)
+process.mix.input.eventPoolMaxEvents = cms.untracked.uint32(options.poolEvents)
+process.mix.input.eventPoolMaxMemoryMB = cms.untracked.uint32(options.poolMemoryMB)
+process.mix.input.eventPoolLoaders = cms.untracked.uint32(options.poolLoaders)
+process.mix.input.eventPoolWait = cms.untracked.bool(bool(options.poolWait))
+
+process.source = cms.Source("PoolSource",
+    fileNames = cms.untracked.vstring(options.inputFiles)
+)
+process.maxEvents = cms.untracked.PSet(input = cms.untracked.int32(options.maxEvents))
+process.options = cms.untracked.PSet(
+    numberOfThreads = cms.untracked.uint32(options.threads),
+    numberOfStreams = cms.untracked.uint32(0)
+)
+
+process.load("HLTrigger.Timer.FastTimerService_cfi")
+process.FastTimerService.enableDQM = False
+process.FastTimerService.printRunSummary = False
+process.FastTimerService.printJobSummary = True
+
+process.p = cms.Path(process.mix)
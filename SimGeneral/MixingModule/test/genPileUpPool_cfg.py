@@ -0,0 +1,23 @@
+# Minimum bias stand-in for testPileUpPool.sh: events without products, with
+# event numbers that tell the file they come from (run = firstRun).
+import FWCore.ParameterSet.Config as cms
+from FWCore.ParameterSet.VarParsing import VarParsing
+
+options = VarParsing()
+options.register('firstRun', 1, VarParsing.multiplicity.singleton, VarParsing.varType.int,
+                 "run number of the events")
+options.register('outputFile', 'pileupPool1.root', VarParsing.multiplicity.singleton, VarParsing.varType.string,
+                 "output file")
+options.parseArguments()
+
+process = cms.Process("GEN")
+
+process.source = cms.Source("EmptySource",
+    firstRun = cms.untracked.uint32(options.firstRun)
+)
+process.maxEvents = cms.untracked.PSet(input = cms.untracked.int32(300))
+
+process.out = cms.OutputModule("PoolOutputModule",
+    fileName = cms.untracked.string(options.outputFile)
+)
+process.e = cms.EndPath(process.out)
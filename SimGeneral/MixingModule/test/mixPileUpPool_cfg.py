@@ -0,0 +1,50 @@
+# Mixing from the in-memory pileup event pool for testPileUpPool.sh: two loaders
+# fill a pool of 40 events out of the 600 of the two input files, and every event
+# mixes about 90 pileup events, so that each job uses the whole pool.
+import FWCore.ParameterSet.Config as cms
+from FWCore.ParameterSet.VarParsing import VarParsing
+
+options = VarParsing()
+options.register('seed', 1234, VarParsing.multiplicity.singleton, VarParsing.varType.int,
+                 "seed of the mixing module")
+options.register('outputFile', 'mixPileUpPool.root', VarParsing.multiplicity.singleton, VarParsing.varType.string,
+                 "output file")
+options.parseArguments()
+
+process = cms.Process("MIX")
+
+process.source = cms.Source("EmptySource")
+process.maxEvents = cms.untracked.PSet(input = cms.untracked.int32(20))
+
+process.RandomNumberGeneratorService = cms.Service("RandomNumberGeneratorService",
+    mix = cms.PSet(initialSeed = cms.untracked.uint32(options.seed))
+)
+
+process.mix = cms.EDProducer("MixingModule",
+    digitizers = cms.PSet(),
+    mixObjects = cms.PSet(),
+    LabelPlayback = cms.string(''),
+    maxBunch = cms.int32(3),
+    minBunch = cms.int32(-5),
+    bunchspace = cms.int32(25),
+    mixProdStep1 = cms.bool(False),
+    mixProdStep2 = cms.bool(False),
+    playback = cms.untracked.bool(False),
+    useCurrentProcessOnly = cms.bool(False),
+    input = cms.SecSource("EmbeddedRootSource",
+        nbPileupEvents = cms.PSet(
+            averageNumber = cms.double(10.0)
+        ),
+        type = cms.string('poisson'),
+        sequential = cms.untracked.bool(False),
+        fileNames = cms.untracked.vstring('file:pileupPool1.root', 'file:pileupPool2.root'),
+        eventPoolMaxEvents = cms.untracked.uint32(40),
+        eventPoolLoaders = cms.untracked.uint32(2)
+    )
+)
+
+process.out = cms.OutputModule("PoolOutputModule",
+    fileName = cms.untracked.string(options.outputFile)
+)
+process.p = cms.Path(process.mix)
+process.e = cms.EndPath(process.out)
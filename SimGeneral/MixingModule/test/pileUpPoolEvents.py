@@ -0,0 +1,12 @@
+#!/usr/bin/env python
+# Print the pileup events mixed by each event of a mixPileUpPool_cfg.py output,
+# as "run:event" from the CrossingFramePlaybackInfoNew of the mixing module.
+from __future__ import print_function
+import sys
+from DataFormats.FWLite import Events, Handle
+
+handle = Handle("CrossingFramePlaybackInfoNew")
+for event in Events(sys.argv[1]):
+    event.getByLabel("mix", handle)
+    ids = [info.eventID() for info in handle.product().eventInfo_]
+    print(" ".join("%d:%d" % (i.run(), i.event()) for i in ids))
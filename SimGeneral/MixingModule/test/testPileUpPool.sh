@@ -0,0 +1,33 @@
+#!/bin/bash
+
+# Pileup event pool: jobs with different seeds of the mixing module fill their
+# pool with different events, a rerun with the same seed mixes the same events.
+
+function die { echo Failure $1: status $2 ; exit $2 ; }
+
+pushd ${LOCAL_TMP_DIR}
+
+  cmsRun ${LOCAL_TEST_DIR}/genPileUpPool_cfg.py firstRun=1 outputFile=pileupPool1.root || die "cmsRun genPileUpPool_cfg.py firstRun=1" $?
+  cmsRun ${LOCAL_TEST_DIR}/genPileUpPool_cfg.py firstRun=2 outputFile=pileupPool2.root || die "cmsRun genPileUpPool_cfg.py firstRun=2" $?
+
+  for job in "1234 a" "1234 b" "4321 c"; do
+    set -- $job
+    cmsRun ${LOCAL_TEST_DIR}/mixPileUpPool_cfg.py seed=$1 outputFile=mixPileUpPool_$2.root || die "cmsRun mixPileUpPool_cfg.py seed=$1" $?
+    python ${LOCAL_TEST_DIR}/pileUpPoolEvents.py mixPileUpPool_$2.root > pileUpPoolEvents_$2.txt || die "pileUpPoolEvents.py mixPileUpPool_$2.root" $?
+    tr ' ' '\n' < pileUpPoolEvents_$2.txt | grep -v '^$' | sort -u > pileUpPool_$2.txt
+  done
+
+  # every job mixes from a pool of at most 40 events, taken from both files
+  for pool in a c; do
+    [ -s pileUpPool_$pool.txt ] || die "no pileup event mixed in job $pool" 1
+    [ $(wc -l < pileUpPool_$pool.txt) -le 40 ] || die "more than 40 distinct pileup events in job $pool" 1
+    grep -q '^1:' pileUpPool_$pool.txt || die "no pileup event from the first file in job $pool" 1
+    grep -q '^2:' pileUpPool_$pool.txt || die "no pileup event from the second file in job $pool" 1
+  done
+
+  diff pileUpPoolEvents_a.txt pileUpPoolEvents_b.txt || die "same seed, different pileup events" $?
+  cmp -s pileUpPool_a.txt pileUpPool_c.txt && die "different seeds, same pileup pool" 1
+
+popd
+
+exit 0
@@ -68,8 +68,12 @@ class CorrelatedNoisifier
 
       void checkOffDiagonal( const M& symCorMat ) ;
 
+      void fillRows() ;
+
       mutable VecDou m_vecgau ;
 
+      VecDou m_rows ; // m_H(j,i) at [i*kRows+j]: contiguous rows for noisify
+
       bool m_isDiagonal ;
       bool m_isIdentity ;
 
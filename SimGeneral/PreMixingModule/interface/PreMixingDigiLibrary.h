@@ -0,0 +1,132 @@
+#ifndef SimGeneral_PreMixingModule_PreMixingDigiLibrary_h
+#define SimGeneral_PreMixingModule_PreMixingDigiLibrary_h
+
+/** \class PreMixingDigiLibrary
+ *
+ * Flat binary library of premixed pileup digis, read by the PreMixing workers
+ * instead of the EDM products of the premixed pileup events.
+ *
+ * The file holds a header with the collection labels, the event records in
+ * the order they were written, an index sorted by EventID, the process
+ * history IDs of the premixed events it was built from and a trailer. An
+ * event record is, for each collection, the number of detectors, the
+ * (detId, number of words) pairs and the packed 32-bit digi words of all the
+ * detectors. The library is mapped read-only and shared by all the workers of
+ * the process; a worker reads the digis of a detector in place. A pileup
+ * event is looked up by its EventID and must come from one of the process
+ * histories of the library, so that a library built from another premixed
+ * dataset is not mixed in silently.
+ *
+ * PreMixingDigiLibraryWriter writes a library as the events come, keeping
+ * one chunk of events in memory, and produces the file at close().
+ */
+
+#include "DataFormats/Provenance/interface/EventID.h"
+#include "DataFormats/Provenance/interface/ProcessHistoryID.h"
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+class PreMixingDigiLibrary {
+public:
+  static constexpr uint32_t formatVersion = 2;
+
+  struct IndexEntry {
+    uint32_t run;
+    uint32_t lumi;
+    uint64_t event;
+    uint64_t offset;  // of the event record, in 32-bit words from the start of the file
+  };
+
+  /// the detectors of one collection of one event
+  class Collection {
+  public:
+    Collection(uint32_t const* dets, uint32_t nDets, uint32_t const* words) : dets_(dets), nDets_(nDets), words_(words) {}
+
+    /// f(detId, words, nWords) for each detector
+    template<typename F>
+    void forEachDetector(F f) const {
+      uint32_t const* words = words_;
+      for (uint32_t i = 0; i < nDets_; ++i) {
+        f(dets_[2*i], words, dets_[2*i+1]);
+        words += dets_[2*i+1];
+      }
+    }
+
+  private:
+    uint32_t const* dets_;
+    uint32_t nDets_;
+    uint32_t const* words_;
+  };
+
+  /// library shared by the whole process
+  static std::shared_ptr<const PreMixingDigiLibrary> get(std::string const& fileName);
+
+  ~PreMixingDigiLibrary();
+
+  PreMixingDigiLibrary(PreMixingDigiLibrary const&) = delete;
+  PreMixingDigiLibrary& operator=(PreMixingDigiLibrary const&) = delete;
+
+  /// index of a collection by label; throws if the library does not have it
+  unsigned int collectionIndex(std::string const& label) const;
+
+  /// the record of an event, nullptr if the library does not have it;
+  /// throws if the event does not come from the input of the library
+  uint32_t const* find(edm::EventID const& id, edm::ProcessHistoryID const& history) const;
+
+  /// collection c of the event record
+  Collection collection(uint32_t const* record, unsigned int c) const;
+
+  size_t size() const { return nEvents_; }
+
+  /// process history IDs of the premixed events the library was built from
+  std::vector<edm::ProcessHistoryID> const& inputs() const { return inputs_; }
+
+private:
+  explicit PreMixingDigiLibrary(std::string const& fileName);
+
+  std::string fileName_;
+  void* base_ = nullptr;
+  size_t size_ = 0;
+  std::vector<std::string> labels_;
+  IndexEntry const* index_ = nullptr;
+  size_t nEvents_ = 0;
+  std::vector<edm::ProcessHistoryID> inputs_;
+};
+
+class PreMixingDigiLibraryWriter {
+public:
+  PreMixingDigiLibraryWriter(std::string const& fileName, std::vector<std::string> const& labels, unsigned int eventsPerChunk);
+  ~PreMixingDigiLibraryWriter();
+
+  /// history is the process history of the premixed event, without the current process
+  void beginEvent(edm::EventID const& id, edm::ProcessHistoryID const& history);
+  /// add a detector to collection c of the current event
+  void addDetector(unsigned int c, uint32_t detId, std::vector<uint32_t> const& words);
+  void endEvent();
+
+  /// write the last chunk and the index, and move the file in place
+  void close();
+
+private:
+  void flush();
+
+  std::string fileName_;
+  std::string tmpName_;
+  std::ofstream out_;
+  unsigned int eventsPerChunk_;
+  uint64_t written_;  // words
+  std::vector<uint32_t> chunk_;
+  unsigned int eventsInChunk_;
+  std::vector<PreMixingDigiLibrary::IndexEntry> index_;
+  std::vector<edm::ProcessHistoryID> inputs_;
+  edm::EventID current_;
+  std::vector<std::vector<uint32_t> > dets_;
+  std::vector<std::vector<uint32_t> > words_;
+  bool closed_;
+};
+
+#endif
@@ -0,0 +1,109 @@
+// Writes the tracker digis of premixed pileup events to a PreMixingDigiLibrary,
+// to be run after the premixing (stage 1) digitization.
+
+#include "FWCore/Framework/interface/one/EDAnalyzer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "DataFormats/Common/interface/DetSetVector.h"
+#include "DataFormats/Common/interface/Handle.h"
+#include "DataFormats/SiPixelDigi/interface/PixelDigi.h"
+#include "DataFormats/SiStripDigi/interface/SiStripDigi.h"
+#include "DataFormats/Provenance/interface/ProcessHistory.h"
+
+#include "SimGeneral/PreMixingModule/interface/PreMixingDigiLibrary.h"
+
+#include <memory>
+
+class PreMixingDigiLibraryBuilder : public edm::one::EDAnalyzer<> {
+public:
+  explicit PreMixingDigiLibraryBuilder(edm::ParameterSet const& ps);
+  ~PreMixingDigiLibraryBuilder() override = default;
+
+  static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
+
+private:
+  void analyze(edm::Event const& e, edm::EventSetup const& es) override;
+  void endJob() override;
+
+  std::vector<edm::EDGetTokenT<edm::DetSetVector<PixelDigi> > > pixelTokens_;
+  std::vector<edm::EDGetTokenT<edm::DetSetVector<SiStripDigi> > > stripTokens_;
+  std::unique_ptr<PreMixingDigiLibraryWriter> writer_;
+  std::vector<uint32_t> words_;
+  unsigned int nEvents_;
+};
+
+PreMixingDigiLibraryBuilder::PreMixingDigiLibraryBuilder(edm::ParameterSet const& ps) : nEvents_(0) {
+  // the collections are named after the InputTags of the pileup digis, as the workers look them up
+  std::vector<std::string> labels;
+  for (auto const& tag : ps.getParameter<std::vector<edm::InputTag> >("pixelDigis")) {
+    pixelTokens_.push_back(consumes<edm::DetSetVector<PixelDigi> >(tag));
+    labels.push_back(tag.encode());
+  }
+  for (auto const& tag : ps.getParameter<std::vector<edm::InputTag> >("stripDigis")) {
+    stripTokens_.push_back(consumes<edm::DetSetVector<SiStripDigi> >(tag));
+    labels.push_back(tag.encode());
+  }
+  writer_ = std::make_unique<PreMixingDigiLibraryWriter>(ps.getParameter<std::string>("fileName"), labels,
+                                                         ps.getUntrackedParameter<unsigned int>("eventsPerChunk"));
+}
+
+void PreMixingDigiLibraryBuilder::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+  edm::ParameterSetDescription desc;
+  desc.add<std::string>("fileName", "premixDigiLibrary.bin");
+  desc.add<std::vector<edm::InputTag> >("pixelDigis", {edm::InputTag("simSiPixelDigis")});
+  desc.add<std::vector<edm::InputTag> >("stripDigis", {edm::InputTag("simSiStripDigis", "ZeroSuppressed")});
+  desc.addUntracked<unsigned int>("eventsPerChunk", 64U);
+  descriptions.add("premixDigiLibraryBuilder", desc);
+}
+
+void PreMixingDigiLibraryBuilder::analyze(edm::Event const& e, edm::EventSetup const& es) {
+  // the history of the premixed event as the PreMixingModule sees it, without this process
+  edm::ProcessHistory const& history = e.processHistory();
+  if (!history.empty() && history.rbegin()->processName() == moduleDescription().processName()) {
+    writer_->beginEvent(e.id(), edm::ProcessHistory(edm::ProcessHistory::collection_type(history.begin(), history.end() - 1)).id());
+  } else {
+    writer_->beginEvent(e.id(), history.id());
+  }
+  unsigned int c = 0;
+
+  // PixelDigi as its packed word
+  for (auto const& token : pixelTokens_) {
+    edm::Handle<edm::DetSetVector<PixelDigi> > digis;
+    if (e.getByToken(token, digis)) {
+      for (auto const& detSet : *digis) {
+        words_.clear();
+        for (auto const& digi : detSet) words_.push_back(digi.packedData());
+        writer_->addDetector(c, detSet.detId(), words_);
+      }
+    }
+    ++c;
+  }
+
+  // SiStripDigi as (strip << 16) | adc
+  for (auto const& token : stripTokens_) {
+    edm::Handle<edm::DetSetVector<SiStripDigi> > digis;
+    if (e.getByToken(token, digis)) {
+      for (auto const& detSet : *digis) {
+        words_.clear();
+        for (auto const& digi : detSet) words_.push_back((uint32_t(digi.strip()) << 16) | digi.adc());
+        writer_->addDetector(c, detSet.detId(), words_);
+      }
+    }
+    ++c;
+  }
+
+  writer_->endEvent();
+  ++nEvents_;
+}
+
+void PreMixingDigiLibraryBuilder::endJob() {
+  writer_->close();
+  edm::LogInfo("PreMixingDigiLibraryBuilder") << "Wrote " << nEvents_ << " premixed events to the digi library";
+}
+
+DEFINE_FWK_MODULE(PreMixingDigiLibraryBuilder);
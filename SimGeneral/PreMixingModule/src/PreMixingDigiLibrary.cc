@@ -0,0 +1,261 @@
+#include "SimGeneral/PreMixingModule/interface/PreMixingDigiLibrary.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+  constexpr char magic[8] = {'C','M','S','P','M','L','I','B'};
+
+  struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t nCollections;
+    uint32_t labelsSize;  // bytes, padded to 8
+    uint32_t padding;
+  };
+
+  struct Trailer {
+    uint64_t indexOffset;  // words
+    uint64_t nEvents;
+    uint32_t nInputs;      // compact process history IDs after the index
+    uint32_t padding;
+    char magic[8];
+  };
+  constexpr size_t inputSize = 16;
+  static_assert(sizeof(Header)==24, "PreMixingDigiLibrary header layout changed: bump formatVersion");
+  static_assert(sizeof(Trailer)==32, "PreMixingDigiLibrary trailer layout changed: bump formatVersion");
+  static_assert(sizeof(PreMixingDigiLibrary::IndexEntry)==24, "PreMixingDigiLibrary index layout changed: bump formatVersion");
+
+  bool indexLess(PreMixingDigiLibrary::IndexEntry const& a, PreMixingDigiLibrary::IndexEntry const& b) {
+    return std::tie(a.run, a.lumi, a.event) < std::tie(b.run, b.lumi, b.event);
+  }
+
+  std::mutex librariesMutex;
+  std::map<std::string, std::weak_ptr<const PreMixingDigiLibrary> > libraries;
+
+}
+
+std::shared_ptr<const PreMixingDigiLibrary>
+PreMixingDigiLibrary::get(std::string const& fileName) {
+  std::lock_guard<std::mutex> guard(librariesMutex);
+  auto& slot = libraries[fileName];
+  if (auto library = slot.lock()) return library;
+  std::shared_ptr<const PreMixingDigiLibrary> library(new PreMixingDigiLibrary(fileName));
+  slot = library;
+  return library;
+}
+
+PreMixingDigiLibrary::PreMixingDigiLibrary(std::string const& fileName) : fileName_(fileName) {
+  int fd = ::open(fileName.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw cms::Exception("PreMixingDigiLibrary") << "Cannot open the premixed digi library " << fileName;
+  }
+  struct stat st;
+  if (::fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(Header) + sizeof(Trailer)) {
+    ::close(fd);
+    throw cms::Exception("PreMixingDigiLibrary") << fileName << " is not a premixed digi library";
+  }
+  size_ = st.st_size;
+  base_ = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (base_ == MAP_FAILED) {
+    base_ = nullptr;
+    throw cms::Exception("PreMixingDigiLibrary") << "Cannot map the premixed digi library " << fileName;
+  }
+  // the pileup events are picked at random: no read-ahead beyond the record
+  ::madvise(base_, size_, MADV_RANDOM);
+
+  char const* data = static_cast<char const*>(base_);
+  Header const* header = reinterpret_cast<Header const*>(data);
+  Trailer const* trailer = reinterpret_cast<Trailer const*>(data + size_ - sizeof(Trailer));
+  bool ok = std::memcmp(header->magic, magic, sizeof(magic)) == 0 &&
+            std::memcmp(trailer->magic, magic, sizeof(magic)) == 0 &&
+            header->version == formatVersion &&
+            sizeof(Header) + header->labelsSize <= size_ &&
+            trailer->indexOffset*sizeof(uint32_t) + trailer->nEvents*sizeof(IndexEntry) +
+              trailer->nInputs*inputSize + sizeof(Trailer) == size_;
+  if (!ok) {
+    ::munmap(base_, size_);
+    base_ = nullptr;
+    throw cms::Exception("PreMixingDigiLibrary") << fileName << " is not a premixed digi library of format version " << formatVersion;
+  }
+
+  char const* label = data + sizeof(Header);
+  for (uint32_t c = 0; c < header->nCollections; ++c) {
+    labels_.emplace_back(label);
+    label += labels_.back().size() + 1;
+  }
+  index_ = reinterpret_cast<IndexEntry const*>(data + trailer->indexOffset*sizeof(uint32_t));
+  nEvents_ = trailer->nEvents;
+  char const* input = reinterpret_cast<char const*>(index_ + nEvents_);
+  for (uint32_t i = 0; i < trailer->nInputs; ++i, input += inputSize) {
+    inputs_.emplace_back(std::string(input, inputSize));
+  }
+}
+
+PreMixingDigiLibrary::~PreMixingDigiLibrary() {
+  if (base_) ::munmap(base_, size_);
+}
+
+unsigned int
+PreMixingDigiLibrary::collectionIndex(std::string const& label) const {
+  auto it = std::find(labels_.begin(), labels_.end(), label);
+  if (it == labels_.end()) {
+    throw cms::Exception("PreMixingDigiLibrary") << "The premixed digi library " << fileName_ << " has no collection " << label;
+  }
+  return it - labels_.begin();
+}
+
+uint32_t const*
+PreMixingDigiLibrary::find(edm::EventID const& id, edm::ProcessHistoryID const& history) const {
+  if (std::find(inputs_.begin(), inputs_.end(), history) == inputs_.end()) {
+    throw cms::Exception("PreMixingDigiLibrary") << "The premixed digi library " << fileName_ << " was not built from the pileup input: event "
+                                                 << id << " has process history " << history << ", not one of the " << inputs_.size()
+                                                 << " of the library";
+  }
+  IndexEntry key{id.run(), id.luminosityBlock(), id.event(), 0};
+  IndexEntry const* end = index_ + nEvents_;
+  IndexEntry const* entry = std::lower_bound(index_, end, key, indexLess);
+  if (entry == end || indexLess(key, *entry)) return nullptr;
+  return static_cast<uint32_t const*>(base_) + entry->offset;
+}
+
+PreMixingDigiLibrary::Collection
+PreMixingDigiLibrary::collection(uint32_t const* record, unsigned int c) const {
+  uint32_t const* collection = record + record[c];
+  return Collection(collection + 1, collection[0], collection + 1 + 2*collection[0]);
+}
+
+PreMixingDigiLibraryWriter::PreMixingDigiLibraryWriter(std::string const& fileName, std::vector<std::string> const& labels,
+                                                       unsigned int eventsPerChunk)
+  : fileName_(fileName),
+    tmpName_(fileName + ".tmp" + std::to_string(::getpid())),
+    out_(tmpName_, std::ios::binary | std::ios::trunc),
+    eventsPerChunk_(std::max(1U, eventsPerChunk)),
+    written_(0),
+    eventsInChunk_(0),
+    dets_(labels.size()),
+    words_(labels.size()),
+    closed_(false) {
+  if (!out_) {
+    throw cms::Exception("PreMixingDigiLibrary") << "Cannot write the premixed digi library " << tmpName_;
+  }
+  std::string strings;
+  for (auto const& label : labels) {
+    strings += label;
+    strings += '\0';
+  }
+  strings.resize((strings.size() + 7) & ~size_t(7), '\0');
+
+  Header header;
+  std::memset(&header, 0, sizeof(Header));
+  std::memcpy(header.magic, magic, sizeof(magic));
+  header.version = PreMixingDigiLibrary::formatVersion;
+  header.nCollections = labels.size();
+  header.labelsSize = strings.size();
+  out_.write(reinterpret_cast<char const*>(&header), sizeof(Header));
+  out_.write(strings.data(), strings.size());
+  written_ = (sizeof(Header) + strings.size())/sizeof(uint32_t);
+}
+
+PreMixingDigiLibraryWriter::~PreMixingDigiLibraryWriter() {
+  if (!closed_) {
+    out_.close();
+    std::remove(tmpName_.c_str());
+  }
+}
+
+void
+PreMixingDigiLibraryWriter::beginEvent(edm::EventID const& id, edm::ProcessHistoryID const& history) {
+  current_ = id;
+  if (std::find(inputs_.begin(), inputs_.end(), history) == inputs_.end()) inputs_.push_back(history);
+  for (auto& dets : dets_) dets.clear();
+  for (auto& words : words_) words.clear();
+}
+
+void
+PreMixingDigiLibraryWriter::addDetector(unsigned int c, uint32_t detId, std::vector<uint32_t> const& words) {
+  if (words.empty()) return;
+  dets_[c].push_back(detId);
+  dets_[c].push_back(words.size());
+  words_[c].insert(words_[c].end(), words.begin(), words.end());
+}
+
+void
+PreMixingDigiLibraryWriter::endEvent() {
+  index_.push_back({current_.run(), current_.luminosityBlock(), current_.event(), written_ + chunk_.size()});
+
+  // collection offsets, then for each collection: nDets, (detId, nWords) pairs, words
+  size_t record = chunk_.size();
+  chunk_.resize(record + dets_.size());
+  for (size_t c = 0; c < dets_.size(); ++c) {
+    chunk_[record + c] = chunk_.size() - record;
+    chunk_.push_back(dets_[c].size()/2);
+    chunk_.insert(chunk_.end(), dets_[c].begin(), dets_[c].end());
+    chunk_.insert(chunk_.end(), words_[c].begin(), words_[c].end());
+  }
+
+  if (++eventsInChunk_ == eventsPerChunk_) flush();
+}
+
+void
+PreMixingDigiLibraryWriter::flush() {
+  out_.write(reinterpret_cast<char const*>(chunk_.data()), chunk_.size()*sizeof(uint32_t));
+  written_ += chunk_.size();
+  chunk_.clear();
+  eventsInChunk_ = 0;
+  if (!out_) {
+    throw cms::Exception("PreMixingDigiLibrary") << "Cannot write the premixed digi library " << tmpName_;
+  }
+}
+
+void
+PreMixingDigiLibraryWriter::close() {
+  flush();
+  std::sort(index_.begin(), index_.end(), indexLess);
+  auto duplicate = std::adjacent_find(index_.begin(), index_.end(),
+                                      [](PreMixingDigiLibrary::IndexEntry const& a, PreMixingDigiLibrary::IndexEntry const& b) { return !indexLess(a, b); });
+  if (duplicate != index_.end()) {
+    throw cms::Exception("PreMixingDigiLibrary") << "Event " << duplicate->run << ":" << duplicate->lumi << ":" << duplicate->event
+                                                 << " is written twice to the premixed digi library " << fileName_;
+  }
+
+  // the index is made of 64-bit words
+  if (written_ % 2) {
+    uint32_t const zero = 0;
+    out_.write(reinterpret_cast<char const*>(&zero), sizeof(zero));
+    ++written_;
+  }
+  Trailer trailer;
+  std::memset(&trailer, 0, sizeof(Trailer));
+  trailer.indexOffset = written_;
+  trailer.nEvents = index_.size();
+  trailer.nInputs = inputs_.size();
+  std::memcpy(trailer.magic, magic, sizeof(magic));
+  out_.write(reinterpret_cast<char const*>(index_.data()), index_.size()*sizeof(PreMixingDigiLibrary::IndexEntry));
+  for (auto const& input : inputs_) {
+    out_.write(input.compactForm().data(), inputSize);
+  }
+  out_.write(reinterpret_cast<char const*>(&trailer), sizeof(Trailer));
+  out_.close();
+  if (!out_) {
+    std::remove(tmpName_.c_str());
+    throw cms::Exception("PreMixingDigiLibrary") << "Cannot write the premixed digi library " << tmpName_;
+  }
+  if (std::rename(tmpName_.c_str(), fileName_.c_str()) != 0) {
+    std::remove(tmpName_.c_str());
+    throw cms::Exception("PreMixingDigiLibrary") << "Cannot rename the premixed digi library to " << fileName_;
+  }
+  closed_ = true;
+}
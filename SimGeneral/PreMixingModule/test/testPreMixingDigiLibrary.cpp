@@ -0,0 +1,138 @@
+#include "SimGeneral/PreMixingModule/interface/PreMixingDigiLibrary.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+  // the detectors of one collection of one event, detId -> words
+  typedef std::map<uint32_t, std::vector<uint32_t> > Detectors;
+
+  Detectors makeDetectors(unsigned int event, unsigned int c) {
+    Detectors dets;
+    for (unsigned int d = 0; d < 3 + event % 4; ++d) {
+      uint32_t detId = 0x12000000 + 16*c + 3*d + event % 2;
+      // the second detector of odd events has no digi: it is not written
+      unsigned int nWords = (d == 1 && event % 2) ? 0 : 1 + (event*7 + d) % 5;
+      for (unsigned int w = 0; w < nWords; ++w) dets[detId].push_back((event << 20) | (c << 16) | (d << 8) | w);
+      if (nWords == 0) dets[detId];
+    }
+    return dets;
+  }
+
+  Detectors readDetectors(PreMixingDigiLibrary const& library, uint32_t const* record, unsigned int c) {
+    Detectors dets;
+    library.collection(record, c).forEachDetector([&dets](uint32_t detId, uint32_t const* words, uint32_t n) {
+        dets[detId].assign(words, words + n);
+      });
+    return dets;
+  }
+
+  bool throws(std::function<void()> const& f) {
+    try {
+      f();
+    } catch (cms::Exception const&) {
+      return true;
+    }
+    return false;
+  }
+
+}
+
+int main() {
+  std::string fileName = "testPreMixingDigiLibrary.bin";
+  std::remove(fileName.c_str());
+
+  std::vector<std::string> labels = {"simSiPixelDigis", "simSiStripDigis:ZeroSuppressed"};
+  edm::ProcessHistoryID history1(std::string("0123456789abcdef0123456789abcdef"));
+  edm::ProcessHistoryID history2(std::string("fedcba9876543210fedcba9876543210"));
+  edm::ProcessHistoryID other(std::string("00112233445566778899aabbccddeeff"));
+
+  // events written out of EventID order, over several chunks and two input histories
+  std::vector<edm::EventID> ids;
+  for (unsigned int event : {5, 3, 12, 1, 8, 2, 9}) ids.emplace_back(1, 1 + event % 3, event);
+  ids.emplace_back(2, 1, 3);
+
+  // a writer that is not closed leaves no file
+  {
+    PreMixingDigiLibraryWriter writer(fileName, labels, 2);
+    writer.beginEvent(ids[0], history1);
+    writer.endEvent();
+  }
+  assert(!std::ifstream(fileName));
+
+  {
+    PreMixingDigiLibraryWriter writer(fileName, labels, 3);
+    for (unsigned int i = 0; i < ids.size(); ++i) {
+      writer.beginEvent(ids[i], i < 5 ? history1 : history2);
+      for (unsigned int c = 0; c < labels.size(); ++c) {
+        for (auto const& det : makeDetectors(ids[i].event(), c)) writer.addDetector(c, det.first, det.second);
+      }
+      writer.endEvent();
+    }
+    writer.close();
+  }
+
+  {
+    auto library = PreMixingDigiLibrary::get(fileName);
+    assert(library == PreMixingDigiLibrary::get(fileName));
+    assert(library->size() == ids.size());
+    assert(library->inputs() == (std::vector<edm::ProcessHistoryID>{history1, history2}));
+    assert(library->collectionIndex(labels[0]) == 0);
+    assert(library->collectionIndex(labels[1]) == 1);
+    assert(throws([&]() { library->collectionIndex("simSiStripDigis"); }));
+
+    // every event reads back what was written, whatever its input history
+    for (auto const& id : ids) {
+      uint32_t const* record = library->find(id, history2);
+      assert(record != nullptr);
+      for (unsigned int c = 0; c < labels.size(); ++c) {
+        Detectors written = makeDetectors(id.event(), c);
+        for (auto it = written.begin(); it != written.end();) {
+          if (it->second.empty()) it = written.erase(it);
+          else ++it;
+        }
+        assert(readDetectors(*library, record, c) == written);
+      }
+    }
+
+    // an event of the input not in the library, and an event of another input
+    assert(library->find(edm::EventID(1, 1, 6), history1) == nullptr);
+    assert(throws([&]() { library->find(ids[0], other); }));
+  }
+
+  // an event written twice
+  {
+    PreMixingDigiLibraryWriter writer(fileName + ".dup", labels, 2);
+    for (int k = 0; k < 2; ++k) {
+      writer.beginEvent(ids[0], history1);
+      writer.endEvent();
+    }
+    assert(throws([&]() { writer.close(); }));
+  }
+  assert(!std::ifstream(fileName + ".dup"));
+
+  // a truncated library
+  {
+    std::ifstream in(fileName, std::ios::binary);
+    std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::ofstream out(fileName + ".short", std::ios::binary);
+    out.write(content.data(), content.size() - 8);
+  }
+  assert(throws([&]() { PreMixingDigiLibrary::get(fileName + ".short"); }));
+  assert(throws([&]() { PreMixingDigiLibrary::get(fileName + ".missing"); }));
+
+  std::remove(fileName.c_str());
+  std::remove((fileName + ".short").c_str());
+  std::cout << "PreMixingDigiLibrary round trip OK" << std::endl;
+  return 0;
+}
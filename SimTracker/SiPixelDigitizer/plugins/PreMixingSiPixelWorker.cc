@@ -30,6 +30,7 @@
 
 #include "CLHEP/Random/RandFlat.h"
 
+#include "SimGeneral/PreMixingModule/interface/PreMixingDigiLibrary.h"
 #include "SimGeneral/PreMixingModule/interface/PreMixingWorker.h"
 #include "SimGeneral/PreMixingModule/interface/PreMixingWorkerFactory.h"
 
@@ -58,6 +59,10 @@ private:
 
   edm::ESHandle<TrackerGeometry> pDD;
 
+  // optional library of the premixed pileup digis, read instead of the pileup products
+  std::shared_ptr<const PreMixingDigiLibrary> library_;
+  unsigned int libraryCollection_ = 0;
+
   SiPixelDigitizerAlgorithm digitizer_;
 
   // 
@@ -94,6 +99,12 @@ PreMixingSiPixelWorker::PreMixingSiPixelWorker(const edm::ParameterSet& ps, edm:
 
   producer.produces< edm::DetSetVector<PixelDigi> > (PixelDigiCollectionDM_);
 
+  std::string libraryFile = ps.getUntrackedParameter<std::string>("digiLibrary", "");
+  if(!libraryFile.empty()) {
+    library_ = PreMixingDigiLibrary::get(libraryFile);
+    libraryCollection_ = library_->collectionIndex(pixeldigi_collectionPile_.encode());
+  }
+
   // clear local storage for this event                                                                     
   SiHitStorage_.clear();
 }
@@ -153,6 +164,20 @@ void PreMixingSiPixelWorker::addPileups(PileUpEventPrincipal const& pep, edm::Ev
 
   // fill in maps of hits; same code as addSignals, except now applied to the pileup events
 
+  // the library has the digis as packed words: no product to read
+  if(library_) {
+    if(uint32_t const* record = library_->find(pep.principal().id(), pep.principal().processHistoryID())) {
+      library_->collection(record, libraryCollection_).forEachDetector([this](uint32_t detID, uint32_t const* words, uint32_t n) {
+          OneDetectorMap& LocalMap = SiHitStorage_[detID];
+          for(uint32_t i = 0; i < n; ++i) {
+            PixelDigi digi(words[i]);
+            LocalMap.insert(OneDetectorMap::value_type( (digi.channel()), digi ));
+          }
+        });
+      return;
+    }
+  }
+
   edm::Handle<edm::DetSetVector<PixelDigi>> inputHandle;
   pep.getByLabel(pixeldigi_collectionPile_, inputHandle);
 
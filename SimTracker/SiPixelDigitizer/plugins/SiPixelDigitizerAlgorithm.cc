@@ -40,6 +40,7 @@
 // February, 2011: Time improvement in DriftDirection()  (J. Bashir Butt)
 // June, 2011: Bug Fix for pixels on ROC edges in module_killing_DB() (J. Bashir Butt)
 // February, 2018: Implement cluster charge reweighting (P. Schuetze, with code from A. Hazi)
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
 
@@ -126,6 +127,7 @@ void SiPixelDigitizerAlgorithm::init(const edm::EventSetup& es) {
   //gets the map and geometry from the DB (to kill ROCs)
   es.get<SiPixelFedCablingMapRcd>().get(map_);
   es.get<TrackerDigiGeometryRecord>().get(geom_);
+  edgesTopol_ = nullptr; // the topologies may have changed with the geometry
 
   // Read template files for charge reweighting
   if (UseReweighting){
@@ -536,17 +538,19 @@ void SiPixelDigitizerAlgorithm::PixelEfficiencies::init_from_db(const edm::ESHan
   const std::map<uint32_t, std::vector<double> >& PUFactors = SiPixelDynamicInefficiency->getPUFactors();
   std::vector<uint32_t > DetIdmasks = SiPixelDynamicInefficiency->getDetIdmasks();
   
-  // Loop on all modules, initialize map for easy access
+  // Loop on all modules, index them for dense access
+  std::vector<uint32_t> rawids;
   for( const auto& it_module : geom->detUnits()) {
     if( dynamic_cast<PixelGeomDetUnit const*>(it_module)==nullptr) continue;
-    const DetId detid = it_module->geographicalId();
-    uint32_t rawid = detid.rawId();
-    PixelGeomFactors[rawid] = 1;
-    ColGeomFactors[rawid] = 1;
-    ChipGeomFactors[rawid] = 1;
-    PixelGeomFactorsROCStdPixels[rawid] = std::vector<double>(16,1);
-    PixelGeomFactorsROCBigPixels[rawid] = std::vector<double>(16,1);
+    rawids.push_back(it_module->geographicalId().rawId());
   }
+  moduleIndex.build(rawids);
+  PixelGeomFactors.assign(rawids.size(), 1);
+  ColGeomFactors.assign(rawids.size(), 1);
+  ChipGeomFactors.assign(rawids.size(), 1);
+  PixelGeomFactorsROCStdPixels.assign(rawids.size(), std::vector<double>(16,1));
+  PixelGeomFactorsROCBigPixels.assign(rawids.size(), std::vector<double>(16,1));
+  iPU.assign(rawids.size(), noPU);
   
   // ROC level inefficiency for phase 1 (disentangle scale factors for big and std size pixels)  
   std::map<uint32_t, double>  PixelGeomFactorsDB;
@@ -574,8 +578,8 @@ void SiPixelDigitizerAlgorithm::PixelEfficiencies::init_from_db(const edm::ESHan
 	double badFractionStd = std::max(0., badFraction - badFractionBig);
 	double badFractionBigReNormalized = badFractionBig/bigPixelFraction;
 	double badFractionStdReNormalized = badFractionStd/stdPixelFraction;
-	PixelGeomFactorsROCStdPixels[rawid][rocId] *= (1. - badFractionStdReNormalized);
-	PixelGeomFactorsROCBigPixels[rawid][rocId] *= (1. - badFractionBigReNormalized);     
+	PixelGeomFactorsROCStdPixels[index(rawid)][rocId] *= (1. - badFractionStdReNormalized);
+	PixelGeomFactorsROCBigPixels[index(rawid)][rocId] *= (1. - badFractionBigReNormalized);     
       }
       else{
 	PixelGeomFactorsDB[db_factor.first] = db_factor.second;      
@@ -587,28 +591,25 @@ void SiPixelDigitizerAlgorithm::PixelEfficiencies::init_from_db(const edm::ESHan
   }
   
   // Loop on all modules, store module level geometrical scale factors 
-  for( const auto& it_module : geom->detUnits()) {
-    if( dynamic_cast<PixelGeomDetUnit const*>(it_module)==nullptr) continue;
-    const DetId detid = it_module->geographicalId();
-    uint32_t rawid = detid.rawId();
-    for (auto db_factor : PixelGeomFactorsDB) if (matches(detid, DetId(db_factor.first), DetIdmasks)) PixelGeomFactors[rawid] *= db_factor.second;
-    for (auto db_factor : ColGeomFactorsDB) if (matches(detid, DetId(db_factor.first), DetIdmasks)) ColGeomFactors[rawid] *= db_factor.second;
-    for (auto db_factor : ChipGeomFactorsDB) if (matches(detid, DetId(db_factor.first), DetIdmasks)) ChipGeomFactors[rawid] *= db_factor.second;
+  for (size_t k=0; k<rawids.size(); ++k) {
+    const DetId detid(rawids[k]);
+    for (auto db_factor : PixelGeomFactorsDB) if (matches(detid, DetId(db_factor.first), DetIdmasks)) PixelGeomFactors[k] *= db_factor.second;
+    for (auto db_factor : ColGeomFactorsDB) if (matches(detid, DetId(db_factor.first), DetIdmasks)) ColGeomFactors[k] *= db_factor.second;
+    for (auto db_factor : ChipGeomFactorsDB) if (matches(detid, DetId(db_factor.first), DetIdmasks)) ChipGeomFactors[k] *= db_factor.second;
   }
   
   // piluep scale factors are calculated once per event
-  // therefore vector index is stored in a map for each module that matches to a db_id
+  // therefore vector index is stored for each module that matches to a db_id
   size_t i=0;
   for (auto factor : PUFactors) {
     const DetId db_id = DetId(factor.first);
-    for( const auto& it_module : geom->detUnits()) {
-      if( dynamic_cast<PixelGeomDetUnit const*>(it_module)==nullptr) continue;
-      const DetId detid = it_module->geographicalId();
+    for (size_t k=0; k<rawids.size(); ++k) {
+      const DetId detid(rawids[k]);
       if (!matches(detid, db_id, DetIdmasks)) continue;
-      if (iPU.count(detid.rawId())) {
+      if (iPU[k]!=noPU) {
 	throw cms::Exception("Database")<<"Multiple db_ids match to same module in SiPixelDynamicInefficiency DB Object";
       } else {
-	iPU[detid.rawId()] = i;
+	iPU[k] = i;
       }
     }
     thePUEfficiency.push_back(factor.second);
@@ -617,6 +618,16 @@ void SiPixelDigitizerAlgorithm::PixelEfficiencies::init_from_db(const edm::ESHan
   pu_scale.resize(thePUEfficiency.size());
 }
 
+constexpr size_t SiPixelDigitizerAlgorithm::PixelEfficiencies::noPU;
+
+uint32_t SiPixelDigitizerAlgorithm::PixelEfficiencies::index(uint32_t rawid) const {
+  uint32_t k = moduleIndex.find(rawid);
+  if (k==TrackerDetIdIndex::invalid) {
+    throw cms::Exception("Database")<<"No SiPixelDynamicInefficiency factors for module "<<rawid;
+  }
+  return k;
+}
+
 bool SiPixelDigitizerAlgorithm::PixelEfficiencies::matches(const DetId& detid, const DetId& db_id, const std::vector<uint32_t >& DetIdmasks) {
   if (detid.subdetId() != db_id.subdetId()) return false;
   for (size_t i=0; i<DetIdmasks.size(); ++i) {
@@ -1063,6 +1074,9 @@ void SiPixelDigitizerAlgorithm::drift(const PSimHit& hit,
   float DriftDistance; // Distance between charge generation and collection
   float DriftLength;   // Actual Drift Lentgh
   float Sigma;
+
+  // the aging parameter depends only on the module
+  float kValue = AddPixelAging ? pixel_aging(pixelAging_,pixdet,tTopo) : 0.f;
   
   for (unsigned int i = 0; i != ionization_points.size(); i++) {
     
@@ -1114,7 +1128,6 @@ void SiPixelDigitizerAlgorithm::drift(const PSimHit& hit,
     
     // add pixel aging 
     if (AddPixelAging) {
-      float kValue = pixel_aging(pixelAging_,pixdet,tTopo);
       energyOnCollector *= exp( -1*kValue*DriftDistance/moduleThickness );
     }
     
@@ -1156,12 +1169,15 @@ void SiPixelDigitizerAlgorithm::induce_signal(std::vector<PSimHit>::const_iterat
       << topol->pitch().first << " " << topol->pitch().second; //OK
 #endif
 
-   // local map to store pixels hit by 1 Hit.
-   typedef std::map< int, float, std::less<int> > hit_map_type;
-   hit_map_type hit_signal;
+   int numColumns = topol->ncolumns();  // det module number of cols&rows
+   int numRows = topol->nrows();
 
-   // map to store pixel integrals in the x and in the y directions
-   std::map<int, float, std::less<int> > x,y;
+   // pixel edges are the same for all the hits of a module type
+   if (topol!=edgesTopol_) fillEdges(topol);
+
+   // dense charge of the pixels hit by 1 Hit, the pixels hit are in hitPixels_
+   if (pixelCharge_.size() < size_t(numRows*numColumns)) pixelCharge_.resize(numRows*numColumns, 0.f);
+   hitPixels_.clear();
 
    // Assign signals to readout channels and store sorted by channel number
 
@@ -1175,13 +1191,6 @@ void SiPixelDigitizerAlgorithm::induce_signal(std::vector<PSimHit>::const_iterat
      float SigmaY = i->sigma_y();            //               in y
      float Charge = i->amplitude();          // Charge amplitude
 
-
-     //if(SigmaX==0 || SigmaY==0) {
-     //cout<<SigmaX<<" "<<SigmaY
-     //   << " cloud " << i->position().x() << " " << i->position().y() << " "
-     //   << i->sigma_x() << " " << i->sigma_y() << " " << i->amplitude()<<std::endl;
-     //}
-
 #ifdef TP_DEBUG
        LogDebug ("Pixel Digitizer")
 	 << " cloud " << i->position().x() << " " << i->position().y() << " "
@@ -1229,92 +1238,33 @@ void SiPixelDigitizerAlgorithm::induce_signal(std::vector<PSimHit>::const_iterat
 #endif
 
      // Check detector limits to correct for pixels outside range.
-     int numColumns = topol->ncolumns();  // det module number of cols&rows
-     int numRows = topol->nrows();
-
      IPixRightUpX = numRows>IPixRightUpX ? IPixRightUpX : numRows-1 ;
      IPixRightUpY = numColumns>IPixRightUpY ? IPixRightUpY : numColumns-1 ;
      IPixLeftDownX = 0<IPixLeftDownX ? IPixLeftDownX : 0 ;
      IPixLeftDownY = 0<IPixLeftDownY ? IPixLeftDownY : 0 ;
 
-     x.clear(); // clear temporary integration array
-     y.clear();
-
-     // First integrate charge strips in x
-     int ix; // TT for compatibility
-     for (ix=IPixLeftDownX; ix<=IPixRightUpX; ix++) {  // loop over x index
-       float xUB, xLB, UpperBound, LowerBound;
-
-       // Why is set to 0 if ix=0, does it meen that we accept charge
-       // outside the sensor? CHeck How it was done in ORCA?
-       //if(ix == 0) LowerBound = 0.;
-       if(ix == 0 || SigmaX==0. )  // skip for surface segemnts
-	 LowerBound = 0.;
-       else {
-	 mp = MeasurementPoint( float(ix), 0.0);
-	 xLB = topol->localPosition(mp).x();
-	 LowerBound = 1-calcQ((xLB-CloudCenterX)/SigmaX);
-       }
-
-       if(ix == numRows-1 || SigmaX==0. )
-	 UpperBound = 1.;
-       else {
-	 mp = MeasurementPoint( float(ix+1), 0.0);
-	 xUB = topol->localPosition(mp).x();
-	 UpperBound = 1. - calcQ((xUB-CloudCenterX)/SigmaX);
-       }
-
-       float   TotalIntegrationRange = UpperBound - LowerBound; // get strip
-       x[ix] = TotalIntegrationRange; // save strip integral
-       //if(SigmaX==0 || SigmaY==0)
-       //cout<<TotalIntegrationRange<<" "<<ix<<std::endl;
-
-     }
-
-    // Now integrate strips in y
-    int iy; // TT for compatibility
-    for (iy=IPixLeftDownY; iy<=IPixRightUpY; iy++) { //loope over y ind
-      float yUB, yLB, UpperBound, LowerBound;
-
-      if(iy == 0 || SigmaY==0.)
-	LowerBound = 0.;
-      else {
-        mp = MeasurementPoint( 0.0, float(iy) );
-        yLB = topol->localPosition(mp).y();
-	LowerBound = 1. - calcQ((yLB-CloudCenterY)/SigmaY);
-      }
-
-      if(iy == numColumns-1 || SigmaY==0. )
-	UpperBound = 1.;
-      else {
-        mp = MeasurementPoint( 0.0, float(iy+1) );
-        yUB = topol->localPosition(mp).y();
-	UpperBound = 1. - calcQ((yUB-CloudCenterY)/SigmaY);
-      }
-
-      float   TotalIntegrationRange = UpperBound - LowerBound;
-      y[iy] = TotalIntegrationRange; // save strip integral
-      //if(SigmaX==0 || SigmaY==0)
-      //cout<<TotalIntegrationRange<<" "<<iy<<std::endl;
-    }
+     // First integrate charge strips in x, then in y
+     integrateStrips(rowEdges_, IPixLeftDownX, IPixRightUpX, numRows, CloudCenterX, SigmaX, xStrips_);
+     integrateStrips(colEdges_, IPixLeftDownY, IPixRightUpY, numColumns, CloudCenterY, SigmaY, yStrips_);
 
     // Get the 2D charge integrals by folding x and y strips
-    int chan;
-    for (ix=IPixLeftDownX; ix<=IPixRightUpX; ix++) {  // loop over x index
-      for (iy=IPixLeftDownY; iy<=IPixRightUpY; iy++) { //loope over y ind
+    for (int ix=IPixLeftDownX; ix<=IPixRightUpX; ix++) {  // loop over x index
+      float chargeX = Charge*xStrips_[ix-IPixLeftDownX];
+      float* rowCharge = &pixelCharge_[ix*numColumns];
+      for (int iy=IPixLeftDownY; iy<=IPixRightUpY; iy++) { //loope over y ind
 
-        float ChargeFraction = Charge*x[ix]*y[iy];
+        float ChargeFraction = chargeX*yStrips_[iy-IPixLeftDownY];
 
         if( ChargeFraction > 0. ) {
-	  chan = PixelDigi::pixelToChannel( ix, iy);  // Get index
           // Load the amplitude
-          hit_signal[chan] += ChargeFraction;
+          if (rowCharge[iy]==0.f) hitPixels_.push_back(ix*numColumns+iy);
+          rowCharge[iy] += ChargeFraction;
 	} // endif
 
 #ifdef TP_DEBUG
 	mp = MeasurementPoint( float(ix), float(iy) );
 	LocalPoint lp = topol->localPosition(mp);
-	chan = topol->channel(lp);
+	int chan = topol->channel(lp);
 	LogDebug ("Pixel Digitizer")
 	  << " pixel " << ix << " " << iy << " - "<<" "
 	  << chan << " " << ChargeFraction<<" "
@@ -1333,6 +1283,8 @@ void SiPixelDigitizerAlgorithm::induce_signal(std::vector<PSimHit>::const_iterat
 
    bool reweighted = false;
    if (UseReweighting){
+     std::map< int, float, std::less<int> > hit_signal;
+     for (int ipix : hitPixels_) hit_signal[PixelDigi::pixelToChannel(ipix/numColumns, ipix%numColumns)] = pixelCharge_[ipix];
      if(hit.processType()==0){
        reweighted = hitSignalReweight (hit, hit_signal, hitIndex, tofBin, topol, detID, theSignal, hit.processType());
      }else{
@@ -1340,23 +1292,52 @@ void SiPixelDigitizerAlgorithm::induce_signal(std::vector<PSimHit>::const_iterat
        reweighted = hitSignalReweight ((*inputBegin), hit_signal, hitIndex, tofBin, topol, detID, theSignal, hit.processType());
      }
    }
-   if (!reweighted){
-     for ( hit_map_type::const_iterator im = hit_signal.begin();
-	   im != hit_signal.end(); ++im) {
-       int chan =  (*im).first;
-       theSignal[chan] += (makeDigiSimLinks_ ? Amplitude( (*im).second, &hit, hitIndex, tofBin, (*im).second) : Amplitude( (*im).second, (*im).second) )  ;
-       
+   for (int ipix : hitPixels_) {
+     float charge = pixelCharge_[ipix];
+     pixelCharge_[ipix] = 0.f;  // ready for the next hit
+     if (reweighted) continue;
+     int chan = PixelDigi::pixelToChannel(ipix/numColumns, ipix%numColumns);
+     theSignal[chan] += (makeDigiSimLinks_ ? Amplitude( charge, &hit, hitIndex, tofBin, charge) : Amplitude( charge, charge) )  ;
+
 #ifdef TP_DEBUG
-       std::pair<int,int> ip = PixelDigi::channelToPixel(chan);
-       LogDebug ("Pixel Digitizer")
-	 << " pixel " << ip.first << " " << ip.second << " "
-	 << theSignal[chan];
+     std::pair<int,int> ip = PixelDigi::channelToPixel(chan);
+     LogDebug ("Pixel Digitizer")
+       << " pixel " << ip.first << " " << ip.second << " "
+       << theSignal[chan];
 #endif
-     }
    }
 
 } // end induce_signal
 
+// Cache the lower edge of each row and column of a module type.
+void SiPixelDigitizerAlgorithm::fillEdges(const PixelTopology* topol) {
+  int numRows = topol->nrows();
+  int numColumns = topol->ncolumns();
+  rowEdges_.resize(numRows+1);
+  colEdges_.resize(numColumns+1);
+  for (int ix=0; ix<=numRows; ++ix) rowEdges_[ix] = topol->localPosition(MeasurementPoint(float(ix), 0.0)).x();
+  for (int iy=0; iy<=numColumns; ++iy) colEdges_[iy] = topol->localPosition(MeasurementPoint(0.0, float(iy))).y();
+  edgesTopol_ = topol;
+}
+
+// Charge fraction of a gaussian cloud in the strips first..last (rows or columns),
+// strips[i-first] for strip i. Each edge is integrated once and shared by
+// its two strips; the first and the last strip of the module collect the tails.
+void SiPixelDigitizerAlgorithm::integrateStrips(const std::vector<float>& edges, int first, int last, int nStrips,
+                                                float center, float sigma, std::vector<float>& strips) const {
+  int n = last-first+1;
+  if (n<=0) { strips.clear(); return; }
+  strips.resize(n+1);
+  if (sigma==0.) { // skip for surface segemnts
+    std::fill(strips.begin(), strips.begin()+n, 1.f);
+    return;
+  }
+  for (int k=0; k<=n; ++k) strips[k] = 1. - calcQ((edges[first+k]-center)/sigma);
+  if (first==0) strips[0] = 0.;
+  if (last==nStrips-1) strips[n] = 1.;
+  for (int k=0; k<n; ++k) strips[k] = strips[k+1]-strips[k];
+}
+
 /***********************************************************************/
 
 // Build pixels, check threshold, add misscalibration, ...
@@ -1471,6 +1452,13 @@ void SiPixelDigitizerAlgorithm::add_noise(const PixelGeomDetUnit* pixdet,
   // First add noise to hit pixels
   float theSmearedChargeRMS = 0.0;
 
+  // Draw the gaussians of all the hit pixels at once, in the order they are used:
+  // (Vcal smearing, readout) per pixel, or readout only
+  const size_t nDraws = addChargeVCALSmearing ? 2 : 1;
+  gaussians_.resize(nDraws*theSignal.size());
+  if (!gaussians_.empty()) CLHEP::RandGaussQ::shootArray(engine, gaussians_.size(), gaussians_.data(), 0., 1.);
+  std::vector<double>::const_iterator gauss = gaussians_.begin();
+
   for ( signal_map_iterator i = theSignal.begin(); i != theSignal.end(); i++) {
 
          if(addChargeVCALSmearing)
@@ -1485,9 +1473,9 @@ void SiPixelDigitizerAlgorithm::add_noise(const PixelGeomDetUnit* pixdet,
 	}
 
 	// Noise from Vcal smearing:
-        float noise_ChargeVCALSmearing = theSmearedChargeRMS * CLHEP::RandGaussQ::shoot(engine, 0., 1.);
+        float noise_ChargeVCALSmearing = theSmearedChargeRMS * (*gauss++);
 	// Noise from full readout:
-        float noise  = CLHEP::RandGaussQ::shoot(engine, 0., theReadoutNoise);
+        float noise  = (*gauss++) * theReadoutNoise;
 
 		if(((*i).second + Amplitude(noise+noise_ChargeVCALSmearing, -1.)) < 0. ) {
 		  (*i).second.set(0);}
@@ -1500,7 +1488,7 @@ void SiPixelDigitizerAlgorithm::add_noise(const PixelGeomDetUnit* pixdet,
      {
 	// Noise: ONLY full READOUT Noise.
 	// Use here the FULL readout noise, including TBM,ALT,AOH,OPT-REC.
-	float noise = CLHEP::RandGaussQ::shoot(engine, 0., theReadoutNoise);
+	float noise = (*gauss++) * theReadoutNoise;
 
 		if(((*i).second + Amplitude(noise, -1.)) < 0. ) {
 		  (*i).second.set(0);}
@@ -1643,13 +1631,17 @@ void SiPixelDigitizerAlgorithm::pixel_inefficiency(const PixelEfficiencies& eff,
       chipEfficiency   = 0.999;
     } // if barrel/forward
   } else { // Load precomputed factors from Database
-    pixelEfficiency  = eff.PixelGeomFactors.at(detID);
-    columnEfficiency = eff.ColGeomFactors.at(detID)*eff.pu_scale[eff.iPU.at(detID)];
-    chipEfficiency   = eff.ChipGeomFactors.at(detID);
+    uint32_t k = eff.index(detID);
+    if (eff.iPU[k]==PixelEfficiencies::noPU) {
+      throw cms::Exception("Database")<<"No pileup factor for module "<<detID<<" in SiPixelDynamicInefficiency DB Object";
+    }
+    pixelEfficiency  = eff.PixelGeomFactors[k];
+    columnEfficiency = eff.ColGeomFactors[k]*eff.pu_scale[eff.iPU[k]];
+    chipEfficiency   = eff.ChipGeomFactors[k];
     if (isPhase1){
-      for (unsigned int i_roc=0; i_roc<eff.PixelGeomFactorsROCStdPixels.at(detID).size();++i_roc){
-	pixelEfficiencyROCStdPixels[i_roc] = eff.PixelGeomFactorsROCStdPixels.at(detID).at(i_roc);
-	pixelEfficiencyROCBigPixels[i_roc] = eff.PixelGeomFactorsROCBigPixels.at(detID).at(i_roc);    
+      for (unsigned int i_roc=0; i_roc<eff.PixelGeomFactorsROCStdPixels[k].size();++i_roc){
+	pixelEfficiencyROCStdPixels[i_roc] = eff.PixelGeomFactorsROCStdPixels[k][i_roc];
+	pixelEfficiencyROCBigPixels[i_roc] = eff.PixelGeomFactorsROCBigPixels[k][i_roc];    
       }
     } // is Phase 1
   }
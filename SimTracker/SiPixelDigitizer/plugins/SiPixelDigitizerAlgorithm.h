@@ -1,6 +1,7 @@
 #ifndef SiPixelDigitizerAlgorithm_h
 #define SiPixelDigitizerAlgorithm_h
 
+#include <limits>
 #include <map>
 #include <memory>
 #include <vector>
@@ -15,6 +16,7 @@
 #include "SimDataFormats/PileupSummaryInfo/interface/PileupMixingContent.h"
 #include "SimDataFormats/PileupSummaryInfo/interface/PileupSummaryInfo.h"
 #include "Geometry/CommonTopologies/interface/PixelTopology.h"
+#include "Geometry/TrackerGeometryBuilder/interface/TrackerDetIdIndex.h"
 #include "CondFormats/SiPixelTransient/interface/SiPixelTemplate2D.h"
 #include "CondFormats/SiPixelObjects/interface/SiPixel2DTemplateDBObject.h"
 #include "boost/multi_array.hpp"
@@ -256,13 +258,17 @@ class SiPixelDigitizerAlgorithm  {
      double theOuterEfficiency_FPix[20]; // Fpix outer module efficiency
      unsigned int FPixIndex;         // The Efficiency index for FPix Disks
 
-     // Read factors from DB and fill containers
-     std::map<uint32_t, double> PixelGeomFactors;
-     std::map<uint32_t, std::vector<double> > PixelGeomFactorsROCStdPixels;     
-     std::map<uint32_t, std::vector<double> > PixelGeomFactorsROCBigPixels;
-     std::map<uint32_t, double> ColGeomFactors;
-     std::map<uint32_t, double> ChipGeomFactors;
-     std::map<uint32_t, size_t > iPU;
+     // Read factors from DB and fill containers,
+     // dense over the pixel modules: entry index(rawid) belongs to module rawid
+     TrackerDetIdIndex moduleIndex;
+     std::vector<double> PixelGeomFactors;
+     std::vector<std::vector<double> > PixelGeomFactorsROCStdPixels;     
+     std::vector<std::vector<double> > PixelGeomFactorsROCBigPixels;
+     std::vector<double> ColGeomFactors;
+     std::vector<double> ChipGeomFactors;
+     std::vector<size_t> iPU;
+     static constexpr size_t noPU = std::numeric_limits<size_t>::max(); // module without pileup factor
+     uint32_t index(uint32_t rawid) const;
      
      // constants for ROC level simulation for Phase1
      enum shiftEnumerator {FPixRocIdShift = 3, BPixRocIdShift = 6};     
@@ -482,6 +488,19 @@ class SiPixelDigitizerAlgorithm  {
     PixelEfficiencies pixelEfficiencies_;
     const PixelAging pixelAging_;
 
+    // work buffers of induce_signal, reused across hits
+    std::vector<float> pixelCharge_;  // charge of the current hit, dense in (row,col) of the module
+    std::vector<int> hitPixels_;      // pixels with a non-zero pixelCharge_
+    std::vector<float> xStrips_, yStrips_; // charge fractions of the rows and columns under a cloud
+    std::vector<float> rowEdges_, colEdges_; // local x (y) of the lower edge of each row (column) of edgesTopol_
+    const PixelTopology* edgesTopol_ = nullptr;
+    void fillEdges(const PixelTopology* topol);
+    void integrateStrips(const std::vector<float>& edges, int first, int last, int nStrips,
+                         float center, float sigma, std::vector<float>& strips) const;
+
+    // random numbers of add_noise, drawn once per module
+    std::vector<double> gaussians_;
+
     double calcQ(float x) const {
       // need erf(x/sqrt2)
       //float x2=0.5*x*x;
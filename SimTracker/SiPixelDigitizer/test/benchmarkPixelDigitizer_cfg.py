@@ -0,0 +1,48 @@
+##############################################################################
+# Timing of the pixel digitizer alone, over saved SimHits (GEN-SIM input).
+#   cmsRun benchmarkPixelDigitizer_cfg.py inputFiles=file:simHits.root maxEvents=100
+# The per-module time of "mix" in the FastTimerService summary is the digitizer.
+
+import FWCore.ParameterSet.Config as cms
+from FWCore.ParameterSet.VarParsing import VarParsing
+
+options = VarParsing('analysis')
+options.register('threads', 1, VarParsing.multiplicity.singleton, VarParsing.varType.int,
+                 "number of threads")
+options.register('globalTag', 'auto:phase1_2017_realistic', VarParsing.multiplicity.singleton, VarParsing.varType.string,
+                 "global tag")
+options.parseArguments()
+
+process = cms.Process("PixelDigiBenchmark")
+
+process.load("FWCore.MessageService.MessageLogger_cfi")
+process.MessageLogger.cerr.FwkReport.reportEvery = 100
+process.load("Configuration.StandardSequences.Services_cff")
+process.load("Configuration.StandardSequences.GeometryRecoDB_cff")
+process.load("Configuration.StandardSequences.MagneticField_cff")
+process.load("Configuration.StandardSequences.FrontierConditions_GlobalTag_cff")
+from Configuration.AlCa.GlobalTag import GlobalTag
+process.GlobalTag = GlobalTag(process.GlobalTag, options.globalTag, '')
+
+# mixing with the pixel digitizer only
+process.load("SimGeneral.MixingModule.mixNoPU_cfi")
+from SimGeneral.MixingModule.pixelDigitizer_cfi import pixelDigitizer
+process.mix.digitizers = cms.PSet(
+    pixel = cms.PSet(pixelDigitizer)
+)
+
+process.source = cms.Source("PoolSource",
+    fileNames = cms.untracked.vstring(options.inputFiles)
+)
+process.maxEvents = cms.untracked.PSet(input = cms.untracked.int32(options.maxEvents))
+process.options = cms.untracked.PSet(
+    numberOfThreads = cms.untracked.uint32(options.threads),
+    numberOfStreams = cms.untracked.uint32(0)
+)
+
+process.load("HLTrigger.Timer.FastTimerService_cfi")
+process.FastTimerService.enableDQM = False
+process.FastTimerService.printRunSummary = False
+process.FastTimerService.printJobSummary = True
+
+process.p = cms.Path(process.mix)
@@ -33,6 +33,7 @@
 
 #include "CLHEP/Random/RandFlat.h"
 
+#include "SimGeneral/PreMixingModule/interface/PreMixingDigiLibrary.h"
 #include "SimGeneral/PreMixingModule/interface/PreMixingWorker.h"
 #include "SimGeneral/PreMixingModule/interface/PreMixingWorkerFactory.h"
 
@@ -77,6 +78,12 @@ private:
   SiGlobalIndex SiHitStorage_;
   SiGlobalRawIndex SiRawDigis_;
 
+  void addPileupDetector(uint32_t detID, OneDetectorMap const& digis);
+
+  // optional library of the premixed pileup digis, read instead of the pileup products
+  std::shared_ptr<const PreMixingDigiLibrary> library_;
+  unsigned int libraryCollection_ = 0;
+
   // variables for temporary storage of mixed hits:
   typedef std::map<int, Amplitude>  SignalMapType;
   typedef std::map<uint32_t, SignalMapType>  signalMaps;
@@ -164,6 +171,12 @@ PreMixingSiStripWorker::PreMixingSiStripWorker(const edm::ParameterSet& ps, edm:
     iC.consumes< std::vector<std::pair<int,std::bitset<6>> > >(SistripAPVLabelSig_);
   }
   iC.consumes<edm::DetSetVector<SiStripDigi>>(SistripLabelSig_);
+
+  std::string libraryFile = ps.getUntrackedParameter<std::string>("digiLibrary", "");
+  if(!libraryFile.empty()) {
+    library_ = PreMixingDigiLibrary::get(libraryFile);
+    libraryCollection_ = library_->collectionIndex(SiStripPileInputTag_.encode());
+  }
   // clear local storage for this event                                                                     
   SiHitStorage_.clear();
 
@@ -273,45 +286,36 @@ void PreMixingSiStripWorker::addPileups(PileUpEventPrincipal const& pep, edm::Ev
 
   // fill in maps of hits; same code as addSignals, except now applied to the pileup events
 
-  edm::Handle<edm::DetSetVector<SiStripDigi>> inputHandle;
-  pep.getByLabel(SiStripPileInputTag_, inputHandle);
-
-  if(inputHandle.isValid()) {
-    const auto& input = *inputHandle;
+  // the library has the digis as packed words: the digi product is not read
+  bool found = false;
+  if(library_) {
+    if(uint32_t const* record = library_->find(pep.principal().id(), pep.principal().processHistoryID())) {
+      OneDetectorMap LocalMap;
+      library_->collection(record, libraryCollection_).forEachDetector([this, &LocalMap](uint32_t detID, uint32_t const* words, uint32_t n) {
+          LocalMap.clear();
+          for(uint32_t i = 0; i < n; ++i) LocalMap.emplace_back(words[i] >> 16, words[i] & 0xffff);
+          addPileupDetector(detID, LocalMap);
+        });
+      found = true;
+    }
+  }
 
-    OneDetectorMap LocalMap;
+  edm::Handle<edm::DetSetVector<SiStripDigi>> inputHandle;
+  if(!found) {
+    pep.getByLabel(SiStripPileInputTag_, inputHandle);
+    found = inputHandle.isValid();
+  }
 
-    //loop on all detsets (detectorIDs) inside the input collection
-    edm::DetSetVector<SiStripDigi>::const_iterator DSViter=input.begin();
-    for (; DSViter!=input.end();DSViter++){
+  if(found) {
+    if(inputHandle.isValid()) {
+      //loop on all detsets (detectorIDs) inside the input collection
+      for(auto const& detSet : *inputHandle) {
 
 #ifdef DEBUG
-      LogDebug("PreMixingSiStripWorker")  << "Pileups: Processing DetID " << DSViter->id;
+        LogDebug("PreMixingSiStripWorker")  << "Pileups: Processing DetID " << detSet.id;
 #endif
 
-      // find correct local map (or new one) for this detector ID
-
-      SiGlobalIndex::const_iterator itest;
-
-      itest = SiHitStorage_.find(DSViter->id);
-
-      if(itest!=SiHitStorage_.end()) {  // this detID already has hits, add to existing map
-
-        LocalMap = itest->second;
-
-        // fill in local map with extra channels
-        LocalMap.insert(LocalMap.end(),(DSViter->data).begin(),(DSViter->data).end());
-        std::stable_sort(LocalMap.begin(),LocalMap.end(),PreMixingSiStripWorker::StrictWeakOrdering());
-        SiHitStorage_[DSViter->id]=LocalMap;
-	  
-      }
-      else{ // fill local storage with this information, put in global collection
-
-        LocalMap.clear();
-        LocalMap.reserve((DSViter->data).size());
-        LocalMap.insert(LocalMap.end(),(DSViter->data).begin(),(DSViter->data).end());
-
-        SiHitStorage_.insert( SiGlobalIndex::value_type( DSViter->id, LocalMap ) );
+        addPileupDetector(detSet.id, detSet.data);
       }
     }
 
@@ -333,6 +337,22 @@ void PreMixingSiStripWorker::addPileups(PileUpEventPrincipal const& pep, edm::Ev
 }
 
 
+void PreMixingSiStripWorker::addPileupDetector(uint32_t detID, OneDetectorMap const& digis) {
+  // find correct local map (or new one) for this detector ID
+  auto itest = SiHitStorage_.find(detID);
+
+  if(itest!=SiHitStorage_.end()) {  // this detID already has hits, add to existing map
+    OneDetectorMap& LocalMap = itest->second;
+
+    // fill in local map with extra channels
+    LocalMap.insert(LocalMap.end(),digis.begin(),digis.end());
+    std::stable_sort(LocalMap.begin(),LocalMap.end(),PreMixingSiStripWorker::StrictWeakOrdering());
+  }
+  else{ // fill local storage with this information, put in global collection
+    SiHitStorage_.insert( SiGlobalIndex::value_type( detID, digis ) );
+  }
+}
+
  
 void PreMixingSiStripWorker::put(edm::Event &e, edm::EventSetup const& iSetup, std::vector<PileupSummaryInfo> const& ps, int bs) {
 
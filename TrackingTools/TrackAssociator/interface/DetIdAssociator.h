@@ -8,7 +8,7 @@
 // 
 /**\
 
- Description: Abstract base class for 3D point -> std::set<DetId>
+ Description: Abstract base class for 3D point -> std::vector<DetId>
 
  Implementation:
      A look up map of active detector elements in eta-phi space is 
@@ -21,6 +21,9 @@
 
      The map is implemented as a double array. The first one has fixed
      size and points to the range of array elements in the second one.
+     DetIds are returned in contiguous vectors sorted by DetId, with
+     duplicates from neighbouring bins removed, i.e. in the same order
+     as a std::set<DetId> would have them.
 **/
 //
 // Original Author:  Dmytro Kovalskyi
@@ -59,24 +62,24 @@ class DetIdAssociator{
    
    /// Preselect DetIds close to a point on the inner surface of the detector. 
    /// "iN" is a number of the adjacent bins of the map to retrieve 
-   virtual std::set<DetId> getDetIdsCloseToAPoint(const GlobalPoint&,
+   virtual std::vector<DetId> getDetIdsCloseToAPoint(const GlobalPoint&,
 						  const int iN = 0) const;
-   virtual std::set<DetId> getDetIdsCloseToAPoint(const GlobalPoint& direction,
+   virtual std::vector<DetId> getDetIdsCloseToAPoint(const GlobalPoint& direction,
 						  const unsigned int iNEtaPlus,
 						  const unsigned int iNEtaMinus,
 						  const unsigned int iNPhiPlus,
 						  const unsigned int iNPhiMinus) const;
-   virtual std::set<DetId> getDetIdsCloseToAPoint(const GlobalPoint& direction,
+   virtual std::vector<DetId> getDetIdsCloseToAPoint(const GlobalPoint& direction,
 						  const MapRange& mapRange) const;
    /// Preselect DetIds close to a point on the inner surface of the detector. 
    /// "d" defines the allowed range in theta-phi space:
    /// - theta is in [point.theta()-d, point.theta()+d]
    /// - phi is in [point.phi()-d, point.phi()+d]
-   virtual std::set<DetId> getDetIdsCloseToAPoint(const GlobalPoint& point,
+   virtual std::vector<DetId> getDetIdsCloseToAPoint(const GlobalPoint& point,
 						  const double d = 0) const;
    /// - theta is in [point.theta()-dThetaMinus, point.theta()+dThetaPlus]
    /// - phi is in [point.phi()-dPhiMinus, point.phi()+dPhiPlus]
-   virtual std::set<DetId> getDetIdsCloseToAPoint(const GlobalPoint& point,
+   virtual std::vector<DetId> getDetIdsCloseToAPoint(const GlobalPoint& point,
 						  const double dThetaPlus,
 						  const double dThetaMinus,
 						  const double dPhiPlus,
@@ -87,7 +90,7 @@ class DetIdAssociator{
 
    /// Find DetIds that satisfy given requirements
    /// - inside eta-phi cone of radius dR
-   virtual std::set<DetId> getDetIdsInACone(const std::set<DetId>&,
+   virtual std::vector<DetId> getDetIdsInACone(const std::vector<DetId>&,
 					    const std::vector<GlobalPoint>& trajectory,
 					    const double dR) const;
    /// - DetIds crossed by the track
@@ -96,9 +99,9 @@ class DetIdAssociator{
    ///   on the trajectory direction. It's the fastest option
    /// - DetIds crossed by the track, ordered according to the order
    ///   that they were crossed by the track flying outside the detector
-   virtual std::vector<DetId> getCrossedDetIds(const std::set<DetId>&,
+   virtual std::vector<DetId> getCrossedDetIds(const std::vector<DetId>&,
 					       const std::vector<GlobalPoint>& trajectory) const;
-   virtual std::vector<DetId> getCrossedDetIds(const std::set<DetId>&,
+   virtual std::vector<DetId> getCrossedDetIds(const std::vector<DetId>&,
 					       const std::vector<SteppingHelixStateInfo>& trajectory,
 					       const double toleranceInSigmas = -1) const;
    /// look-up map eta index
@@ -147,7 +150,8 @@ class DetIdAssociator{
    unsigned int index(unsigned int iEta, unsigned int iPhi) const {
      return iEta*nPhi_+iPhi;
    }
-   void fillSet( std::set<DetId>& set, unsigned int iEta, unsigned int iPhi) const;
+   /// append the DetIds of a bin, which may already be in the vector
+   void fillSet( std::vector<DetId>& set, unsigned int iEta, unsigned int iPhi) const;
 
    // map parameters
    const int nPhi_;
@@ -20,6 +20,7 @@
 #include "TrackingTools/TrackAssociator/interface/DetIdAssociator.h"
 #include "DetIdInfo.h"
 #include "FWCore/Utilities/interface/isFinite.h"
+#include <algorithm>
 #include <map>
 
 DetIdAssociator::DetIdAssociator(const int nPhi, const int nEta, const double etaBinSize)
@@ -32,7 +33,7 @@ DetIdAssociator::DetIdAssociator(const int nPhi, const int nEta, const double et
    minTheta_ = 2*atan(exp(-maxEta_));
 }
    
-std::set<DetId> DetIdAssociator::getDetIdsCloseToAPoint(const GlobalPoint& direction,
+std::vector<DetId> DetIdAssociator::getDetIdsCloseToAPoint(const GlobalPoint& direction,
 							const int iN) const
 {
    unsigned int n = 0;
@@ -40,13 +41,13 @@ std::set<DetId> DetIdAssociator::getDetIdsCloseToAPoint(const GlobalPoint& direc
    return getDetIdsCloseToAPoint(direction,n,n,n,n);
 }
 
-std::set<DetId> DetIdAssociator::getDetIdsCloseToAPoint(const GlobalPoint& direction,
+std::vector<DetId> DetIdAssociator::getDetIdsCloseToAPoint(const GlobalPoint& direction,
 							const unsigned int iNEtaPlus,
 							const unsigned int iNEtaMinus,
 							const unsigned int iNPhiPlus,
 							const unsigned int iNPhiMinus) const
 {
-   std::set<DetId> set;
+   std::vector<DetId> set;
    check_setup();
    if (! theMapIsValid_ ) throw cms::Exception("FatalError") << "map is not valid.";
    LogTrace("TrackAssociator") << "(iNEtaPlus, iNEtaMinus, iNPhiPlus, iNPhiMinus): " <<
@@ -86,18 +87,20 @@ std::set<DetId> DetIdAssociator::getDetIdsCloseToAPoint(const GlobalPoint& direc
 	      fillSet(set,i,j%nPhi_);
 	   }
       }
-      
+      // large elements span several bins
+      std::sort(set.begin(),set.end());
+      set.erase(std::unique(set.begin(),set.end()),set.end());
    }
    return set;
 }
 
-std::set<DetId> DetIdAssociator::getDetIdsCloseToAPoint(const GlobalPoint& point,
+std::vector<DetId> DetIdAssociator::getDetIdsCloseToAPoint(const GlobalPoint& point,
 							const double d) const
 {
    return getDetIdsCloseToAPoint(point,d,d,d,d);
 }
 
-std::set<DetId> DetIdAssociator::getDetIdsCloseToAPoint(const GlobalPoint& point,
+std::vector<DetId> DetIdAssociator::getDetIdsCloseToAPoint(const GlobalPoint& point,
 							const double dThetaPlus,
 							const double dThetaMinus,
 							const double dPhiPlus,
@@ -113,7 +116,7 @@ std::set<DetId> DetIdAssociator::getDetIdsCloseToAPoint(const GlobalPoint& point
    if (maxTheta > M_PI-minTheta_) maxTheta =  M_PI-minTheta_;
    double minTheta = point.theta()-dThetaMinus;
    if (minTheta < minTheta_) minTheta = minTheta_;
-   if ( maxTheta < minTheta_ || minTheta > M_PI-minTheta_) return std::set<DetId>();
+   if ( maxTheta < minTheta_ || minTheta > M_PI-minTheta_) return std::vector<DetId>();
    
    // take into account non-linear dependence of eta from
    // theta in regions with large |eta|
@@ -265,56 +268,53 @@ void DetIdAssociator::buildMap()
    theMapIsValid_ = true;
 }
 
-std::set<DetId> DetIdAssociator::getDetIdsInACone(const std::set<DetId>& inset, 
+std::vector<DetId> DetIdAssociator::getDetIdsInACone(const std::vector<DetId>& inset, 
 					     const std::vector<GlobalPoint>& trajectory,
 					     const double dR) const
 {
   if ( selectAllInACone(dR)) return inset;
    check_setup();
-   std::set<DetId> outset;
-   for(std::set<DetId>::const_iterator id_iter = inset.begin(); id_iter != inset.end(); id_iter++)
+   std::vector<DetId> outset;
+   for(std::vector<DetId>::const_iterator id_iter = inset.begin(); id_iter != inset.end(); id_iter++)
      for(std::vector<GlobalPoint>::const_iterator point_iter = trajectory.begin(); point_iter != trajectory.end(); point_iter++)
        if (nearElement(*point_iter,*id_iter,dR)) {
-	  outset.insert(*id_iter);
+	  outset.push_back(*id_iter);
 	  break;
        }
    return outset;
 }
 
-std::vector<DetId> DetIdAssociator::getCrossedDetIds(const std::set<DetId>& inset,
+std::vector<DetId> DetIdAssociator::getCrossedDetIds(const std::vector<DetId>& inset,
 						     const std::vector<GlobalPoint>& trajectory) const
 {
    check_setup();
    std::vector<DetId> output;
-   std::set<DetId> ids(inset);
+   // elements already found crossed are not tested again
+   std::vector<bool> crossed(inset.size(),false);
    for ( unsigned int i=0; i+1 < trajectory.size(); ++i ) {
-      std::set<DetId>::const_iterator id_iter = ids.begin();
-      while ( id_iter != ids.end() ) {
-	 if ( crossedElement(trajectory[i],trajectory[i+1],*id_iter) ){
-	    output.push_back(*id_iter);
-	    ids.erase(id_iter++);
-	 }else
-	   id_iter++;
+      for ( unsigned int j=0; j < inset.size(); ++j ) {
+	 if ( !crossed[j] && crossedElement(trajectory[i],trajectory[i+1],inset[j]) ){
+	    output.push_back(inset[j]);
+	    crossed[j] = true;
+	 }
       }
    }
    return output;
 }
 
-std::vector<DetId> DetIdAssociator::getCrossedDetIds(const std::set<DetId>& inset,
+std::vector<DetId> DetIdAssociator::getCrossedDetIds(const std::vector<DetId>& inset,
 						     const std::vector<SteppingHelixStateInfo>& trajectory,
 						     const double tolerance) const
 {
    check_setup();
    std::vector<DetId> output;
-   std::set<DetId> ids(inset);
+   std::vector<bool> crossed(inset.size(),false);
    for ( unsigned int i=0; i+1 < trajectory.size(); ++i ) {
-      std::set<DetId>::const_iterator id_iter = ids.begin();
-      while ( id_iter != ids.end() ) {
-	 if ( crossedElement(trajectory[i].position(),trajectory[i+1].position(),*id_iter,tolerance,&trajectory[i]) ){
-	    output.push_back(*id_iter);
-	    ids.erase(id_iter++);
-	 }else
-	   id_iter++;
+      for ( unsigned int j=0; j < inset.size(); ++j ) {
+	 if ( !crossed[j] && crossedElement(trajectory[i].position(),trajectory[i+1].position(),inset[j],tolerance,&trajectory[i]) ){
+	    output.push_back(inset[j]);
+	    crossed[j] = true;
+	 }
       }
    }
    return output;
@@ -330,10 +330,10 @@ void DetIdAssociator::dumpMapContent(int ieta, int iphi) const
      }
 
    std::vector<GlobalPoint> pointBuffer;
-   std::set<DetId> set;
+   std::vector<DetId> set;
    fillSet(set,ieta,iphi%nPhi_);
    LogTrace("TrackAssociator") << "Map content for cell (ieta,iphi): " << ieta << ", " << iphi%nPhi_;
-   for(std::set<DetId>::const_iterator itr = set.begin(); itr!=set.end(); itr++)
+   for(std::vector<DetId>::const_iterator itr = set.begin(); itr!=set.end(); itr++)
      {
 	LogTrace("TrackAssociator") << "\tDetId " << itr->rawId() << ", geometry (x,y,z,rho,eta,phi):";
 	std::pair<const_iterator,const_iterator> points = getDetIdPoints(*itr, pointBuffer);
@@ -356,7 +356,7 @@ const FiducialVolume& DetIdAssociator::volume() const
    return volume_; 
 }
 
-std::set<DetId> DetIdAssociator::getDetIdsCloseToAPoint(const GlobalPoint& direction,
+std::vector<DetId> DetIdAssociator::getDetIdsCloseToAPoint(const GlobalPoint& direction,
 							const MapRange& mapRange) const
 {
    return getDetIdsCloseToAPoint(direction, mapRange.dThetaPlus, mapRange.dThetaMinus,
@@ -382,13 +382,12 @@ void DetIdAssociator::check_setup() const
   if (etaBinSize_==0) throw cms::Exception("FatalError") << "Eta bin size is not set.\n";
 }
 
-void DetIdAssociator::fillSet( std::set<DetId>& set, unsigned int iEta, unsigned int iPhi) const
+void DetIdAssociator::fillSet( std::vector<DetId>& set, unsigned int iEta, unsigned int iPhi) const
 {
   unsigned int i = index(iEta,iPhi);
   unsigned int i0 = lookupMap_.at(i).first;
   unsigned int size = lookupMap_.at(i).second;
-  for ( i = i0; i < i0+size; ++i )
-    set.insert(container_.at(i));
+  set.insert(set.end(), container_.begin()+i0, container_.begin()+i0+size);
 }
 
 #include "FWCore/PluginManager/interface/ModuleDef.h"
@@ -294,7 +294,7 @@ void TrackDetectorAssociator::fillEcal( const edm::Event& iEvent,
    iEvent.getByToken(parameters.EERecHitsToken, EERecHits);
    if (!EERecHits.isValid()) throw cms::Exception("FatalError") << "Unable to find EERecHitCollection in event!\n";
 
-   std::set<DetId> ecalIdsInRegion;
+   std::vector<DetId> ecalIdsInRegion;
    if (parameters.accountForTrajectoryChangeCalo){
       // get trajectory change with respect to initial state
       DetIdAssociator::MapRange mapRange = getMapRange(cachedTrajectory_.trajectoryDelta(CachedTrajectory::IpToEcal),
@@ -322,7 +322,7 @@ void TrackDetectorAssociator::fillEcal( const edm::Event& iEvent,
       else  
          LogTrace("TrackAssociator") << "Crossed EcalRecHit is not found for DetId: " << itr->rawId();
    }
-   for(std::set<DetId>::const_iterator itr=ecalIdsInRegion.begin(); itr!=ecalIdsInRegion.end();itr++)
+   for(std::vector<DetId>::const_iterator itr=ecalIdsInRegion.begin(); itr!=ecalIdsInRegion.end();itr++)
    {
       std::vector<EcalRecHit>::const_iterator ebHit = (*EBRecHits).find(*itr);
       std::vector<EcalRecHit>::const_iterator eeHit = (*EERecHits).find(*itr);
@@ -360,7 +360,7 @@ void TrackDetectorAssociator::fillCaloTowers( const edm::Event& iEvent,
    iEvent.getByToken(parameters.caloTowersToken, caloTowers);
    if (!caloTowers.isValid())  throw cms::Exception("FatalError") << "Unable to find CaloTowers in event!\n";
    
-   std::set<DetId> caloTowerIdsInRegion;
+   std::vector<DetId> caloTowerIdsInRegion;
    if (parameters.accountForTrajectoryChangeCalo){
       // get trajectory change with respect to initial state
       DetIdAssociator::MapRange mapRange = getMapRange(cachedTrajectory_.trajectoryDelta(CachedTrajectory::IpToHcal),
@@ -372,7 +372,7 @@ void TrackDetectorAssociator::fillCaloTowers( const edm::Event& iEvent,
 
    auto caloTowerIdsInAConeBegin = caloTowerIdsInRegion.begin();
    auto caloTowerIdsInAConeEnd = caloTowerIdsInRegion.end();
-   std::set<DetId> caloTowerIdsInAConeTmp;
+   std::vector<DetId> caloTowerIdsInAConeTmp;
    if (!caloDetIdAssociator_->selectAllInACone(parameters.dRHcal)){
      caloTowerIdsInAConeTmp = caloDetIdAssociator_->getDetIdsInACone(caloTowerIdsInRegion, trajectory, parameters.dRHcal);
      caloTowerIdsInAConeBegin = caloTowerIdsInAConeTmp.begin();
@@ -394,7 +394,7 @@ void TrackDetectorAssociator::fillCaloTowers( const edm::Event& iEvent,
 	  LogTrace("TrackAssociator") << "Crossed CaloTower is not found for DetId: " << (*itr).rawId();
      }
    
-   for(std::set<DetId>::const_iterator itr=caloTowerIdsInAConeBegin; itr!=caloTowerIdsInAConeEnd;itr++)
+   for(std::vector<DetId>::const_iterator itr=caloTowerIdsInAConeBegin; itr!=caloTowerIdsInAConeEnd;itr++)
      {
 	CaloTowerCollection::const_iterator tower = (*caloTowers).find(*itr);
 	if(tower != (*caloTowers).end()) 
@@ -419,7 +419,7 @@ void TrackDetectorAssociator::fillPreshower( const edm::Event& iEvent,
       return;
    }
    
-   std::set<DetId> idsInRegion = 
+   std::vector<DetId> idsInRegion = 
      preshowerDetIdAssociator_->getDetIdsCloseToAPoint(trajectory[0], 
 						       parameters.dRPreshowerPreselection);
    
@@ -451,7 +451,7 @@ void TrackDetectorAssociator::fillHcal( const edm::Event& iEvent,
    iEvent.getByToken(parameters.HBHEcollToken, collection);
    if ( ! collection.isValid() ) throw cms::Exception("FatalError") << "Unable to find HBHERecHits in event!\n";
    
-   std::set<DetId> idsInRegion;
+   std::vector<DetId> idsInRegion;
    if (parameters.accountForTrajectoryChangeCalo){
       // get trajectory change with respect to initial state
       DetIdAssociator::MapRange mapRange = getMapRange(cachedTrajectory_.trajectoryDelta(CachedTrajectory::IpToHcal),
@@ -463,14 +463,14 @@ void TrackDetectorAssociator::fillHcal( const edm::Event& iEvent,
 
    auto idsInAConeBegin = idsInRegion.begin();
    auto idsInAConeEnd = idsInRegion.end();
-   std::set<DetId> idsInAConeTmp;
+   std::vector<DetId> idsInAConeTmp;
    if (! hcalDetIdAssociator_->selectAllInACone(parameters.dRHcal)){
      idsInAConeTmp = hcalDetIdAssociator_->getDetIdsInACone(idsInRegion, coreTrajectory, parameters.dRHcal);
      idsInAConeBegin = idsInAConeTmp.begin();
      idsInAConeEnd = idsInAConeTmp.end();
    }
    LogTrace("TrackAssociator") << "HCAL hits in the cone: " << std::distance(idsInAConeBegin, idsInAConeEnd) << "\n" 
-			       << DetIdInfo::info(std::set<DetId>(idsInAConeBegin, idsInAConeEnd), nullptr);
+			       << DetIdInfo::info(std::vector<DetId>(idsInAConeBegin, idsInAConeEnd), nullptr);
    info.crossedHcalIds = hcalDetIdAssociator_->getCrossedDetIds(idsInRegion, coreTrajectory);
    const std::vector<DetId>& crossedIds = info.crossedHcalIds;
    LogTrace("TrackAssociator") << "HCAL hits crossed: " << crossedIds.size() << "\n" << DetIdInfo::info(crossedIds,nullptr);
@@ -484,7 +484,7 @@ void TrackDetectorAssociator::fillHcal( const edm::Event& iEvent,
 	else
 	  LogTrace("TrackAssociator") << "Crossed HBHERecHit is not found for DetId: " << itr->rawId();
      }
-   for(std::set<DetId>::const_iterator itr=idsInAConeBegin; itr!=idsInAConeEnd;itr++)
+   for(std::vector<DetId>::const_iterator itr=idsInAConeBegin; itr!=idsInAConeEnd;itr++)
      {
 	HBHERecHitCollection::const_iterator hit = (*collection).find(*itr);
 	if( hit != (*collection).end() ) 
@@ -516,7 +516,7 @@ void TrackDetectorAssociator::fillHO( const edm::Event& iEvent,
    iEvent.getByToken(parameters.HOcollToken, collection);
    if ( ! collection.isValid() ) throw cms::Exception("FatalError") << "Unable to find HORecHits in event!\n";
    
-   std::set<DetId> idsInRegion;
+   std::vector<DetId> idsInRegion;
    if (parameters.accountForTrajectoryChangeCalo){
       // get trajectory change with respect to initial state
       DetIdAssociator::MapRange mapRange = getMapRange(cachedTrajectory_.trajectoryDelta(CachedTrajectory::IpToHO),
@@ -528,7 +528,7 @@ void TrackDetectorAssociator::fillHO( const edm::Event& iEvent,
 
    auto idsInAConeBegin = idsInRegion.begin();
    auto idsInAConeEnd = idsInRegion.end();
-   std::set<DetId> idsInAConeTmp;
+   std::vector<DetId> idsInAConeTmp;
    if (! hoDetIdAssociator_->selectAllInACone(parameters.dRHcal)){
      idsInAConeTmp = hoDetIdAssociator_->getDetIdsInACone(idsInRegion, coreTrajectory, parameters.dRHcal);
      idsInAConeBegin = idsInAConeTmp.begin();
@@ -548,7 +548,7 @@ void TrackDetectorAssociator::fillHO( const edm::Event& iEvent,
 	  LogTrace("TrackAssociator") << "Crossed HORecHit is not found for DetId: " << itr->rawId();
      }
 
-   for(std::set<DetId>::const_iterator itr=idsInAConeBegin; itr!=idsInAConeEnd;itr++)
+   for(std::vector<DetId>::const_iterator itr=idsInAConeBegin; itr!=idsInAConeEnd;itr++)
      {
 	HORecHitCollection::const_iterator hit = (*collection).find(*itr);
 	if( hit != (*collection).end() ) 
@@ -664,10 +664,10 @@ void TrackDetectorAssociator::getTAMuonChamberMatches(std::vector<TAMuonChamberM
      
    // and find chamber DetIds
 
-   std::set<DetId> muonIdsInRegion = 
+   std::vector<DetId> muonIdsInRegion = 
      muonDetIdAssociator_->getDetIdsCloseToAPoint(trajectoryPoint.position(), mapRange);
    LogTrace("TrackAssociator") << "Number of chambers to check: " << muonIdsInRegion.size();
-   for(std::set<DetId>::const_iterator detId = muonIdsInRegion.begin(); detId != muonIdsInRegion.end(); detId++)
+   for(std::vector<DetId>::const_iterator detId = muonIdsInRegion.begin(); detId != muonIdsInRegion.end(); detId++)
    {
       const GeomDet* geomDet = muonDetIdAssociator_->getGeomDet(*detId);
       TrajectoryStateOnSurface stateOnSurface = cachedTrajectory_.propagate( &geomDet->surface() );
@@ -0,0 +1,212 @@
+// Timing of the DetIdAssociator look-ups for high-multiplicity events,
+// against the std::set<DetId> implementation they replace: for every
+// track, the elements close to its impact point, those in a cone around
+// its trajectory and those it crosses, as in TrackDetectorAssociator.
+// The map is the CaloTowers one (72 x 70 bins of 0.087) filled with
+// crystal-sized barrel elements, several per bin, and endcap towers
+// spanning 2 x 2 bins. Prints the time per track of each step for both;
+// fails only if they find different elements.
+
+#include "TrackingTools/TrackAssociator/interface/DetIdAssociator.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace {
+
+  class TowerAssociator final : public DetIdAssociator {
+  public:
+    TowerAssociator() : DetIdAssociator(72, 70, 0.087) {
+      // barrel crystals, 0.0174 x 0.0174
+      for (int ieta = -85; ieta < 85; ++ieta)
+        for (int iphi = 0; iphi < 360; ++iphi)
+          add(ieta*0.0174, (ieta+1)*0.0174, -M_PI + iphi*2*M_PI/360, -M_PI + (iphi+1)*2*M_PI/360);
+      // endcap towers, 0.174 x 0.174: each covers 2 x 2 bins of the map
+      for (int side : {-1, 1})
+        for (int ieta = 0; ieta < 8; ++ieta)
+          for (int iphi = 0; iphi < 36; ++iphi) {
+            double eta1 = side*(1.479 + ieta*0.174), eta2 = side*(1.479 + (ieta+1)*0.174);
+            add(std::min(eta1, eta2), std::max(eta1, eta2), -M_PI + iphi*2*M_PI/36, -M_PI + (iphi+1)*2*M_PI/36);
+          }
+    }
+
+    void setGeometry(const DetIdAssociatorRecord&) override {}
+    const GeomDet* getGeomDet(const DetId&) const override { return nullptr; }
+    const char* name() const override { return "Towers"; }
+
+    static GlobalPoint point(double eta, double phi, double r = 130.) {
+      return GlobalPoint(r*std::cos(phi), r*std::sin(phi), r*std::sinh(eta));
+    }
+
+    // the std::set implementation before the contiguous vectors
+    std::set<DetId> setCloseToAPoint(const GlobalPoint& direction, const int iN) const {
+      std::set<DetId> set;
+      int ieta = iEta(direction);
+      int iphi = iPhi(direction);
+      if (ieta>=0 && ieta<nEta_ && iphi>=0 && iphi<nPhi_) {
+        int maxIEta = std::min(ieta+iN, nEta_-1);
+        int minIEta = std::max(ieta-iN, 0);
+        int maxIPhi = iphi+iN;
+        int minIPhi = iphi-iN;
+        if (maxIPhi-minIPhi>=nPhi_) { minIPhi = 0; maxIPhi = nPhi_-1; }
+        if (minIPhi<0) { minIPhi+=nPhi_; maxIPhi+=nPhi_; }
+        for (int i=minIEta; i<=maxIEta; i++)
+          for (int j=minIPhi; j<=maxIPhi; j++) {
+            unsigned int k = index(i, j%nPhi_);
+            unsigned int i0 = lookupMap_.at(k).first;
+            for (unsigned int n = i0; n < i0+lookupMap_.at(k).second; ++n) set.insert(container_.at(n));
+          }
+      }
+      return set;
+    }
+    std::set<DetId> setInACone(const std::set<DetId>& inset, const std::vector<GlobalPoint>& trajectory,
+                               const double dR) const {
+      std::set<DetId> outset;
+      for (auto const& id : inset)
+        for (auto const& p : trajectory)
+          if (nearElement(p, id, dR)) { outset.insert(id); break; }
+      return outset;
+    }
+    std::vector<DetId> setCrossed(const std::set<DetId>& inset, const std::vector<GlobalPoint>& trajectory) const {
+      std::vector<DetId> output;
+      std::set<DetId> ids(inset);
+      for (unsigned int i=0; i+1 < trajectory.size(); ++i) {
+        auto id_iter = ids.begin();
+        while (id_iter != ids.end()) {
+          if (crossedElement(trajectory[i], trajectory[i+1], *id_iter)) {
+            output.push_back(*id_iter);
+            ids.erase(id_iter++);
+          } else
+            id_iter++;
+        }
+      }
+      return output;
+    }
+
+  protected:
+    GlobalPoint getPosition(const DetId& id) const override { return elements_[id.rawId() & 0xFFFFF].center; }
+    void getValidDetIds(unsigned int, std::vector<DetId>& ids) const override {
+      ids.clear();
+      for (unsigned int i = 0; i < elements_.size(); ++i) ids.push_back(detId(i));
+    }
+    std::pair<const_iterator, const_iterator> getDetIdPoints(const DetId& id, std::vector<GlobalPoint>& points) const override {
+      // the corners, slightly inside so that they fall in the bins the element covers
+      auto const& e = elements_[id.rawId() & 0xFFFFF];
+      constexpr double d = 1e-4;
+      points = {point(e.eta1+d, e.phi1+d), point(e.eta1+d, e.phi2-d), point(e.eta2-d, e.phi1+d), point(e.eta2-d, e.phi2-d)};
+      return std::make_pair(points.cbegin(), points.cend());
+    }
+    bool insideElement(const GlobalPoint& p, const DetId& id) const override {
+      auto const& e = elements_[id.rawId() & 0xFFFFF];
+      return p.eta() >= e.eta1 && p.eta() < e.eta2 && p.phi() >= e.phi1 && p.phi() < e.phi2;
+    }
+    bool crossedElement(const GlobalPoint& p1, const GlobalPoint& p2, const DetId& id,
+                        const double = -1, const SteppingHelixStateInfo* = nullptr) const override {
+      // the middle of the step
+      return insideElement(GlobalPoint(0.5f*(p1.x()+p2.x()), 0.5f*(p1.y()+p2.y()), 0.5f*(p1.z()+p2.z())), id);
+    }
+
+  private:
+    struct Element { double eta1, eta2, phi1, phi2; GlobalPoint center; };
+
+    static DetId detId(unsigned int i) { return DetId(DetId(DetId::Ecal, 1).rawId() | i); }
+    void add(double eta1, double eta2, double phi1, double phi2) { elements_.push_back({eta1, eta2, phi1, phi2, point(0.5*(eta1+eta2), 0.5*(phi1+phi2))}); }
+
+    std::vector<Element> elements_;
+  };
+
+  struct Track {
+    GlobalPoint impact;
+    std::vector<GlobalPoint> trajectory;
+  };
+
+  // charged tracks of |eta| < 2.5 bending in phi through the calorimeter, 129 to 177 cm
+  std::vector<Track> makeTracks(std::mt19937& gen, int nTracks) {
+    std::uniform_real_distribution<double> eta(-2.5, 2.5), phi(-M_PI, M_PI), curvature(-0.002, 0.002);
+    std::vector<Track> tracks(nTracks);
+    for (auto& track : tracks) {
+      double eta0 = eta(gen), phi0 = phi(gen), k = curvature(gen);
+      auto at = [&](double r) {
+        double p = phi0 + k*r;
+        if (p > M_PI) p -= 2*M_PI;
+        if (p < -M_PI) p += 2*M_PI;
+        return TowerAssociator::point(eta0, p, r);
+      };
+      track.impact = at(129.);
+      for (int s = 0; s <= 12; ++s) track.trajectory.push_back(at(129. + 4.*s));
+    }
+    return tracks;
+  }
+
+  template <typename F>
+  double microseconds(F f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+  }
+
+}
+
+int main() {
+  TowerAssociator associator;
+  associator.buildMap();
+
+  // 3 events of 1000 tracks
+  std::mt19937 gen(45);
+  std::vector<std::vector<Track> > events;
+  for (int e = 0; e < 3; ++e) events.push_back(makeTracks(gen, 1000));
+
+  // each step on the same input for both, the output of the vector one
+  bool ok = true;
+  for (int iN : {1, 2}) {
+    constexpr double dR = 0.1;
+    unsigned long nClose = 0, nCone = 0, nCrossed = 0, nTracks = 0, nDiff = 0;
+    double tVector[3] = {0., 0., 0.}, tSet[3] = {0., 0., 0.};
+    for (auto const& tracks : events) {
+      size_t n = tracks.size();
+      std::vector<std::vector<DetId> > close(n), cone(n), crossed(n), setCrossed(n);
+      std::vector<std::set<DetId> > setClose(n), setCone(n);
+      tVector[0] += microseconds([&]() {
+        for (size_t t = 0; t < n; ++t) close[t] = associator.getDetIdsCloseToAPoint(tracks[t].impact, iN);
+      });
+      tSet[0] += microseconds([&]() {
+        for (size_t t = 0; t < n; ++t) setClose[t] = associator.setCloseToAPoint(tracks[t].impact, iN);
+      });
+      tVector[1] += microseconds([&]() {
+        for (size_t t = 0; t < n; ++t) cone[t] = associator.getDetIdsInACone(close[t], tracks[t].trajectory, dR);
+      });
+      tSet[1] += microseconds([&]() {
+        for (size_t t = 0; t < n; ++t) setCone[t] = associator.setInACone(setClose[t], tracks[t].trajectory, dR);
+      });
+      tVector[2] += microseconds([&]() {
+        for (size_t t = 0; t < n; ++t) crossed[t] = associator.getCrossedDetIds(cone[t], tracks[t].trajectory);
+      });
+      tSet[2] += microseconds([&]() {
+        for (size_t t = 0; t < n; ++t) setCrossed[t] = associator.setCrossed(setCone[t], tracks[t].trajectory);
+      });
+      for (size_t t = 0; t < n; ++t) {
+        nClose += close[t].size();
+        nCone += cone[t].size();
+        nCrossed += crossed[t].size();
+        nTracks++;
+        if (close[t] != std::vector<DetId>(setClose[t].begin(), setClose[t].end()) ||
+            cone[t] != std::vector<DetId>(setCone[t].begin(), setCone[t].end()) ||
+            crossed[t] != setCrossed[t]) nDiff++;
+      }
+    }
+    std::cout << "+-" << iN << " bins, " << nTracks << " tracks, " << nDiff << " with different elements" << std::endl;
+    const char* steps[3] = {"close to a point", "in a cone", "crossed"};
+    const unsigned long nFound[3] = {nClose, nCone, nCrossed};
+    for (int k = 0; k < 3; ++k) {
+      std::cout << "  " << steps[k] << ": " << double(nFound[k])/nTracks << " per track, "
+                << tVector[k]/nTracks << " us per track with vectors, " << tSet[k]/nTracks
+                << " us with std::set (" << tSet[k]/tVector[k] << "x)" << std::endl;
+    }
+    ok &= nDiff == 0 && nCrossed > 0;
+  }
+  return ok ? 0 : 1;
+}